@@ -0,0 +1,210 @@
+// -----------------------------------------------------------------------------
+//    RETwoOFun convolution benchmark:  convbench.cpp
+//
+/**
+    \file   convbench.cpp
+    \brief  per-block cost of the PartitionedConvolver layouts (Linux command line)
+
+    		- convolves noise with a decaying noise IR (a stand-in for a spring
+    		  reverb) in host sized blocks, for uniform layouts with the
+    		  partition size at the host block size and above, non-uniform
+    		  layouts up to --max-partition, and the single block layout
+    		  FastConvolver defaults to (one partition of the whole IR)
+    		- reports the latency, the mean ns/sample and the worst block in
+    		  ns/sample: the uniform layouts cost the same on every block, the
+    		  non-uniform ones are cheaper on average but spike when their large
+    		  partitions come due, the single block one spikes once per IR length
+    		- the MAC runs on the CPU-dispatched complexMultiplyAccumulate kernel;
+    		  build with -DFX_KERNELS_MAX_ISA=0 or 1 to time the scalar or SSE2
+    		  version on an AVX2 machine
+
+    Build (from the repository root; needs FFTW):
+
+    g++ -std=c++14 -O2 -DHAVE_FFTW -IPluginKernel -IPluginObjects -ICustomControls \
+        Benchmark/convbench.cpp PluginObjects/fxobjects.cpp -lfftw3 -lpthread -o convbench
+
+    Usage:
+
+    convbench [--ir-ms 2000] [--block 64] [--max-partition 4096] [--seconds 10] [--rate 48000] [--csv results.csv]
+*/
+// -----------------------------------------------------------------------------
+#include "fxobjects.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef HAVE_FFTW
+#error convbench needs FFTW: build with -DHAVE_FFTW and link -lfftw3
+#endif
+
+/**
+\struct BenchOptions
+\brief command line settings
+*/
+struct BenchOptions
+{
+	double irMsec = 2000.0;				///< IR length
+	uint32_t blockSize = 64;			///< host block size
+	uint32_t maxPartitionSize = 4096;	///< largest partition for the non-uniform layouts
+	double seconds = 10.0;				///< audio to render per layout
+	unsigned int sampleRate = 48000;	///< sample rate
+	std::string csvPath;				///< optional CSV output
+};
+
+/**
+\struct BenchResult
+\brief one layout
+*/
+struct BenchResult
+{
+	std::string layout;
+	unsigned int stages = 0;
+	unsigned int latency = 0;
+	double meanNsPerSample = 0.0;
+	double worstBlockNsPerSample = 0.0;
+};
+
+static bool parseArgs(int argc, char** argv, BenchOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, "missing value for %s\n", arg.c_str());
+			return false;
+		}
+
+		if (arg == "--ir-ms")
+			options.irMsec = atof(argv[++i]);
+		else if (arg == "--block")
+			options.blockSize = (uint32_t)atol(argv[++i]);
+		else if (arg == "--max-partition")
+			options.maxPartitionSize = (uint32_t)atol(argv[++i]);
+		else if (arg == "--seconds")
+			options.seconds = atof(argv[++i]);
+		else if (arg == "--rate")
+			options.sampleRate = (unsigned int)atol(argv[++i]);
+		else if (arg == "--csv")
+			options.csvPath = argv[++i];
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", arg.c_str());
+			return false;
+		}
+	}
+	return options.irMsec > 0.0 && options.blockSize > 0 && options.seconds > 0.0 && options.sampleRate > 0;
+}
+
+/** render in host blocks, timed per block */
+static BenchResult timeLayout(const BenchOptions& options, const std::vector<double>& ir, const std::vector<double>& noise,
+							  unsigned int partitionSize, unsigned int maxPartitionSize, double& checksum)
+{
+	PartitionedConvolver convolver;
+	convolver.initialize(partitionSize, (unsigned int)ir.size(), maxPartitionSize);
+	convolver.setFilterIR(ir.data(), (unsigned int)ir.size());
+
+	BenchResult result;
+	char name[64];
+	if (partitionSize >= ir.size())
+		snprintf(name, sizeof(name), "single block");
+	else if (maxPartitionSize > partitionSize)
+		snprintf(name, sizeof(name), "non-uniform %u..%u", partitionSize, maxPartitionSize);
+	else
+		snprintf(name, sizeof(name), "uniform %u", partitionSize);
+	result.layout = name;
+	result.stages = convolver.getNumStages();
+	result.latency = convolver.getLatency();
+
+	uint32_t numSamples = (uint32_t)(options.seconds * options.sampleRate);
+	uint32_t mask = (uint32_t)noise.size() - 1;
+	std::vector<double> block(options.blockSize);
+	double sum = 0.0;
+	double total = 0.0;
+	double worst = 0.0;
+	for (uint32_t start = 0; start < numSamples; start += options.blockSize)
+	{
+		uint32_t length = numSamples - start < options.blockSize ? numSamples - start : options.blockSize;
+		for (uint32_t n = 0; n < length; n++)
+			block[n] = noise[(start + n) & mask];
+
+		auto blockStart = std::chrono::steady_clock::now();
+		convolver.processAudioBlock(block.data(), block.data(), length);
+		auto blockStop = std::chrono::steady_clock::now();
+
+		double ns = std::chrono::duration<double, std::nano>(blockStop - blockStart).count();
+		total += ns;
+		worst = fmax(worst, ns / length);
+		sum += block[0];
+	}
+
+	// --- keep the loop alive
+	checksum += sum;
+	result.meanNsPerSample = total / numSamples;
+	result.worstBlockNsPerSample = worst;
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+	if (!parseArgs(argc, argv, options))
+	{
+		fprintf(stderr, "usage: convbench [--ir-ms 2000] [--block 64] [--max-partition 4096] [--seconds 10] [--rate 48000] [--csv results.csv]\n");
+		return 1;
+	}
+
+	// --- decaying noise, about -60dB at the end
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	std::vector<double> ir((size_t)(options.irMsec * options.sampleRate / 1000.0));
+	for (size_t n = 0; n < ir.size(); n++)
+		ir[n] = distribution(generator) * exp(-6.9 * n / ir.size());
+
+	const uint32_t tableLength = 65536;
+	std::vector<double> noise(tableLength);
+	for (uint32_t n = 0; n < tableLength; n++)
+		noise[n] = distribution(generator);
+
+	std::vector<BenchResult> results;
+	double checksum = 0.0;
+	for (unsigned int partitionSize = options.blockSize; partitionSize <= 4 * options.blockSize; partitionSize *= 2)
+		results.push_back(timeLayout(options, ir, noise, partitionSize, 0, checksum));
+	for (unsigned int partitionSize = options.blockSize; partitionSize <= 4 * options.blockSize; partitionSize *= 2)
+	{
+		if (options.maxPartitionSize > partitionSize)
+			results.push_back(timeLayout(options, ir, noise, partitionSize, options.maxPartitionSize, checksum));
+	}
+	results.push_back(timeLayout(options, ir, noise, (unsigned int)ir.size(), 0, checksum));
+
+	const char* isa[] = { "scalar", "sse2", "avx2" };
+	printf("IR %zu samples, blocks of %u, %u Hz, complexMultiplyAccumulate kernel %s (checksum %g)\n\n", ir.size(),
+		   options.blockSize, options.sampleRate, isa[(int)getFXKernels().isa], checksum);
+	printf("%-24s %6s %8s %14s %18s\n", "layout", "stages", "latency", "mean ns/smp", "worst block ns/smp");
+	for (auto& result : results)
+		printf("%-24s %6u %8u %14.1f %18.1f\n", result.layout.c_str(), result.stages, result.latency,
+			   result.meanNsPerSample, result.worstBlockNsPerSample);
+
+	if (!options.csvPath.empty())
+	{
+		FILE* csv = fopen(options.csvPath.c_str(), "w");
+		if (!csv)
+		{
+			fprintf(stderr, "cannot write %s\n", options.csvPath.c_str());
+			return 1;
+		}
+
+		fprintf(csv, "layout,stages,latency,mean_ns_per_sample,worst_block_ns_per_sample\n");
+		for (auto& result : results)
+			fprintf(csv, "%s,%u,%u,%.3f,%.3f\n", result.layout.c_str(), result.stages, result.latency,
+					result.meanNsPerSample, result.worstBlockNsPerSample);
+		fclose(csv);
+	}
+
+	return 0;
+}
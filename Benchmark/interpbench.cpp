@@ -0,0 +1,262 @@
+// -----------------------------------------------------------------------------
+//    RETwoOFun fractional delay interpolation benchmark:  interpbench.cpp
+//
+/**
+    \file   interpbench.cpp
+    \brief  cost and quality of the CircularBuffer interpolators (Linux command line)
+
+    		- writes noise into a CircularBuffer<double> and reads it back once
+    		  per write through a swept (vibrato) delay, for each
+    		  bufferInterpolation type; this is the FourTapDelay and
+    		  ModulatedDelay access pattern
+    		- reports ns/read (write included) and the cost relative to linear
+    		- reports the gain at --freq Hz through a fixed half sample delay,
+    		  which is the worst case for linear interpolation, and the error of
+    		  a --freq Hz sine through the swept delay against the ideal swept
+    		  sine, in dB below the signal (the modulation noise)
+
+    Build (from the repository root):
+
+    g++ -std=c++14 -O2 -IPluginKernel -IPluginObjects -ICustomControls \
+        Benchmark/interpbench.cpp PluginObjects/fxobjects.cpp -lpthread -o interpbench
+
+    Usage:
+
+    interpbench [--reads 10000000] [--rate 48000] [--freq 12000] [--csv results.csv]
+*/
+// -----------------------------------------------------------------------------
+#include "fxobjects.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+\struct BenchOptions
+\brief command line settings
+*/
+struct BenchOptions
+{
+	uint32_t numReads = 10000000;	///< reads per interpolator for the timing
+	double sampleRate = 48000.0;	///< for the sweep and the test frequency
+	double testFrequency_Hz = 12000.0;	///< quality test tone
+	std::string csvPath;			///< optional CSV output
+};
+
+/**
+\struct BenchResult
+\brief one interpolator
+*/
+struct BenchResult
+{
+	const char* name = "";
+	double nsPerRead = 0.0;
+	double relativeCost = 0.0;
+	double halfSampleGain_dB = 0.0;
+	double sweepError_dB = 0.0;
+};
+
+// --- the vibrato: 5 mSec centre, +/-2 mSec at 5Hz
+const double kSweepCentre_mSec = 5.0;
+const double kSweepDepth_mSec = 2.0;
+const double kSweepRate_Hz = 5.0;
+const unsigned int kBufferLength = 4096;
+
+static bool parseArgs(int argc, char** argv, BenchOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, "missing value for %s\n", arg.c_str());
+			return false;
+		}
+
+		if (arg == "--reads")
+			options.numReads = (uint32_t)atol(argv[++i]);
+		else if (arg == "--rate")
+			options.sampleRate = atof(argv[++i]);
+		else if (arg == "--freq")
+			options.testFrequency_Hz = atof(argv[++i]);
+		else if (arg == "--csv")
+			options.csvPath = argv[++i];
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", arg.c_str());
+			return false;
+		}
+	}
+	return options.numReads > 0 && options.sampleRate > 0.0 && options.testFrequency_Hz > 0.0;
+}
+
+/** the swept delay in samples for sample n */
+static double sweptDelay(const BenchOptions& options, uint32_t n)
+{
+	double samplesPerMSec = options.sampleRate / 1000.0;
+	double lfo = sin(kTwoPi * kSweepRate_Hz * n / options.sampleRate);
+	return (kSweepCentre_mSec + kSweepDepth_mSec * lfo) * samplesPerMSec;
+}
+
+/** ns per write + read through the swept delay */
+static double timeReads(const BenchOptions& options, bufferInterpolation interpolation, const std::vector<double>& noise,
+						const std::vector<double>& delays, double& checksum)
+{
+	CircularBuffer<double> buffer;
+	buffer.createCircularBuffer(kBufferLength);
+	buffer.setInterpolation(interpolation);
+
+	uint32_t mask = (uint32_t)noise.size() - 1;
+	double sum = 0.0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t n = 0; n < options.numReads; n++)
+	{
+		sum += buffer.readBuffer(delays[n & mask]);
+		buffer.writeBuffer(noise[n & mask]);
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+	// --- keep the loop alive
+	checksum += sum;
+	return std::chrono::duration<double, std::nano>(stop - start).count() / options.numReads;
+}
+
+/** gain of a sine through a fixed delay of 10.5 samples, in dB */
+static double halfSampleGain_dB(const BenchOptions& options, bufferInterpolation interpolation)
+{
+	CircularBuffer<double> buffer;
+	buffer.createCircularBuffer(kBufferLength);
+	buffer.setInterpolation(interpolation);
+
+	const uint32_t settle = 1024;
+	const uint32_t length = 48000;
+	double w = kTwoPi * options.testFrequency_Hz / options.sampleRate;
+	double inPower = 0.0;
+	double outPower = 0.0;
+	for (uint32_t n = 0; n < settle + length; n++)
+	{
+		double yn = buffer.readBuffer(10.5);
+		double xn = sin(w * n);
+		buffer.writeBuffer(xn);
+		if (n >= settle)
+		{
+			inPower += xn * xn;
+			outPower += yn * yn;
+		}
+	}
+	return 10.0 * log10(outPower / inPower);
+}
+
+/** error of a sine through the swept delay against the ideal swept sine, in dB below the signal */
+static double sweepError_dB(const BenchOptions& options, bufferInterpolation interpolation)
+{
+	CircularBuffer<double> buffer;
+	buffer.createCircularBuffer(kBufferLength);
+	buffer.setInterpolation(interpolation);
+
+	const uint32_t settle = 1024;
+	const uint32_t length = (uint32_t)options.sampleRate;
+	double w = kTwoPi * options.testFrequency_Hz / options.sampleRate;
+	double signalPower = 0.0;
+	double errorPower = 0.0;
+	for (uint32_t n = 0; n < settle + length; n++)
+	{
+		double delay = sweptDelay(options, n);
+		double yn = buffer.readBuffer(delay);
+		buffer.writeBuffer(sin(w * n));
+
+		// --- read-before-write: a delay of 0 is the previous input
+		double ideal = sin(w * (n - 1.0 - delay));
+		if (n >= settle)
+		{
+			signalPower += ideal * ideal;
+			errorPower += (yn - ideal) * (yn - ideal);
+		}
+	}
+	return 10.0 * log10(errorPower / signalPower);
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+	if (!parseArgs(argc, argv, options))
+	{
+		fprintf(stderr, "usage: interpbench [--reads 10000000] [--rate 48000] [--freq 12000] [--csv results.csv]\n");
+		return 1;
+	}
+
+	// --- one table of inputs and delays, so the timing is the buffer and nothing else
+	const uint32_t tableLength = 65536;
+	std::vector<double> noise(tableLength);
+	std::vector<double> delays(tableLength);
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	for (uint32_t n = 0; n < tableLength; n++)
+	{
+		noise[n] = distribution(generator);
+		delays[n] = sweptDelay(options, n);
+	}
+
+	struct { bufferInterpolation type; const char* name; } interpolators[] = {
+		{ bufferInterpolation::kNone, "none" },
+		{ bufferInterpolation::kLinear, "linear" },
+		{ bufferInterpolation::kLagrange4, "lagrange4" },
+		{ bufferInterpolation::kHermite4, "hermite4" },
+		{ bufferInterpolation::kThiranAllpass, "thiran" },
+		{ bufferInterpolation::kWindowedSinc, "sinc8" } };
+
+	std::vector<BenchResult> results;
+	double checksum = 0.0;
+	double linearCost = 0.0;
+	for (auto& interpolator : interpolators)
+	{
+		BenchResult result;
+		result.name = interpolator.name;
+
+		// --- warm up, then the best of three
+		timeReads(options, interpolator.type, noise, delays, checksum);
+		result.nsPerRead = 1.0e30;
+		for (int pass = 0; pass < 3; pass++)
+			result.nsPerRead = fmin(result.nsPerRead, timeReads(options, interpolator.type, noise, delays, checksum));
+
+		if (interpolator.type == bufferInterpolation::kLinear)
+			linearCost = result.nsPerRead;
+
+		result.halfSampleGain_dB = halfSampleGain_dB(options, interpolator.type);
+		result.sweepError_dB = sweepError_dB(options, interpolator.type);
+		results.push_back(result);
+	}
+
+	printf("%u reads, %.0f Hz, test tone %.0f Hz (checksum %g)\n\n", options.numReads, options.sampleRate,
+		   options.testFrequency_Hz, checksum);
+	printf("%-12s %10s %10s %16s %16s\n", "interpolator", "ns/read", "x linear", "gain@0.5smp dB", "sweep error dB");
+	for (auto& result : results)
+	{
+		result.relativeCost = linearCost > 0.0 ? result.nsPerRead / linearCost : 0.0;
+		printf("%-12s %10.2f %10.2f %16.2f %16.1f\n", result.name, result.nsPerRead, result.relativeCost,
+			   result.halfSampleGain_dB, result.sweepError_dB);
+	}
+
+	if (!options.csvPath.empty())
+	{
+		FILE* csv = fopen(options.csvPath.c_str(), "w");
+		if (!csv)
+		{
+			fprintf(stderr, "cannot write %s\n", options.csvPath.c_str());
+			return 1;
+		}
+
+		fprintf(csv, "interpolator,ns_per_read,relative_cost,half_sample_gain_db,sweep_error_db\n");
+		for (auto& result : results)
+			fprintf(csv, "%s,%.3f,%.3f,%.3f,%.3f\n", result.name, result.nsPerRead, result.relativeCost,
+					result.halfSampleGain_dB, result.sweepError_dB);
+		fclose(csv);
+	}
+
+	return 0;
+}
@@ -0,0 +1,748 @@
+// -----------------------------------------------------------------------------
+//    RETwoOFun offline render benchmark:  renderbench.cpp
+//
+/**
+    \file   renderbench.cpp
+    \brief  headless render benchmark for PluginCore (Linux command line)
+
+    		- instantiates PluginCore outside of any host, calls initialize( )
+    		  and reset( ) and feeds it ProcessBufferInfo blocks, exactly as
+    		  a buffer-processing host would
+    		- input is a WAV file (16/24/32-bit PCM or 32-bit float, mono or
+    		  stereo) or generated white noise
+    		- sweeps buffer sizes, sample rates and modeSelectorValue 1 - 14
+    		- renders mono, stereo or a surround bed (--channels 12 is 7.1.4); the
+    		  file or noise channels are repeated L, R, L, R... across a bed
+    		- reports ns/sample (per frame, all channels), real-time factor, and
+    		  p99/max per-block latency against the block's real-time budget
+    		- --denormal-stress renders a short noise burst followed by --seconds of
+    		  silence with short, fed-back delays, once with the DenormalGuard and once
+    		  without, and reports the cost of the decaying tail against the burst;
+    		  this is the "song stop" case where the echoes fade into the denormal range
+    		- --automation smoothing turns on parameter smoothing for the feedback,
+    		  blend and delay times and moves their targets every buffer; --automation
+    		  vst3 drives them with sample accurate ramps from a host-style update queue
+    		  that reports its queue points. Each point is rendered twice, with the
+    		  plugin's sub-block granularity and with per-sample updates (granularity 1,
+    		  and a queue that reports no queue points, which is what the default
+    		  IParameterUpdateQueue::getSamplesToNextQueuePoint( ) does), and the
+    		  speedup of the sub-block path is reported
+
+    Build (from the repository root):
+
+    g++ -std=c++14 -O2 -IPluginKernel -IPluginObjects -ICustomControls \
+        Benchmark/renderbench.cpp PluginKernel/pluginbase.cpp PluginKernel/plugincore.cpp \
+        PluginKernel/pluginparameter.cpp PluginObjects/fxobjects.cpp -lpthread -o renderbench
+
+    Usage:
+
+    renderbench [--wav file.wav] [--seconds 10] [--buffers 64,128,256,512,1024]
+                [--rates 44100,48000,96000] [--modes 1-14] [--mod] [--sidechain]
+                [--channels 2] [--denormal-stress] [--automation smoothing|vst3]
+                [--csv results.csv]
+*/
+// -----------------------------------------------------------------------------
+#include "plugincore.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- host-side stand-ins
+class NullMidiEventQueue : public IMidiEventQueue
+{
+public:
+	virtual uint32_t getEventCount() { return 0; }
+	virtual bool fireMidiEvents(uint32_t uSampleOffset) { return true; }
+};
+
+/**
+\class RampParameterUpdateQueue
+\brief
+Host-side stand-in for a VST3 parameter queue: one linear ramp per buffer, with a queue point every pointSpacing
+samples. Unlike the default it reports its queue points, so the sub-block path can run between them.
+*/
+class RampParameterUpdateQueue : public IParameterUpdateQueue
+{
+public:
+	/** the ramp for the next buffer, in normalized values */
+	void setRamp(double _startValue, double _endValue, uint32_t _numFrames)
+	{
+		startValue = _startValue;
+		endValue = _endValue;
+		numFrames = _numFrames;
+		counter = 0;
+	}
+
+	virtual uint32_t getParameterIndex() { return parameterIndex; }
+
+	virtual bool getValueAtOffset(long int _sampleOffset, double _previousValue, double& _nextValue)
+	{
+		_nextValue = getValue((uint32_t)_sampleOffset);
+		return _nextValue != _previousValue;
+	}
+
+	virtual bool getNextValue(double& _nextValue)
+	{
+		double previousValue = getValue(counter == 0 ? 0 : counter - 1);
+		_nextValue = getValue(counter++);
+		return _nextValue != previousValue;
+	}
+
+	virtual uint32_t getSamplesToNextQueuePoint(uint32_t _sampleOffset, uint32_t _maxSamples)
+	{
+		if (!reportQueuePoints)
+			return 1;
+		uint32_t toPoint = pointSpacing - _sampleOffset % pointSpacing;
+		return toPoint < _maxSamples ? toPoint : _maxSamples;
+	}
+
+	uint32_t parameterIndex = 0;	///< the parameter this queue feeds
+	uint32_t pointSpacing = 32;		///< samples between queue points
+	bool reportQueuePoints = true;	///< false: behave like the default, one sample at a time
+
+protected:
+	double getValue(uint32_t offset)
+	{
+		if (numFrames <= 1)
+			return endValue;
+		uint32_t clamped = offset < numFrames ? offset : numFrames - 1;
+		return startValue + (endValue - startValue) * clamped / (numFrames - 1);
+	}
+
+	double startValue = 0.0;
+	double endValue = 0.0;
+	uint32_t numFrames = 0;
+	uint32_t counter = 0;
+};
+
+/**
+\class BenchPluginCore
+\brief PluginCore with the descriptor settings the automation runs change
+*/
+class BenchPluginCore : public PluginCore
+{
+public:
+	void setParamSmoothingGranularity(uint32_t granularity) { pluginDescriptor.paramSmoothingGranularity = granularity; }
+	void enableVST3SampleAccurateAutomation(bool enable) { apiSpecificInfo.enableVST3SampleAccurateAutomation = enable; }
+};
+
+/**
+\enum automationType
+\brief --automation: what moves the parameters during the render
+*/
+enum class automationType { kNone, kSmoothing, kVST3 };
+
+/**
+\struct BenchOptions
+\brief command line settings
+*/
+struct BenchOptions
+{
+	std::string wavPath;							///< input file; empty = noise
+	double noiseSeconds = 10.0;						///< noise length
+	std::vector<uint32_t> bufferSizes = { 64, 128, 256, 512, 1024 };
+	std::vector<double> sampleRates = { 44100.0, 48000.0, 96000.0 };
+	std::vector<uint32_t> modes;					///< modeSelectorValue list; empty = 1 - 14
+	bool enableMod = false;							///< modes 1 and 2 only
+	bool enableSidechain = false;					///< sidechain detector driven from the input
+	uint32_t numChannels = 2;						///< 1, 2 or a bed: 3, 4, 5, 6, 8, 10 (7.1.2), 12 (7.1.4)
+	bool denormalStress = false;					///< burst + silent tail, with and without the DenormalGuard
+	double burstSeconds = 0.5;						///< --denormal-stress: noise before the tail
+	automationType automation = automationType::kNone;	///< --automation
+	std::string csvPath;							///< optional CSV output
+};
+
+/**
+\struct BenchResult
+\brief one sweep point
+*/
+struct BenchResult
+{
+	double sampleRate = 0.0;
+	uint32_t bufferSize = 0;
+	uint32_t mode = 0;
+	double nsPerSample = 0.0;		///< wall time / frames
+	double realTimeFactor = 0.0;	///< audio duration / wall time
+	double p99Block_us = 0.0;		///< 99th percentile block time
+	double maxBlock_us = 0.0;		///< worst block time
+	double budget_us = 0.0;			///< real-time length of one block
+
+	// --- --denormal-stress only
+	bool denormalGuard = true;		///< DenormalGuard on for this run
+	double tailNsPerSample = 0.0;	///< wall time / frames over the silent tail
+	double tailP99Block_us = 0.0;	///< 99th percentile block time in the tail
+	double tailMaxBlock_us = 0.0;	///< worst block time in the tail
+	uint64_t denormalBlocks = 0;	///< ProcessingStats::denormalBlocks (x86 only)
+
+	// --- --automation only
+	uint32_t granularity = 0;		///< sub-block granularity of this run; 1 = per-sample updates
+};
+
+// --- little-endian readers for the WAV header
+static uint32_t readU32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t readU16(const unsigned char* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+/**
+\brief load a WAV file into two float channels (mono is duplicated)
+
+\return true if the file was read
+*/
+static bool loadWAV(const std::string& path, std::vector<float>& left, std::vector<float>& right)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file)
+		return false;
+
+	std::vector<unsigned char> data;
+	unsigned char chunk[65536];
+	size_t count = 0;
+	while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0)
+		data.insert(data.end(), chunk, chunk + count);
+	fclose(file);
+
+	if (data.size() < 12 || memcmp(&data[0], "RIFF", 4) != 0 || memcmp(&data[8], "WAVE", 4) != 0)
+		return false;
+
+	uint16_t format = 0, channels = 0, bits = 0;
+	const unsigned char* samples = nullptr;
+	size_t sampleBytes = 0;
+
+	// --- walk the chunks
+	size_t pos = 12;
+	while (pos + 8 <= data.size())
+	{
+		uint32_t size = readU32(&data[pos + 4]);
+		const unsigned char* body = &data[pos + 8];
+		size_t available = std::min<size_t>(size, data.size() - pos - 8);
+
+		if (memcmp(&data[pos], "fmt ", 4) == 0 && available >= 16)
+		{
+			format = readU16(body);
+			channels = readU16(body + 2);
+			bits = readU16(body + 14);
+
+			// --- WAVE_FORMAT_EXTENSIBLE: the real format is the first word of the sub-format GUID
+			if (format == 0xFFFE && available >= 26)
+				format = readU16(body + 24);
+		}
+		else if (memcmp(&data[pos], "data", 4) == 0)
+		{
+			samples = body;
+			sampleBytes = available;
+		}
+		pos += 8 + size + (size & 1);
+	}
+
+	bool pcm = format == 1 && (bits == 16 || bits == 24 || bits == 32);
+	bool ieee = format == 3 && bits == 32;
+	if (!samples || channels == 0 || (!pcm && !ieee))
+		return false;
+
+	size_t bytesPerSample = bits / 8;
+	size_t frames = sampleBytes / (bytesPerSample * channels);
+	left.resize(frames);
+	right.resize(frames);
+
+	for (size_t n = 0; n < frames; n++)
+	{
+		float value[2] = { 0.f, 0.f };
+		for (uint32_t ch = 0; ch < 2 && ch < channels; ch++)
+		{
+			const unsigned char* s = samples + (n * channels + ch) * bytesPerSample;
+			if (ieee)
+			{
+				uint32_t u = readU32(s);
+				memcpy(&value[ch], &u, sizeof(float));
+			}
+			else if (bits == 16)
+				value[ch] = (int16_t)readU16(s) / 32768.f;
+			else if (bits == 24)
+				value[ch] = (int32_t)((s[0] << 8) | (s[1] << 16) | ((uint32_t)s[2] << 24)) / 2147483648.f;
+			else
+				value[ch] = (int32_t)readU32(s) / 2147483648.f;
+		}
+		left[n] = value[0];
+		right[n] = channels > 1 ? value[1] : value[0];
+	}
+	return frames > 0;
+}
+
+/** white noise at -12dBFS */
+static void makeNoise(size_t frames, std::vector<float>& left, std::vector<float>& right)
+{
+	std::mt19937 rng(20181007);
+	std::uniform_real_distribution<float> noise(-0.25f, 0.25f);
+	left.resize(frames);
+	right.resize(frames);
+	for (size_t n = 0; n < frames; n++)
+	{
+		left[n] = noise(rng);
+		right[n] = noise(rng);
+	}
+}
+
+/** the ASPiK channel format for a channel count; kCFNone if we do not render it */
+static uint32_t getChannelFormat(uint32_t numChannels)
+{
+	switch (numChannels)
+	{
+		case 1: return kCFMono;
+		case 2: return kCFStereo;
+		case 3: return kCFLCR;
+		case 4: return kCFQuad;
+		case 5: return kCF5p0;
+		case 6: return kCF5p1;
+		case 8: return kCF7p1DTS;
+		case 10: return kCF9p1;		// --- 7.1.2
+		case 12: return kCF11p1;	// --- 7.1.4
+		default: return kCFNone;
+	}
+}
+
+/** set a parameter the way a GUI or host would; it is applied at the next buffer */
+static void setParameter(PluginCore& core, int32_t controlID, double value)
+{
+	ParameterUpdateInfo info;
+	core.updatePluginParameter(controlID, value, info);
+}
+
+/** sorted block times -> {p99, max} in usec */
+static void getBlockPercentiles(std::vector<double>& blockTimes_ns, double& p99_us, double& max_us)
+{
+	if (blockTimes_ns.empty())
+		return;
+	std::sort(blockTimes_ns.begin(), blockTimes_ns.end());
+	size_t p99 = (size_t)(0.99 * (blockTimes_ns.size() - 1));
+	p99_us = blockTimes_ns[p99] * 1.0e-3;
+	max_us = blockTimes_ns.back() * 1.0e-3;
+}
+
+/**
+\brief render the whole input through a fresh PluginCore and time every block
+
+\param tailStart first frame of the silent tail (--denormal-stress); blocks from here on are also timed separately
+\param denormalGuard run the buffer process cycle with or without the DenormalGuard
+\param granularity --automation: the parameter update sub-block granularity; 1 = per-sample, 0 = the plugin's own
+
+\return the result for this sweep point
+*/
+static BenchResult runBench(const BenchOptions& options, const std::vector<float>& inputL, const std::vector<float>& inputR,
+							double sampleRate, uint32_t bufferSize, uint32_t mode, size_t tailStart, bool denormalGuard,
+							uint32_t granularity = 0)
+{
+	BenchPluginCore core;
+	PluginInfo pluginInfo;
+	pluginInfo.pathToDLL = "";
+	core.initialize(pluginInfo);
+	core.enableDenormalGuard(denormalGuard);
+	if (granularity > 0)
+		core.setParamSmoothingGranularity(granularity);
+
+	ResetInfo resetInfo(sampleRate, 32, getChannelFormat(options.numChannels));
+	core.reset(resetInfo);
+
+	// --- a busy, typical setting; the stress test uses short delays so the tail recirculates
+	//     often enough to reach the denormal range in a few seconds
+	setParameter(core, controlID::modeSelectorValue, mode);
+	setParameter(core, controlID::delayTime_short, options.denormalStress ? 10.0 : 150.0);
+	setParameter(core, controlID::delayTime_long, options.denormalStress ? 200.0 : 400.0);
+	setParameter(core, controlID::feedback_Pct, options.denormalStress ? 50.0 : 60.0);
+	setParameter(core, controlID::delayBlend, 0.5);
+	setParameter(core, controlID::enableMod, options.enableMod ? 1.0 : 0.0);
+	setParameter(core, controlID::modDepth_Pct, 50.0);
+	setParameter(core, controlID::modRate_Hz, 2.0);
+	setParameter(core, controlID::enableSidechain, options.enableSidechain ? 1.0 : 0.0);
+
+	// --- host buffers
+	uint32_t numChannels = options.numChannels;
+	std::vector<std::vector<float>> in(numChannels, std::vector<float>(bufferSize));
+	std::vector<std::vector<float>> out(numChannels, std::vector<float>(bufferSize));
+	std::vector<float> aux(bufferSize);
+	std::vector<float*> inputs(numChannels), outputs(numChannels);
+	for (uint32_t c = 0; c < numChannels; c++)
+	{
+		inputs[c] = &in[c][0];
+		outputs[c] = &out[c][0];
+	}
+	float* auxInputs[1] = { &aux[0] };
+	uint32_t channelFormat = getChannelFormat(numChannels);
+
+	NullMidiEventQueue midiEventQueue;
+	HostInfo hostInfo;
+	hostInfo.dBPM = 120.0;
+	hostInfo.fTimeSigNumerator = 4;
+	hostInfo.uTimeSigDenomintor = 4;
+
+	// --- the tapes start short and grow on the FXBufferGrowthService thread: run silent buffers until they fit
+	//     this setting (or a second has passed) so the timed run never has its heads held short
+	for (int warmUp = 0; warmUp < 1000; warmUp++)
+	{
+		ProcessBufferInfo processBufferInfo;
+		processBufferInfo.inputs = &inputs[0];
+		processBufferInfo.outputs = &outputs[0];
+		processBufferInfo.numAudioInChannels = numChannels;
+		processBufferInfo.numAudioOutChannels = numChannels;
+		processBufferInfo.numFramesToProcess = bufferSize;
+		processBufferInfo.channelIOConfig.inputChannelFormat = channelFormat;
+		processBufferInfo.channelIOConfig.outputChannelFormat = channelFormat;
+		processBufferInfo.hostInfo = &hostInfo;
+		processBufferInfo.midiEventQueue = &midiEventQueue;
+		core.processAudioBuffers(processBufferInfo);
+
+		bool stereoReady = core.audioDelay.getBufferLength_mSec() >= core.audioDelay.getRequiredBufferLength_mSec();
+		bool surroundReady = core.surroundDelay.getNumChannels() <= 2 ||
+							 core.surroundDelay.getBufferLength_mSec() >= core.surroundDelay.getRequiredBufferLength_mSec();
+		if (stereoReady && surroundReady)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	hostInfo.uAbsoluteFrameBufferIndex = 0;
+	hostInfo.dAbsoluteFrameBufferTime = 0.0;
+
+	// --- --automation: the continuous delay controls move for the whole run, a slow sweep of the normalized range
+	const int32_t automatedControls[] = { controlID::delayTime_short, controlID::delayTime_long, controlID::feedback_Pct, controlID::delayBlend };
+	const uint32_t numAutomated = sizeof(automatedControls) / sizeof(automatedControls[0]);
+	RampParameterUpdateQueue queues[numAutomated];
+	auto sweep = [&](uint32_t control, size_t frame) {
+		return 0.5 + 0.3 * sin(2.0 * kPi * (0.5 * frame / sampleRate + 0.25 * control));
+	};
+	for (uint32_t i = 0; i < numAutomated && options.automation != automationType::kNone; i++)
+	{
+		PluginParameter* piParam = core.getPluginParameterByControlID(automatedControls[i]);
+		if (options.automation == automationType::kSmoothing)
+			piParam->setParameterSmoothing(true);
+		else
+		{
+			queues[i].parameterIndex = automatedControls[i];
+			queues[i].reportQueuePoints = granularity != 1;
+			piParam->setEnableVSTSampleAccurateAutomation(true);
+			piParam->setParameterUpdateQueue(&queues[i]);
+		}
+	}
+	if (options.automation == automationType::kVST3)
+		core.enableVST3SampleAccurateAutomation(true);
+
+	size_t frames = inputL.size();
+	std::vector<double> blockTimes_ns, tailBlockTimes_ns;
+	blockTimes_ns.reserve(frames / bufferSize + 1);
+	tailBlockTimes_ns.reserve(frames / bufferSize + 1);
+	double total_ns = 0.0;
+	double tail_ns = 0.0;
+	size_t tailFrames = 0;
+
+	for (size_t start = 0; start < frames; start += bufferSize)
+	{
+		uint32_t numFrames = (uint32_t)std::min<size_t>(bufferSize, frames - start);
+		for (uint32_t c = 0; c < numChannels; c++)
+			memcpy(&in[c][0], c % 2 == 0 ? &inputL[start] : &inputR[start], numFrames * sizeof(float));
+		memcpy(&aux[0], &inputL[start], numFrames * sizeof(float));
+
+		for (uint32_t i = 0; i < numAutomated; i++)
+		{
+			if (options.automation == automationType::kSmoothing)
+			{
+				// --- a new target every buffer, as a GUI drag would; the smoother chases it
+				ParameterUpdateInfo info;
+				core.updatePluginParameterNormalized(automatedControls[i], sweep(i, start), info);
+			}
+			else if (options.automation == automationType::kVST3)
+				queues[i].setRamp(sweep(i, start), sweep(i, start + numFrames - 1), numFrames);
+		}
+
+		ProcessBufferInfo processBufferInfo;
+		processBufferInfo.inputs = &inputs[0];
+		processBufferInfo.outputs = &outputs[0];
+		processBufferInfo.auxInputs = auxInputs;
+		processBufferInfo.numAudioInChannels = numChannels;
+		processBufferInfo.numAudioOutChannels = numChannels;
+		processBufferInfo.numAuxAudioInChannels = 1;
+		processBufferInfo.numFramesToProcess = numFrames;
+		processBufferInfo.channelIOConfig.inputChannelFormat = channelFormat;
+		processBufferInfo.channelIOConfig.outputChannelFormat = channelFormat;
+		processBufferInfo.auxChannelIOConfig.inputChannelFormat = kCFMono;
+		processBufferInfo.auxChannelIOConfig.outputChannelFormat = kCFNone;
+		hostInfo.uAbsoluteFrameBufferIndex = start;
+		hostInfo.dAbsoluteFrameBufferTime = start / sampleRate;
+		processBufferInfo.hostInfo = &hostInfo;
+		processBufferInfo.midiEventQueue = &midiEventQueue;
+
+		auto t0 = std::chrono::steady_clock::now();
+		core.processAudioBuffers(processBufferInfo);
+		auto t1 = std::chrono::steady_clock::now();
+
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+		blockTimes_ns.push_back(ns);
+		total_ns += ns;
+		if (start >= tailStart)
+		{
+			tailBlockTimes_ns.push_back(ns);
+			tail_ns += ns;
+			tailFrames += numFrames;
+		}
+	}
+
+	BenchResult result;
+	result.sampleRate = sampleRate;
+	result.bufferSize = bufferSize;
+	result.mode = mode;
+	result.nsPerSample = total_ns / frames;
+	result.realTimeFactor = (frames / sampleRate) / (total_ns * 1.0e-9);
+	result.budget_us = 1.0e6 * bufferSize / sampleRate;
+
+	getBlockPercentiles(blockTimes_ns, result.p99Block_us, result.maxBlock_us);
+
+	result.denormalGuard = denormalGuard;
+	if (tailFrames > 0)
+	{
+		result.tailNsPerSample = tail_ns / tailFrames;
+		getBlockPercentiles(tailBlockTimes_ns, result.tailP99Block_us, result.tailMaxBlock_us);
+	}
+
+	ProcessingStats stats;
+	core.getProcessingStats(stats);
+	result.denormalBlocks = stats.denormalBlocks;
+	result.granularity = granularity;
+
+	return result;
+}
+
+// --- comma separated list parsers
+template <typename T>
+static std::vector<T> parseList(const char* text)
+{
+	std::vector<T> values;
+	std::string list(text);
+	size_t start = 0;
+	while (start < list.size())
+	{
+		size_t end = list.find(',', start);
+		if (end == std::string::npos) end = list.size();
+		values.push_back((T)atof(list.substr(start, end - start).c_str()));
+		start = end + 1;
+	}
+	return values;
+}
+
+/** modes as "1-14" or "1,5,14" */
+static std::vector<uint32_t> parseModes(const char* text)
+{
+	const char* dash = strchr(text, '-');
+	if (!dash)
+		return parseList<uint32_t>(text);
+
+	std::vector<uint32_t> modes;
+	for (uint32_t m = (uint32_t)atoi(text); m <= (uint32_t)atoi(dash + 1); m++)
+		modes.push_back(m);
+	return modes;
+}
+
+/**
+\brief --denormal-stress: burst (the WAV or noise) then options.noiseSeconds of silence, guarded and unguarded
+
+\return the process exit code
+*/
+static int runDenormalStress(const BenchOptions& options, const std::vector<float>& wavL, const std::vector<float>& wavR, FILE* csv)
+{
+	if (csv)
+		fprintf(csv, "sample_rate,buffer,mode,guard,burst_ns_per_sample,tail_ns_per_sample,tail_p99_block_us,tail_max_block_us,denormal_blocks\n");
+
+	printf("%8s %6s %4s %6s %12s %12s %8s %12s %12s %10s\n", "rate", "buffer", "mode", "guard",
+		   "burst ns/s", "tail ns/s", "tail/burst", "tail p99 us", "tail max us", "denormals");
+	for (double sampleRate : options.sampleRates)
+	{
+		// --- the burst, then silence: the song stops and the echoes fade out
+		std::vector<float> inputL, inputR;
+		if (wavL.empty())
+			makeNoise((size_t)(options.burstSeconds * sampleRate), inputL, inputR);
+		else
+		{
+			inputL = wavL;
+			inputR = wavR;
+		}
+		size_t tailStart = inputL.size();
+		inputL.resize(tailStart + (size_t)(options.noiseSeconds * sampleRate), 0.f);
+		inputR.resize(inputL.size(), 0.f);
+
+		for (uint32_t bufferSize : options.bufferSizes)
+		{
+			for (uint32_t mode : options.modes)
+			{
+				for (bool guard : { true, false })
+				{
+					BenchResult r = runBench(options, inputL, inputR, sampleRate, bufferSize, mode, tailStart, guard);
+
+					// --- burst cost from the totals
+					size_t frames = inputL.size();
+					double total_ns = r.nsPerSample * frames;
+					size_t tailFrames = frames - ((tailStart + bufferSize - 1) / bufferSize) * bufferSize;
+					double burst_ns = (total_ns - r.tailNsPerSample * tailFrames) / (frames - tailFrames);
+
+					printf("%8.0f %6u %4u %6s %12.2f %12.2f %8.2fx %12.2f %12.2f %10llu\n", r.sampleRate, r.bufferSize, r.mode,
+						   guard ? "on" : "off", burst_ns, r.tailNsPerSample, r.tailNsPerSample / burst_ns,
+						   r.tailP99Block_us, r.tailMaxBlock_us, (unsigned long long)r.denormalBlocks);
+					if (csv)
+						fprintf(csv, "%.0f,%u,%u,%d,%.3f,%.3f,%.3f,%.3f,%llu\n", r.sampleRate, r.bufferSize, r.mode, guard ? 1 : 0,
+								burst_ns, r.tailNsPerSample, r.tailP99Block_us, r.tailMaxBlock_us, (unsigned long long)r.denormalBlocks);
+				}
+			}
+		}
+	}
+
+	if (csv)
+		fclose(csv);
+	return 0;
+}
+
+/**
+\brief --automation: every sweep point with per-sample parameter updates and with the sub-block path
+
+\return the process exit code
+*/
+static int runAutomation(const BenchOptions& options, const std::vector<float>& wavL, const std::vector<float>& wavR, FILE* csv)
+{
+	const char* automationName = options.automation == automationType::kSmoothing ? "smoothing" : "vst3";
+	if (csv)
+		fprintf(csv, "sample_rate,buffer,mode,automation,per_sample_ns_per_sample,sub_block_ns_per_sample,speedup,sub_block_p99_block_us\n");
+
+	printf("%8s %6s %4s %10s %14s %14s %8s %12s\n", "rate", "buffer", "mode", "automation", "per-sample ns/s",
+		   "sub-block ns/s", "speedup", "p99 us");
+	for (double sampleRate : options.sampleRates)
+	{
+		std::vector<float> noiseL, noiseR;
+		if (wavL.empty())
+			makeNoise((size_t)(options.noiseSeconds * sampleRate), noiseL, noiseR);
+		const std::vector<float>& inputL = wavL.empty() ? noiseL : wavL;
+		const std::vector<float>& inputR = wavL.empty() ? noiseR : wavR;
+
+		for (uint32_t bufferSize : options.bufferSizes)
+		{
+			for (uint32_t mode : options.modes)
+			{
+				BenchResult perSample = runBench(options, inputL, inputR, sampleRate, bufferSize, mode, inputL.size(), true, 1);
+				BenchResult subBlock = runBench(options, inputL, inputR, sampleRate, bufferSize, mode, inputL.size(), true, 0);
+				double speedup = perSample.nsPerSample / subBlock.nsPerSample;
+
+				printf("%8.0f %6u %4u %10s %14.2f %14.2f %7.2fx %12.2f\n", sampleRate, bufferSize, mode, automationName,
+					   perSample.nsPerSample, subBlock.nsPerSample, speedup, subBlock.p99Block_us);
+				if (csv)
+					fprintf(csv, "%.0f,%u,%u,%s,%.3f,%.3f,%.3f,%.3f\n", sampleRate, bufferSize, mode, automationName,
+							perSample.nsPerSample, subBlock.nsPerSample, speedup, subBlock.p99Block_us);
+			}
+		}
+	}
+
+	if (csv)
+		fclose(csv);
+	return 0;
+}
+
+static void printUsage()
+{
+	printf("usage: renderbench [--wav file.wav] [--seconds 10] [--buffers 64,128,256,512,1024]\n"
+		   "                   [--rates 44100,48000,96000] [--modes 1-14] [--mod] [--sidechain]\n"
+		   "                   [--channels 2] [--denormal-stress] [--automation smoothing|vst3]\n"
+		   "                   [--csv results.csv]\n");
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		bool hasValue = i + 1 < argc;
+		if (arg == "--wav" && hasValue) options.wavPath = argv[++i];
+		else if (arg == "--seconds" && hasValue) options.noiseSeconds = atof(argv[++i]);
+		else if (arg == "--buffers" && hasValue) options.bufferSizes = parseList<uint32_t>(argv[++i]);
+		else if (arg == "--rates" && hasValue) options.sampleRates = parseList<double>(argv[++i]);
+		else if (arg == "--modes" && hasValue) options.modes = parseModes(argv[++i]);
+		else if (arg == "--mod") options.enableMod = true;
+		else if (arg == "--sidechain") options.enableSidechain = true;
+		else if (arg == "--channels" && hasValue) options.numChannels = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--denormal-stress") options.denormalStress = true;
+		else if (arg == "--automation" && hasValue && std::string(argv[i + 1]) == "smoothing")
+		{
+			options.automation = automationType::kSmoothing;
+			i++;
+		}
+		else if (arg == "--automation" && hasValue && std::string(argv[i + 1]) == "vst3")
+		{
+			options.automation = automationType::kVST3;
+			i++;
+		}
+		else if (arg == "--csv" && hasValue) options.csvPath = argv[++i];
+		else
+		{
+			printUsage();
+			return arg == "--help" || arg == "-h" ? 0 : 1;
+		}
+	}
+	if (options.modes.empty())
+		options.modes = parseModes("1-14");
+	if (getChannelFormat(options.numChannels) == kCFNone)
+	{
+		fprintf(stderr, "renderbench: --channels must be 1, 2, 3, 4, 5, 6, 8, 10 or 12\n");
+		return 1;
+	}
+
+	// --- the WAV is rendered as-is at every sweep rate; noise is generated per rate for a fixed duration
+	std::vector<float> wavL, wavR;
+	if (!options.wavPath.empty() && !loadWAV(options.wavPath, wavL, wavR))
+	{
+		fprintf(stderr, "renderbench: could not read %s (16/24/32-bit PCM or 32-bit float WAV)\n", options.wavPath.c_str());
+		return 1;
+	}
+
+	FILE* csv = nullptr;
+	if (!options.csvPath.empty())
+	{
+		csv = fopen(options.csvPath.c_str(), "w");
+		if (!csv)
+		{
+			fprintf(stderr, "renderbench: could not write %s\n", options.csvPath.c_str());
+			return 1;
+		}
+	}
+
+	if (options.denormalStress)
+		return runDenormalStress(options, wavL, wavR, csv);
+	if (options.automation != automationType::kNone)
+		return runAutomation(options, wavL, wavR, csv);
+
+	if (csv)
+		fprintf(csv, "sample_rate,buffer,mode,ns_per_sample,realtime_factor,p99_block_us,max_block_us,budget_us\n");
+
+	printf("%8s %6s %4s %12s %10s %12s %12s %10s\n", "rate", "buffer", "mode", "ns/sample", "RT factor", "p99 us", "max us", "p99 %");
+	for (double sampleRate : options.sampleRates)
+	{
+		std::vector<float> noiseL, noiseR;
+		if (wavL.empty())
+			makeNoise((size_t)(options.noiseSeconds * sampleRate), noiseL, noiseR);
+		const std::vector<float>& inputL = wavL.empty() ? noiseL : wavL;
+		const std::vector<float>& inputR = wavL.empty() ? noiseR : wavR;
+
+		for (uint32_t bufferSize : options.bufferSizes)
+		{
+			for (uint32_t mode : options.modes)
+			{
+				BenchResult r = runBench(options, inputL, inputR, sampleRate, bufferSize, mode, inputL.size(), true);
+				printf("%8.0f %6u %4u %12.2f %10.1f %12.2f %12.2f %9.2f%%\n", r.sampleRate, r.bufferSize, r.mode,
+					   r.nsPerSample, r.realTimeFactor, r.p99Block_us, r.maxBlock_us, 100.0 * r.p99Block_us / r.budget_us);
+				if (csv)
+					fprintf(csv, "%.0f,%u,%u,%.3f,%.2f,%.3f,%.3f,%.3f\n", r.sampleRate, r.bufferSize, r.mode,
+							r.nsPerSample, r.realTimeFactor, r.p99Block_us, r.maxBlock_us, r.budget_us);
+			}
+		}
+	}
+
+	if (csv)
+		fclose(csv);
+	return 0;
+}
@@ -0,0 +1,227 @@
+// -----------------------------------------------------------------------------
+//    RETwoOFun sample rate conversion benchmark:  srcbench.cpp
+//
+/**
+    \file   srcbench.cpp
+    \brief  per-sample cost of the Interpolator/Decimator pair (Linux command line)
+
+    		- runs noise up and back down through an Interpolator and a
+    		  Decimator, one sample at a time as an oversampled effect does,
+    		  for each filters.h table length (128/256/512/1024) at 2x and 4x
+    		- times every --block samples and reports the mean ns/sample and
+    		  the 99th percentile and worst block in ns/sample: the direct form
+    		  path costs the same on every sample, the FFT path (FastConvolver)
+    		  spends nothing for FIRLength samples and then a whole FFT/IFFT at once
+    		- the worst block is reported twice, in wall clock time and in thread
+    		  CPU time; a wall clock worst far above the CPU worst is the thread
+    		  being descheduled mid-block (a loaded or shared machine shows
+    		  millisecond stalls on any block size), not the filters, so compare
+    		  the paths on the CPU worst and the p99; the CPU worst still carries
+    		  interrupts and the cache refill after a switch, a few microseconds
+    		  that show most on the small blocks
+    		- the direct form runs on the CPU-dispatched polyphaseFIR kernel;
+    		  build with -DFX_KERNELS_MAX_ISA=0 or 1 to time the scalar or SSE2
+    		  version on an AVX2 machine
+    		- the FFT path needs FFTW (-DHAVE_FFTW ... -lfftw3); without it only
+    		  the direct form tables (up to kMaxPolyphaseFIRLength) are timed
+
+    Build (from the repository root):
+
+    g++ -std=c++14 -O2 -IPluginKernel -IPluginObjects -ICustomControls \
+        Benchmark/srcbench.cpp PluginObjects/fxobjects.cpp -lpthread -o srcbench
+
+    Usage:
+
+    srcbench [--samples 480000] [--block 64] [--rate 48000] [--csv results.csv]
+*/
+// -----------------------------------------------------------------------------
+#include "fxobjects.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+\struct BenchOptions
+\brief command line settings
+*/
+struct BenchOptions
+{
+	uint32_t numSamples = 480000;	///< input samples per run
+	uint32_t blockSize = 64;		///< samples per timed block, e.g. the host buffer
+	unsigned int sampleRate = 48000;	///< picks the filters.h table set
+	std::string csvPath;			///< optional CSV output
+};
+
+/**
+\struct BenchResult
+\brief one path, ratio and FIR length
+*/
+struct BenchResult
+{
+	const char* path = "";
+	unsigned int ratio = 0;
+	unsigned int FIRLength = 0;
+	double meanNsPerSample = 0.0;
+	double p99BlockNsPerSample = 0.0;		///< wall clock
+	double worstBlockNsPerSample = 0.0;		///< wall clock
+	double worstBlockCPUNsPerSample = 0.0;	///< thread CPU time; see threadCPUTime_ns( )
+};
+
+/** CPU time used by this thread; unlike the wall clock it stops while the thread is descheduled */
+static double threadCPUTime_ns()
+{
+	timespec now;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	return now.tv_sec * 1.0e9 + now.tv_nsec;
+}
+
+static bool parseArgs(int argc, char** argv, BenchOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, "missing value for %s\n", arg.c_str());
+			return false;
+		}
+
+		if (arg == "--samples")
+			options.numSamples = (uint32_t)atol(argv[++i]);
+		else if (arg == "--block")
+			options.blockSize = (uint32_t)atol(argv[++i]);
+		else if (arg == "--rate")
+			options.sampleRate = (unsigned int)atol(argv[++i]);
+		else if (arg == "--csv")
+			options.csvPath = argv[++i];
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", arg.c_str());
+			return false;
+		}
+	}
+	return options.numSamples > 0 && options.blockSize > 0 && options.sampleRate > 0;
+}
+
+/** up and back down, timed per block */
+static BenchResult timeRoundTrip(const BenchOptions& options, rateConversionRatio ratio, unsigned int FIRLength,
+								 unsigned int maxDirectFIRLength, const std::vector<double>& noise, double& checksum)
+{
+	Interpolator interpolator;
+	Decimator decimator;
+	interpolator.initialize(FIRLength, ratio, options.sampleRate, true, maxDirectFIRLength);
+	decimator.initialize(FIRLength, ratio, options.sampleRate, true, maxDirectFIRLength);
+
+	BenchResult result;
+	result.path = interpolator.isDirectForm() ? "direct" : "fft";
+	result.ratio = countForRatio(ratio);
+	result.FIRLength = FIRLength;
+
+	uint32_t mask = (uint32_t)noise.size() - 1;
+	double sum = 0.0;
+	double total = 0.0;
+	double worstCPU = 0.0;
+	std::vector<double> blockNsPerSample;
+	blockNsPerSample.reserve(options.numSamples / options.blockSize + 1);
+	for (uint32_t start = 0; start < options.numSamples; start += options.blockSize)
+	{
+		uint32_t length = options.numSamples - start < options.blockSize ? options.numSamples - start : options.blockSize;
+		double blockStartCPU = threadCPUTime_ns();
+		auto blockStart = std::chrono::steady_clock::now();
+		for (uint32_t n = start; n < start + length; n++)
+		{
+			InterpolatorOutput up = interpolator.interpolateAudio(noise[n & mask]);
+
+			DecimatorInput down;
+			down.count = up.count;
+			memcpy(down.audioData, up.audioData, sizeof(up.audioData));
+			sum += decimator.decimateAudio(down);
+		}
+		auto blockStop = std::chrono::steady_clock::now();
+		worstCPU = fmax(worstCPU, (threadCPUTime_ns() - blockStartCPU) / length);
+
+		double ns = std::chrono::duration<double, std::nano>(blockStop - blockStart).count();
+		total += ns;
+		blockNsPerSample.push_back(ns / length);
+	}
+
+	// --- keep the loop alive
+	checksum += sum;
+	result.meanNsPerSample = total / options.numSamples;
+	std::sort(blockNsPerSample.begin(), blockNsPerSample.end());
+	result.p99BlockNsPerSample = blockNsPerSample[(blockNsPerSample.size() - 1) * 99 / 100];
+	result.worstBlockNsPerSample = blockNsPerSample.back();
+	result.worstBlockCPUNsPerSample = worstCPU;
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+	if (!parseArgs(argc, argv, options))
+	{
+		fprintf(stderr, "usage: srcbench [--samples 480000] [--block 64] [--rate 48000] [--csv results.csv]\n");
+		return 1;
+	}
+
+	// --- one table of inputs, so the timing is the filters and nothing else
+	const uint32_t tableLength = 65536;
+	std::vector<double> noise(tableLength);
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	for (uint32_t n = 0; n < tableLength; n++)
+		noise[n] = distribution(generator);
+
+	const unsigned int lengths[] = { 128, 256, 512, 1024 };
+	const rateConversionRatio ratios[] = { rateConversionRatio::k2x, rateConversionRatio::k4x };
+
+	std::vector<BenchResult> results;
+	double checksum = 0.0;
+	for (rateConversionRatio ratio : ratios)
+	{
+		for (unsigned int FIRLength : lengths)
+		{
+			if (FIRLength <= kMaxPolyphaseFIRLength)
+				results.push_back(timeRoundTrip(options, ratio, FIRLength, kMaxPolyphaseFIRLength, noise, checksum));
+#ifdef HAVE_FFTW
+			// --- the same table on the FFT path
+			results.push_back(timeRoundTrip(options, ratio, FIRLength, 0, noise, checksum));
+#endif
+		}
+	}
+
+	const char* isa[] = { "scalar", "sse2", "avx2" };
+	printf("%u samples, blocks of %u, %u Hz, polyphaseFIR kernel %s (checksum %g)\n\n", options.numSamples,
+		   options.blockSize, options.sampleRate, isa[(int)getFXKernels().isa], checksum);
+	printf("%-8s %6s %6s %14s %14s %14s %14s\n", "path", "ratio", "taps", "mean ns/smp", "p99 ns/smp", "worst ns/smp",
+		   "worst cpu ns/smp");
+	for (auto& result : results)
+		printf("%-8s %5ux %6u %14.1f %14.1f %14.1f %14.1f\n", result.path, result.ratio, result.FIRLength, result.meanNsPerSample,
+			   result.p99BlockNsPerSample, result.worstBlockNsPerSample, result.worstBlockCPUNsPerSample);
+
+	if (!options.csvPath.empty())
+	{
+		FILE* csv = fopen(options.csvPath.c_str(), "w");
+		if (!csv)
+		{
+			fprintf(stderr, "cannot write %s\n", options.csvPath.c_str());
+			return 1;
+		}
+
+		fprintf(csv, "path,ratio,fir_length,mean_ns_per_sample,p99_block_ns_per_sample,worst_block_ns_per_sample,"
+				"worst_block_cpu_ns_per_sample\n");
+		for (auto& result : results)
+			fprintf(csv, "%s,%u,%u,%.3f,%.3f,%.3f,%.3f\n", result.path, result.ratio, result.FIRLength, result.meanNsPerSample,
+					result.p99BlockNsPerSample, result.worstBlockNsPerSample, result.worstBlockCPUNsPerSample);
+		fclose(csv);
+	}
+
+	return 0;
+}
@@ -779,17 +779,15 @@ float CMeterDetector::detect(float input)
     // --- store envelope prior to sqrt for RMS version
     setEnvelope(currEnvelope);
 
-    // --- if RMS, do the SQRT
-    if(detectMode == ENVELOPE_DETECT_MODE_RMS)
-        currEnvelope =  (float)pow(currEnvelope, 0.5f);
-
     // --- 16-bit scaling!
     if(logDetector)
     {
         if(currEnvelope <= 0)
             return 0;
 
-        float fdB = 20.f*(float)log10(currEnvelope);
+        // --- fastLog2( ) on the envelope; RMS reads 10*log10(x^2) so it needs no SQRT
+        float fdB = detectMode == ENVELOPE_DETECT_MODE_RMS ? LOG2_TO_DB_POWER * fastLog2(currEnvelope)
+                                                           : LOG2_TO_DB_AMPLITUDE * fastLog2(currEnvelope);
         fdB = (float)fmax(GUI_METER_MIN_DB, fdB);
 
         // --- convert to 0->1 value
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <vector>
 #include <string>
+#include <string.h>
 #include <math.h>
 
 // --- RESERVED PARAMETER ID VALUES
@@ -28,7 +29,9 @@ const unsigned int VECTOR_JOYSTICK = 131074;	///<RESERVED PARAMETER ID VALUE
 const unsigned int PRESET_NAME = 131075;		///<RESERVED PARAMETER ID VALUE
 const unsigned int WRITE_PRESET_FILE = 131076;	///<RESERVED PARAMETER ID VALUE
 const unsigned int SCALE_GUI_SIZE = 131077;		///<RESERVED PARAMETER ID VALUE
-// --- 131078 -through- 131999 are RESERVED		///<RESERVED PARAMETER ID VALUE
+const unsigned int PROCESSING_LOAD_METER = 131078;		///<RESERVED PARAMETER ID VALUE: buffer time / deadline meter
+const unsigned int PROCESSING_PEAK_LOAD_METER = 131079;	///<RESERVED PARAMETER ID VALUE: worst buffer time / deadline meter
+// --- 131080 -through- 131999 are RESERVED		///<RESERVED PARAMETER ID VALUE
 
 // --- custom views may be added using the base here: e.g.
 //     const unsigned int CUSTOM_SPECTRUM_VIEW = CUSTOM_VIEW_BASE + 1;
@@ -203,8 +206,77 @@ const uint32_t ENVELOPE_DETECT_MODE_NONE = 3;	///< not used
 
 const float ENVELOPE_DIGITAL_TC = -4.6051701859880913680359829093687;///< ln(1%)
 const float ENVELOPE_ANALOG_TC = -1.0023934309275667804345424248947; ///< ln(36.7%)
+
+const float FAST_LOG2_MAX_ERROR = 1.2e-4f;	///< fastLog2( ) bound: 0.00072dB on 20*log10, 0.00036dB on 10*log10
+const float LOG2_TO_DB_AMPLITUDE = 6.0205999132796239f;	///< 20*log10(2): 20*log10(x) = LOG2_TO_DB_AMPLITUDE*log2(x)
+const float LOG2_TO_DB_POWER = 3.0102999566398120f;		///< 10*log10(2): 10*log10(x) = LOG2_TO_DB_POWER*log2(x)
 /** @} */
 
+/**
+@fastLog2
+\ingroup ASPiK-GUI
+
+@brief log2(x) for the detectors and meters: the exponent from the float bits plus a 4th order minimax fit
+of log2(m) over the mantissa m = [1, 2). The fit is exact at powers of two and continuous across octaves;
+the absolute error is within FAST_LOG2_MAX_ERROR. Denormals are treated as FLT_MIN.
+
+\param x - the value, > 0
+\return log2(x) within FAST_LOG2_MAX_ERROR
+*/
+inline float fastLog2(float x)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &x, sizeof(bits));
+
+	// --- denormal: no mantissa to fit
+	if ((bits & 0x7F800000) == 0)
+		return -126.f;
+
+	// --- x = 2^exponent * (1 + t), t = [0, 1)
+	int exponent = (int)((bits >> 23) & 0xFF) - 127;
+	bits = (bits & 0x007FFFFF) | 0x3F800000;
+	float t = 0.f;
+	memcpy(&t, &bits, sizeof(t));
+	t -= 1.f;
+
+	return exponent + t * (1.438725708f + t * (-0.677783816f + t * (0.321188698f + t * -0.082130590f)));
+}
+
+/**
+@fastRaw2dB
+\ingroup ASPiK-GUI
+
+@brief 20*log10(x) via fastLog2( ); x <= 0 returns floor_dB
+
+\param x - amplitude value
+\param floor_dB - the value for x <= 0
+\return the value in dB
+*/
+inline double fastRaw2dB(double x, double floor_dB = -96.0)
+{
+	if (x <= 0.0)
+		return floor_dB;
+	return LOG2_TO_DB_AMPLITUDE * fastLog2((float)x);
+}
+
+/**
+@fastPower2dB
+\ingroup ASPiK-GUI
+
+@brief 10*log10(x) via fastLog2( ); this is the dB value of sqrt(x) so an RMS level can be read from a mean square
+envelope without the square root; x <= 0 returns floor_dB
+
+\param x - power (mean square) value
+\param floor_dB - the value for x <= 0
+\return the value in dB
+*/
+inline double fastPower2dB(double x, double floor_dB = -96.0)
+{
+	if (x <= 0.0)
+		return floor_dB;
+	return LOG2_TO_DB_POWER * fastLog2((float)x);
+}
+
 /** @GUITiming
 \ingroup Constants-Enums @{*/
 // ---
@@ -334,6 +406,10 @@ public:
 
 		// --- for linear smoother
 		linInc = (maxVal - minVal) / (smoothingTimeInMSec * 0.001 * sampleRate);
+
+		// --- force recalculation of the multi-step coefficient
+		aSteps = 1.0;
+		numStepsA = 0;
 	}
 
 	/** initialize the smoother; this recalculates internal coefficients
@@ -404,6 +480,58 @@ public:
 		}
 	}
 
+	/**perform numSteps smoothing operations at once, in closed form; used for sub-block smoothing
+	\param in input sample
+	\param out smoothed value after numSteps iterations
+	\param numSteps number of per-sample iterations to advance
+	\return true if smoothing occurred, false otherwise (e.g. once control has assumed final value, smoothing is turned off)
+	*/
+	inline bool smoothParameter(T in, T& out, uint32_t numSteps)
+	{
+		if (numSteps <= 1)
+			return smoothParameter(in, out);
+
+		if (smootherType == smoothingMethod::kLPFSmoother)
+		{
+			// --- z(n+N) = in + (z(n) - in)*a^N; a^N is cached for the last step count
+			if (numSteps != numStepsA)
+			{
+				aSteps = pow(a, (T)numSteps);
+				numStepsA = numSteps;
+			}
+			z = in + (z - in)*aSteps;
+			if (z == z2)
+			{
+				out = in;
+				return false;
+			}
+			z2 = z;
+			out = z2;
+			return true;
+		}
+		else // if (smootherType == smoothingMethod::kLinearSmoother)
+		{
+			if (in == z)
+			{
+				out = in;
+				return false;
+			}
+			T inc = linInc*numSteps;
+			if (in > z)
+			{
+				z += inc;
+				if (z > in) z = in;
+			}
+			else if (in < z)
+			{
+				z -= inc;
+				if (z < in) z = in;
+			}
+			out = z;
+			return true;
+		}
+	}
+
 private:
 	T a = 0.0;		///< a coefficient for smoothing
 	T b = 0.0;		///< b coefficient for smoothing
@@ -412,6 +540,9 @@ private:
 
 	T linInc = 0.0;	///< linear stepping value
 
+	T aSteps = 1.0;				///< a^numStepsA for multi-step smoothing
+	uint32_t numStepsA = 0;		///< step count aSteps was calculated for
+
 	T minVal = 0.0;	///< min extrema
 	T maxVal = 1.0;	///< max exrema
 
@@ -77,6 +77,9 @@ bool PluginBase::reset(ResetInfo& resetInfo)
 			piParam->updateSampleRate(resetInfo.sampleRate);
 	}
 
+	// --- new stream, new deadlines
+	processingStats.requestReset();
+
 	return true;
 }
 
@@ -99,7 +102,8 @@ bool PluginBase::initialize(PluginInfo& _pluginInfo)
 
 Operation:
 - iterate through parameters and copy their values into the bound variables you set up
-- then, call the postUpdatePluginParameter method to do any post-update cooking required to use the variable for processing
+- then, for each bound variable whose value actually changed, call the postUpdatePluginParameter method to do any
+  post-update cooking required to use the variable for processing
 */
 void PluginBase::syncInBoundVariables()
 {
@@ -133,6 +137,9 @@ Operation:
 */
 bool PluginBase::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
 {
+	// --- flush denormals to zero until we return
+	DenormalGuard denormalGuard(denormalGuardEnabled);
+
 	memset(&inputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
 	memset(&outputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
 	memset(&auxInputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
@@ -142,6 +149,8 @@ bool PluginBase::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
 
 	if (pluginDescriptor.processFrames)
 	{
+		beginProcessingStats();
+
 		ProcessFrameInfo info;
 
 		info.audioInputFrame = &inputFrame[0];
@@ -195,6 +204,8 @@ bool PluginBase::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
 			info.hostInfo->dAbsoluteFrameBufferTime += sampleInterval;
 		}
 
+		endProcessingStats(processBufferInfo.numFramesToProcess);
+
 		// --- generally not used
 		postProcessAudioBuffers(processBufferInfo);
 
@@ -208,6 +219,7 @@ bool PluginBase::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
 \brief copy newly updated metering variables into GUI parameters for display
 
 Operation:
+- copy the processing statistics load values into their meter variables
 - simple loop to update meter variables
 - to display custom data (waveforms, histograms, etc...) see Custom Views example in ASPiK SDK
 
@@ -217,6 +229,10 @@ bool PluginBase::updateOutBoundVariables()
 {
 	bool updated = false;
 
+	// --- publish the DSP load for any meters bound to it
+	processingLoadMeter = (float)processingStats.getLastLoad();
+	processingPeakLoadMeter = (float)processingStats.getMaxLoad();
+
 	// --- rip through and synch em
 	for (unsigned int i = 0; i < numOutboundPluginParameters; i++)
 	{
@@ -241,7 +257,8 @@ NOTE:
 - but in either case, the list MUST be iterated; this function is the reason for the old-fashioned C-array of pointers\n
   as it was found to be faster than any other list method for entire-list iteration (if you have a faster way, let me knmow!)
 - the parameter is updated with the smoothed value
-- the post-parameter update function is then called (complex cooking functions here will eat the CPU as well)
+- the post-parameter update function is then called when the bound variable actually changed (complex cooking
+  functions here will eat the CPU as well)
 */
 void PluginBase::doSampleAccurateParameterUpdates()
 {
@@ -275,12 +292,12 @@ void PluginBase::doSampleAccurateParameterUpdates()
 						piParam->setControlValueNormalized(value, false, true); // false = do not apply taper, true = ignore smoothing (not needed here)
 						vstSAAutomated = true;
 
-						// --- now update the bound variable
+						// --- now update the bound variable; post-update only when it actually changed
 						if (piParam->updateInBoundVariable())
 						{
 							vst3Update.boundVariableUpdate = true;
+							postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), vst3Update);
 						}
-						postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), vst3Update);
 					}
 				}
 			}
@@ -288,11 +305,122 @@ void PluginBase::doSampleAccurateParameterUpdates()
 			// --- do smoothing, but not if we did a sample accurate automation update!
 			if (!vstSAAutomated && piParam->smoothParameterValue())
 			{
-				// --- update bound variable, if there is one
+				// --- update bound variable, if there is one; post-update only when it actually changed
 				if (piParam->updateInBoundVariable())
 				{
 					paramSmoothUpdate.boundVariableUpdate = true;
+					postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), paramSmoothUpdate);
+				}
+			}
+		}
+	}
+}
+
+/**
+\brief finds the length of the next sub-block for buffer-based parameter updates
+
+NOTE:
+- if nothing is smoothing and there is no sample accurate automation, the whole remainder of the buffer is returned
+- otherwise the sub-block is limited to the parameter smoothing granularity (see pluginDescriptor.paramSmoothingGranularity)
+- VST3 sample accurate parameters further limit the sub-block so that it never crosses a queue point; between queue
+  points the host ramps the value linearly, so the sub-block update below is exact for them. This needs the shell's
+  queue to implement IParameterUpdateQueue::getSamplesToNextQueuePoint( ); none in this tree does yet, and the
+  default of one sample keeps them on per-sample updates
+- this plugin ships with smoothing off and kVSTSAA false, so as it stands every buffer is a single sub-block; the
+  sub-block path only runs once a parameter has smoothing turned on (measure it with renderbench --automation)
+
+\param sampleOffset the sub-block start, in samples from the top of the buffer
+\param maxSamples samples remaining in the buffer
+
+\return the sub-block length in samples (always >= 1 when maxSamples >= 1)
+*/
+uint32_t PluginBase::getParameterUpdateSubBlockLength(uint32_t sampleOffset, uint32_t maxSamples)
+{
+	if (numSmoothablePluginParameters == 0 || maxSamples <= 1)
+		return maxSamples;
+
+	uint32_t subBlockLength = maxSamples;
+	bool updating = false;
+	bool vst3SAA = wantsVST3SampleAccurateAutomation();
+
+	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+	{
+		PluginParameter* piParam = smoothablePluginParameters[i];
+		if (!piParam)
+			continue;
+
+		if (vst3SAA && piParam->getParameterUpdateQueue() && piParam->getEnableVSTSampleAccurateAutomation())
+		{
+			uint32_t toQueuePoint = piParam->getParameterUpdateQueue()->getSamplesToNextQueuePoint(sampleOffset, subBlockLength);
+			subBlockLength = toQueuePoint < 1 ? 1 : toQueuePoint;
+			updating = true;
+		}
+		else if (piParam->isSmoothingActive())
+			updating = true;
+	}
+
+	// --- nothing moving: one sub-block for the rest of the buffer
+	if (!updating)
+		return maxSamples;
+
+	uint32_t granularity = getParamSmoothingGranularity();
+	if (granularity < 1) granularity = 1;
+	return subBlockLength < granularity ? subBlockLength : granularity;
+}
+
+/**
+\brief sub-block version of doSampleAccurateParameterUpdates( ) for buffer processing
+
+NOTE:
+- the parameters are advanced to their values at the END of the sub-block (sampleOffset + numSamples - 1)
+- smoothers are advanced numSamples steps in closed form (see ParamSmoother::smoothParameter( ))
+- VST3 sample accurate values are read with getValueAtOffset( ) so the host queue's internal counter is not used
+- postUpdatePluginParameter( ) is called once per parameter whose bound variable changed, flagged as a smoothing or sample accurate update
+  so that the derived class can ramp its cooked values linearly across the sub-block
+
+\param sampleOffset the sub-block start, in samples from the top of the buffer
+\param numSamples the sub-block length, from getParameterUpdateSubBlockLength( )
+*/
+void PluginBase::doSampleAccurateParameterUpdates(uint32_t sampleOffset, uint32_t numSamples)
+{
+	if (numSmoothablePluginParameters == 0 || numSamples == 0)
+		return;
+
+	double value = 0;
+	ParameterUpdateInfo vst3Update(false, true); /// false = this is NOT called from smoothing operation, true: this is a VST sample accurate update
+	vst3Update.isVSTSampleAccurateUpdate = true;
+
+	ParameterUpdateInfo paramSmoothUpdate(true, false); /// true = this is called from smoothing operation, false = NOT VST sample accurate update
+	paramSmoothUpdate.isSmoothing = true;
+
+	bool vst3SAA = wantsVST3SampleAccurateAutomation();
+	uint32_t lastSample = sampleOffset + numSamples - 1;
+
+	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+	{
+		PluginParameter* piParam = smoothablePluginParameters[i];
+		if (!piParam)
+			continue;
+
+		if (vst3SAA && piParam->getParameterUpdateQueue() && piParam->getEnableVSTSampleAccurateAutomation())
+		{
+			if (piParam->getParameterUpdateQueue()->getValueAtOffset(lastSample, piParam->getControlValueNormalized(), value))
+			{
+				piParam->setControlValueNormalized(value, false, true); // false = do not apply taper, true = ignore smoothing (not needed here)
+				if (piParam->updateInBoundVariable())
+				{
+					vst3Update.boundVariableUpdate = true;
+					postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), vst3Update);
 				}
+			}
+			continue;
+		}
+
+		if (piParam->smoothParameterValue(numSamples))
+		{
+			if (piParam->updateInBoundVariable())
+			{
+				paramSmoothUpdate.boundVariableUpdate = true;
 				postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), paramSmoothUpdate);
 			}
 		}
@@ -271,6 +271,31 @@ public:
 	/** perform parameter smoothing or VST3 sample accurate upates */
 	void doSampleAccurateParameterUpdates();
 
+	/** perform parameter smoothing or VST3 sample accurate upates for a sub-block of a buffer */
+	void doSampleAccurateParameterUpdates(uint32_t sampleOffset, uint32_t numSamples);
+
+	/** find the length of the next parameter-update sub-block in a buffer */
+	uint32_t getParameterUpdateSubBlockLength(uint32_t sampleOffset, uint32_t maxSamples);
+
+	/** processing statistics: call at the top of the buffer process cycle (audio thread) */
+	void beginProcessingStats() { processingStats.beginBlock(); }
+
+	/** processing statistics: call once the buffer is rendered, before postProcessAudioBuffers( ) (audio thread) */
+	void endProcessingStats(uint32_t numFrames) { processingStats.endBlock(numFrames, audioProcDescriptor.sampleRate); }
+
+	/** processing statistics: lock-free snapshot, safe to call from any thread */
+	void getProcessingStats(ProcessingStats& stats) { processingStats.getStats(stats); }
+
+	/** processing statistics: clear at the next buffer, safe to call from any thread */
+	void resetProcessingStats() { processingStats.requestReset(); }
+
+	/** flush-to-zero for the buffer process cycle (see DenormalGuard); on by default, switch off only to measure
+	    denormal costs; not from the audio thread */
+	void enableDenormalGuard(bool enable) { denormalGuardEnabled = enable; }
+
+	/** true if the buffer process cycle runs with flush-to-zero */
+	bool getDenormalGuardEnabled() { return denormalGuardEnabled; }
+
 	/** only for a vector joystick control from DAW that implements it (reserved for future use): base class implementation is empty */
 	virtual bool setVectorJoystickParameters(const VectorJoystickData& vectorJoysickData) { return true; }
 
@@ -452,11 +477,23 @@ public:
 	double getLatencyInSamples() { return pluginDescriptor.latencyInSamples; }
 
 	/**
-	\brief Description query: tail time
+	\brief Description query: tail time; the live value if the core publishes one with setTailTimeInMSec( ), else the
+	static kTailTimeMsec description (safe to call from any thread)
 
 	\return tail time in milliseconds (as double)
 	*/
-	double getTailTimeInMSec() { return pluginDescriptor.tailTimeInMSec; }
+	double getTailTimeInMSec()
+	{
+		double tailTime = dynamicTailTimeInMSec.load(std::memory_order_relaxed);
+		return tailTime >= 0.0 ? tailTime : pluginDescriptor.tailTimeInMSec;
+	}
+
+	/**
+	\brief publish the current tail time (e.g. from the cooked feedback and delay times) for getTailTimeInMSec( )
+
+	\param tailTimeInMSec tail time in milliseconds
+	*/
+	void setTailTimeInMSec(double tailTimeInMSec) { dynamicTailTimeInMSec.store(tailTimeInMSec, std::memory_order_relaxed); }
 
 	/**
 	\brief Description query: infinite tail (VST3 only)
@@ -465,6 +502,13 @@ public:
 	*/
 	bool wantsInfiniteTailVST3() { return pluginDescriptor.infiniteTailVST3; }
 
+	/**
+	\brief Description query: parameter smoothing granularity for buffer processing
+
+	\return the longest sub-block, in samples, over which smoothed parameters are treated as linear ramps
+	*/
+	uint32_t getParamSmoothingGranularity() { return pluginDescriptor.paramSmoothingGranularity; }
+
 	/**
 	\brief Description query: name
 
@@ -590,6 +634,13 @@ protected:
 	AudioProcDescriptor audioProcDescriptor;	///< current audio processing description
 	PluginInfo pluginInfo;						///< info about the DLL (component) itself, includes path to DLL
 
+	// --- per-instance CPU/latency statistics; the load values are published to the outbound meter variables below
+	ProcessingStatsMonitor processingStats;		///< written by the audio thread, read from any thread
+	bool denormalGuardEnabled = true;			///< DenormalGuard on the buffer process cycle
+	std::atomic<double> dynamicTailTimeInMSec{ -1.0 };	///< see setTailTimeInMSec( ); < 0 = not published
+	float processingLoadMeter = 0.f;			///< last buffer time / deadline; bind a meter to PROCESSING_LOAD_METER
+	float processingPeakLoadMeter = 0.f;		///< worst buffer time / deadline; bind a meter to PROCESSING_PEAK_LOAD_METER
+
     // --- arrays for frame processing
     float inputFrame[MAX_CHANNEL_COUNT];		///< input array for frame processing
     float outputFrame[MAX_CHANNEL_COUNT];		///< output array for frame processing
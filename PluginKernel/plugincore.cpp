@@ -34,6 +34,16 @@ PluginCore::PluginCore()
 		addSupportedIOCombination({ kCFMono, kCFMono });
 		addSupportedIOCombination({ kCFMono, kCFStereo });
 		addSupportedIOCombination({ kCFStereo, kCFStereo });
+
+		// --- surround and immersive beds, same format in and out; these run on surroundDelay
+		addSupportedIOCombination({ kCFLCR, kCFLCR });
+		addSupportedIOCombination({ kCFQuad, kCFQuad });
+		addSupportedIOCombination({ kCF5p0, kCF5p0 });
+		addSupportedIOCombination({ kCF5p1, kCF5p1 });
+		addSupportedIOCombination({ kCF7p1Sony, kCF7p1Sony });
+		addSupportedIOCombination({ kCF7p1DTS, kCF7p1DTS });
+		addSupportedIOCombination({ kCF9p1, kCF9p1 });		// --- 7.1.2
+		addSupportedIOCombination({ kCF11p1, kCF11p1 });	// --- 7.1.4
 	}
 	else // --- synth plugins have no input, only output
 	{
@@ -204,6 +214,15 @@ bool PluginCore::initPluginParameters()
     PluginParameter* piParamBonus = new PluginParameter(SCALE_GUI_SIZE, "Scale GUI", "tiny,small,medium,normal,large,giant", "normal");
     addPluginParameter(piParamBonus);
 
+	// --- DSP load meters (buffer time / deadline) fed by the base class processing statistics
+	piParam = new PluginParameter(PROCESSING_LOAD_METER, "DSP Load", 10.00, 500.00, ENVELOPE_DETECT_MODE_PEAK, meterCal::kLinearMeter);
+	piParam->setBoundVariable(&processingLoadMeter, boundVariableType::kFloat);
+	addPluginParameter(piParam);
+
+	piParam = new PluginParameter(PROCESSING_PEAK_LOAD_METER, "DSP Peak Load", 10.00, 500.00, ENVELOPE_DETECT_MODE_PEAK, meterCal::kLinearMeter);
+	piParam->setBoundVariable(&processingPeakLoadMeter, boundVariableType::kFloat);
+	addPluginParameter(piParam);
+
 	// --- create the super fast access array
 	initPluginParameterArray();
 
@@ -227,11 +246,27 @@ bool PluginCore::reset(ResetInfo& resetInfo)
     audioProcDescriptor.sampleRate = resetInfo.sampleRate;
     audioProcDescriptor.bitDepth = resetInfo.bitDepth;
 
-	audioDelay[0].reset(resetInfo.sampleRate);
-	audioDelay[1].reset(resetInfo.sampleRate);
-
-	audioDelay[0].createDelayBuffers(resetInfo.sampleRate, 12000.0);
-	audioDelay[1].createDelayBuffers(resetInfo.sampleRate, 12000.0);
+	// --- the surround engine only exists for a bed layout: from the shell, or else the last bed a buffer arrived in
+	uint32_t bedChannels = pluginDescriptor.getChannelCountForChannelIOConfig(resetInfo.outputChannelFormat);
+	if (resetInfo.outputChannelFormat == kCFNone)
+		bedChannels = pendingBedChannels.load();
+	bool advertisedBed = false;
+	for (uint32_t i = 0; i < getNumSupportedIOCombinations(); i++)
+		advertisedBed |= getInputChannelCount(i) == bedChannels && getOutputChannelCount(i) == bedChannels;
+	if (bedChannels > 2 && advertisedBed && bedChannels != surroundDelay.getNumChannels())
+		setupSurroundDelay(bedChannels);
+
+	// --- the tapes were sized in initialize( )/setupSurroundDelay( ): a new rate re-slices them, the same rate zeroes
+	//     what the last run wrote; neither allocates unless the rate is above kMaxSampleRate (and then the heap takes
+	//     what the arena cannot)
+	FXArenaScope arenaScope(fxArena);
+	audioDelay.reset(resetInfo.sampleRate);
+	if (surroundDelay.getNumChannels() > 2)
+		surroundDelay.reset(resetInfo.sampleRate);
+
+	// --- force a cook on the next buffer; that also publishes the tail time
+	parametersDirty = true;
+	silenceTracker.reset(resetInfo.sampleRate);
 
     // --- other reset inits
     return PluginBase::reset(resetInfo);
@@ -246,10 +281,60 @@ Operation:
 bool PluginCore::initialize(PluginInfo& pluginInfo)
 {
 	// --- add one-time init stuff here
+	//
+	// --- detect the CPU and bind the FX DSP kernels now, rather than on the first audio buffer
+	getFXKernels();
+
+	// --- the tape starts as long as the current settings need and grows on demand (off the audio thread), up to
+	//     kTapeLength_mSec; cook the bound variables first so the heads are known. The surround engine waits for
+	//     a bed layout; see setupSurroundDelay( )
+	updateParameters();
+	double tapeLength_mSec = audioDelay.getRequiredBufferLength_mSec();
+	audioDelay.enableBufferGrowth(kTapeLength_mSec);
+
+	// --- one block for the first tape, freed in one call; huge pages only pay off when the tape fills one,
+	//     and a second initialize( ) keeps the block the tape lives in
+	if (fxArena.getCapacity() == 0)
+	{
+		size_t arenaBytes = audioDelay.getReserveBytes(kMaxSampleRate, tapeLength_mSec);
+		fxArena.reserve(arenaBytes, arenaBytes >= kFXArenaHugePageSize);
+	}
+	FXArenaScope arenaScope(fxArena);
+
+	// --- allocate the first tape for the highest rate we expect; reset( ) then only re-slices it
+	audioDelay.reserveDelayBuffers(kMaxSampleRate, tapeLength_mSec);
 
 	return true;
 }
 
+/**
+\brief set the surround engine up for a bed layout; called from reset( ), never on the audio thread
+
+Operation:
+- one tape line per bed channel, each channel's heads offset by kSurroundTapOffsetStep_mSec to decorrelate the bed
+- the tape starts as long as the current settings need, reserved for kMaxSampleRate, and grows on demand up to
+  kSurroundTapeLength_mSec; mono and stereo sessions never get here, so they carry no bed tape
+
+\param bedChannels channel count of the bed (3 to 12)
+*/
+void PluginCore::setupSurroundDelay(uint32_t bedChannels)
+{
+	// --- nothing from the growth thread may land on the old layout
+	surroundDelay.disableBufferGrowth();
+	surroundDelay.setNumChannels(bedChannels);
+	for (uint32_t c = 0; c < bedChannels; c++)
+		surroundDelay.setChannelTapOffset(c, c * kSurroundTapOffsetStep_mSec);
+
+	// --- cook the current settings so the heads are known; the next buffer re-cooks both engines anyway
+	surroundDelay.setParameters(audioDelay.getParameters());
+	double surroundTapeLength_mSec = fmin(surroundDelay.getRequiredBufferLength_mSec(), kSurroundTapeLength_mSec);
+	surroundDelay.enableBufferGrowth(kSurroundTapeLength_mSec);
+
+	// --- the arena was sized for the stereo tape; the heap takes the bed
+	surroundDelay.reserveDelayBuffers(kMaxSampleRate, surroundTapeLength_mSec);
+	pendingBedChannels = 0;
+}
+
 /**
 \brief do anything needed prior to arrival of audio buffers
 
@@ -290,37 +375,200 @@ bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
     // --- fire any MIDI events for this sample interval
     processFrameInfo.midiEventQueue->fireMidiEvents(processFrameInfo.currentFrame);
 
+	// --- pick up a tape the growth thread has lengthened, once per host buffer
+	if (processFrameInfo.currentFrame == 0)
+	{
+		audioDelay.swapInGrownBuffers();
+		if (surroundDelay.getNumChannels() > 2)
+			surroundDelay.swapInGrownBuffers();
+	}
+
 	// --- do per-frame updates; VST automation and parameter smoothing
 	doSampleAccurateParameterUpdates();
 
-    // --- decode the channelIOConfiguration and process accordingly
-	updateParameters();
+    // --- re-cook only if a parameter changed
+	if (parametersDirty)
+		updateParameters();
 	
 
-	double xnL = processFrameInfo.audioInputFrame[0];
-	double xnR = processFrameInfo.numAudioInChannels > 1 ? processFrameInfo.audioInputFrame[1] : xnL;
+	// --- the sidechain (aux) frame, mixed to mono, drives the ducking
+	double sidechain = 0.0;
+	bool hasSidechain = processFrameInfo.numAuxAudioInChannels > 0 && processFrameInfo.auxAudioInputFrame;
+	if (hasSidechain)
+	{
+		for (uint32_t i = 0; i < processFrameInfo.numAuxAudioInChannels; i++)
+			sidechain += processFrameInfo.auxAudioInputFrame[i];
+		sidechain /= processFrameInfo.numAuxAudioInChannels;
+	}
+
+	// --- FX Plugin: surround beds run on the multichannel delay
+	uint32_t bedChannels = pluginDescriptor.getChannelCountForChannelIOConfig(processFrameInfo.channelIOConfig.outputChannelFormat);
+	if (bedChannels > 2 && bedChannels == surroundDelay.getNumChannels())
+	{
+		if (hasSidechain)
+			surroundDelay.processAuxInputAudioSample(sidechain);
+		return surroundDelay.processAudioFrame(processFrameInfo.audioInputFrame, processFrameInfo.audioOutputFrame,
+											   processFrameInfo.numAudioInChannels, bedChannels);
+	}
 
-	double ynL = audioDelay[0].processAudioSample(xnL);
-	double ynR = audioDelay[1].processAudioSample(xnR);
+	// --- not set up for this bed yet: the front pair runs stereo until the next reset( ); see processAudioBuffers( )
+	if (bedChannels > 2)
+		pendingBedChannels = bedChannels;
 
-	// --- FX Plugin:
-	if (processFrameInfo.channelIOConfig.outputChannelFormat == kCFMono)
+	// --- one stereo-linked delay; mono out runs the left side only
+	if (hasSidechain)
+		audioDelay.processAuxInputAudioSample(sidechain);
+	uint32_t outputChannels = processFrameInfo.channelIOConfig.outputChannelFormat == kCFMono ? 1 : 2;
+	return audioDelay.processAudioFrame(processFrameInfo.audioInputFrame, processFrameInfo.audioOutputFrame,
+										processFrameInfo.numAudioInChannels, outputChannels);
+}
+
+/**
+\brief buffer-processing method
+
+Operation:
+- sync the bound variables, then process the buffer in sub-blocks (getParameterUpdateSubBlockLength( )): at the
+  top of each one doSampleAccurateParameterUpdates( ) advances the smoothed and VST3 sample accurate parameters to
+  the end of the sub-block and updateParameters( ) cooks them, and the delays ramp their cooked values linearly
+  across it; with nothing moving the whole buffer is one sub-block, cooked once
+- run the delay over the channel buffers with processAudioBlock( ) rather than de-interleaving the buffer
+  into frames: the stereo-linked FourTapDelay for mono and stereo, the MultichannelFourTapDelay for
+  surround beds; processAudioFrame( ) is kept for frame-based shells
+- the aux (sidechain) buffers, when the host connects them, are passed along for the delays' ducking detector
+- the tapes grow on demand: a longer tape built by FXBufferGrowthService is swapped in at the top of the buffer
+- the whole cycle runs under a DenormalGuard (flush-to-zero) unless enableDenormalGuard(false) was called
+- once the input has been silent for longer than the tail time the delays are skipped and the outputs are
+  written as silence; the first non-silent input sample re-arms them for that buffer (see TailSilenceTracker)
+- this plugin ships with parameter smoothing off and VST3 sample accurate automation off, so as it stands every
+  buffer is a single sub-block; with sample accurate automation on, the sub-blocks are one sample long until the
+  shell's queue implements IParameterUpdateQueue::getSamplesToNextQueuePoint( ), which defaults to 1
+
+\param processBufferInfo structure of information about *buffer* processing
+
+\return true if operation succeeds, false otherwise
+*/
+bool PluginCore::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
+{
+	// --- flush denormals to zero until we return: the echo tails decay to a true zero after the input stops
+	DenormalGuard denormalGuard(denormalGuardEnabled);
+
+	// --- time the whole cycle, parameter updates included
+	beginProcessingStats();
+
+	// --- sync internal bound variables
+	preProcessAudioBuffers(processBufferInfo);
+
+	// --- pick up a tape the growth thread has lengthened since the last buffer (no allocation here)
+	audioDelay.swapInGrownBuffers();
+	if (surroundDelay.getNumChannels() > 2)
+		surroundDelay.swapInGrownBuffers();
+
+	const uint32_t numFrames = processBufferInfo.numFramesToProcess;
+
+	// --- fire any MIDI events for this buffer; the core does not render MIDI so sample offsets are not needed
+	if (processBufferInfo.midiEventQueue && processBufferInfo.midiEventQueue->getEventCount() > 0)
 	{
-		// --- left
-		processFrameInfo.audioOutputFrame[0] = ynL;
-		return true; /// processed
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+			processBufferInfo.midiEventQueue->fireMidiEvents(frame);
 	}
-	else {
-		processFrameInfo.audioOutputFrame[0] = ynL;
-		processFrameInfo.audioOutputFrame[1] = ynR;
-		return true;
+
+	// --- process in sub-blocks: VST automation and parameter smoothing are applied at the top of each one,
+	//     and the delays ramp their cooked values linearly across it; with nothing moving this is one
+	//     sub-block for the whole buffer (see getParamSmoothingGranularity())
+	bool processAudio = processBufferInfo.numAudioInChannels > 0 && processBufferInfo.numAudioOutChannels > 0;
+	uint32_t bedChannels = pluginDescriptor.getChannelCountForChannelIOConfig(processBufferInfo.channelIOConfig.outputChannelFormat);
+	bool processBed = processAudio && bedChannels > 2 && bedChannels == surroundDelay.getNumChannels() &&
+					  processBufferInfo.numAudioInChannels >= bedChannels && processBufferInfo.numAudioOutChannels >= bedChannels;
+
+	// --- a bed the engine is not set up for (the shell did not say at reset): the front pair runs on the stereo
+	//     engine and the rest is silenced until the next reset( ) sets the surround engine up; nothing is allocated here
+	if (processAudio && bedChannels > 2 && bedChannels != surroundDelay.getNumChannels())
+		pendingBedChannels = bedChannels;
+	const float* bedInputs[MAX_CHANNEL_COUNT];
+	float* bedOutputs[MAX_CHANNEL_COUNT];
+	const float* sidechainInputs[MAX_CHANNEL_COUNT];
+	uint32_t numSidechainChannels = processBufferInfo.auxInputs ? processBufferInfo.numAuxAudioInChannels : 0;
+	if (numSidechainChannels > MAX_CHANNEL_COUNT)
+		numSidechainChannels = MAX_CHANNEL_COUNT;
+
+	// --- input and tail both silent: skip the delays (parameters are still cooked)
+	uint32_t numRenderedInputs = processBed ? bedChannels : (processBufferInfo.numAudioInChannels > 1 ? 2 : 1);
+	bool silent = processAudio && silenceTracker.isBlockSilent(processBufferInfo.inputs, numRenderedInputs, numFrames);
+	if (silent)
+		processAudio = processBed = false;
+
+	uint32_t subBlockStart = 0;
+	while (subBlockStart < numFrames)
+	{
+		uint32_t subBlockLength = getParameterUpdateSubBlockLength(subBlockStart, numFrames - subBlockStart);
+		doSampleAccurateParameterUpdates(subBlockStart, subBlockLength);
+		if (parametersDirty)
+			updateParameters();
+
+		for (uint32_t c = 0; c < numSidechainChannels; c++)
+			sidechainInputs[c] = processBufferInfo.auxInputs[c] + subBlockStart;
+
+		if (processBed)
+		{
+			for (uint32_t c = 0; c < bedChannels; c++)
+			{
+				bedInputs[c] = processBufferInfo.inputs[c] + subBlockStart;
+				bedOutputs[c] = processBufferInfo.outputs[c] + subBlockStart;
+			}
+			surroundDelay.processAudioBlock(bedInputs, bedOutputs, subBlockLength, sidechainInputs, numSidechainChannels);
+		}
+		else if (processAudio)
+		{
+			float* inputL = processBufferInfo.inputs[0] + subBlockStart;
+			float* inputR = processBufferInfo.numAudioInChannels > 1 ? processBufferInfo.inputs[1] + subBlockStart : inputL;
+
+			if (processBufferInfo.channelIOConfig.outputChannelFormat == kCFMono)
+			{
+				audioDelay.processAudioBlock(inputL, processBufferInfo.outputs[0] + subBlockStart, subBlockLength,
+											 sidechainInputs, numSidechainChannels);
+			}
+			else
+			{
+				// --- stereo-linked; safe if the host aliases outputs onto the (shared) input
+				audioDelay.processAudioBlock(inputL, inputR, processBufferInfo.outputs[0] + subBlockStart,
+											 processBufferInfo.outputs[1] + subBlockStart, subBlockLength,
+											 sidechainInputs, numSidechainChannels);
+			}
+		}
+
+		subBlockStart += subBlockLength;
 	}
 
-    return false; /// NOT processed
+	// --- silence anything we do not render
+	uint32_t firstUnusedOutput = processBufferInfo.channelIOConfig.outputChannelFormat == kCFMono ? 1 : 2;
+	if (processBed)
+		firstUnusedOutput = bedChannels;
+	if (processBufferInfo.numAudioInChannels == 0 || silent)
+		firstUnusedOutput = 0;
+	for (uint32_t i = firstUnusedOutput; i < processBufferInfo.numAudioOutChannels; i++)
+		memset(processBufferInfo.outputs[i], 0, numFrames * sizeof(float));
+	for (uint32_t i = 0; i < processBufferInfo.numAuxAudioOutChannels; i++)
+		memset(processBufferInfo.auxOutputs[i], 0, numFrames * sizeof(float));
+
+	// --- update per-buffer
+	processBufferInfo.hostInfo->uAbsoluteFrameBufferIndex += numFrames;
+	processBufferInfo.hostInfo->dAbsoluteFrameBufferTime += numFrames / audioProcDescriptor.sampleRate;
+
+	// --- before postProcessAudioBuffers() so the load meters show this buffer
+	endProcessingStats(numFrames);
+
+	// --- generally not used
+	postProcessAudioBuffers(processBufferInfo);
+
+	return true; /// processed
 }
 
 void PluginCore::updateParameters() {
-	FourTapDelayParameters params = audioDelay[0].getParameters();
+	// --- take the flags before reading the bound variables, so a change posted while cooking is not lost
+	parametersDirty = false;
+	bool ramp = rampParameters.exchange(false);
+
+	FourTapDelayParameters params = audioDelay.getParameters();
 	params.blend = delayBlend;
 	params.feedback_Pct = feedback_Pct;
 	params.delayTime_long = delayTime_long;
@@ -332,8 +580,16 @@ void PluginCore::updateParameters() {
 	params.enableMod = (enableMod == 1);
 	params.enableSidechain = (enableSidechain == 1);
 
-	audioDelay[0].setParameters(params);
-	audioDelay[1].setParameters(params);
+	audioDelay.setParameters(params, ramp);
+	if (surroundDelay.getNumChannels() > 2)
+		surroundDelay.setParameters(params, ramp);
+
+	// --- the tail follows the feedback and the head times; the surround delay's offset heads can run longer
+	double tailTime_mSec = audioDelay.getTailTime_mSec();
+	if (surroundDelay.getNumChannels() > 2)
+		tailTime_mSec = fmax(tailTime_mSec, surroundDelay.getTailTime_mSec());
+	silenceTracker.setTailTime(tailTime_mSec);
+	setTailTimeInMSec(tailTime_mSec);
 }
 
 
@@ -422,18 +678,33 @@ bool PluginCore::postUpdatePluginParameter(int32_t controlID, double controlValu
     // --- now do any post update cooking; be careful with VST Sample Accurate automation
     //     If enabled, then make sure the cooking functions are short and efficient otherwise disable it
     //     for the Parameter involved
-    /*switch(controlID)
+	//
+	// --- bound variable updates only arrive here when the value actually changed; mark the
+	//     delays for re-cooking, which happens once on the next processing interval
+    switch(controlID)
     {
-        case 0:
-        {
-            return true;    /// handled
-        }
+		case controlID::delayTime_short:
+		case controlID::feedback_Pct:
+		case controlID::delayBlend:
+		case controlID::delayTime_long:
+		case controlID::modeSelectorValue:
+		case controlID::modType:
+		case controlID::modDepth_Pct:
+		case controlID::modRate_Hz:
+		case controlID::enableMod:
+		case controlID::enableSidechain:
+		{
+			// --- smoothed and sample accurate values glide across the current sub-block
+			if (paramInfo.isSmoothing || paramInfo.isVSTSampleAccurateUpdate)
+				rampParameters = true;
+
+			parametersDirty = true;
+			return true;    /// handled
+		}
 
         default:
             return false;   /// not handled
-    }*/
-
-    return false;
+    }
 }
 
 /**
@@ -512,6 +783,23 @@ bool PluginCore::processMessage(MessageInfo& messageInfo)
 		return false;
 	}
 
+	// --- per-buffer CPU/latency statistics for monitoring; outMessageData is an optional ProcessingStats*
+	case PLUGIN_QUERY_PROCESSING_STATS:
+	{
+		ProcessingStats stats;
+		getProcessingStats(stats);
+		if (messageInfo.outMessageData)
+			*static_cast<ProcessingStats*>(messageInfo.outMessageData) = stats;
+		messageInfo.outMessageString = stats.toString();
+		return true;
+	}
+
+	case PLUGIN_RESET_PROCESSING_STATS:
+	{
+		resetProcessingStats();
+		return true;
+	}
+
 	case PLUGINGUI_REGISTER_SUBCONTROLLER:
 	case PLUGINGUI_QUERY_HASUSERCUSTOM:
 	case PLUGINGUI_USER_CUSTOMOPEN:
@@ -619,6 +907,7 @@ bool PluginCore::initPluginDescriptors()
 	pluginDescriptor.latencyInSamples = kLatencyInSamples;
 	pluginDescriptor.tailTimeInMSec = kTailTimeMsec;
 	pluginDescriptor.infiniteTailVST3 = kVSTInfiniteTail;
+	pluginDescriptor.paramSmoothingGranularity = kParamSmoothingGranularity;
 
     // --- AAX
     apiSpecificInfo.aaxManufacturerID = kManufacturerID;
@@ -15,6 +15,7 @@
 
 #include "pluginbase.h"
 #include "fourtapdelay.h"
+#include <atomic>
 
 // **--0x7F1F--**
 
@@ -80,9 +81,8 @@ public:
 	/** process frames of data */
 	virtual bool processAudioFrame(ProcessFrameInfo& processFrameInfo);
 
-	// --- uncomment and override this for buffer processing; see base class implementation for
-	//     help on breaking up buffers and getting info from processBufferInfo
-	//virtual bool processAudioBuffers(ProcessBufferInfo& processBufferInfo);
+	/** process buffers of data; runs the delay engines in blocks over the host's channel buffers */
+	virtual bool processAudioBuffers(ProcessBufferInfo& processBufferInfo);
 
 	/** preProcess: do any post-buffer processing required; default operation is to send metering data to GUI  */
 	virtual bool postProcessAudioBuffers(ProcessBufferInfo& processInfo);
@@ -113,8 +113,19 @@ public:
 
 	// --- BEGIN USER VARIABLES AND FUNCTIONS -------------------------------------- //
 	//	   Add your variables and methods here
-	FourTapDelay audioDelay[2];
+	FXArena fxArena;			///< one block for the first tapes; declared first so it outlives the delays
+	FourTapDelay audioDelay;	///< stereo-linked: one set of heads, LFO and detector for both channels
+	MultichannelFourTapDelay surroundDelay;	///< surround/immersive beds (LCR up to 7.1.4); set up in reset( ) when the layout is a bed
+	void setupSurroundDelay(uint32_t bedChannels);
+	std::atomic<uint32_t> pendingBedChannels{ 0 };	///< a bed layout processAudioBuffers() saw before reset( ) set the engine up for it
+	const double kSurroundTapOffsetStep_mSec = 1.5;	///< per-channel head offset step across a bed
+	const double kMaxSampleRate = 96000.0;			///< the tapes are preallocated for this rate in initialize( )
+	const double kTapeLength_mSec = 12000.0;		///< longest the stereo tape may grow to
+	const double kSurroundTapeLength_mSec = 4100.0;	///< longest the surround tape may grow to: 4 heads x 1000 mSec long delay, plus room for the head modulation
 	void updateParameters();
+	std::atomic<bool> parametersDirty{ true };	///< set when a bound variable feeding the delays changes (any thread); cleared by updateParameters()
+	std::atomic<bool> rampParameters{ false };	///< set when the change came from smoothing or sample accurate automation; cleared by updateParameters()
+	TailSilenceTracker silenceTracker;	///< skips the delays once the input and the echoes are both silent
 
 	// --- END USER VARIABLES AND FUNCTIONS -------------------------------------- //
 
@@ -67,6 +67,7 @@ const double kTailTimeMsec = 4000.000;
 const bool kVSTInfiniteTail = false;
 const bool kVSTSAA = false;
 const uint32_t kVST3SAAGranularity = 1;
+const uint32_t kParamSmoothingGranularity = 16;
 const uint32_t kAAXCategory = 0;
 
 #endif
@@ -20,6 +20,7 @@
 #include <map>
 #include <iomanip>
 #include <iostream>
+#include <algorithm>
 
 #include <math.h>
 #include "pluginstructures.h"
@@ -431,18 +432,37 @@ public:
 	/**
 	\brief perform smoothing operation on data
 
+	\param numSteps number of samples to advance the smoother (> 1 for sub-block smoothing)
 	\return true if data was actually smoothed, false otherwise (data that has reached its terminal value will not be smoothed any further)
 	*/
-	bool smoothParameterValue()
+	bool smoothParameterValue(uint32_t numSteps = 1)
     {
         if(!useParameterSmoothing) return false;
         double smoothedValue = 0.0;
-        bool smoothed = paramSmoother.smoothParameter(getSmoothedTargetValue(), smoothedValue);
+		double targetValue = getSmoothedTargetValue();
+        bool smoothed = paramSmoother.smoothParameter(targetValue, smoothedValue, numSteps);
         if(smoothed)
 			setAtomicControlValueDouble(smoothedValue);
+		else
+		{
+			// --- remember where we settled so isSmoothingActive( ) can skip us
+			settledTargetValue = targetValue;
+			smoothingSettled = true;
+		}
         return smoothed;
     }
 
+	/**
+	\brief query whether the smoother still has work to do; true until it has settled on the current target
+
+	\return true if smoothing is enabled and the target has not been reached
+	*/
+	bool isSmoothingActive()
+	{
+		if (!useParameterSmoothing) return false;
+		return !smoothingSettled || getSmoothedTargetValue() != settledTargetValue;
+	}
+
 	/**
 	\brief save the variable for binding operation
 
@@ -476,30 +496,18 @@ public:
 	/**
 	\brief perform the variable binding update (change the value)
 
-	\return boundVariableType
+	\return true if the bound variable's value actually changed, false otherwise
 	*/
 	bool updateInBoundVariable()
 	{
 		if (boundVariableUInt)
-		{
-			*boundVariableUInt = (uint32_t)getControlValue();
-			return true;
-		}
+			return updateBoundValue(*boundVariableUInt, (uint32_t)getControlValue());
 		else if (boundVariableInt)
-		{
-			*boundVariableInt = (int)getControlValue();
-			return true;
-		}
+			return updateBoundValue(*boundVariableInt, (int)getControlValue());
 		else if (boundVariableFloat)
-		{
-			*boundVariableFloat = (float)getControlValue();
-			return true;
-		}
+			return updateBoundValue(*boundVariableFloat, (float)getControlValue());
 		else if (boundVariableDouble)
-		{
-			*boundVariableDouble = getControlValue();
-			return true;
-		}
+			return updateBoundValue(*boundVariableDouble, getControlValue());
 		return false;
 	}
 
@@ -601,6 +609,17 @@ protected:
     double getAtomicControlValueDouble() const { return (double)controlValueAtomic.load(std::memory_order_relaxed); }		///< set atomic variable with double
 	void setAtomicControlValueDouble(double value) { controlValueAtomic.store((float)value, std::memory_order_relaxed); }	///< get atomic variable as double
 
+	/** write a bound variable only when its value changes so that the core can skip re-cooking */
+	template <typename T>
+	static bool updateBoundValue(T& boundVariable, T value)
+	{
+		if (boundVariable == value)
+			return false;
+
+		boundVariable = value;
+		return true;
+	}
+
     std::atomic<float> smoothedTargetValueAtomic;	///< the underlying atomic variable TARGET for smoothing
     void setSmoothedTargetValue(double value){ smoothedTargetValueAtomic.store((float)value); }	///< set atomic TARGET smoothing variable with double
     double getSmoothedTargetValue() const { return (double)smoothedTargetValueAtomic.load(); }	///< set atomic TARGET smoothing variable with double
@@ -630,6 +649,8 @@ protected:
     bool useParameterSmoothing = false;			///< enable param smoothing
     smoothingMethod smoothingType = smoothingMethod::kLPFSmoother;	///< param smoothing type
     double smoothingTimeMsec = 100.0;			///< param smoothing time
+    double settledTargetValue = 0.0;			///< target the smoother last settled on
+    bool smoothingSettled = false;				///< true once the smoother has reached settledTargetValue
     ParamSmoother<double> paramSmoother;		///< param smoothing object
 
 	// --- variable binding
@@ -4,7 +4,101 @@
 #define __FourTapDelay__
 
 #include "fxobjects.h"
+#include "fxkernels.h"
 #include "superlfo.h"
+
+// --- tape (delay line) storage formats; interpolation and feedback math are always done in double
+#define TAPE_STORAGE_DOUBLE		0	///< 8 bytes per sample
+#define TAPE_STORAGE_FLOAT		1	///< 4 bytes per sample
+#define TAPE_STORAGE_FIXED16	2	///< 2 bytes per sample, +/-4.0 full scale
+
+// --- define FOURTAPDELAY_TAPE_STORAGE before including this file to choose another format
+#ifndef FOURTAPDELAY_TAPE_STORAGE
+#define FOURTAPDELAY_TAPE_STORAGE TAPE_STORAGE_FLOAT
+#endif
+
+/**
+\struct Fixed16TapeSample
+\ingroup FX-Objects
+\brief
+16-bit fixed point tape sample for the FourTapDelay delay line; converts to and from double.
+
+- full scale is +/-4.0 (12dB of headroom for feedback build-up); values beyond that are clipped, like tape
+- resolution is 4/32768 (about -78dBFS re: 1.0)
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+struct Fixed16TapeSample
+{
+	Fixed16TapeSample() = default;	// --- trivial, so the tape buffers can zero it with memset
+	Fixed16TapeSample(double value)
+	{
+		// --- scale, round and clip to 16 bits
+		double scaled = value * (32767.0 / 4.0);
+		scaled += scaled >= 0.0 ? 0.5 : -0.5;
+		if (scaled > 32767.0) scaled = 32767.0;
+		else if (scaled < -32768.0) scaled = -32768.0;
+		sample = (int16_t)scaled;
+	}
+
+	/** convert to double */
+	operator double() const { return sample * (4.0 / 32767.0); }
+
+	int16_t sample;	///< the stored value; zeroed by the tape buffers' flush
+};
+
+#if FOURTAPDELAY_TAPE_STORAGE == TAPE_STORAGE_DOUBLE
+typedef double TapeSample;
+#elif FOURTAPDELAY_TAPE_STORAGE == TAPE_STORAGE_FIXED16
+typedef Fixed16TapeSample TapeSample;
+#else
+typedef float TapeSample;
+#endif
+
+/**
+\struct TapeFrame
+\ingroup FX-Objects
+\brief
+One interleaved left/right pair on the FourTapDelay tape, so a head position serves both channels from one cache line.
+Mono processing writes the same value to both sides so that the right side is valid if the layout becomes stereo.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+struct TapeFrame
+{
+	TapeFrame() = default;	// --- trivial, so the tape buffers can zero it with memset
+	TapeFrame(double _left, double _right)
+		: left((TapeSample)_left)
+		, right((TapeSample)_right) {}
+
+	TapeSample left;	///< left channel
+	TapeSample right;	///< right channel
+};
+
+// --- tape (delay line) buffer types
+#define TAPE_BUFFER_POW2		0	///< CircularBuffer: rounded up to a power of two, mask wrapping
+#define TAPE_BUFFER_EXACT		1	///< ExactCircularBuffer: sized to the maximum delay, compare-and-subtract wrapping
+#define TAPE_BUFFER_MIRRORED	2	///< MirroredCircularBuffer: double-mapped, no wrapping on reads
+
+// --- define FOURTAPDELAY_TAPE_BUFFER before including this file to choose another buffer
+#ifndef FOURTAPDELAY_TAPE_BUFFER
+#define FOURTAPDELAY_TAPE_BUFFER TAPE_BUFFER_EXACT
+#endif
+
+#if FOURTAPDELAY_TAPE_BUFFER == TAPE_BUFFER_POW2
+typedef CircularBuffer<TapeFrame> TapeBuffer;
+#elif FOURTAPDELAY_TAPE_BUFFER == TAPE_BUFFER_MIRRORED
+typedef MirroredCircularBuffer<TapeFrame> TapeBuffer;
+#else
+typedef ExactCircularBuffer<TapeFrame> TapeBuffer;
+#endif
+
 /**
 \struct FourTapDelayParameters
 \ingroup FX-Objects
@@ -41,6 +135,14 @@ struct FourTapDelayParameters
 		modType = params.modType;
 		enableMod = params.enableMod;
 		enableSidechain = params.enableSidechain;
+		duckThreshold_dB = params.duckThreshold_dB;
+		duckRange_dB = params.duckRange_dB;
+		tapeInterpolation = params.tapeInterpolation;
+		enableVarispeed = params.enableVarispeed;
+		enableSaturation = params.enableSaturation;
+		saturationType = params.saturationType;
+		saturationDrive = params.saturationDrive;
+		saturationOversampling = params.saturationOversampling;
 
 		// --- MUST be last
 		return *this;
@@ -50,7 +152,7 @@ struct FourTapDelayParameters
 	
 	double feedback_Pct = 0.0;
 	double blend = 0.0;
-	unsigned int modeSelectorValue;
+	unsigned int modeSelectorValue = 0;
 	double delayTime_short = 0.0;
 	double delayTime_long = 0.0;
 
@@ -59,6 +161,14 @@ struct FourTapDelayParameters
 	int modType = 0;
 	bool enableMod = false;
 	bool enableSidechain = false;
+	double duckThreshold_dB = -30.0;	///< sidechain level where the echoes start to duck
+	double duckRange_dB = -18.0;		///< wet gain at full duck, reached 12dB above the threshold
+	bufferInterpolation tapeInterpolation = bufferInterpolation::kLinear;	///< head interpolator; anything but kLinear runs the heads per sample
+	bool enableVarispeed = false;		///< delay time changes change the tape speed instead of moving the heads
+	bool enableSaturation = false;		///< saturate the feedback path; see TapeSaturator
+	saturationModel saturationType = saturationModel::kTanh;	///< feedback saturation waveshaper
+	double saturationDrive = 1.0;		///< feedback saturation drive; the loop levels off near 1 / drive
+	unsigned int saturationOversampling = 4;	///< 1 (off), 2 or 4
 };
 
 
@@ -69,8 +179,65 @@ struct FourTapDelayParameters
 The FourTapDelay object implements ....
 
 Audio I/O:
-- Processes mono input to mono output.
-- *** Optionally, process frame *** Modify this according to your object functionality
+- Processes mono input to mono output, or stereo-linked L/R frames in one object.
+- In stereo the parameter cooking, LFO, sidechain detector (fed with the L/R average) and head positions are shared;
+  the tape stores interleaved TapeFrame pairs.
+
+Sidechain:
+- with enableSidechain on, the echoes duck under the sidechain (and, in modes 1 and 2 with the mod on, it sets the
+  modulation depth); pass the host's aux buffers to processAudioBlock( ) or the aux frame to processAuxInputAudioSample( )
+  before each frame; with no aux signal the object ducks under its own input
+- the detector runs in the linear (mean square) domain; the gain curve is evaluated once per kSidechainSubBlock
+  samples and the wet gain ramps linearly across the sub-block
+
+Modulation:
+- in modes 1 and 2 with enableMod on, the LFO (or the sidechain) moves head 0 around its set position
+- while modulated the output mix is the modType's own (modWet_dB/modDry_dB) instead of the blend: chorus -3/-3dB,
+  vibrato wet only (dry at -96dB), flanger -3/0dB; the mix fades with the head excursion when the mod is toggled
+
+Tape growth:
+- after enableBufferGrowth( ) the tape is only as long as the heads need (getRequiredBufferLength_mSec( ), from the
+  mode and the short/long delay times); when setParameters( ) asks for longer heads it posts a request and
+  FXBufferGrowthService builds the longer tape on its own thread
+- swapInGrownBuffers( ), once per buffer on the audio thread, copies the history into it oldest first,
+  kBufferGrowthSlice tape samples per call (twice what the last buffer wrote if that is more), so a long tape takes
+  a few buffers;
+  once the copy has caught up with the write head the tapes are swapped and the old one goes back to the service
+  thread to be freed, so nothing is allocated, freed or copied in one go on the audio thread
+- until then the heads are held at the end of the current tape; the tape grows by at least kBufferGrowthFactor so
+  a knob sweep costs a few swaps, and it never shrinks
+
+Head interpolation:
+- tapeInterpolation picks the fractional delay interpolator (see bufferInterpolation); kLinear keeps the block tape
+  kernels for fixed heads, anything else runs every head through a FractionalDelayInterpolator per sample, trading
+  CPU for less high frequency loss and modulation noise on the swept head
+- MultichannelFourTapDelay lines are always linear
+
+Varispeed:
+- with enableVarispeed on, the heads sit at fixed distances along the tape and a delay time change glides the tape
+  speed (kVarispeedGlide_mSec) instead, as on the RE-201: the pitch bends and what is already on the tape stretches
+- the write head lays the input onto the tape at the tape speed, and the heads read it back at the output rate,
+  both through a ResamplingKernel band limited to the slower of the two rates; the speed is held to
+  [1/maxSamplingRatio, maxSamplingRatio], which bounds the kernel to kResamplingKernelMaxTaps taps per tape sample
+  written (at most maxSamplingRatio per output sample) and per head read
+- the longest head sets the speed; the other heads slide along the tape to their new times. A change that needs a
+  speed outside that range, a mode change or switching varispeed on re-threads the tape at unit speed
+- the write head runs kVarispeedLatency samples late so that its kernel has input on both sides; the head distances
+  allow for it, and heads at zero delay read the previous input as in the fixed speed path
+- varispeed runs per sample and does its own interpolation, so tapeInterpolation and the block tape kernels do not
+  apply; MultichannelFourTapDelay ignores it
+
+Feedback saturation:
+- with enableSaturation on, the feedback term runs through a TapeSaturator before it is added to the input, so
+  feedback past 100% levels off near 1 / saturationDrive instead of running away; the first echo stays clean
+- the shaper runs at saturationOversampling x through the direct form polyphase filters (the 256 point 2x or
+  512 point 4x tables, which are flat enough to sit in a loop), which delay it by TapeSaturator::getLatency( )
+  samples; the feedback is read that much nearer the write head than the heads, with linear interpolation, so a
+  trip round the loop still takes the head time
+- heads nearer than that delay (the unused heads at zero, which feed back the previous write) cannot be read
+  ahead; their share of the feedback goes through a second saturator at the base rate, with no delay
+- those heads close the loop every sample, so the tape runs per sample instead of through the block tape kernels,
+  and each sample is one block of 2 or 4 through the oversampled shaper; MultichannelFourTapDelay ignores it
 
 Control I/F:
 - Use FourTapDelayParameters structure to get/set object params.
@@ -80,42 +247,62 @@ Control I/F:
 \version Revision : 1.0
 \date Date : 2019 / 01 / 31
 */
-class FourTapDelay : public IAudioSignalProcessor
+class FourTapDelay : public IAudioSignalProcessor, public IBufferGrowthClient
 {
 public:
 	FourTapDelay(void) {}	/* C-TOR */
-	~FourTapDelay(void) {}	/* D-TOR */
+	~FourTapDelay(void) { disableBufferGrowth(); }	/* D-TOR */
 
 public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
+		selectTapeKernel();
+
+		// --- no glide into the modulation at the top of a stream
+		modAmount = isModulated() ? 1.0 : 0.0;
+		cookModMixLevels();
+
+		// --- a grown tape part way through its history copy would miss the flush; the request stands, so it is rebuilt
+		delete adoptingTape;
+		adoptingTape = nullptr;
+
 		if (sampleRate == _sampleRate)
 		{
 			// --- just flush buffer and return
-			delayBuffer.flushBuffer();
+			flushDelayBuffers();
+			detector.reset(_sampleRate);
+			resetSidechain();
 			return true;
 		}
+
+		if (growBuffers)
+		{
+			// --- a request the service thread has not delivered yet is applied here, where allocating is allowed
+			bufferLength_mSec = fmax(bufferLength_mSec, requestedBufferLength_mSec.exchange(0.0));
+			growthSampleRate.store(_sampleRate);
+		}
 		createDelayBuffers(_sampleRate, bufferLength_mSec);
 		sampleRate = _sampleRate;
 
-		modDelay.reset(_sampleRate);
-		modDelay.createDelayBuffers(_sampleRate, 100);
-
 		lfo.reset(_sampleRate);
 		SuperLFOParameters params;
 		params.waveform = LFOWaveform::kTriangle;
+		params.frequency_Hz = parameters.modRate_Hz;
 		lfo.setParameters(params);
 
+		// --- fast mode, mean square: the gain curve works on power, so no log( ) or sqrt( ) per sample
 		AudioDetectorParameters adParams;
 		adParams.attackTime_mSec = 1.0;
 		adParams.releaseTime_mSec = 500.0;
-		adParams.detectMode = TLD_AUDIO_DETECT_MODE_RMS;
-		adParams.detect_dB = true;
+		adParams.detectMode = TLD_AUDIO_DETECT_MODE_MS;
+		adParams.detect_dB = false;
 		adParams.clampToUnityMax = false;
+		adParams.fastMode = true;
 		detector.setParameters(adParams);
+		detector.reset(_sampleRate);
 
-		sidechainInputSample = 0.0;
+		resetSidechain();
 
 		return true;
 	}
@@ -127,82 +314,254 @@ public:
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		double delayLines[4];
-		double weightedFeedback_Pct[4];
-		double weightedFeebackValues[4] = { 0.05, 0.1, 0.25, 0.6 };
-		double weightedFeedbackOutput = 0.0;
-		double yn = 0.0;
-		double sc_depth = 0.0;
+		// --- frame processing re-cooks every frame; no need to ramp
+		if (rampPending)
+			endParameterRamp();
 
-		if (parameters.enableSidechain) {
-			detector.enableAuxInput(true);
-			double sc_xn = detector.processAuxInputAudioSample(xn);
-			double detect_dB = detector.processAudioSample(sc_xn);
-			double detectValue = pow(10.0, detect_dB / 20.0);
+		if (isDucking())
+			detectSidechainSample(xn);
+
+		framesWritten++;
+		return renderSample(xn);
+	}
 
-			sc_depth = doUnipolarModulationFromMin(detectValue, 0.2, 1.0);
+	/** process one frame: stereo-linked for two or more outputs, mono (left input) for one */
+	/**
+	\param inputFrame input frame; inputFrame[1] is ignored for mono input
+	\param outputFrame output frame
+	\param inputChannels number of input channels
+	\param outputChannels number of output channels
+	\return true if processed
+	*/
+	virtual bool processAudioFrame(const float* inputFrame, float* outputFrame, uint32_t inputChannels, uint32_t outputChannels)
+	{
+		if (inputChannels == 0 || outputChannels == 0)
+			return false;
+
+		if (outputChannels == 1)
+		{
+			outputFrame[0] = (float)processAudioSample(inputFrame[0]);
+			return true;
 		}
 
-		if ((parameters.enableMod && parameters.modeSelectorValue == 1) || (parameters.enableMod && parameters.modeSelectorValue == 2)) {
-			double depth = parameters.modDepth_Pct / 200.0; 
-			if (parameters.modType == 0) {
-				depth = depth * 2.0;
-			}
+		double ynL = 0.0;
+		double ynR = 0.0;
+		processStereoFrame(inputFrame[0], inputChannels > 1 ? inputFrame[1] : inputFrame[0], ynL, ynR);
+		outputFrame[0] = (float)ynL;
+		outputFrame[1] = (float)ynR;
+
+		return true;
+	}
+
+	/** process one stereo-linked frame */
+	/**
+	\param xnL left input
+	\param xnR right input
+	\param ynL left output
+	\param ynR right output
+	*/
+	void processStereoFrame(double xnL, double xnR, double& ynL, double& ynR)
+	{
+		// --- frame processing re-cooks every frame; no need to ramp
+		if (rampPending)
+			endParameterRamp();
+
+		// --- one linked detector for both channels
+		if (isDucking())
+			detectSidechainSample(0.5 * (xnL + xnR));
+
+		framesWritten++;
+		renderFrame(xnL, xnR, ynL, ynR);
+	}
+
+	/** process a block of MONO input */
+	/**
+	\param in input buffer
+	\param out output buffer; may be the same buffer as in
+	\param numSamples number of samples to process; if a ramp is pending it completes on the last sample (on the
+	       first sidechain sub-block while ducking)
+	\param sidechain aux input buffers, or nullptr to duck under the input
+	\param numSidechainChannels number of aux input buffers
+	*/
+	void processAudioBlock(const float* in, float* out, uint32_t numSamples,
+						   const float* const* sidechain = nullptr, uint32_t numSidechainChannels = 0)
+	{
+		framesWritten += numSamples;
+		if (!isDucking())
+		{
+			renderBlock(in, out, numSamples);
+			return;
+		}
+
+		const float* const* detectInputs = numSidechainChannels > 0 ? sidechain : &in;
+		uint32_t numDetectChannels = numSidechainChannels > 0 ? numSidechainChannels : 1;
+		for (uint32_t start = 0; start < numSamples; start += kSidechainSubBlock)
+		{
+			uint32_t length = numSamples - start < kSidechainSubBlock ? numSamples - start : kSidechainSubBlock;
+			detectSidechainBlock(detectInputs, numDetectChannels, start, length);
+			renderBlock(in + start, out + start, length);
+		}
+	}
+
+	/** render a block of MONO input with the wet gain ramp already set up; see processAudioBlock( ) */
+	void renderBlock(const float* in, float* out, uint32_t numSamples)
+	{
+		// --- the modulated and varispeed paths are stateful per-sample chains
+		if (isModulating() || parameters.enableVarispeed)
+		{
+			if (rampPending)
+				endParameterRamp();
+
+			for (uint32_t i = 0; i < numSamples; i++)
+				out[i] = (float)renderSample(in[i]);
+
+			return;
+		}
 
-			if (parameters.enableSidechain) {
-				depth = sc_depth;
+		if (rampPending && numSamples > 0)
+		{
+			// --- linear ramp of the cooked values, arriving at the targets on the last sample
+			beginBlockRamp(numSamples);
+			for (uint32_t i = 0; i < numSamples - 1; i++)
+			{
+				stepBlockRamp();
+				out[i] = (float)processTapeSample(in[i]);
 			}
-			double modMin = minDelay_mSec[parameters.modeSelectorValue - 1][parameters.modType];
-			double modMax = modMin + modDepth_mSec[parameters.modeSelectorValue - 1][parameters.modType];
 
-			double lfoOutput = lfo.renderModulatorOutput().normalOutput;
-			AudioDelayParameters params = modDelay.getParameters();
+			// --- land exactly on the targets
+			endParameterRamp();
+			out[numSamples - 1] = (float)processTapeSample(in[numSamples - 1]);
+			return;
+		}
+
+		// --- the tape kernels interpolate linearly and have a linear loop; anything else runs per sample
+		if (parameters.tapeInterpolation != bufferInterpolation::kLinear || parameters.enableSaturation)
+		{
+			for (uint32_t i = 0; i < numSamples; i++)
+				out[i] = (float)processTapeSample(in[i]);
+			return;
+		}
+
+		// --- heads are fixed for the block
+		processTapeBlock(in, out, numSamples);
+	}
+
+	/** process a block of stereo-linked input */
+	/**
+	\param inL left input buffer
+	\param inR right input buffer; may be the same buffer as inL
+	\param outL left output buffer; may alias either input
+	\param outR right output buffer; may alias either input
+	\param numSamples number of samples to process; if a ramp is pending it completes on the last sample (on the
+	       first sidechain sub-block while ducking)
+	\param sidechain aux input buffers, or nullptr to duck under the L/R average
+	\param numSidechainChannels number of aux input buffers
+	*/
+	void processAudioBlock(const float* inL, const float* inR, float* outL, float* outR, uint32_t numSamples,
+						   const float* const* sidechain = nullptr, uint32_t numSidechainChannels = 0)
+	{
+		framesWritten += numSamples;
+		if (!isDucking())
+		{
+			renderBlock(inL, inR, outL, outR, numSamples);
+			return;
+		}
+
+		const float* inputs[2] = { inL, inR };
+		const float* const* detectInputs = numSidechainChannels > 0 ? sidechain : inputs;
+		uint32_t numDetectChannels = numSidechainChannels > 0 ? numSidechainChannels : 2;
+		for (uint32_t start = 0; start < numSamples; start += kSidechainSubBlock)
+		{
+			uint32_t length = numSamples - start < kSidechainSubBlock ? numSamples - start : kSidechainSubBlock;
+			detectSidechainBlock(detectInputs, numDetectChannels, start, length);
+			renderBlock(inL + start, inR + start, outL + start, outR + start, length);
+		}
+	}
+
+	/** render a block of stereo-linked input with the wet gain ramp already set up; see processAudioBlock( ) */
+	void renderBlock(const float* inL, const float* inR, float* outL, float* outR, uint32_t numSamples)
+	{
+		// --- every path reads both inputs of a frame before writing its outputs, so aliasing is safe
+		if (isModulating() || parameters.enableVarispeed)
+		{
+			if (rampPending)
+				endParameterRamp();
 
-			if (parameters.modType == 0) {
-				params.leftDelay_mSec = doUnipolarModulationFromMin(bipolarToUnipolar(lfoOutput * depth), modMin, modMax);
-			
-			} else {
-				params.leftDelay_mSec = doBipolarModulation(lfoOutput * depth, modMin, modMax);
+			for (uint32_t i = 0; i < numSamples; i++)
+			{
+				double ynL = 0.0;
+				double ynR = 0.0;
+				renderFrame(inL[i], inR[i], ynL, ynR);
+				outL[i] = (float)ynL;
+				outR[i] = (float)ynR;
 			}
-			double delay = delayBuffer.readBuffer(delayInSamples[0]);
+			return;
+		}
 
-			params.dryLevel_dB = modDry_dB[parameters.modType];
-			params.wetLevel_dB = modWet_dB[parameters.modType];
-			params.feedback_Pct = parameters.feedback_Pct;
-			if (parameters.modType != 0) {
-				params.feedback_Pct = 0.0;
+		if (rampPending && numSamples > 0)
+		{
+			double ynL = 0.0;
+			double ynR = 0.0;
+			beginBlockRamp(numSamples);
+			for (uint32_t i = 0; i < numSamples - 1; i++)
+			{
+				stepBlockRamp();
+				processTapeFrame(inL[i], inR[i], ynL, ynR);
+				outL[i] = (float)ynL;
+				outR[i] = (float)ynR;
 			}
-			modDelay.setParameters(params);
-			return modDelay.processAudioSample(xn);
 
-		} else {
-			for (int i = 0; i < 4; i++) {
-				delayLines[i] = delayBuffer.readBuffer(delayInSamples[i]);
-				yn = yn + delayLines[i];
+			// --- land exactly on the targets
+			endParameterRamp();
+			processTapeFrame(inL[numSamples - 1], inR[numSamples - 1], ynL, ynR);
+			outL[numSamples - 1] = (float)ynL;
+			outR[numSamples - 1] = (float)ynR;
+			return;
+		}
 
-				weightedFeedback_Pct[i] = float(i) / 10.0;
-				weightedFeedbackOutput = weightedFeedbackOutput + (delayLines[i] * weightedFeedback_Pct[i]);
+		// --- the tape kernels interpolate linearly and have a linear loop; anything else runs per sample
+		if (parameters.tapeInterpolation != bufferInterpolation::kLinear || parameters.enableSaturation)
+		{
+			double ynL = 0.0;
+			double ynR = 0.0;
+			for (uint32_t i = 0; i < numSamples; i++)
+			{
+				processTapeFrame(inL[i], inR[i], ynL, ynR);
+				outL[i] = (float)ynL;
+				outR[i] = (float)ynR;
 			}
+			return;
+		}
 
-			yn = yn / 4.0;
-			double dn = xn + ((parameters.feedback_Pct / 100.0) * weightedFeedbackOutput);
-			delayBuffer.writeBuffer(dn);
+		// --- heads are fixed for the block
+		(this->*tapeFrameKernel)(inL, inR, outL, outR, numSamples);
+	}
 
-			// --- done
-			return (yn * parameters.blend) + (xn * (1.0 - parameters.blend));
-		}
+	/** pick the stereo-linked tape kernel for the instruction set the FX kernels are bound to; called from reset( ).
+	    Only the stereo path has an SSE2 version: an L/R pair fills a register, where the four mono heads would have
+	    to be gathered one at a time and summed across the register, which measured slower than the scalar loop */
+	void selectTapeKernel()
+	{
+		tapeFrameKernel = &FourTapDelay::processTapeFrameBlock;
+#if defined(FX_KERNELS_X86)
+		if (getFXKernels().isa != fxKernelISA::kScalar)
+			tapeFrameKernel = &FourTapDelay::processTapeFrameBlockSSE2;
+#endif
 	}
 
 	virtual void enableAuxInput(bool enableAuxInput) { parameters.enableSidechain = enableAuxInput; }
 
+	/** the sidechain (aux) sample for the next processAudioSample( )/processAudioFrame( ) call; without one the
+	    object ducks under its own input */
 	virtual double processAuxInputAudioSample(double xn)
 	{
 		sidechainInputSample = xn;
+		sidechainInputPending = true;
 		return sidechainInputSample;
 	}
 
 	/** query to see if this object can process frames */
-	virtual bool canProcessAudioFrame() { return false; } // <-- change this!
+	virtual bool canProcessAudioFrame() { return true; }
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
@@ -216,40 +575,332 @@ public:
 	/** set parameters: note use of custom structure for passing param data */
 	/**
 	\param FourTapDelayParameters custom data structure
+	\param rampToNewValues true: glide the cooked feedback, blend and head positions to the new values over
+	       the next processAudioBlock( ) call (smoothed or sample accurate updates); false: jump to them
 	*/
-	void setParameters(const FourTapDelayParameters& params)
+	void setParameters(const FourTapDelayParameters& params, bool rampToNewValues = false)
 	{
-		// --- copy them; note you may choose to ignore certain items
-		//     and copy the variables one at a time, or you may test
-		//     to see if cook-able variables have changed; if not, then
-		//     do not re-cook them as it just wastes CPU
+		// --- only re-cook the head positions and the LFO when their controls have moved;
+		//     everything else is used raw in the audio path
+		bool cookDelayTimes = params.modeSelectorValue != parameters.modeSelectorValue ||
+							  params.delayTime_short != parameters.delayTime_short ||
+							  params.delayTime_long != parameters.delayTime_long;
+		bool cookModRate = params.modRate_Hz != parameters.modRate_Hz;
+		bool cookModLevels = params.modType != parameters.modType;
+		bool cookDucking = params.duckThreshold_dB != parameters.duckThreshold_dB ||
+						   params.duckRange_dB != parameters.duckRange_dB;
+		bool cookInterpolation = params.tapeInterpolation != parameters.tapeInterpolation;
+		bool varispeedChanged = params.enableVarispeed != parameters.enableVarispeed;
+		bool cookSaturation = params.enableSaturation != parameters.enableSaturation ||
+							  params.saturationType != parameters.saturationType ||
+							  params.saturationDrive != parameters.saturationDrive ||
+							  params.saturationOversampling != parameters.saturationOversampling;
+		bool saturationEnabled = params.enableSaturation && !parameters.enableSaturation;
+
+		// --- a mode change rearranges the heads; never glide between layouts
+		bool modeChanged = params.modeSelectorValue != parameters.modeSelectorValue;
+		if (modeChanged)
+			rampToNewValues = false;
+
 		parameters = params;
-		loadDelayTimes();
-		delayInSamples[0] = delayTime_mSec[0] * (samplesPerMSec);
-		delayInSamples[1] = delayTime_mSec[1] * (samplesPerMSec);
-		delayInSamples[2] = delayTime_mSec[2] * (samplesPerMSec);
-		delayInSamples[3] = delayTime_mSec[3] * (samplesPerMSec);
 
-		SuperLFOParameters LFOparams = lfo.getParameters();
-		LFOparams.frequency_Hz = parameters.modRate_Hz;
-		lfo.setParameters(LFOparams);
+		// --- ...nor fade the head modulation across them
+		if (modeChanged)
+			modAmount = isModulated() ? 1.0 : 0.0;
+
+		targetFeedbackGain = parameters.feedback_Pct / 100.0;
+		targetBlend = parameters.blend;
+
+		if (cookDelayTimes)
+		{
+			loadDelayTimes();
+			requestBufferGrowth();
+			updateDelayInSamples();
+		}
+
+		// --- varispeed turns the new head times into a tape speed
+		if (parameters.enableVarispeed && (cookDelayTimes || varispeedChanged))
+			retargetVarispeed(modeChanged || varispeedChanged);
+
+		if (rampToNewValues)
+			rampPending = true;
+		else
+			endParameterRamp();
+
+		if (cookModRate)
+		{
+			SuperLFOParameters LFOparams = lfo.getParameters();
+			LFOparams.frequency_Hz = parameters.modRate_Hz;
+			lfo.setParameters(LFOparams);
+		}
+
+		if (cookDucking)
+			cookDuckCurve();
+
+		if (cookModLevels)
+			cookModMixLevels();
+
+		if (cookInterpolation)
+			resetTapeInterpolators();
 
-		// --- cook parameters here
+		if (cookSaturation)
+			cookFeedbackSaturators();
+
+		// --- don't start with what the saturators held the last time they ran
+		if (saturationEnabled)
+			resetFeedbackSaturators();
 	}
 
-	/** creation function */
-	void createDelayBuffers(double _sampleRate, double _bufferLength_mSec)
+	/** the modulated wet/dry levels for the current modType */
+	void cookModMixLevels()
+	{
+		modWetLevel = pow(10.0, modWet_dB[parameters.modType] / 20.0);
+		modDryLevel = pow(10.0, modDry_dB[parameters.modType] / 20.0);
+	}
+
+	/** hand the saturation controls to the feedback saturators; realtime safe */
+	void cookFeedbackSaturators()
+	{
+		TapeSaturatorParameters saturatorParams = feedbackSaturator[0].getParameters();
+		saturatorParams.model = parameters.saturationType;
+		saturatorParams.saturation = parameters.saturationDrive;
+		saturatorParams.oversampling = parameters.saturationOversampling;
+
+		// --- the shorter tables have passband ripple that a loop would build up
+		saturatorParams.FIRLength = parameters.saturationOversampling == 2 ? 256 : 512;
+		feedbackSaturator[0].setParameters(saturatorParams);
+		feedbackSaturator[1].setParameters(saturatorParams);
+
+		saturatorParams.oversampling = 1;
+		nearFeedbackSaturator[0].setParameters(saturatorParams);
+		nearFeedbackSaturator[1].setParameters(saturatorParams);
+	}
+
+	/** clear the feedback saturators */
+	void resetFeedbackSaturators()
+	{
+		for (int side = 0; side < 2; side++)
+		{
+			feedbackSaturator[side].reset(sampleRate);
+			nearFeedbackSaturator[side].reset(sampleRate);
+		}
+	}
+
+	/** convert the ducking controls to the power threshold and wet gain floor the sidechain curve uses */
+	void cookDuckCurve()
+	{
+		duckThresholdPower = pow(10.0, parameters.duckThreshold_dB / 10.0);
+		duckFloorGain = pow(10.0, parameters.duckRange_dB / 20.0);
+	}
+
+	/** convert the cooked head times to samples; these are the targets for any pending ramp; heads past the end of
+	    the tape (while it is growing) are held there, with room for the interpolation neighbour */
+	void updateDelayInSamples()
+	{
+		double maxHead = bufferLength > 2 ? (double)bufferLength - 2.0 : 0.0;
+		for (int i = 0; i < 4; i++)
+			targetDelayInSamples[i] = fmin(delayTime_mSec[i] * (samplesPerMSec), maxHead);
+	}
+
+	/** set up the per-sample increments of a block ramp so that the targets are reached after numSamples steps */
+	void beginBlockRamp(uint32_t numSamples)
+	{
+		double ramp = 1.0 / numSamples;
+		feedbackInc = (targetFeedbackGain - feedbackGain) * ramp;
+		blendInc = (targetBlend - blend) * ramp;
+		for (int j = 0; j < 4; j++)
+			delayInc[j] = (targetDelayInSamples[j] - delayInSamples[j]) * ramp;
+	}
+
+	/** advance the cooked values one step of the block ramp */
+	inline void stepBlockRamp()
+	{
+		feedbackGain += feedbackInc;
+		blend += blendInc;
+		for (int j = 0; j < 4; j++)
+			delayInSamples[j] += delayInc[j];
+	}
+
+	/** jump the cooked values to their targets and cancel any pending ramp */
+	void endParameterRamp()
+	{
+		feedbackGain = targetFeedbackGain;
+		blend = targetBlend;
+		for (int i = 0; i < 4; i++)
+			delayInSamples[i] = targetDelayInSamples[i];
+
+		rampPending = false;
+	}
+
+	/** preallocation: set the tape length and allocate it for the highest sample rate reset( ) will see, so that
+	    reset( ) (and createDelayBuffers( ) at that length) only re-slices and zeroes it; not realtime safe */
+	/**
+	\param maxSampleRate highest sample rate; a higher one still works, but reset( ) allocates for it
+	\param _bufferLength_mSec tape length in mSec
+	*/
+	virtual void reserveDelayBuffers(double maxSampleRate, double _bufferLength_mSec)
 	{
-		sampleRate = _sampleRate;
-		samplesPerMSec = sampleRate / 1000.0;
-		// --- store for math
 		bufferLength_mSec = _bufferLength_mSec;
-		// --- total buffer length including fractional part
-		bufferLength = (unsigned int)(bufferLength_mSec * (samplesPerMSec)) + 1; // +1 for fractional part
+
+		// --- same rounding as setBufferLength( )
+		delayBuffer.reserveCircularBuffer((unsigned int)(_bufferLength_mSec * (maxSampleRate / 1000.0)) + 1);
+
+		// --- already running: switch to the new length now
+		if (sampleRate > 0.0)
+			createDelayBuffers(sampleRate, bufferLength_mSec);
+	}
+
+	/** bytes reserveDelayBuffers( ) takes from an FXArena; size the arena with this before reserving */
+	virtual size_t getReserveBytes(double maxSampleRate, double _bufferLength_mSec) const
+	{
+		return TapeBuffer::getReserveBytes((unsigned int)(_bufferLength_mSec * (maxSampleRate / 1000.0)) + 1);
+	}
+
+	/** creation function; re-slices the reserved tape if it is long enough (see reserveDelayBuffers( )) */
+	virtual void createDelayBuffers(double _sampleRate, double _bufferLength_mSec)
+	{
+		setBufferLength(_sampleRate, _bufferLength_mSec);
 
 		// --- create new buffer
 		delayBuffer.createCircularBuffer(bufferLength);
-		
+
+		// --- head positions depend on the sample rate
+		updateDelayInSamples();
+		endParameterRamp();
+		resetTapeInterpolators();
+		varispeedKernel.initialize((unsigned int)_sampleRate);
+		resetVarispeed();
+		resetFeedbackSaturators();
+	}
+
+	/** clear the tape */
+	virtual void flushDelayBuffers()
+	{
+		delayBuffer.flushBuffer();
+		resetTapeInterpolators();
+		resetVarispeed();
+		resetFeedbackSaturators();
+	}
+
+	/** select parameters.tapeInterpolation on every head and clear the allpass states */
+	void resetTapeInterpolators()
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			headInterpolator[0][i].setInterpolation(parameters.tapeInterpolation);
+			headInterpolator[1][i].setInterpolation(parameters.tapeInterpolation);
+		}
+	}
+
+	/** grow the tape on demand, up to _maxBufferLength_mSec, instead of allocating it at full length; size the first
+	    tape with reserveDelayBuffers( ) and getRequiredBufferLength_mSec( ); not realtime safe */
+	void enableBufferGrowth(double _maxBufferLength_mSec)
+	{
+		maxBufferLength_mSec = _maxBufferLength_mSec;
+		if (growBuffers)
+			return;
+
+		growBuffers = true;
+		growthSampleRate.store(sampleRate);
+		FXBufferGrowthService::getInstance().registerClient(this);
+	}
+
+	/** stop growing the tape and drop anything in flight; not realtime safe */
+	void disableBufferGrowth()
+	{
+		if (!growBuffers)
+			return;
+
+		// --- once this returns the service thread is done with us
+		FXBufferGrowthService::getInstance().unregisterClient(this);
+		growBuffers = false;
+		delete adoptingTape;
+		adoptingTape = nullptr;
+		delete grownTape.exchange(nullptr);
+		delete retiredTape.exchange(nullptr);
+		requestedBufferLength_mSec.store(0.0);
+	}
+
+	/** the tape the cooked heads need: the longest head, the modulation swing in modes 1 and 2 and kBufferHeadroom_mSec */
+	double getRequiredBufferLength_mSec()
+	{
+		double longestHead = 0.0;
+		for (int i = 0; i < 4; i++)
+			longestHead = fmax(longestHead, delayTime_mSec[i]);
+
+		// --- sized for the deepest mod type, so switching the mod section or its type never needs a longer tape
+		if (parameters.modeSelectorValue == 1 || parameters.modeSelectorValue == 2)
+		{
+			const double* depth = modDepth_mSec[parameters.modeSelectorValue - 1];
+			longestHead += 0.5 * fmax(depth[0], fmax(depth[1], depth[2]));
+		}
+
+		return longestHead + kBufferHeadroom_mSec;
+	}
+
+	/** current tape length in mSec */
+	double getBufferLength_mSec() { return bufferLength_mSec; }
+
+	/** audio thread, at the top of every buffer: carry the history into a tape that the service thread has grown (see
+	    enableBufferGrowth( )), a slice per call, and swap it in once the copy has caught up with the write head; the
+	    heads then move out to their set positions */
+	/**
+	\return true if a longer tape was swapped in
+	*/
+	bool swapInGrownBuffers()
+	{
+		unsigned int written = framesWritten;
+		framesWritten = 0;
+		if (!growBuffers)
+			return false;
+
+		if (!adoptingTape)
+		{
+			if (!grownTape.load(std::memory_order_relaxed))
+				return false;
+
+			// --- the old tape needs the retired slot to get back to the service thread
+			if (retiredTape.load(std::memory_order_acquire))
+				return false;
+
+			adoptingTape = grownTape.exchange(nullptr, std::memory_order_acquire);
+
+			// --- a reset( ) since the request may have changed the rate, or served it already
+			if (adoptingTape->sampleRate != sampleRate || adoptingTape->bufferLength_mSec <= bufferLength_mSec)
+				return retireGrownTape(false);
+
+			// --- the whole history is still to copy, including what the last buffer wrote
+			adoptPending = getGrownTapeHistory(*adoptingTape);
+			written = 0;
+		}
+
+		// --- a layout change since the request, or a buffer long enough for the write head to lap the copy: drop the
+		//     tape; the request stands, so the service thread builds another
+		unsigned int history = getGrownTapeHistory(*adoptingTape);
+		if (history == 0 || adoptPending + written > history)
+			return retireGrownTape(false);
+
+		// --- oldest first; at least twice what the last buffer wrote, so the copy gains on the write head
+		adoptPending += written;
+		unsigned int slice = adoptingTape->sliceFrames > 2 * written ? adoptingTape->sliceFrames : 2 * written;
+		unsigned int count = adoptPending < slice ? adoptPending : slice;
+		copyToGrownTape(*adoptingTape, adoptPending - 1, count);
+		adoptPending -= count;
+
+		return adoptPending == 0 ? retireGrownTape(true) : false;
+	}
+
+	/** service thread: free the tape the audio thread retired and build the one it asked for; see IBufferGrowthClient */
+	virtual void serviceBufferGrowth()
+	{
+		delete retiredTape.exchange(nullptr, std::memory_order_acquire);
+
+		double length_mSec = requestedBufferLength_mSec.load(std::memory_order_acquire);
+		double rate = growthSampleRate.load(std::memory_order_acquire);
+		if (length_mSec <= 0.0 || rate <= 0.0 || grownTape.load(std::memory_order_acquire))
+			return;
+
+		grownTape.store(createGrownTape(rate, length_mSec), std::memory_order_release);
 	}
 
 	void loadDelayTimes() {
@@ -341,32 +992,1599 @@ public:
 		}
 	}
 
-private:
-	FourTapDelayParameters parameters; ///< object parameters
-	SuperLFO lfo;
-	AudioDelay modDelay;
-	AudioDetector detector;
+	/** true when the mod section is switched on for the tape head (modes 1 and 2 only) */
+	bool isModulated()
+	{
+		return parameters.enableMod && (parameters.modeSelectorValue == 1 || parameters.modeSelectorValue == 2);
+	}
 
-	// --- local variables used by this object
-	double sampleRate = 0.0;	///< sample rate
+	/** true while the head is modulated, including the fade out after the mod section is switched off */
+	bool isModulating()
+	{
+		return isModulated() || modAmount > 0.0;
+	}
 
-	double sidechainInputSample = 0.0;
+	/** time for the echoes to fall below kTailFloor_dB after the input stops, for the target (cooked) parameters */
+	/**
+	\return the tail time in mSec
+	*/
+	virtual double getTailTime_mSec() { return computeTailTime_mSec(0.0); }
 
-	double samplesPerMSec = 0.0;	///< samples per millisecond, for easy access calculation
-	double delayInSamples[4] = { 0.0, 0.0, 0.0, 0.0 };	///< double includes fractional part
-	double bufferLength_mSec = 0.0;	///< buffer length in mSec
-	unsigned int bufferLength = 0;	///< buffer length in samples
-	double delayTime_mSec[4] = { 0.0, 0.0, 0.0, 0.0 };
+	/** the tail time with every head read headOffset_mSec further back (see MultichannelFourTapDelay) */
+	double computeTailTime_mSec(double headOffset_mSec)
+	{
+		// --- the output reads up to the longest head; the loop recirculates through the weighted heads only,
+		//     and head 0 (the modulated one) has no feedback weight
+		double longestHead = 0.0;
+		double longestLoop = 0.0;
+		double weightSum = 0.0;
+		for (int i = 0; i < 4; i++)
+		{
+			longestHead = fmax(longestHead, delayTime_mSec[i]);
+			if (weightedFeedback_Pct[i] != 0.0)
+				longestLoop = fmax(longestLoop, delayTime_mSec[i]);
+			weightSum += weightedFeedback_Pct[i];
+		}
+		if (isModulated())
+			longestHead += 0.5 * modDepth_mSec[parameters.modeSelectorValue - 1][parameters.modType];
 
-	// Modulation Variables
-	double minDelay_mSec[2][3] = { { 1.0, 0.0, 4.0 }, { 1.0, 0.0, 16.0 } };
-	double modDepth_mSec[2][3] = { { 4.0, 5.0, 8.0 }, { 6.0, 7.0, 24.0 } };
+		// --- +1 sample: a head at 0 mSec reads the last write
+		double oneSample_mSec = samplesPerMSec > 0.0 ? 1.0 / samplesPerMSec : 0.0;
+		longestHead += headOffset_mSec + oneSample_mSec;
+		longestLoop += headOffset_mSec + oneSample_mSec;
+
+		// --- one trip round the loop takes at most longestLoop and multiplies by at most the loop gain: the heads
+		//     interpolate (a convex sum) and the duck only lowers the wet gain
+		double loopGain = fabs(targetFeedbackGain) * weightSum;
+		if (loopGain <= 0.0)
+			return longestHead;
+
+		// --- the tape can build up to 1/(1 - gain) of the input level; what is still circulating after k trips is
+		//     below gain^k/(1 - gain), so that must fall under the floor
+		double floorGain = pow(10.0, kTailFloor_dB / 20.0);
+		double trips = loopGain < 1.0 ? ceil(log(floorGain * (1.0 - loopGain)) / log(loopGain)) : kMaxTailTrips;
+		if (trips > kMaxTailTrips)
+			trips = kMaxTailTrips;
+
+		return longestHead + trips * longestLoop;
+	}
+
+	/** true while the sidechain is on, or the echoes are still recovering from a duck after it was switched off */
+	bool isDucking()
+	{
+		return parameters.enableSidechain || duckGain != 1.0;
+	}
+
+protected:
+	/** store the sample rate and the tape length in mSec and samples */
+	void setBufferLength(double _sampleRate, double _bufferLength_mSec)
+	{
+		sampleRate = _sampleRate;
+		samplesPerMSec = sampleRate / 1000.0;
+		// --- store for math
+		bufferLength_mSec = _bufferLength_mSec;
+		// --- total buffer length including fractional part
+		bufferLength = (unsigned int)(bufferLength_mSec * (samplesPerMSec)) + 1; // +1 for fractional part
+	}
+
+	/** a longer tape built on the service thread; once swapped in, it holds the old tape until the service thread frees it */
+	struct GrownTape
+	{
+		virtual ~GrownTape() {}
+		double sampleRate = 0.0;		///< rate it was built for
+		double bufferLength_mSec = 0.0;	///< length it was built for
+		unsigned int sliceFrames = 0;	///< frames of history swapInGrownBuffers( ) copies per call, at least
+	};
+
+	/** the FourTapDelay tape */
+	struct GrownTapeBuffer : public GrownTape
+	{
+		TapeBuffer buffer;
+	};
+
+	/** post a growth request if the cooked heads run past the tape; realtime safe */
+	void requestBufferGrowth()
+	{
+		if (!growBuffers)
+			return;
+
+		double required = fmin(getRequiredBufferLength_mSec(), maxBufferLength_mSec);
+		if (required <= bufferLength_mSec || required <= requestedBufferLength_mSec.load(std::memory_order_relaxed))
+			return;
+
+		// --- grow geometrically so that sweeping a delay time costs a few swaps, not one per step
+		double length_mSec = fmin(fmax(required, kBufferGrowthFactor * bufferLength_mSec), maxBufferLength_mSec);
+		requestedBufferLength_mSec.store(length_mSec, std::memory_order_release);
+	}
+
+	/** service thread: allocate a tape of the given length */
+	virtual GrownTape* createGrownTape(double _sampleRate, double _bufferLength_mSec)
+	{
+		GrownTapeBuffer* grown = new GrownTapeBuffer;
+		grown->sampleRate = _sampleRate;
+		grown->bufferLength_mSec = _bufferLength_mSec;
+		grown->sliceFrames = kBufferGrowthSlice / 2;
+
+		// --- same rounding as setBufferLength( )
+		grown->buffer.createCircularBuffer((unsigned int)(_bufferLength_mSec * (_sampleRate / 1000.0)) + 1);
+		return grown;
+	}
+
+	/** audio thread: frames of our history the grown tape takes, 0 if it can no longer be adopted */
+	virtual unsigned int getGrownTapeHistory(GrownTape& grown)
+	{
+		TapeBuffer& tape = static_cast<GrownTapeBuffer&>(grown).buffer;
+		return (delayBuffer.getBufferLength() < tape.getBufferLength() ? delayBuffer.getBufferLength() : tape.getBufferLength()) - 1;
+	}
+
+	/** audio thread: append count frames of history to the grown tape, starting oldest frames back from our write head */
+	virtual void copyToGrownTape(GrownTape& grown, unsigned int oldest, unsigned int count)
+	{
+		TapeBuffer& tape = static_cast<GrownTapeBuffer&>(grown).buffer;
+		for (unsigned int k = 0; k < count; k++)
+			tape.writeBuffer(delayBuffer.readBuffer((int)(oldest - k)));
+	}
+
+	/** audio thread: exchange the grown tape, whose history has caught up with ours, with our tape */
+	virtual void swapGrownTape(GrownTape& grown)
+	{
+		delayBuffer.swapBuffer(static_cast<GrownTapeBuffer&>(grown).buffer);
+	}
+
+	/** audio thread: swap in the tape being adopted if adopt is true, then hand it (holding our old tape if swapped)
+	    back to the service thread */
+	/**
+	\return adopt
+	*/
+	bool retireGrownTape(bool adopt)
+	{
+		GrownTape* grown = adoptingTape;
+		adoptingTape = nullptr;
+		if (adopt)
+		{
+			swapGrownTape(*grown);
+			setBufferLength(sampleRate, grown->bufferLength_mSec);
+			updateDelayInSamples();
+			if (!rampPending)
+				endParameterRamp();
+			if (parameters.enableVarispeed)
+				retargetVarispeed(false);
+		}
+
+		// --- served, unless a longer request came in meanwhile
+		double requested = requestedBufferLength_mSec.load(std::memory_order_acquire);
+		if (requested <= bufferLength_mSec)
+			requestedBufferLength_mSec.compare_exchange_strong(requested, 0.0);
+
+		// --- after swapGrownTape( ) this holds the old tape
+		retiredTape.store(grown, std::memory_order_release);
+		return adopt;
+	}
+
+	/** read the left side of the tape; mono processing uses the left side only */
+	inline double readTapeLeft(int delayInSamples)
+	{
+		return delayBuffer.readBuffer(delayInSamples).left;
+	}
+
+	/** the longest delay the heads can read; the interpolators hold their outer taps here */
+	inline int getMaxTapeDelay() { return (int)delayBuffer.getBufferLength() - 1; }
+
+	/** read the (left side of the) tape at a fractional delay; the interpolation is done in double whatever the storage format */
+	inline double readTape(double delayInFractionalSamples, int head)
+	{
+		if (parameters.tapeInterpolation != bufferInterpolation::kLinear)
+			return headInterpolator[0][head].interpolate([this](int delayInSamples) { return readTapeLeft(delayInSamples); },
+														 delayInFractionalSamples, getMaxTapeDelay());
+
+		int delay = (int)delayInFractionalSamples;
+		double y1 = readTapeLeft(delay);
+		double y2 = readTapeLeft(delay + 1);
+
+		return doLinearInterpolation(y1, y2, delayInFractionalSamples - delay);
+	}
+
+	/** read both sides of the tape at a fractional delay */
+	inline void readTapeFrame(double delayInFractionalSamples, int head, double& left, double& right)
+	{
+		if (parameters.tapeInterpolation != bufferInterpolation::kLinear)
+		{
+			int maxDelay = getMaxTapeDelay();
+			left = headInterpolator[0][head].interpolate([this](int delayInSamples) { return (double)delayBuffer.readBuffer(delayInSamples).left; },
+														 delayInFractionalSamples, maxDelay);
+			right = headInterpolator[1][head].interpolate([this](int delayInSamples) { return (double)delayBuffer.readBuffer(delayInSamples).right; },
+														  delayInFractionalSamples, maxDelay);
+			return;
+		}
+
+		int delay = (int)delayInFractionalSamples;
+		double fraction = delayInFractionalSamples - delay;
+		TapeFrame y1 = delayBuffer.readBuffer(delay);
+		TapeFrame y2 = delayBuffer.readBuffer(delay + 1);
+
+		left = doLinearInterpolation(y1.left, y2.left, fraction);
+		right = doLinearInterpolation(y1.right, y2.right, fraction);
+	}
+
+	/** clear the sidechain state: no duck, and a fresh sub-block */
+	void resetSidechain()
+	{
+		cookDuckCurve();
+		duckGain = 1.0;
+		duckTarget = 1.0;
+		duckInc = 0.0;
+		sidechainDepth = 0.2;
+		sidechainDepthTarget = 0.2;
+		sidechainDepthInc = 0.0;
+		sidechainCount = 0;
+		sidechainInputSample = 0.0;
+		sidechainInputPending = false;
+	}
+
+	/** evaluate the ducking curve once per sidechain sub-block: land on the previous targets, then ramp the wet gain
+	    (and the sidechain mod depth) to the values the detector now implies over the next numSamples samples */
+	/**
+	\param envelope detector output (linear mean square)
+	\param numSamples length of the sub-block
+	*/
+	void updateSidechainRamps(double envelope, uint32_t numSamples)
+	{
+		duckGain = duckTarget;
+		sidechainDepth = sidechainDepthTarget;
+
+		// --- linear in power from the threshold (no duck) to 12dB (16x) above it (full duck)
+		double duck = (envelope - duckThresholdPower) / (15.0 * duckThresholdPower);
+		boundValue(duck, 0.0, 1.0);
+		duckTarget = 1.0 - duck * (1.0 - duckFloorGain);
+
+		// --- the sidechain mod depth follows the RMS level; one sqrt( ) per sub-block
+		sidechainDepthTarget = doUnipolarModulationFromMin(sqrt(envelope), 0.2, 1.0);
+
+		double ramp = 1.0 / numSamples;
+		duckInc = (duckTarget - duckGain) * ramp;
+		sidechainDepthInc = (sidechainDepthTarget - sidechainDepth) * ramp;
+	}
+
+	/** frame processing: detect one sidechain sample (the aux sample if one was given, else xn) and update the
+	    ramps every kSidechainSubBlock samples */
+	inline void detectSidechainSample(double xn)
+	{
+		double sc_xn = sidechainInputPending ? sidechainInputSample : xn;
+		sidechainInputPending = false;
+
+		// --- switched off: no detection, just release the duck
+		double envelope = parameters.enableSidechain ? detector.detectEnvelope(sc_xn) : 0.0;
+
+		if (++sidechainCount == kSidechainSubBlock)
+		{
+			updateSidechainRamps(envelope, kSidechainSubBlock);
+			sidechainCount = 0;
+		}
+	}
+
+	/** block processing: detect one sub-block of the sidechain (the channel average) and set up the ramps for it */
+	/**
+	\param sidechain sidechain buffers
+	\param numChannels number of sidechain buffers
+	\param start first sample of the sub-block in each buffer
+	\param numSamples length of the sub-block, at most kSidechainSubBlock
+	*/
+	void detectSidechainBlock(const float* const* sidechain, uint32_t numChannels, uint32_t start, uint32_t numSamples)
+	{
+		double envelope = 0.0;
+		if (parameters.enableSidechain)
+		{
+			double detect[kSidechainSubBlock];
+			double scale = 1.0 / numChannels;
+			for (uint32_t n = 0; n < numSamples; n++)
+			{
+				double sum = 0.0;
+				for (uint32_t c = 0; c < numChannels; c++)
+					sum += sidechain[c][start + n];
+				detect[n] = sum * scale;
+			}
+
+			detector.detectEnvelopeBlock(detect, detect, numSamples);
+			envelope = detect[numSamples - 1];
+		}
+
+		updateSidechainRamps(envelope, numSamples);
+
+		// --- block and frame processing share the detector; start the frame count afresh
+		sidechainCount = 0;
+	}
+
+	/** one MONO sample through the tape, modulated or not */
+	inline double renderSample(double xn)
+	{
+		if (parameters.enableVarispeed)
+			return processVarispeedSample(xn);
+
+		if (isModulating())
+			return processModulatedSample(xn);
+
+		return processTapeSample(xn);
+	}
+
+	/** one stereo-linked frame through the tape, modulated or not */
+	inline void renderFrame(double xnL, double xnR, double& ynL, double& ynR)
+	{
+		if (parameters.enableVarispeed)
+			processVarispeedFrame(xnL, xnR, ynL, ynR);
+		else if (isModulating())
+			processModulatedFrame(xnL, xnR, ynL, ynR);
+		else
+			processTapeFrame(xnL, xnR, ynL, ynR);
+	}
+
+	/** the feedback term for one side of the tape: with the saturation on, the heads beyond the oversampled
+	    saturator's delay go through it and the nearer ones through the base rate saturator */
+	/**
+	\param feedback the feedback term; with the saturation on, from the heads beyond the delay only
+	\param nearFeedback the feedback term from the nearer heads (see readFeedbackLead( ))
+	\param side 0 = left (or mono), 1 = right
+	*/
+	inline double saturateFeedback(double feedback, double nearFeedback, int side)
+	{
+		if (!parameters.enableSaturation)
+			return feedback;
+
+		return feedbackSaturator[side].processAudioSample(feedback) + nearFeedbackSaturator[side].processAudioSample(nearFeedback);
+	}
+
+	/** the weighted feedback for the saturators: heads beyond the oversampled saturator's delay are read that much
+	    nearer the write head, so that the delay does not lengthen the loop; nearer heads (the unused ones at zero,
+	    a loop of one sample) are read in place for the base rate saturator; linear interpolation */
+	inline void readFeedbackLead(bool stereo, double& left, double& right, double& nearLeft, double& nearRight)
+	{
+		double lead = feedbackSaturator[0].getLatency();
+		double weightedFeedback[2][2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };	// [far/near][side]
+		for (int i = 0; i < 4; i++)
+		{
+			if (weightedFeedback_Pct[i] == 0.0)
+				continue;
+
+			bool isNear = delayInSamples[i] < lead;
+			double delay = isNear ? delayInSamples[i] : delayInSamples[i] - lead;
+			int integer = (int)delay;
+			TapeFrame y1 = delayBuffer.readBuffer(integer);
+			TapeFrame y2 = delayBuffer.readBuffer(integer + 1);
+			weightedFeedback[isNear][0] += weightedFeedback_Pct[i] * doLinearInterpolation(y1.left, y2.left, delay - integer);
+			if (stereo)
+				weightedFeedback[isNear][1] += weightedFeedback_Pct[i] * doLinearInterpolation(y1.right, y2.right, delay - integer);
+		}
+		left = weightedFeedback[0][0];
+		right = stereo ? weightedFeedback[0][1] : left;
+		nearLeft = weightedFeedback[1][0];
+		nearRight = stereo ? weightedFeedback[1][1] : nearLeft;
+	}
+
+	/** four-head tape echo: read the heads, write input plus weighted feedback */
+	inline double processTapeSample(double xn)
+	{
+		double yn = 0.0;
+		double weightedFeedbackOutput = 0.0;
+
+		for (int i = 0; i < 4; i++)
+		{
+			double delayLine = readTape(delayInSamples[i], i);
+			yn = yn + delayLine;
+			weightedFeedbackOutput = weightedFeedbackOutput + (delayLine * weightedFeedback_Pct[i]);
+		}
+
+		double nearFeedback = 0.0;
+		if (parameters.enableSaturation)
+			readFeedbackLead(false, weightedFeedbackOutput, weightedFeedbackOutput, nearFeedback, nearFeedback);
+
+		yn = yn / 4.0;
+		double dn = xn + saturateFeedback(feedbackGain * weightedFeedbackOutput, feedbackGain * nearFeedback, 0);
+		antiDenormal.apply(dn);
+		delayBuffer.writeBuffer(TapeFrame(dn, dn));
+
+		// --- done; the sidechain ducks the echoes only
+		double wet = 0.0;
+		double dry = 0.0;
+		getMixLevels(wet, dry);
+		double wetGain = duckGain;
+		duckGain += duckInc;
+		return (yn * wet) * wetGain + (xn * dry);
+	}
+
+	/** stereo-linked four-head tape echo: the same heads read both sides of the tape */
+	inline void processTapeFrame(double xnL, double xnR, double& ynL, double& ynR)
+	{
+		double yL = 0.0;
+		double yR = 0.0;
+		double weightedFeedbackL = 0.0;
+		double weightedFeedbackR = 0.0;
+
+		for (int i = 0; i < 4; i++)
+		{
+			double delayLineL = 0.0;
+			double delayLineR = 0.0;
+			readTapeFrame(delayInSamples[i], i, delayLineL, delayLineR);
+			yL = yL + delayLineL;
+			yR = yR + delayLineR;
+			weightedFeedbackL = weightedFeedbackL + (delayLineL * weightedFeedback_Pct[i]);
+			weightedFeedbackR = weightedFeedbackR + (delayLineR * weightedFeedback_Pct[i]);
+		}
+
+		double nearFeedbackL = 0.0;
+		double nearFeedbackR = 0.0;
+		if (parameters.enableSaturation)
+			readFeedbackLead(true, weightedFeedbackL, weightedFeedbackR, nearFeedbackL, nearFeedbackR);
+
+		yL = yL / 4.0;
+		yR = yR / 4.0;
+		double dnL = xnL + saturateFeedback(feedbackGain * weightedFeedbackL, feedbackGain * nearFeedbackL, 0);
+		double dnR = xnR + saturateFeedback(feedbackGain * weightedFeedbackR, feedbackGain * nearFeedbackR, 1);
+		antiDenormal.apply(dnL);
+		antiDenormal.apply(dnR);
+		delayBuffer.writeBuffer(TapeFrame(dnL, dnR));
+
+		double wet = 0.0;
+		double dry = 0.0;
+		getMixLevels(wet, dry);
+		ynL = (yL * wet) * duckGain + (xnL * dry);
+		ynR = (yR * wet) * duckGain + (xnR * dry);
+		duckGain += duckInc;
+	}
+
+	/** tape kernel: the heads are split into reads and fractions once for the block; sums in head order so it
+	    matches processTapeSample( ) bit for bit */
+	void processTapeBlock(const float* in, float* out, uint32_t numSamples)
+	{
+		int headDelay[4];
+		double headFraction[4];
+		prepareTapeHeads(headDelay, headFraction);
+
+		// --- fixed for the block; locals so the tape writes cannot force them to be reloaded
+		double oneMinusFraction[4];
+		double weight[4];
+		for (int i = 0; i < 4; i++)
+		{
+			oneMinusFraction[i] = 1.0 - headFraction[i];
+			weight[i] = weightedFeedback_Pct[i];
+		}
+		const double feedback = feedbackGain;
+		const double wet = blend;
+		const double dry = 1.0 - blend;
+		double wetGain = duckGain;
+
+		for (uint32_t n = 0; n < numSamples; n++)
+		{
+			double yn = 0.0;
+			double weightedFeedbackOutput = 0.0;
+			for (int i = 0; i < 4; i++)
+			{
+				// --- frac*y2 + (1 - frac)*y1, as in doLinearInterpolation( )
+				double delayLine = headFraction[i] * readTapeLeft(headDelay[i] + 1) + oneMinusFraction[i] * readTapeLeft(headDelay[i]);
+				yn = yn + delayLine;
+				weightedFeedbackOutput = weightedFeedbackOutput + (delayLine * weight[i]);
+			}
+
+			double xn = in[n];
+			yn = yn / 4.0;
+			double dn = xn + (feedback * weightedFeedbackOutput);
+			antiDenormal.apply(dn);
+			delayBuffer.writeBuffer(TapeFrame(dn, dn));
+
+			out[n] = (float)((yn * wet) * wetGain + (xn * dry));
+			wetGain += duckInc;
+		}
+		duckGain = wetGain;
+	}
+
+	/** stereo-linked tape kernel: the same heads read both sides of each tape frame */
+	void processTapeFrameBlock(const float* inL, const float* inR, float* outL, float* outR, uint32_t numSamples)
+	{
+		int headDelay[4];
+		double headFraction[4];
+		prepareTapeHeads(headDelay, headFraction);
+
+		// --- fixed for the block; see processTapeBlock( )
+		double oneMinusFraction[4];
+		double weight[4];
+		for (int i = 0; i < 4; i++)
+		{
+			oneMinusFraction[i] = 1.0 - headFraction[i];
+			weight[i] = weightedFeedback_Pct[i];
+		}
+		const double feedback = feedbackGain;
+		const double wet = blend;
+		const double dry = 1.0 - blend;
+		double wetGain = duckGain;
+
+		for (uint32_t n = 0; n < numSamples; n++)
+		{
+			double yL = 0.0;
+			double yR = 0.0;
+			double weightedFeedbackL = 0.0;
+			double weightedFeedbackR = 0.0;
+			for (int i = 0; i < 4; i++)
+			{
+				TapeFrame y1 = delayBuffer.readBuffer(headDelay[i]);
+				TapeFrame y2 = delayBuffer.readBuffer(headDelay[i] + 1);
+				double delayLineL = headFraction[i] * y2.left + oneMinusFraction[i] * y1.left;
+				double delayLineR = headFraction[i] * y2.right + oneMinusFraction[i] * y1.right;
+				yL = yL + delayLineL;
+				yR = yR + delayLineR;
+				weightedFeedbackL = weightedFeedbackL + (delayLineL * weight[i]);
+				weightedFeedbackR = weightedFeedbackR + (delayLineR * weight[i]);
+			}
+
+			double xnL = inL[n];
+			double xnR = inR[n];
+			yL = yL / 4.0;
+			yR = yR / 4.0;
+			double dnL = xnL + (feedback * weightedFeedbackL);
+			double dnR = xnR + (feedback * weightedFeedbackR);
+			antiDenormal.apply(dnL);
+			antiDenormal.apply(dnR);
+			delayBuffer.writeBuffer(TapeFrame(dnL, dnR));
+
+			outL[n] = (float)((yL * wet) * wetGain + (xnL * dry));
+			outR[n] = (float)((yR * wet) * wetGain + (xnR * dry));
+			wetGain += duckInc;
+		}
+		duckGain = wetGain;
+	}
+
+#if defined(FX_KERNELS_X86)
+	/** SSE2 stereo-linked tape kernel: left and right share a register all the way from the tape to the output */
+	FX_TARGET_SSE2 void processTapeFrameBlockSSE2(const float* inL, const float* inR, float* outL, float* outR, uint32_t numSamples)
+	{
+		int headDelay[4];
+		double headFraction[4];
+		prepareTapeHeads(headDelay, headFraction);
+
+		__m128d frac[4], oneMinusFrac[4], weight[4];
+		for (int i = 0; i < 4; i++)
+		{
+			frac[i] = _mm_set1_pd(headFraction[i]);
+			oneMinusFrac[i] = _mm_sub_pd(_mm_set1_pd(1.0), frac[i]);
+			weight[i] = _mm_set1_pd(weightedFeedback_Pct[i]);
+		}
+		const __m128d quarter = _mm_set1_pd(0.25);	// --- exact, so the same as yn / 4.0
+		const __m128d feedback = _mm_set1_pd(feedbackGain);
+		const __m128d wet = _mm_set1_pd(blend);
+		const __m128d dry = _mm_set1_pd(1.0 - blend);
+
+		for (uint32_t n = 0; n < numSamples; n++)
+		{
+			__m128d yn = _mm_setzero_pd();
+			__m128d wfo = _mm_setzero_pd();
+
+			// --- heads in order, as in processTapeFrame( ); lane 0 = left
+			for (int i = 0; i < 4; i++)
+			{
+				TapeFrame y1 = delayBuffer.readBuffer(headDelay[i]);
+				TapeFrame y2 = delayBuffer.readBuffer(headDelay[i] + 1);
+				__m128d head = _mm_add_pd(_mm_mul_pd(frac[i], _mm_set_pd(y2.right, y2.left)),
+										  _mm_mul_pd(oneMinusFrac[i], _mm_set_pd(y1.right, y1.left)));
+				yn = _mm_add_pd(yn, head);
+				wfo = _mm_add_pd(wfo, _mm_mul_pd(head, weight[i]));
+			}
+
+			__m128d xn = _mm_set_pd(inR[n], inL[n]);
+			__m128d dn = _mm_add_pd(xn, _mm_mul_pd(feedback, wfo));
+			double dnL = _mm_cvtsd_f64(dn);
+			double dnR = _mm_cvtsd_f64(_mm_unpackhi_pd(dn, dn));
+			antiDenormal.apply(dnL);
+			antiDenormal.apply(dnR);
+			delayBuffer.writeBuffer(TapeFrame(dnL, dnR));
+
+			__m128d y = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(_mm_mul_pd(yn, quarter), wet), _mm_set1_pd(duckGain)), _mm_mul_pd(xn, dry));
+			duckGain += duckInc;
+			outL[n] = (float)_mm_cvtsd_f64(y);
+			outR[n] = (float)_mm_cvtsd_f64(_mm_unpackhi_pd(y, y));
+		}
+	}
+#endif
+
+	/** split the head positions into the integer reads and the interpolation fractions for a block */
+	inline void prepareTapeHeads(int* headDelay, double* headFraction)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			headDelay[i] = (int)delayInSamples[i];
+			headFraction[i] = delayInSamples[i] - headDelay[i];
+		}
+	}
+
+	/** modulated tape for modes 1 and 2: the LFO (or the sidechain) wobbles head 0 around its set position,
+	    so the tape keeps recording and the feedback path is the tape's own; advances the LFO and returns
+	    the head position for this sample */
+	inline double renderModulatedHead()
+	{
+		double depth = parameters.modDepth_Pct / 200.0;
+		if (parameters.modType == 0) {
+			depth = depth * 2.0;
+		}
+
+		if (parameters.enableSidechain) {
+			depth = sidechainDepth;
+			sidechainDepth += sidechainDepthInc;
+		}
+
+		// --- glide the excursion in or out so switching the mod section never jumps the head
+		double modTarget = isModulated() ? 1.0 : 0.0;
+		double modStep = 1.0 / (kModFade_mSec * samplesPerMSec);
+		if (modAmount < modTarget)
+			modAmount = fmin(modAmount + modStep, modTarget);
+		else if (modAmount > modTarget)
+			modAmount = fmax(modAmount - modStep, modTarget);
+
+		// --- zero-mean excursion, modDepth_mSec peak to peak at full depth
+		double lfoOutput = lfo.renderModulatorOutput().normalOutput;
+		double excursion_mSec = doBipolarModulation(lfoOutput * depth, -0.5, 0.5) * modDepth_mSec[parameters.modeSelectorValue - 1][parameters.modType];
+
+		// --- the head must stay inside the tape, with room for the interpolation neighbour
+		double headPosition = delayInSamples[0] + modAmount * excursion_mSec * samplesPerMSec;
+		boundValue(headPosition, 0.0, (double)bufferLength - 2.0);
+
+		return headPosition;
+	}
+
+	/** the output mix for this sample: the blend, crossfaded to the modType's own wet/dry levels (see modWet_dB)
+	    while the head is modulated; exactly the blend otherwise */
+	inline void getMixLevels(double& wet, double& dry)
+	{
+		wet = blend;
+		dry = 1.0 - blend;
+		if (modAmount > 0.0)
+		{
+			wet += modAmount * (modWetLevel - wet);
+			dry += modAmount * (modDryLevel - dry);
+		}
+	}
+
+	/** modulated tape, mono */
+	inline double processModulatedSample(double xn)
+	{
+		double setPosition = delayInSamples[0];
+		delayInSamples[0] = renderModulatedHead();
+		double yn = processTapeSample(xn);
+		delayInSamples[0] = setPosition;
+
+		return yn;
+	}
+
+	/** modulated tape, stereo-linked: one LFO moves the head for both channels */
+	inline void processModulatedFrame(double xnL, double xnR, double& ynL, double& ynR)
+	{
+		double setPosition = delayInSamples[0];
+		delayInSamples[0] = renderModulatedHead();
+		processTapeFrame(xnL, xnR, ynL, ynR);
+		delayInSamples[0] = setPosition;
+	}
+
+	/** set the tape speed and head distances that put the heads on targetDelayInSamples[ ] */
+	/**
+	\param rethread true: go to unit speed and jump the heads there (mode change, reset); false: glide the speed
+	       from the longest head and slide the others, unless the speed would leave its range
+	*/
+	void retargetVarispeed(bool rethread)
+	{
+		// --- the longest head sets the speed
+		int longest = -1;
+		for (int i = 0; i < 4; i++)
+		{
+			if (delayTime_mSec[i] > 0.0 && (longest < 0 || targetDelayInSamples[i] > targetDelayInSamples[longest]))
+				longest = i;
+		}
+
+		// --- a head's time is the write latency plus its distance at the tape speed
+		double speed = 1.0;
+		if (!rethread && longest >= 0 && targetTapeDistance[longest] > 0.0)
+		{
+			speed = targetTapeDistance[longest] / fmax(targetDelayInSamples[longest] - kVarispeedLatency, 1.0);
+			if (speed < kMinTapeSpeed || speed > kMaxTapeSpeed)
+				speed = 1.0;
+		}
+
+		targetTapeSpeed = speed;
+		for (int i = 0; i < 4; i++)
+			targetTapeDistance[i] = delayTime_mSec[i] > 0.0 ? fmax(targetDelayInSamples[i] - kVarispeedLatency, 0.0) * speed : 0.0;
+
+		if (rethread)
+		{
+			tapeSpeed = targetTapeSpeed;
+			for (int i = 0; i < 4; i++)
+				tapeDistance[i] = targetTapeDistance[i];
+		}
+	}
+
+	/** empty the write head and re-thread the tape at unit speed */
+	void resetVarispeed()
+	{
+		memset(varispeedHistoryL, 0, sizeof(varispeedHistoryL));
+		memset(varispeedHistoryR, 0, sizeof(varispeedHistoryR));
+		varispeedHistoryIndex = 0;
+		writePhase = 0.0;
+		lastTapeInputL = 0.0;
+		lastTapeInputR = 0.0;
+		varispeedGlide = samplesPerMSec > 0.0 ? 1.0 - exp(-1.0 / (kVarispeedGlide_mSec * samplesPerMSec)) : 1.0;
+		retargetVarispeed(true);
+	}
+
+	/** one sample of the tape motor: glide the speed and slide the heads */
+	inline void glideVarispeed()
+	{
+		tapeSpeed += (targetTapeSpeed - tapeSpeed) * varispeedGlide;
+		for (int i = 0; i < 4; i++)
+			tapeDistance[i] += (targetTapeDistance[i] - tapeDistance[i]) * varispeedGlide;
+	}
+
+	/** read a head at a distance (in tape samples) behind the write head, band limited to the output rate */
+	inline void readVarispeedHead(double distance, bool stereo, double& left, double& right)
+	{
+		// --- reading faster than the tape was written decimates
+		double cutoff = tapeSpeed > 1.0 ? 1.0 / tapeSpeed : 1.0;
+		double span = kResamplingKernelHalfSpan / cutoff;
+
+		// --- delay from the newest tape sample; the kernel must stay on written tape
+		double delay = distance - writePhase;
+		boundValue(delay, span, fmax(span, getMaxTapeDelay() - span));
+
+		double weights[kResamplingKernelMaxTaps];
+		int firstTap = 0;
+		unsigned int count = varispeedKernel.getWeights(delay, cutoff, firstTap, weights);
+
+		double yL = 0.0;
+		double yR = 0.0;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			TapeFrame tap = delayBuffer.readBuffer(firstTap + (int)i);
+			yL += weights[i] * tap.left;
+			if (stereo)
+				yR += weights[i] * tap.right;
+		}
+		left = yL;
+		right = stereo ? yR : yL;
+	}
+
+	/** advance the write head by the tape speed, laying every tape sample it passes; at most kMaxTapeSpeed per call */
+	inline void writeVarispeedTape(double left, double right, bool stereo)
+	{
+		varispeedHistoryL[varispeedHistoryIndex] = left;
+		varispeedHistoryR[varispeedHistoryIndex] = right;
+		varispeedHistoryIndex = (varispeedHistoryIndex + 1) & (kVarispeedHistoryLength - 1);
+		lastTapeInputL = left;
+		lastTapeInputR = right;
+
+		// --- a slow tape holds less bandwidth than the input
+		double cutoff = tapeSpeed < 1.0 ? tapeSpeed : 1.0;
+		double weights[kResamplingKernelMaxTaps];
+		int firstTap = 0;
+
+		writePhase += tapeSpeed;
+		while (writePhase >= 1.0)
+		{
+			writePhase -= 1.0;
+
+			// --- the head passed this tape sample writePhase / tapeSpeed samples ago
+			double delay = kVarispeedLatency + writePhase / tapeSpeed;
+			unsigned int count = varispeedKernel.getWeights(delay, cutoff, firstTap, weights);
+
+			double yL = 0.0;
+			double yR = 0.0;
+			for (unsigned int i = 0; i < count; i++)
+			{
+				unsigned int index = (varispeedHistoryIndex - 1 - (unsigned int)(firstTap + (int)i)) & (kVarispeedHistoryLength - 1);
+				yL += weights[i] * varispeedHistoryL[index];
+				if (stereo)
+					yR += weights[i] * varispeedHistoryR[index];
+			}
+			delayBuffer.writeBuffer(TapeFrame(yL, stereo ? yR : yL));
+		}
+	}
+
+	/** read head i on the varispeed tape; unused (zero time) heads read the previous input, as readTape(0) does */
+	inline void readVarispeedHead(int i, double modOffset, bool stereo, double& left, double& right)
+	{
+		if (delayTime_mSec[i] <= 0.0)
+		{
+			left = lastTapeInputL;
+			right = stereo ? lastTapeInputR : lastTapeInputL;
+			return;
+		}
+
+		// --- the mod excursion is a time; the tape speed turns it into a distance
+		readVarispeedHead(tapeDistance[i] + (i == 0 ? modOffset * tapeSpeed : 0.0), stereo, left, right);
+	}
+
+	/** the weighted feedback on the varispeed tape, split and read ahead like readFeedbackLead( ): the saturator's
+	    delay is a time, the tape speed turns it into a distance; the varispeed heads are at least kVarispeedLatency
+	    away, so only the unused heads (the previous input) are near */
+	inline void readVarispeedFeedbackLead(bool stereo, double& left, double& right, double& nearLeft, double& nearRight)
+	{
+		double lead = feedbackSaturator[0].getLatency() * tapeSpeed;
+		double weightedFeedback[2][2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };	// [far/near][side]
+		for (int i = 0; i < 4; i++)
+		{
+			if (weightedFeedback_Pct[i] == 0.0)
+				continue;
+
+			bool isNear = delayTime_mSec[i] <= 0.0;
+			double delayLineL = lastTapeInputL;
+			double delayLineR = lastTapeInputR;
+			if (!isNear)
+				readVarispeedHead(fmax(tapeDistance[i] - lead, 0.0), stereo, delayLineL, delayLineR);
+
+			weightedFeedback[isNear][0] += weightedFeedback_Pct[i] * delayLineL;
+			weightedFeedback[isNear][1] += weightedFeedback_Pct[i] * delayLineR;
+		}
+		left = weightedFeedback[0][0];
+		right = stereo ? weightedFeedback[0][1] : left;
+		nearLeft = weightedFeedback[1][0];
+		nearRight = stereo ? weightedFeedback[1][1] : nearLeft;
+	}
+
+	/** varispeed tape, mono */
+	inline double processVarispeedSample(double xn)
+	{
+		glideVarispeed();
+		double modOffset = isModulating() ? renderModulatedHead() - delayInSamples[0] : 0.0;
+
+		double yn = 0.0;
+		double weightedFeedbackOutput = 0.0;
+		for (int i = 0; i < 4; i++)
+		{
+			double delayLine = 0.0;
+			double unused = 0.0;
+			readVarispeedHead(i, modOffset, false, delayLine, unused);
+			yn = yn + delayLine;
+			weightedFeedbackOutput = weightedFeedbackOutput + (delayLine * weightedFeedback_Pct[i]);
+		}
+
+		double nearFeedback = 0.0;
+		if (parameters.enableSaturation)
+			readVarispeedFeedbackLead(false, weightedFeedbackOutput, weightedFeedbackOutput, nearFeedback, nearFeedback);
+
+		yn = yn / 4.0;
+		double dn = xn + saturateFeedback(feedbackGain * weightedFeedbackOutput, feedbackGain * nearFeedback, 0);
+		antiDenormal.apply(dn);
+		writeVarispeedTape(dn, dn, false);
+
+		double wet = 0.0;
+		double dry = 0.0;
+		getMixLevels(wet, dry);
+		double wetGain = duckGain;
+		duckGain += duckInc;
+		return (yn * wet) * wetGain + (xn * dry);
+	}
+
+	/** varispeed tape, stereo-linked */
+	inline void processVarispeedFrame(double xnL, double xnR, double& ynL, double& ynR)
+	{
+		glideVarispeed();
+		double modOffset = isModulating() ? renderModulatedHead() - delayInSamples[0] : 0.0;
+
+		double yL = 0.0;
+		double yR = 0.0;
+		double weightedFeedbackL = 0.0;
+		double weightedFeedbackR = 0.0;
+		for (int i = 0; i < 4; i++)
+		{
+			double delayLineL = 0.0;
+			double delayLineR = 0.0;
+			readVarispeedHead(i, modOffset, true, delayLineL, delayLineR);
+			yL = yL + delayLineL;
+			yR = yR + delayLineR;
+			weightedFeedbackL = weightedFeedbackL + (delayLineL * weightedFeedback_Pct[i]);
+			weightedFeedbackR = weightedFeedbackR + (delayLineR * weightedFeedback_Pct[i]);
+		}
+
+		double nearFeedbackL = 0.0;
+		double nearFeedbackR = 0.0;
+		if (parameters.enableSaturation)
+			readVarispeedFeedbackLead(true, weightedFeedbackL, weightedFeedbackR, nearFeedbackL, nearFeedbackR);
+
+		yL = yL / 4.0;
+		yR = yR / 4.0;
+		double dnL = xnL + saturateFeedback(feedbackGain * weightedFeedbackL, feedbackGain * nearFeedbackL, 0);
+		double dnR = xnR + saturateFeedback(feedbackGain * weightedFeedbackR, feedbackGain * nearFeedbackR, 1);
+		antiDenormal.apply(dnL);
+		antiDenormal.apply(dnR);
+		writeVarispeedTape(dnL, dnR, true);
+
+		double wet = 0.0;
+		double dry = 0.0;
+		getMixLevels(wet, dry);
+		ynL = (yL * wet) * duckGain + (xnL * dry);
+		ynR = (yR * wet) * duckGain + (xnR * dry);
+		duckGain += duckInc;
+	}
+
+	// --- shared with MultichannelFourTapDelay
+	FourTapDelayParameters parameters; ///< object parameters
+	SuperLFO lfo;
+	AudioDetector detector;
+
+	// --- local variables used by this object
+	double sampleRate = 0.0;	///< sample rate
+
+	// --- sidechain ducking; see updateSidechainRamps( )
+	static constexpr uint32_t kSidechainSubBlock = 64;	///< samples per evaluation of the ducking curve
+	double sidechainInputSample = 0.0;	///< aux sample for the next frame
+	bool sidechainInputPending = false;	///< true when processAuxInputAudioSample( ) has set it
+	uint32_t sidechainCount = 0;		///< frame processing: samples into the current sub-block
+	double duckThresholdPower = 0.001;	///< cooked duckThreshold_dB, as mean square
+	double duckFloorGain = 0.125;		///< cooked duckRange_dB
+	double duckGain = 1.0;				///< wet gain; ramps across each sub-block
+	double duckTarget = 1.0;			///< wet gain at the end of the sub-block
+	double duckInc = 0.0;				///< per-sample step of duckGain
+	double sidechainDepth = 0.2;		///< sidechain mod depth for modes 1 and 2, ramped like duckGain
+	double sidechainDepthTarget = 0.2;
+	double sidechainDepthInc = 0.0;
+
+	double samplesPerMSec = 0.0;	///< samples per millisecond, for easy access calculation
+	double delayInSamples[4] = { 0.0, 0.0, 0.0, 0.0 };	///< double includes fractional part
+
+	// --- cooked values used by the tape path, and the targets they ramp to in block processing
+	double feedbackGain = 0.0;			///< feedback_Pct / 100
+	double blend = 0.0;					///< wet/dry blend
+	double targetFeedbackGain = 0.0;	///< ramp target for feedbackGain
+	double targetBlend = 0.0;			///< ramp target for blend
+	double targetDelayInSamples[4] = { 0.0, 0.0, 0.0, 0.0 };	///< ramp targets for delayInSamples
+	bool rampPending = false;			///< true when setParameters( ) asked for a ramp over the next block
+	double feedbackInc = 0.0;			///< per-sample block ramp increments; see beginBlockRamp( )
+	double blendInc = 0.0;
+	double delayInc[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+	// --- stereo-linked tape kernel for this CPU; see selectTapeKernel( )
+	void (FourTapDelay::*tapeFrameKernel)(const float* inL, const float* inR, float* outL, float* outR, uint32_t numSamples) = &FourTapDelay::processTapeFrameBlock;
+	double bufferLength_mSec = 0.0;	///< buffer length in mSec
+	unsigned int bufferLength = 0;	///< buffer length in samples
+	double delayTime_mSec[4] = { 0.0, 0.0, 0.0, 0.0 };
+	const double weightedFeedback_Pct[4] = { 0.0 / 10.0, 1.0 / 10.0, 2.0 / 10.0, 3.0 / 10.0 };	///< per-head feedback weights
+
+	// Modulation Variables
+	double modDepth_mSec[2][3] = { { 4.0, 5.0, 8.0 }, { 6.0, 7.0, 24.0 } };	///< peak to peak head excursion [mode][modType]
+	double modWet_dB[3] = { -3.0, 0.0, -3.0 };	///< wet level while modulated [modType]; replaces the blend
+	double modDry_dB[3] = { -3.0, -96.0, 0.0 };	///< dry level while modulated [modType]; vibrato is wet only
+	double modWetLevel = 1.0;					///< cooked modWet_dB for the current modType; see cookModLevels( )
+	double modDryLevel = 1.0;					///< cooked modDry_dB for the current modType
+	double modAmount = 0.0;						///< 0 -> 1 fade of the head excursion (and the mix levels) when the mod section is toggled
+	static constexpr double kModFade_mSec = 10.0;	///< length of that fade
+
+	// --- tail time; see getTailTime_mSec( )
+	static constexpr double kTailFloor_dB = -120.0;	///< the tail ends when the echoes are this far below the input
+	static constexpr double kMaxTailTrips = 1000.0;	///< cap on the loop trips, for a runaway (>= unity) loop gain
+
+	// --- the tape; see FOURTAPDELAY_TAPE_STORAGE and FOURTAPDELAY_TAPE_BUFFER
+	TapeBuffer delayBuffer;
+	FractionalDelayInterpolator<double> headInterpolator[2][4];	///< [side][head]; see FourTapDelayParameters::tapeInterpolation
+	TapeSaturator feedbackSaturator[2];		///< [side], oversampled; see FourTapDelayParameters::enableSaturation
+	TapeSaturator nearFeedbackSaturator[2];	///< [side], base rate, for heads nearer than its delay
+
+	// --- varispeed; see retargetVarispeed( )
+	static constexpr double kMinTapeSpeed = 1.0 / maxSamplingRatio;	///< slowest tape, relative to the output rate
+	static constexpr double kMaxTapeSpeed = maxSamplingRatio;			///< fastest tape
+	static constexpr double kVarispeedGlide_mSec = 100.0;				///< time constant of the tape motor
+	static constexpr unsigned int kVarispeedLatency = kResamplingKernelHalfSpan * maxSamplingRatio;	///< write head delay: half the widest kernel
+	static constexpr unsigned int kVarispeedHistoryLength = 512;		///< input history; holds the widest kernel past the latency
+	ResamplingKernel varispeedKernel;						///< write and read head resampler
+	double varispeedHistoryL[kVarispeedHistoryLength] = { 0.0 };	///< write head input, left
+	double varispeedHistoryR[kVarispeedHistoryLength] = { 0.0 };	///< write head input, right
+	unsigned int varispeedHistoryIndex = 0;					///< next history slot
+	double writePhase = 0.0;			///< write head position past the newest tape sample, in tape samples
+	double lastTapeInputL = 0.0;		///< previous input, for heads at zero delay
+	double lastTapeInputR = 0.0;
+	double tapeSpeed = 1.0;				///< tape samples per output sample
+	double targetTapeSpeed = 1.0;		///< where the motor is gliding to
+	double varispeedGlide = 1.0;		///< one pole coefficient for kVarispeedGlide_mSec
+	double tapeDistance[4] = { 0.0, 0.0, 0.0, 0.0 };		///< head distances behind the write head, in tape samples
+	double targetTapeDistance[4] = { 0.0, 0.0, 0.0, 0.0 };	///< where the heads are sliding to
+	AntiDenormal antiDenormal;	///< see FX_DENORMAL_INJECTION
+
+	// --- tape growth; see enableBufferGrowth( )
+	static constexpr double kBufferHeadroom_mSec = 2.0;		///< added to the longest head when sizing the tape
+	static constexpr double kBufferGrowthFactor = 1.5;		///< smallest step the tape grows by
+	static constexpr unsigned int kBufferGrowthSlice = 32768;	///< tape samples (frames x channels) copied into a grown tape per buffer
+	bool growBuffers = false;								///< true after enableBufferGrowth( )
+	double maxBufferLength_mSec = 0.0;						///< the tape never grows past this
+	std::atomic<double> requestedBufferLength_mSec{ 0.0 };	///< audio -> service thread: tape wanted, 0 = none
+	std::atomic<double> growthSampleRate{ 0.0 };			///< rate the service thread builds for; set in reset( )
+	std::atomic<GrownTape*> grownTape{ nullptr };			///< service -> audio thread: the longer tape
+	std::atomic<GrownTape*> retiredTape{ nullptr };			///< audio -> service thread: the tape it replaced
+	GrownTape* adoptingTape = nullptr;						///< audio thread: the grown tape being filled with our history
+	unsigned int adoptPending = 0;							///< frames of history still to copy into adoptingTape
+	unsigned int framesWritten = 0;							///< frames processed since the last swapInGrownBuffers( )
+};
+
+/**
+\class MultichannelFourTapDelay
+\ingroup FX-Objects
+\brief
+The MultichannelFourTapDelay object is the FourTapDelay for surround and immersive beds (e.g. 7.1.4 = 12 channels) in
+one instance: one parameter cook, one LFO and one sidechain detector (fed with the channel average) drive the heads
+of every channel.
+
+Audio I/O:
+- Processes N channels in to N channels out; set the count with setNumChannels( ) (not from the audio thread).
+- Each channel can offset all four of its heads by up to kMaxTapOffset_mSec (setChannelTapOffset( )) to decorrelate
+  the bed; with no offsets every channel is the same echo as a mono FourTapDelay.
+
+Storage:
+- structure of arrays: one tape line per channel, back to back in one allocation and sharing one write index
+- the head positions are kept per head as arrays over the channels, so the kernels run the interpolation and
+  feedback math across 2 (SSE2) or 4 (AVX2) channels at a time
+
+Control I/F:
+- Use FourTapDelayParameters structure to get/set object params.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class MultichannelFourTapDelay : public FourTapDelay
+{
+public:
+	MultichannelFourTapDelay(void) { setNumChannels(1); }	/* C-TOR */
+	~MultichannelFourTapDelay(void) { disableBufferGrowth(); }	/* D-TOR: stop the service thread before the lines go */
+
+	static constexpr double kMaxTapOffset_mSec = 50.0;	///< longest per-channel head offset; the lines are sized for it
+
+	/** set the channel count; re-creates the tape if the sample rate is already known (not realtime safe) */
+	void setNumChannels(uint32_t _numChannels)
+	{
+		// --- zero what the old layout wrote while we still know it
+		flushDelayBuffers();
+
+		numChannels = _numChannels > 0 ? _numChannels : 1;
+		channelTapOffset_mSec.resize(numChannels, 0.0);
+		headDelay.assign(4 * numChannels, 0);
+		headFraction.assign(4 * numChannels, 0.0);
+		headOneMinusFraction.assign(4 * numChannels, 1.0);
+		frameInputs.assign(numChannels, nullptr);
+		frameOutputs.assign(numChannels, nullptr);
+
+		if (sampleRate > 0.0)
+			createDelayBuffers(sampleRate, bufferLength_mSec);
+	}
+
+	/** number of channels processed */
+	uint32_t getNumChannels() { return numChannels; }
+
+	/** offset all four heads of one channel (0 to kMaxTapOffset_mSec) */
+	void setChannelTapOffset(uint32_t channel, double offset_mSec)
+	{
+		if (channel >= numChannels)
+			return;
+		boundValue(offset_mSec, 0.0, kMaxTapOffset_mSec);
+		channelTapOffset_mSec[channel] = offset_mSec;
+	}
+
+	/** per-channel head offset in mSec */
+	double getChannelTapOffset(uint32_t channel) { return channel < numChannels ? channelTapOffset_mSec[channel] : 0.0; }
+
+	/** the tail of the latest channel: every head moved back by the largest offset */
+	virtual double getTailTime_mSec()
+	{
+		double maxOffset = 0.0;
+		for (uint32_t c = 0; c < numChannels; c++)
+			maxOffset = fmax(maxOffset, channelTapOffset_mSec[c]);
+
+		return computeTailTime_mSec(maxOffset);
+	}
+
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		selectChannelKernel();
+		return FourTapDelay::reset(_sampleRate);
+	}
+
+	/** preallocation: the tape for numChannels lines at maxSampleRate; call after setNumChannels( ) */
+	virtual void reserveDelayBuffers(double maxSampleRate, double _bufferLength_mSec)
+	{
+		bufferLength_mSec = _bufferLength_mSec;
+
+		// --- same rounding as setBufferLength( ) and createDelayBuffers( )
+		double maxSamplesPerMSec = maxSampleRate / 1000.0;
+		size_t tapeLength = (size_t)getLineLength(maxSamplesPerMSec, (unsigned int)(_bufferLength_mSec * maxSamplesPerMSec) + 1) * numChannels;
+		if (tapeLength > tapeCapacity)
+		{
+			flushDelayBuffers();
+			tape.reset();
+			tape.reset(fxNewArray<TapeSample>(tapeLength));
+			tapeCapacity = tapeLength;
+			memset(&tape[0], 0, tapeCapacity * sizeof(TapeSample));
+			lineLength = 0;
+			writeIndex = 0;
+			wrapped = false;
+		}
+
+		if (sampleRate > 0.0)
+			createDelayBuffers(sampleRate, bufferLength_mSec);
+	}
+
+	/** bytes reserveDelayBuffers( ) takes from an FXArena for the current channel count */
+	virtual size_t getReserveBytes(double maxSampleRate, double _bufferLength_mSec) const
+	{
+		double maxSamplesPerMSec = maxSampleRate / 1000.0;
+		size_t tapeLength = (size_t)getLineLength(maxSamplesPerMSec, (unsigned int)(_bufferLength_mSec * maxSamplesPerMSec) + 1) * numChannels;
+		return FXArena::getAllocationBytes(tapeLength * sizeof(TapeSample));
+	}
+
+	/** creation function: one line per channel, each long enough for the longest head plus the largest offset;
+	    re-slices the reserved tape if it is long enough */
+	virtual void createDelayBuffers(double _sampleRate, double _bufferLength_mSec)
+	{
+		setBufferLength(_sampleRate, _bufferLength_mSec);
+
+		unsigned int newLineLength = getLineLength(samplesPerMSec, bufferLength);
+		size_t tapeLength = (size_t)newLineLength * numChannels;
+		if (tapeLength > tapeCapacity)
+		{
+			tape.reset();
+			tape.reset(fxNewArray<TapeSample>(tapeLength));
+			tapeCapacity = tapeLength;
+			memset(&tape[0], 0, tapeCapacity * sizeof(TapeSample));
+		}
+		else
+			flushDelayBuffers();
+
+		lineLength = newLineLength;
+		writeIndex = 0;
+		wrapped = false;
+
+		// --- head positions depend on the sample rate
+		updateDelayInSamples();
+		endParameterRamp();
+	}
+
+	/** clear every line; only what has been written needs it */
+	virtual void flushDelayBuffers()
+	{
+		if (!tape)
+			return;
+
+		// --- before the first wrap only [0, writeIndex) of each line has been written
+		if (wrapped)
+			memset(&tape[0], 0, (size_t)lineLength * numChannels * sizeof(TapeSample));
+		else if (writeIndex > 0)
+		{
+			for (uint32_t c = 0; c < numChannels; c++)
+				memset(&tape[(size_t)c * lineLength], 0, writeIndex * sizeof(TapeSample));
+		}
+
+		writeIndex = 0;
+		wrapped = false;
+	}
+
+	/** process MONO input: the sample is fed to every channel and channel 0 is returned */
+	virtual double processAudioSample(double xn)
+	{
+		float in = (float)xn;
+		float out = 0.f;
+		for (uint32_t c = 0; c < numChannels; c++)
+		{
+			frameInputs[c] = &in;
+			frameOutputs[c] = c == 0 ? &out : &frameScratch;
+		}
+		renderChannelFrame(xn);
+		return out;
+	}
+
+	/** process one frame of numChannels channels */
+	/**
+	\param inputFrame input frame
+	\param outputFrame output frame
+	\param inputChannels must be numChannels
+	\param outputChannels must be numChannels
+	\return true if processed
+	*/
+	virtual bool processAudioFrame(const float* inputFrame, float* outputFrame, uint32_t inputChannels, uint32_t outputChannels)
+	{
+		if (inputChannels != numChannels || outputChannels != numChannels)
+			return false;
+
+		double sum = 0.0;
+		for (uint32_t c = 0; c < numChannels; c++)
+		{
+			frameInputs[c] = &inputFrame[c];
+			frameOutputs[c] = &outputFrame[c];
+			sum += inputFrame[c];
+		}
+		renderChannelFrame(sum * (1.0 / numChannels));
+		return true;
+	}
+
+	/** process a block of numChannels channels */
+	/**
+	\param inputs numChannels input buffers
+	\param outputs numChannels output buffers; each may alias its own input
+	\param numSamples number of samples to process; if a ramp is pending it completes on the last sample (on the
+	       first sidechain sub-block while ducking)
+	\param sidechain aux input buffers, or nullptr to duck under the bed (one linked detector on the channel average)
+	\param numSidechainChannels number of aux input buffers
+	*/
+	void processAudioBlock(const float* const* inputs, float* const* outputs, uint32_t numSamples,
+						   const float* const* sidechain = nullptr, uint32_t numSidechainChannels = 0)
+	{
+		framesWritten += numSamples;
+		if (!isDucking())
+		{
+			renderChannelBlock(inputs, outputs, 0, numSamples);
+			return;
+		}
+
+		const float* const* detectInputs = numSidechainChannels > 0 ? sidechain : inputs;
+		uint32_t numDetectChannels = numSidechainChannels > 0 ? numSidechainChannels : numChannels;
+		for (uint32_t start = 0; start < numSamples; start += kSidechainSubBlock)
+		{
+			uint32_t length = numSamples - start < kSidechainSubBlock ? numSamples - start : kSidechainSubBlock;
+			detectSidechainBlock(detectInputs, numDetectChannels, start, length);
+			renderChannelBlock(inputs, outputs, start, length);
+		}
+	}
+
+	/** render samples start to start + numSamples - 1 of every channel with the wet gain ramp already set up */
+	void renderChannelBlock(const float* const* inputs, float* const* outputs, uint32_t start, uint32_t numSamples)
+	{
+		// --- heads fixed for the block: one head cook, then the kernel
+		if (!isModulating() && !rampPending)
+		{
+			prepareChannelHeads(delayInSamples[0]);
+			(this->*channelKernel)(inputs, outputs, start, numSamples);
+			return;
+		}
+
+		// --- moving heads: re-cook them every sample, then run the kernel for that sample
+		bool ramping = rampPending && numSamples > 0;
+		if (ramping)
+			beginBlockRamp(numSamples);
+
+		for (uint32_t n = start; n < start + numSamples; n++)
+		{
+			if (ramping)
+			{
+				// --- land exactly on the targets on the last sample
+				if (n < start + numSamples - 1)
+					stepBlockRamp();
+				else
+					endParameterRamp();
+			}
+
+			prepareChannelHeads(isModulating() ? renderModulatedHead() : delayInSamples[0]);
+			(this->*channelKernel)(inputs, outputs, n, 1);
+		}
+	}
+
+	/** pick the channel kernel for the instruction set the FX kernels are bound to; called from reset( ) */
+	void selectChannelKernel()
+	{
+		channelKernel = &MultichannelFourTapDelay::processChannelBlock;
+#if defined(FX_KERNELS_X86)
+		fxKernelISA isa = getFXKernels().isa;
+		if (isa == fxKernelISA::kAVX2)
+			channelKernel = &MultichannelFourTapDelay::processChannelBlockAVX2;
+		else if (isa == fxKernelISA::kSSE2)
+			channelKernel = &MultichannelFourTapDelay::processChannelBlockSSE2;
+#endif
+	}
+
+protected:
+	/** the multichannel tape */
+	struct GrownLines : public GrownTape
+	{
+		FXArray<TapeSample> lines = nullptr;	///< numChannels lines of lineLength samples
+		size_t capacity = 0;					///< allocated samples
+		unsigned int lineLength = 0;			///< samples per line
+		unsigned int writeIndex = 0;			///< where copyToGrownTape( ) appends
+		bool wrapped = false;					///< writeIndex has wrapped
+		uint32_t numChannels = 0;				///< channel count it was built for
+	};
+
+	/** service thread: allocate the lines for the current channel count */
+	virtual GrownTape* createGrownTape(double _sampleRate, double _bufferLength_mSec)
+	{
+		GrownLines* grown = new GrownLines;
+		grown->sampleRate = _sampleRate;
+		grown->bufferLength_mSec = _bufferLength_mSec;
+
+		// --- same rounding as setBufferLength( ) and createDelayBuffers( )
+		double grownSamplesPerMSec = _sampleRate / 1000.0;
+		grown->numChannels = numChannels;
+		grown->sliceFrames = kBufferGrowthSlice / (numChannels > 0 ? numChannels : 1);
+		grown->lineLength = getLineLength(grownSamplesPerMSec, (unsigned int)(_bufferLength_mSec * grownSamplesPerMSec) + 1);
+		grown->capacity = (size_t)grown->lineLength * grown->numChannels;
+		grown->lines.reset(fxNewArray<TapeSample>(grown->capacity));
+		memset(&grown->lines[0], 0, grown->capacity * sizeof(TapeSample));
+		return grown;
+	}
+
+	/** audio thread: samples of each line's history the grown lines take; 0 if setNumChannels( ) has changed the
+	    layout since the request */
+	virtual unsigned int getGrownTapeHistory(GrownTape& grown)
+	{
+		GrownLines& grownLines = static_cast<GrownLines&>(grown);
+		if (!tape || grownLines.numChannels != numChannels)
+			return 0;
+
+		return (lineLength < grownLines.lineLength ? lineLength : grownLines.lineLength) - 1;
+	}
+
+	/** audio thread: append count samples of every line's history to the grown lines, starting oldest samples back
+	    from the write index */
+	virtual void copyToGrownTape(GrownTape& grown, unsigned int oldest, unsigned int count)
+	{
+		GrownLines& grownLines = static_cast<GrownLines&>(grown);
+		int start = (int)writeIndex - 1 - (int)oldest;
+		if (start < 0)
+			start += lineLength;
+
+		for (uint32_t c = 0; c < numChannels; c++)
+		{
+			const TapeSample* line = &tape[(size_t)c * lineLength];
+			TapeSample* grownLine = &grownLines.lines[(size_t)c * grownLines.lineLength];
+			unsigned int readIndex = (unsigned int)start;
+			unsigned int grownIndex = grownLines.writeIndex;
+			for (unsigned int k = 0; k < count; k++)
+			{
+				grownLine[grownIndex] = line[readIndex];
+				if (++readIndex == lineLength)
+					readIndex = 0;
+				if (++grownIndex == grownLines.lineLength)
+					grownIndex = 0;
+			}
+		}
+
+		// --- count is less than a line, so this wraps at most once
+		grownLines.writeIndex += count;
+		if (grownLines.writeIndex >= grownLines.lineLength)
+		{
+			grownLines.writeIndex -= grownLines.lineLength;
+			grownLines.wrapped = true;
+		}
+	}
+
+	/** audio thread: exchange the grown lines, whose history has caught up with ours, with our tape */
+	virtual void swapGrownTape(GrownTape& grown)
+	{
+		GrownLines& grownLines = static_cast<GrownLines&>(grown);
+		std::swap(tape, grownLines.lines);
+		std::swap(tapeCapacity, grownLines.capacity);
+		std::swap(lineLength, grownLines.lineLength);
+		std::swap(writeIndex, grownLines.writeIndex);
+		std::swap(wrapped, grownLines.wrapped);
+	}
+
+	/** one frame through frameInputs/frameOutputs; the sidechain is the aux sample if one was given, else detectValue */
+	void renderChannelFrame(double detectValue)
+	{
+		// --- frame processing re-cooks every frame; no need to ramp
+		if (rampPending)
+			endParameterRamp();
+
+		if (isDucking())
+			detectSidechainSample(detectValue);
+
+		framesWritten++;
+		renderChannelBlock(&frameInputs[0], &frameOutputs[0], 0, 1);
+	}
+
+	/** split every channel's head positions into integer reads and interpolation fractions; head 0 may be modulated */
+	inline void prepareChannelHeads(double head0)
+	{
+		double maxHead = (double)lineLength - 2.0;
+		for (int i = 0; i < 4; i++)
+		{
+			double head = i == 0 ? head0 : delayInSamples[i];
+			for (uint32_t c = 0; c < numChannels; c++)
+			{
+				double position = head + channelTapOffset_mSec[c] * samplesPerMSec;
+				if (position > maxHead)
+					position = maxHead;
+
+				uint32_t k = i * numChannels + c;
+				headDelay[k] = (int)position;
+				headFraction[k] = position - headDelay[k];
+				headOneMinusFraction[k] = 1.0 - headFraction[k];
+			}
+		}
+	}
+
+	/** read channel c's line delayInSamples behind the last write */
+	inline double readLine(uint32_t c, int delayInSamples)
+	{
+		int readIndex = (int)writeIndex - 1 - delayInSamples;
+		if (readIndex < 0)
+			readIndex += lineLength;
+
+		return tape[(size_t)c * lineLength + readIndex];
+	}
+
+	/** write channel c's line at the shared write index */
+	inline void writeLine(uint32_t c, double dn)
+	{
+		antiDenormal.apply(dn);
+		tape[(size_t)c * lineLength + writeIndex] = (TapeSample)dn;
+	}
+
+	/** every line has been written for this sample */
+	inline void advanceWriteIndex()
+	{
+		if (++writeIndex == lineLength)
+		{
+			writeIndex = 0;
+			wrapped = true;
+		}
+	}
+
+	/** samples per line: the tape plus the largest offset, +1 for the interpolation neighbour of the longest head */
+	static unsigned int getLineLength(double _samplesPerMSec, unsigned int _bufferLength)
+	{
+		return _bufferLength + (unsigned int)(kMaxTapOffset_mSec * _samplesPerMSec) + 1;
+	}
+
+	/** one channel, one sample: the same math as FourTapDelay::processTapeSample( ); wet and dry are from getMixLevels( ) */
+	inline void processChannelSample(uint32_t c, const float* const* inputs, float* const* outputs, uint32_t n, double wet, double dry)
+	{
+		double yn = 0.0;
+		double weightedFeedbackOutput = 0.0;
+		for (int i = 0; i < 4; i++)
+		{
+			uint32_t k = i * numChannels + c;
+			double delayLine = doLinearInterpolation(readLine(c, headDelay[k]), readLine(c, headDelay[k] + 1), headFraction[k]);
+			yn = yn + delayLine;
+			weightedFeedbackOutput = weightedFeedbackOutput + (delayLine * weightedFeedback_Pct[i]);
+		}
+
+		double xn = inputs[c][n];
+		yn = yn / 4.0;
+		writeLine(c, xn + (feedbackGain * weightedFeedbackOutput));
+		outputs[c][n] = (float)((yn * wet) * duckGain + (xn * dry));
+	}
+
+	/** scalar channel kernel: the fallback for CPUs without SSE2/AVX2 */
+	void processChannelBlock(const float* const* inputs, float* const* outputs, uint32_t start, uint32_t numSamples)
+	{
+		double wet = 0.0;
+		double dry = 0.0;
+		getMixLevels(wet, dry);
+
+		for (uint32_t n = start; n < start + numSamples; n++)
+		{
+			for (uint32_t c = 0; c < numChannels; c++)
+				processChannelSample(c, inputs, outputs, n, wet, dry);
+			advanceWriteIndex();
+			duckGain += duckInc;
+		}
+	}
+
+#if defined(FX_KERNELS_X86)
+	/** SSE2 channel kernel: two channels per register, the rest one at a time */
+	FX_TARGET_SSE2 void processChannelBlockSSE2(const float* const* inputs, float* const* outputs, uint32_t start, uint32_t numSamples)
+	{
+		const __m128d quarter = _mm_set1_pd(0.25);	// --- exact, so the same as yn / 4.0
+		const __m128d feedback = _mm_set1_pd(feedbackGain);
+		double mixWet = 0.0;
+		double mixDry = 0.0;
+		getMixLevels(mixWet, mixDry);
+		const __m128d wet = _mm_set1_pd(mixWet);
+		const __m128d dry = _mm_set1_pd(mixDry);
+
+		for (uint32_t n = start; n < start + numSamples; n++)
+		{
+			const __m128d duck = _mm_set1_pd(duckGain);
+			uint32_t c = 0;
+			for (; c + 2 <= numChannels; c += 2)
+			{
+				__m128d yn = _mm_setzero_pd();
+				__m128d wfo = _mm_setzero_pd();
+
+				// --- heads in order; lane 0 = channel c
+				for (int i = 0; i < 4; i++)
+				{
+					uint32_t k = i * numChannels + c;
+					__m128d y1 = _mm_set_pd(readLine(c + 1, headDelay[k + 1]), readLine(c, headDelay[k]));
+					__m128d y2 = _mm_set_pd(readLine(c + 1, headDelay[k + 1] + 1), readLine(c, headDelay[k] + 1));
+					__m128d head = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(&headFraction[k]), y2),
+											  _mm_mul_pd(_mm_loadu_pd(&headOneMinusFraction[k]), y1));
+					yn = _mm_add_pd(yn, head);
+					wfo = _mm_add_pd(wfo, _mm_mul_pd(head, _mm_set1_pd(weightedFeedback_Pct[i])));
+				}
+
+				__m128d xn = _mm_set_pd(inputs[c + 1][n], inputs[c][n]);
+				__m128d dn = _mm_add_pd(xn, _mm_mul_pd(feedback, wfo));
+				writeLine(c, _mm_cvtsd_f64(dn));
+				writeLine(c + 1, _mm_cvtsd_f64(_mm_unpackhi_pd(dn, dn)));
+
+				__m128d y = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(_mm_mul_pd(yn, quarter), wet), duck), _mm_mul_pd(xn, dry));
+				outputs[c][n] = (float)_mm_cvtsd_f64(y);
+				outputs[c + 1][n] = (float)_mm_cvtsd_f64(_mm_unpackhi_pd(y, y));
+			}
+
+			for (; c < numChannels; c++)
+				processChannelSample(c, inputs, outputs, n, mixWet, mixDry);
+
+			advanceWriteIndex();
+			duckGain += duckInc;
+		}
+	}
+
+	/** AVX2 channel kernel: four channels per register, the rest one at a time */
+	FX_TARGET_AVX2 void processChannelBlockAVX2(const float* const* inputs, float* const* outputs, uint32_t start, uint32_t numSamples)
+	{
+		const __m256d quarter = _mm256_set1_pd(0.25);	// --- exact, so the same as yn / 4.0
+		const __m256d feedback = _mm256_set1_pd(feedbackGain);
+		double mixWet = 0.0;
+		double mixDry = 0.0;
+		getMixLevels(mixWet, mixDry);
+		const __m256d wet = _mm256_set1_pd(mixWet);
+		const __m256d dry = _mm256_set1_pd(mixDry);
+		double dn[4];
+		float y[4];
+
+		for (uint32_t n = start; n < start + numSamples; n++)
+		{
+			const __m256d duck = _mm256_set1_pd(duckGain);
+			uint32_t c = 0;
+			for (; c + 4 <= numChannels; c += 4)
+			{
+				__m256d yn = _mm256_setzero_pd();
+				__m256d wfo = _mm256_setzero_pd();
+
+				// --- heads in order; lane 0 = channel c
+				for (int i = 0; i < 4; i++)
+				{
+					uint32_t k = i * numChannels + c;
+					__m256d y1 = _mm256_set_pd(readLine(c + 3, headDelay[k + 3]), readLine(c + 2, headDelay[k + 2]),
+											   readLine(c + 1, headDelay[k + 1]), readLine(c, headDelay[k]));
+					__m256d y2 = _mm256_set_pd(readLine(c + 3, headDelay[k + 3] + 1), readLine(c + 2, headDelay[k + 2] + 1),
+											   readLine(c + 1, headDelay[k + 1] + 1), readLine(c, headDelay[k] + 1));
+					__m256d head = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(&headFraction[k]), y2),
+												 _mm256_mul_pd(_mm256_loadu_pd(&headOneMinusFraction[k]), y1));
+					yn = _mm256_add_pd(yn, head);
+					wfo = _mm256_add_pd(wfo, _mm256_mul_pd(head, _mm256_set1_pd(weightedFeedback_Pct[i])));
+				}
+
+				__m256d xn = _mm256_set_pd(inputs[c + 3][n], inputs[c + 2][n], inputs[c + 1][n], inputs[c][n]);
+				_mm256_storeu_pd(dn, _mm256_add_pd(xn, _mm256_mul_pd(feedback, wfo)));
+				_mm_storeu_ps(y, _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(yn, quarter), wet), duck), _mm256_mul_pd(xn, dry))));
+				for (uint32_t j = 0; j < 4; j++)
+				{
+					writeLine(c + j, dn[j]);
+					outputs[c + j][n] = y[j];
+				}
+			}
+
+			for (; c < numChannels; c++)
+				processChannelSample(c, inputs, outputs, n, mixWet, mixDry);
+
+			advanceWriteIndex();
+			duckGain += duckInc;
+		}
+	}
+#endif
+
+	uint32_t numChannels = 0;					///< channels processed
+	std::vector<double> channelTapOffset_mSec;	///< per-channel head offset
+
+	// --- per-head arrays over the channels: [head * numChannels + channel]
+	std::vector<int> headDelay;					///< integer read positions
+	std::vector<double> headFraction;			///< interpolation fractions
+	std::vector<double> headOneMinusFraction;	///< 1 - headFraction
+
+	// --- the tape: numChannels lines of lineLength samples
+	FXArray<TapeSample> tape = nullptr;			///< smart pointer will auto-delete; see fxNewArray( )
+	size_t tapeCapacity = 0;						///< allocated samples; see reserveDelayBuffers( )
+	unsigned int lineLength = 0;					///< samples per line
+	unsigned int writeIndex = 0;					///< shared by every line
+	bool wrapped = false;							///< the write index has wrapped since the last flush
 
-	double modWet_dB[3] = { -3.0, 0.0, -3.0 };
-	double modDry_dB[3] = { -3.0, -96.0, 0.0 };
+	// --- single frame/sample processing
+	std::vector<const float*> frameInputs;		///< channel pointers into the frame
+	std::vector<float*> frameOutputs;			///< channel pointers into the frame
+	float frameScratch = 0.f;					///< discarded outputs of processAudioSample( )
 
-	// --- delay buffer of doubles
-	CircularBuffer<double> delayBuffer;
+	// --- channel block kernel for this CPU; see selectChannelKernel( )
+	void (MultichannelFourTapDelay::*channelKernel)(const float* const* inputs, float* const* outputs, uint32_t start, uint32_t numSamples) = &MultichannelFourTapDelay::processChannelBlock;
 };
 
 #endif
\ No newline at end of file
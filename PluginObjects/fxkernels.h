@@ -0,0 +1,686 @@
+// -----------------------------------------------------------------------------
+//    ASPiK-Core File:  fxkernels.h
+//
+/**
+    \file   fxkernels.h
+    \brief  CPU feature detection and runtime-dispatched DSP kernels for
+    		the FX objects
+
+    		- the CPU is queried once; getFXKernels( ) binds the hot loops
+    		  (interpolated reads, direct form biquad, detector envelope,
+    		  complex multiply and multiply-accumulate, polyphase FIR) to the fastest versions the
+    		  machine supports
+    		- PluginCore::initialize( ) calls getFXKernels( ) so the binding
+    		  never happens on the audio thread
+    		- kernels that need an instruction set beyond the compiler's
+    		  baseline are marked with FX_TARGET_SSE2/FX_TARGET_AVX2 so that one binary
+    		  carries every path
+    		- every SIMD kernel is bit-exact with its scalar version except the
+    		  RMS square root in the detector (sqrt vs. pow(x, 0.5), within 1ulp)
+*/
+// -----------------------------------------------------------------------------
+#pragma once
+
+#ifndef __FXKernels__
+#define __FXKernels__
+
+#include <stdint.h>
+#include <math.h>
+
+// --- x86/x64 only; other architectures use the scalar kernels
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define FX_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// --- per-function instruction set targets (MSVC does not need them to emit AVX intrinsics)
+#if defined(FX_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FX_TARGET_SSE2 __attribute__((target("sse2")))
+#define FX_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FX_TARGET_SSE2
+#define FX_TARGET_AVX2
+#endif
+
+/**
+\struct CPUFeatures
+\ingroup FX-Objects
+\brief
+The instruction sets available on this machine (and usable by the OS).
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+struct CPUFeatures
+{
+	bool sse2 = false;		///< SSE2 (always true on x64)
+	bool avx = false;		///< AVX
+	bool avx2 = false;		///< AVX2
+	bool fma = false;		///< FMA3
+	bool avx512f = false;	///< AVX-512 Foundation
+};
+
+/**
+@detectCPUFeatures
+\ingroup FX-Functions
+
+@brief queries the CPU; use getCPUFeatures( ) instead, which only does this once
+
+\return the CPUFeatures for this machine
+*/
+inline CPUFeatures detectCPUFeatures()
+{
+	CPUFeatures features;
+#if defined(FX_KERNELS_X86)
+#if defined(_MSC_VER)
+	int info[4] = { 0 };
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	features.sse2 = (info[3] & (1 << 26)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	features.fma = (info[2] & (1 << 12)) != 0;
+
+	// --- the OS must save the YMM (and ZMM) state for AVX to be usable
+	unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+	bool ymm = (xcr0 & 0x6) == 0x6;
+	bool zmm = (xcr0 & 0xE6) == 0xE6;
+	features.avx = avx && ymm;
+	features.fma = features.fma && ymm;
+
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		features.avx2 = features.avx && (info[1] & (1 << 5)) != 0;
+		features.avx512f = zmm && (info[1] & (1 << 16)) != 0;
+	}
+#else
+	// --- GCC/Clang: these include the OS (XSAVE) checks
+	__builtin_cpu_init();
+	features.sse2 = __builtin_cpu_supports("sse2") != 0;
+	features.avx = __builtin_cpu_supports("avx") != 0;
+	features.avx2 = __builtin_cpu_supports("avx2") != 0;
+	features.fma = __builtin_cpu_supports("fma") != 0;
+	features.avx512f = __builtin_cpu_supports("avx512f") != 0;
+#endif
+#endif
+	return features;
+}
+
+/**
+@getCPUFeatures
+\ingroup FX-Functions
+
+@brief returns the CPU features, detected on the first call (thread safe)
+
+\return the CPUFeatures for this machine
+*/
+inline const CPUFeatures& getCPUFeatures()
+{
+	static const CPUFeatures features = detectCPUFeatures();
+	return features;
+}
+
+/**
+\enum fxKernelISA
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to identify the instruction set a kernel table is bound to.
+
+- enum class fxKernelISA { kScalar, kSSE2, kAVX2 };
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+enum class fxKernelISA { kScalar, kSSE2, kAVX2 };
+
+// --- define FX_KERNELS_MAX_ISA (0 = scalar, 1 = SSE2, 2 = AVX2) to cap the dispatch, e.g. for A/B testing
+#ifndef FX_KERNELS_MAX_ISA
+#define FX_KERNELS_MAX_ISA 2
+#endif
+
+// --- same limits as checkFloatUnderflow( ) in fxobjects.h
+const double kKernelSmallestPositiveFloatValue = 1.175494351e-38;
+const double kKernelSmallestNegativeFloatValue = -1.175494351e-38;
+
+/** flush values in the float denormal range to zero; the same test as checkFloatUnderflow( ) */
+inline void kernelFlushUnderflow(double& value)
+{
+	if (value > 0.0 && value < kKernelSmallestPositiveFloatValue)
+		value = 0.0;
+	else if (value < 0.0 && value > kKernelSmallestNegativeFloatValue)
+		value = 0.0;
+}
+
+// --- chunk size for kernels that need scratch space on the stack
+const uint32_t kKernelChunkSize = 64;
+
+// ------------------------------------------------------------------------------------------------------ //
+// --- scalar kernels (reference versions)
+// ------------------------------------------------------------------------------------------------------ //
+
+/** out[i] = fraction[i]*y2[i] + (1 - fraction[i])*y1[i]; fraction must be < 1.0 (see doLinearInterpolation( )) */
+inline void interpolateKernelScalar(const double* y1, const double* y2, const double* fraction, double* out, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+		out[i] = fraction[i] * y2[i] + (1.0 - fraction[i])*y1[i];
+}
+
+/** direct form biquad over a block; coeffs = { a0, a1, a2, b1, b2 }, state = { x_z1, x_z2, y_z1, y_z2 } (the
+    filterCoeff and stateReg layouts); in and out may alias; returns the storage component of the last sample */
+inline double biquadDirectKernelScalar(const double* coeffs, double* state, const double* in, double* out, uint32_t count)
+{
+	double x_z1 = state[0], x_z2 = state[1], y_z1 = state[2], y_z2 = state[3];
+	double storage = 0.0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		double xn = in[i];
+		storage = coeffs[1] * x_z1 + coeffs[2] * x_z2 - coeffs[3] * y_z1 - coeffs[4] * y_z2;
+		double yn = coeffs[0] * xn + storage;
+		kernelFlushUnderflow(yn);
+
+		x_z2 = x_z1;
+		x_z1 = xn;
+		y_z2 = y_z1;
+		y_z1 = yn;
+		out[i] = yn;
+	}
+	state[0] = x_z1; state[1] = x_z2; state[2] = y_z1; state[3] = y_z2;
+	return storage;
+}
+
+/** the envelope recursion shared by all detector kernels; rectified holds |x| (or x^2) and is overwritten with the envelope */
+inline double detectorRecursion(double* rectified, uint32_t count, double lastEnvelope, double attackCoeff, double releaseCoeff, bool clampToUnity)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		double input = rectified[i];
+		double currEnvelope = input > lastEnvelope ? attackCoeff * (lastEnvelope - input) + input
+												   : releaseCoeff * (lastEnvelope - input) + input;
+		kernelFlushUnderflow(currEnvelope);
+		if (clampToUnity)
+			currEnvelope = fmin(currEnvelope, 1.0);
+		currEnvelope = fmax(currEnvelope, 0.0);
+
+		lastEnvelope = currEnvelope;
+		rectified[i] = currEnvelope;
+	}
+	return lastEnvelope;
+}
+
+/** AudioDetector envelope over a block (linear output); squareInput for MS/RMS, rootOutput for RMS;
+    in and envelope may alias; returns the new lastEnvelope (before the square root) */
+inline double detectorEnvelopeKernelScalar(const double* in, double* envelope, uint32_t count, double lastEnvelope,
+										   double attackCoeff, double releaseCoeff, bool squareInput, bool clampToUnity, bool rootOutput)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		double input = fabs(in[i]);
+		envelope[i] = squareInput ? input * input : input;
+	}
+
+	lastEnvelope = detectorRecursion(envelope, count, lastEnvelope, attackCoeff, releaseCoeff, clampToUnity);
+
+	if (rootOutput)
+	{
+		for (uint32_t i = 0; i < count; i++)
+			envelope[i] = pow(envelope[i], 0.5);
+	}
+	return lastEnvelope;
+}
+
+/** signal[i] *= filter[i] for interleaved (real, imag) pairs, i.e. fftw_complex arrays; see complexMultiply( ) */
+inline void complexMultiplyKernelScalar(double* signal, const double* filter, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		double sr = signal[2 * i], si = signal[2 * i + 1];
+		double fr = filter[2 * i], fi = filter[2 * i + 1];
+		signal[2 * i] = (sr*fr) - (si*fi);
+		signal[2 * i + 1] = (sr*fi) + (si*fr);
+	}
+}
+
+/** acc[i] += signal[i] * filter[i] for interleaved (real, imag) pairs; the frequency domain delay line MAC of the
+    partitioned convolver. The product is rounded exactly as in complexMultiplyKernelScalar( ) before it is added */
+inline void complexMultiplyAccumulateKernelScalar(double* acc, const double* signal, const double* filter, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		double sr = signal[2 * i], si = signal[2 * i + 1];
+		double fr = filter[2 * i], fi = filter[2 * i + 1];
+		acc[2 * i] += (sr*fr) - (si*fi);
+		acc[2 * i + 1] += (sr*fi) + (si*fr);
+	}
+}
+
+/** the taps the polyphase FIR kernels sum in parallel: tap k goes to partial sum k % kPolyphaseFIRLanes */
+const uint32_t kPolyphaseFIRLanes = 8;
+
+/** reduce the partial sums of a polyphase FIR in the order every kernel uses: (s[l] + s[l + 4]) for l < 4, then
+    (0 + 2) and (1 + 3), then the two halves */
+inline double reducePolyphaseFIRLanes(const double* partial)
+{
+	double s0 = partial[0] + partial[4];
+	double s1 = partial[1] + partial[5];
+	double s2 = partial[2] + partial[6];
+	double s3 = partial[3] + partial[7];
+	return (s0 + s2) + (s1 + s3);
+}
+
+/** out[j] = sum over k of coeffs[j * coeffStride + k] * window[j * windowStride + k], for numPhases phases of length
+    taps; a windowStride of 0 runs every phase over the same window (interpolation). The taps are summed in
+    kPolyphaseFIRLanes partial sums, reduced with reducePolyphaseFIRLanes( ), and the last length % 8 taps are
+    added after that, in order, so that the SIMD versions match bit for bit */
+inline void polyphaseFIRKernelScalar(const double* coeffs, uint32_t coeffStride, const double* window, uint32_t windowStride,
+									 double* out, uint32_t numPhases, uint32_t length)
+{
+	for (uint32_t j = 0; j < numPhases; j++)
+	{
+		const double* h = &coeffs[j * coeffStride];
+		const double* x = &window[j * windowStride];
+		double partial[kPolyphaseFIRLanes] = { 0.0 };
+		uint32_t k = 0;
+		for (; k + kPolyphaseFIRLanes <= length; k += kPolyphaseFIRLanes)
+		{
+			for (uint32_t l = 0; l < kPolyphaseFIRLanes; l++)
+				partial[l] += h[k + l] * x[k + l];
+		}
+
+		double sum = reducePolyphaseFIRLanes(partial);
+		for (; k < length; k++)
+			sum += h[k] * x[k];
+		out[j] = sum;
+	}
+}
+
+#if defined(FX_KERNELS_X86)
+// ------------------------------------------------------------------------------------------------------ //
+// --- SSE2 kernels
+// ------------------------------------------------------------------------------------------------------ //
+FX_TARGET_SSE2 inline void interpolateKernelSSE2(const double* y1, const double* y2, const double* fraction, double* out, uint32_t count)
+{
+	const __m128d one = _mm_set1_pd(1.0);
+	uint32_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128d frac = _mm_loadu_pd(&fraction[i]);
+		__m128d result = _mm_add_pd(_mm_mul_pd(frac, _mm_loadu_pd(&y2[i])), _mm_mul_pd(_mm_sub_pd(one, frac), _mm_loadu_pd(&y1[i])));
+		_mm_storeu_pd(&out[i], result);
+	}
+	interpolateKernelScalar(&y1[i], &y2[i], &fraction[i], &out[i], count - i);
+}
+
+/** the feed-forward part x-terms of the direct form in SIMD (a1*x(n-1) + a2*x(n-2)), then the recursion */
+FX_TARGET_SSE2 inline double biquadDirectKernelSSE2(const double* coeffs, double* state, const double* in, double* out, uint32_t count)
+{
+	const __m128d a1 = _mm_set1_pd(coeffs[1]);
+	const __m128d a2 = _mm_set1_pd(coeffs[2]);
+	double feedForward[kKernelChunkSize + 2];
+	double storage = 0.0;
+
+	for (uint32_t start = 0; start < count; start += kKernelChunkSize)
+	{
+		uint32_t chunk = count - start < kKernelChunkSize ? count - start : kKernelChunkSize;
+
+		// --- x(n-2), x(n-1), x(n)... for this chunk (copied: in and out may alias)
+		double x[kKernelChunkSize + 2];
+		x[0] = state[1];
+		x[1] = state[0];
+		for (uint32_t i = 0; i < chunk; i++)
+			x[i + 2] = in[start + i];
+
+		uint32_t i = 0;
+		for (; i + 2 <= chunk; i += 2)
+			_mm_storeu_pd(&feedForward[i], _mm_add_pd(_mm_mul_pd(a1, _mm_loadu_pd(&x[i + 1])), _mm_mul_pd(a2, _mm_loadu_pd(&x[i]))));
+		for (; i < chunk; i++)
+			feedForward[i] = coeffs[1] * x[i + 1] + coeffs[2] * x[i];
+
+		// --- recursion, in the same operation order as the scalar kernel
+		double y_z1 = state[2], y_z2 = state[3];
+		for (i = 0; i < chunk; i++)
+		{
+			storage = feedForward[i] - coeffs[3] * y_z1 - coeffs[4] * y_z2;
+			double yn = coeffs[0] * x[i + 2] + storage;
+			kernelFlushUnderflow(yn);
+			y_z2 = y_z1;
+			y_z1 = yn;
+			out[start + i] = yn;
+		}
+
+		state[0] = x[chunk + 1];
+		state[1] = x[chunk];
+		state[2] = y_z1;
+		state[3] = y_z2;
+	}
+	return storage;
+}
+
+FX_TARGET_SSE2 inline double detectorEnvelopeKernelSSE2(const double* in, double* envelope, uint32_t count, double lastEnvelope,
+														 double attackCoeff, double releaseCoeff, bool squareInput, bool clampToUnity, bool rootOutput)
+{
+	const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	uint32_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128d x = _mm_and_pd(_mm_loadu_pd(&in[i]), absMask);
+		_mm_storeu_pd(&envelope[i], squareInput ? _mm_mul_pd(x, x) : x);
+	}
+	for (; i < count; i++)
+	{
+		double input = fabs(in[i]);
+		envelope[i] = squareInput ? input * input : input;
+	}
+
+	lastEnvelope = detectorRecursion(envelope, count, lastEnvelope, attackCoeff, releaseCoeff, clampToUnity);
+
+	if (rootOutput)
+	{
+		for (i = 0; i + 2 <= count; i += 2)
+			_mm_storeu_pd(&envelope[i], _mm_sqrt_pd(_mm_loadu_pd(&envelope[i])));
+		for (; i < count; i++)
+			envelope[i] = sqrt(envelope[i]);
+	}
+	return lastEnvelope;
+}
+
+/** one complex value per register; the sign flip makes (sr*fr) + (-(si*fi)), which rounds exactly like the subtraction */
+FX_TARGET_SSE2 inline void complexMultiplyKernelSSE2(double* signal, const double* filter, uint32_t count)
+{
+	const __m128d negateReal = _mm_set_pd(0.0, -0.0);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		__m128d s = _mm_loadu_pd(&signal[2 * i]);			// (sr, si)
+		__m128d f = _mm_loadu_pd(&filter[2 * i]);			// (fr, fi)
+		__m128d sr = _mm_unpacklo_pd(s, s);					// (sr, sr)
+		__m128d si = _mm_unpackhi_pd(s, s);					// (si, si)
+		__m128d fSwap = _mm_shuffle_pd(f, f, 1);			// (fi, fr)
+		__m128d t1 = _mm_mul_pd(sr, f);						// (sr*fr, sr*fi)
+		__m128d t2 = _mm_xor_pd(_mm_mul_pd(si, fSwap), negateReal);	// (-(si*fi), si*fr)
+		_mm_storeu_pd(&signal[2 * i], _mm_add_pd(t1, t2));
+	}
+}
+
+/** complexMultiplyKernelSSE2( ) plus the add into the accumulator */
+FX_TARGET_SSE2 inline void complexMultiplyAccumulateKernelSSE2(double* acc, const double* signal, const double* filter, uint32_t count)
+{
+	const __m128d negateReal = _mm_set_pd(0.0, -0.0);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		__m128d s = _mm_loadu_pd(&signal[2 * i]);			// (sr, si)
+		__m128d f = _mm_loadu_pd(&filter[2 * i]);			// (fr, fi)
+		__m128d sr = _mm_unpacklo_pd(s, s);					// (sr, sr)
+		__m128d si = _mm_unpackhi_pd(s, s);					// (si, si)
+		__m128d fSwap = _mm_shuffle_pd(f, f, 1);			// (fi, fr)
+		__m128d t1 = _mm_mul_pd(sr, f);						// (sr*fr, sr*fi)
+		__m128d t2 = _mm_xor_pd(_mm_mul_pd(si, fSwap), negateReal);	// (-(si*fi), si*fr)
+		_mm_storeu_pd(&acc[2 * i], _mm_add_pd(_mm_loadu_pd(&acc[2 * i]), _mm_add_pd(t1, t2)));
+	}
+}
+
+/** the eight partial sums in four registers of two */
+FX_TARGET_SSE2 inline void polyphaseFIRKernelSSE2(const double* coeffs, uint32_t coeffStride, const double* window, uint32_t windowStride,
+												  double* out, uint32_t numPhases, uint32_t length)
+{
+	for (uint32_t j = 0; j < numPhases; j++)
+	{
+		const double* h = &coeffs[j * coeffStride];
+		const double* x = &window[j * windowStride];
+		__m128d sum01 = _mm_setzero_pd();
+		__m128d sum23 = _mm_setzero_pd();
+		__m128d sum45 = _mm_setzero_pd();
+		__m128d sum67 = _mm_setzero_pd();
+		uint32_t k = 0;
+		for (; k + kPolyphaseFIRLanes <= length; k += kPolyphaseFIRLanes)
+		{
+			sum01 = _mm_add_pd(sum01, _mm_mul_pd(_mm_loadu_pd(&h[k]), _mm_loadu_pd(&x[k])));
+			sum23 = _mm_add_pd(sum23, _mm_mul_pd(_mm_loadu_pd(&h[k + 2]), _mm_loadu_pd(&x[k + 2])));
+			sum45 = _mm_add_pd(sum45, _mm_mul_pd(_mm_loadu_pd(&h[k + 4]), _mm_loadu_pd(&x[k + 4])));
+			sum67 = _mm_add_pd(sum67, _mm_mul_pd(_mm_loadu_pd(&h[k + 6]), _mm_loadu_pd(&x[k + 6])));
+		}
+
+		// --- (s0, s1) = lanes 0..3 + lanes 4..7, then (s0 + s2, s1 + s3)
+		__m128d reduced = _mm_add_pd(_mm_add_pd(sum01, sum45), _mm_add_pd(sum23, sum67));
+		double sum = _mm_cvtsd_f64(reduced) + _mm_cvtsd_f64(_mm_unpackhi_pd(reduced, reduced));
+		for (; k < length; k++)
+			sum += h[k] * x[k];
+		out[j] = sum;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------ //
+// --- AVX2 kernels
+// ------------------------------------------------------------------------------------------------------ //
+FX_TARGET_AVX2 inline void interpolateKernelAVX2(const double* y1, const double* y2, const double* fraction, double* out, uint32_t count)
+{
+	const __m256d one = _mm256_set1_pd(1.0);
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d frac = _mm256_loadu_pd(&fraction[i]);
+		__m256d result = _mm256_add_pd(_mm256_mul_pd(frac, _mm256_loadu_pd(&y2[i])), _mm256_mul_pd(_mm256_sub_pd(one, frac), _mm256_loadu_pd(&y1[i])));
+		_mm256_storeu_pd(&out[i], result);
+	}
+	interpolateKernelScalar(&y1[i], &y2[i], &fraction[i], &out[i], count - i);
+}
+
+FX_TARGET_AVX2 inline double biquadDirectKernelAVX2(const double* coeffs, double* state, const double* in, double* out, uint32_t count)
+{
+	const __m256d a1 = _mm256_set1_pd(coeffs[1]);
+	const __m256d a2 = _mm256_set1_pd(coeffs[2]);
+	double feedForward[kKernelChunkSize + 2];
+	double storage = 0.0;
+
+	for (uint32_t start = 0; start < count; start += kKernelChunkSize)
+	{
+		uint32_t chunk = count - start < kKernelChunkSize ? count - start : kKernelChunkSize;
+
+		// --- x(n-2), x(n-1), x(n)... for this chunk (copied: in and out may alias)
+		double x[kKernelChunkSize + 2];
+		x[0] = state[1];
+		x[1] = state[0];
+		for (uint32_t i = 0; i < chunk; i++)
+			x[i + 2] = in[start + i];
+
+		uint32_t i = 0;
+		for (; i + 4 <= chunk; i += 4)
+			_mm256_storeu_pd(&feedForward[i], _mm256_add_pd(_mm256_mul_pd(a1, _mm256_loadu_pd(&x[i + 1])), _mm256_mul_pd(a2, _mm256_loadu_pd(&x[i]))));
+		for (; i < chunk; i++)
+			feedForward[i] = coeffs[1] * x[i + 1] + coeffs[2] * x[i];
+
+		// --- recursion, in the same operation order as the scalar kernel
+		double y_z1 = state[2], y_z2 = state[3];
+		for (i = 0; i < chunk; i++)
+		{
+			storage = feedForward[i] - coeffs[3] * y_z1 - coeffs[4] * y_z2;
+			double yn = coeffs[0] * x[i + 2] + storage;
+			kernelFlushUnderflow(yn);
+			y_z2 = y_z1;
+			y_z1 = yn;
+			out[start + i] = yn;
+		}
+
+		state[0] = x[chunk + 1];
+		state[1] = x[chunk];
+		state[2] = y_z1;
+		state[3] = y_z2;
+	}
+	return storage;
+}
+
+FX_TARGET_AVX2 inline double detectorEnvelopeKernelAVX2(const double* in, double* envelope, uint32_t count, double lastEnvelope,
+														 double attackCoeff, double releaseCoeff, bool squareInput, bool clampToUnity, bool rootOutput)
+{
+	const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d x = _mm256_and_pd(_mm256_loadu_pd(&in[i]), absMask);
+		_mm256_storeu_pd(&envelope[i], squareInput ? _mm256_mul_pd(x, x) : x);
+	}
+	for (; i < count; i++)
+	{
+		double input = fabs(in[i]);
+		envelope[i] = squareInput ? input * input : input;
+	}
+
+	lastEnvelope = detectorRecursion(envelope, count, lastEnvelope, attackCoeff, releaseCoeff, clampToUnity);
+
+	if (rootOutput)
+	{
+		for (i = 0; i + 4 <= count; i += 4)
+			_mm256_storeu_pd(&envelope[i], _mm256_sqrt_pd(_mm256_loadu_pd(&envelope[i])));
+		for (; i < count; i++)
+			envelope[i] = sqrt(envelope[i]);
+	}
+	return lastEnvelope;
+}
+
+/** two complex values per register; addsub gives (sr*fr - si*fi, sr*fi + si*fr) */
+FX_TARGET_AVX2 inline void complexMultiplyKernelAVX2(double* signal, const double* filter, uint32_t count)
+{
+	uint32_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256d s = _mm256_loadu_pd(&signal[2 * i]);		// (sr0, si0, sr1, si1)
+		__m256d f = _mm256_loadu_pd(&filter[2 * i]);		// (fr0, fi0, fr1, fi1)
+		__m256d sr = _mm256_movedup_pd(s);					// (sr0, sr0, sr1, sr1)
+		__m256d si = _mm256_permute_pd(s, 0xF);				// (si0, si0, si1, si1)
+		__m256d fSwap = _mm256_permute_pd(f, 0x5);			// (fi0, fr0, fi1, fr1)
+		_mm256_storeu_pd(&signal[2 * i], _mm256_addsub_pd(_mm256_mul_pd(sr, f), _mm256_mul_pd(si, fSwap)));
+	}
+	complexMultiplyKernelScalar(&signal[2 * i], &filter[2 * i], count - i);
+}
+
+/** two complex values per register, as complexMultiplyKernelAVX2( ) */
+FX_TARGET_AVX2 inline void complexMultiplyAccumulateKernelAVX2(double* acc, const double* signal, const double* filter, uint32_t count)
+{
+	uint32_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256d s = _mm256_loadu_pd(&signal[2 * i]);		// (sr0, si0, sr1, si1)
+		__m256d f = _mm256_loadu_pd(&filter[2 * i]);		// (fr0, fi0, fr1, fi1)
+		__m256d sr = _mm256_movedup_pd(s);					// (sr0, sr0, sr1, sr1)
+		__m256d si = _mm256_permute_pd(s, 0xF);				// (si0, si0, si1, si1)
+		__m256d fSwap = _mm256_permute_pd(f, 0x5);			// (fi0, fr0, fi1, fr1)
+		__m256d product = _mm256_addsub_pd(_mm256_mul_pd(sr, f), _mm256_mul_pd(si, fSwap));
+		_mm256_storeu_pd(&acc[2 * i], _mm256_add_pd(_mm256_loadu_pd(&acc[2 * i]), product));
+	}
+	complexMultiplyAccumulateKernelScalar(&acc[2 * i], &signal[2 * i], &filter[2 * i], count - i);
+}
+
+/** the eight partial sums in two registers of four */
+FX_TARGET_AVX2 inline void polyphaseFIRKernelAVX2(const double* coeffs, uint32_t coeffStride, const double* window, uint32_t windowStride,
+												  double* out, uint32_t numPhases, uint32_t length)
+{
+	for (uint32_t j = 0; j < numPhases; j++)
+	{
+		const double* h = &coeffs[j * coeffStride];
+		const double* x = &window[j * windowStride];
+		__m256d sum0123 = _mm256_setzero_pd();
+		__m256d sum4567 = _mm256_setzero_pd();
+		uint32_t k = 0;
+		for (; k + kPolyphaseFIRLanes <= length; k += kPolyphaseFIRLanes)
+		{
+			sum0123 = _mm256_add_pd(sum0123, _mm256_mul_pd(_mm256_loadu_pd(&h[k]), _mm256_loadu_pd(&x[k])));
+			sum4567 = _mm256_add_pd(sum4567, _mm256_mul_pd(_mm256_loadu_pd(&h[k + 4]), _mm256_loadu_pd(&x[k + 4])));
+		}
+
+		// --- (s0, s1, s2, s3), then (s0 + s2, s1 + s3)
+		__m256d s = _mm256_add_pd(sum0123, sum4567);
+		__m128d reduced = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+		double sum = _mm_cvtsd_f64(reduced) + _mm_cvtsd_f64(_mm_unpackhi_pd(reduced, reduced));
+		for (; k < length; k++)
+			sum += h[k] * x[k];
+		out[j] = sum;
+	}
+}
+#endif
+
+/**
+\struct FXKernels
+\ingroup FX-Objects
+\brief
+Table of runtime-dispatched DSP kernels; see the scalar versions above for the exact contracts.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+struct FXKernels
+{
+	fxKernelISA isa = fxKernelISA::kScalar;	///< instruction set the table is bound to
+
+	void(*interpolate)(const double* y1, const double* y2, const double* fraction, double* out, uint32_t count) = interpolateKernelScalar;
+	double(*biquadDirect)(const double* coeffs, double* state, const double* in, double* out, uint32_t count) = biquadDirectKernelScalar;
+	double(*detectorEnvelope)(const double* in, double* envelope, uint32_t count, double lastEnvelope,
+							  double attackCoeff, double releaseCoeff, bool squareInput, bool clampToUnity, bool rootOutput) = detectorEnvelopeKernelScalar;
+	void(*complexMultiply)(double* signal, const double* filter, uint32_t count) = complexMultiplyKernelScalar;
+	void(*complexMultiplyAccumulate)(double* acc, const double* signal, const double* filter, uint32_t count) = complexMultiplyAccumulateKernelScalar;
+	void(*polyphaseFIR)(const double* coeffs, uint32_t coeffStride, const double* window, uint32_t windowStride,
+						double* out, uint32_t numPhases, uint32_t length) = polyphaseFIRKernelScalar;
+};
+
+/**
+@bindFXKernels
+\ingroup FX-Functions
+
+@brief fills a kernel table with the fastest versions this CPU supports, up to FX_KERNELS_MAX_ISA
+
+\param cpu the CPU features
+\return the bound table
+*/
+inline FXKernels bindFXKernels(const CPUFeatures& cpu)
+{
+	FXKernels kernels;
+#if defined(FX_KERNELS_X86)
+	if (cpu.sse2 && FX_KERNELS_MAX_ISA >= 1)
+	{
+		kernels.isa = fxKernelISA::kSSE2;
+		kernels.interpolate = interpolateKernelSSE2;
+		kernels.biquadDirect = biquadDirectKernelSSE2;
+		kernels.detectorEnvelope = detectorEnvelopeKernelSSE2;
+		kernels.complexMultiply = complexMultiplyKernelSSE2;
+		kernels.complexMultiplyAccumulate = complexMultiplyAccumulateKernelSSE2;
+		kernels.polyphaseFIR = polyphaseFIRKernelSSE2;
+	}
+	if (cpu.avx2 && FX_KERNELS_MAX_ISA >= 2)
+	{
+		kernels.isa = fxKernelISA::kAVX2;
+		kernels.interpolate = interpolateKernelAVX2;
+		kernels.biquadDirect = biquadDirectKernelAVX2;
+		kernels.detectorEnvelope = detectorEnvelopeKernelAVX2;
+		kernels.complexMultiply = complexMultiplyKernelAVX2;
+		kernels.complexMultiplyAccumulate = complexMultiplyAccumulateKernelAVX2;
+		kernels.polyphaseFIR = polyphaseFIRKernelAVX2;
+	}
+#endif
+	return kernels;
+}
+
+/**
+@getFXKernels
+\ingroup FX-Functions
+
+@brief returns the kernel table, detecting the CPU and binding it on the first call (thread safe);
+call once from a non-realtime thread (PluginCore::initialize( ) does) so the audio thread never pays for it
+
+\return the bound kernel table
+*/
+inline const FXKernels& getFXKernels()
+{
+	static const FXKernels kernels = bindFXKernels(getCPUFeatures());
+	return kernels;
+}
+
+#endif
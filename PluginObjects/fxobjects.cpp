@@ -1033,15 +1033,15 @@ void FastFFT::destroyFFTW()
 	if (plan_backward)
 		fftw_destroy_plan(plan_backward);
 
-	if (fft_input)
-		fftw_free(fft_input);
-	if (fft_result)
-		fftw_free(fft_result);
-
-	if (ifft_input)
-		fftw_free(ifft_input);
-	if (ifft_result)
-		fftw_free(ifft_result);
+	plan_forward = nullptr;
+	plan_backward = nullptr;
+
+	// --- arrays are arena slices (see fxNewArray); null them so a re-initialize cannot free twice
+	fxDeleteArray((double*)fft_input);
+	fxDeleteArray((double*)fft_result);
+	fxDeleteArray((double*)ifft_input);
+	fxDeleteArray((double*)ifft_result);
+	fft_input = fft_result = ifft_input = ifft_result = nullptr;
 #endif
 }
 
@@ -1062,10 +1062,8 @@ void FastFFT::initialize(unsigned int _frameLength, windowType _window)
 	window = _window;
 	windowGainCorrection = 0.0;
 
-	if (windowBuffer)
-		delete windowBuffer;
-
-	windowBuffer = new double[frameLength];
+	fxDeleteArray(windowBuffer);
+	windowBuffer = fxNewArray<double>(frameLength);
 	memset(&windowBuffer[0], 0, frameLength * sizeof(double));
 
 
@@ -1130,11 +1128,11 @@ void FastFFT::initialize(unsigned int _frameLength, windowType _window)
 	windowGainCorrection = 1.0 / windowGainCorrection;
 
 	destroyFFTW();
-	fft_input = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-	fft_result = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
+	fft_input = (fftw_complex*)fxNewArray<double>(2 * frameLength);
+	fft_result = (fftw_complex*)fxNewArray<double>(2 * frameLength);
 
-	ifft_input =  (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-	ifft_result = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
+	ifft_input =  (fftw_complex*)fxNewArray<double>(2 * frameLength);
+	ifft_result = (fftw_complex*)fxNewArray<double>(2 * frameLength);
 
 	plan_forward = fftw_plan_dft_1d(frameLength, fft_input, fft_result, FFTW_FORWARD, FFTW_ESTIMATE);
 	plan_backward = fftw_plan_dft_1d(frameLength, ifft_input, ifft_result, FFTW_BACKWARD, FFTW_ESTIMATE);
@@ -1206,12 +1204,13 @@ void PhaseVocoder::destroyFFTW()
 	if (plan_backward)
 		fftw_destroy_plan(plan_backward);
 
-	if (fft_input)
-		fftw_free(fft_input);
-	if (fft_result)
-		fftw_free(fft_result);
-	if (ifft_result)
-		fftw_free(ifft_result);
+	plan_forward = nullptr;
+	plan_backward = nullptr;
+
+	fxDeleteArray((double*)fft_input);
+	fxDeleteArray((double*)fft_result);
+	fxDeleteArray((double*)ifft_result);
+	fft_input = fft_result = ifft_result = nullptr;
 }
 
 /**
@@ -1242,15 +1241,12 @@ void PhaseVocoder::initialize(unsigned int _frameLength, unsigned int _hopSize,
 	//     NOTE: input and output buffers are circular, others are linear
 	//
 	// --- input buffer, for processing the x(n) timeline
-	if (inputBuffer)
-		delete inputBuffer;
-
-	inputBuffer = new double[frameLength];
+	fxDeleteArray(inputBuffer);
+	inputBuffer = fxNewArray<double>(frameLength);
 	memset(&inputBuffer[0], 0, frameLength * sizeof(double));
 
 	// --- output buffer, for processing the y(n) timeline and accumulating frames
-	if (outputBuffer)
-		delete outputBuffer;
+	fxDeleteArray(outputBuffer);
 
 	// --- the output buffer is declared as 2x the normal frame size
 	//     to accomodate time-stretching/pitch shifting; you can increase the size
@@ -1259,15 +1255,13 @@ void PhaseVocoder::initialize(unsigned int _frameLength, unsigned int _hopSize,
 	//     (not sure why you would do this - and it will surely affect CPU performance)
 	//     NOTE: the length of the buffer is only to accomodate accumulations
 	//           it does not stretch time or change causality on its own
-	outputBuffer = new double[frameLength * 4];
+	outputBuffer = fxNewArray<double>(frameLength * 4);
 	memset(&outputBuffer[0], 0, (frameLength*4.0) * sizeof(double));
 	wrapMaskOut = (frameLength*4.0) - 1;
 
 	// --- fixed window buffer
-	if (windowBuffer)
-		delete windowBuffer;
-
-	windowBuffer = new double[frameLength];
+	fxDeleteArray(windowBuffer);
+	windowBuffer = fxNewArray<double>(frameLength);
 	memset(&windowBuffer[0], 0, frameLength * sizeof(double));
 
 	// --- this is from Reiss & McPherson's code
@@ -1348,9 +1342,9 @@ void PhaseVocoder::initialize(unsigned int _frameLength, unsigned int _hopSize,
 
 #ifdef HAVE_FFTW
 	destroyFFTW();
-	fft_input = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-	fft_result = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-	ifft_result = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
+	fft_input = (fftw_complex*)fxNewArray<double>(2 * frameLength);
+	fft_result = (fftw_complex*)fxNewArray<double>(2 * frameLength);
+	ifft_result = (fftw_complex*)fxNewArray<double>(2 * frameLength);
 
 	plan_forward = fftw_plan_dft_1d(frameLength, fft_input, fft_result, FFTW_FORWARD, FFTW_ESTIMATE);
 	plan_backward = fftw_plan_dft_1d(frameLength, fft_result, ifft_result, FFTW_BACKWARD, FFTW_ESTIMATE);
@@ -19,9 +19,24 @@
 
 #include <memory>
 #include <math.h>
+#include <string.h>
 #include "guiconstants.h"
 #include "filters.h"
+#include "fxkernels.h"
 #include <time.h>       /* time */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// --- for the mirrored (double-mapped) ring buffer
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 /** @file fxobjects.h
 \brief HELLO LOOK
@@ -70,6 +85,51 @@ inline bool checkFloatUnderflow(double& value)
 	return retValue;
 }
 
+// --- anti-denormal noise for the feedback loops: needed only where DenormalGuard (pluginstructures.h) cannot
+//     switch the FPU to flush-to-zero; define FX_DENORMAL_INJECTION before including this file to override
+#ifndef FX_DENORMAL_INJECTION
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__aarch64__)
+#define FX_DENORMAL_INJECTION 0
+#else
+#define FX_DENORMAL_INJECTION 1
+#endif
+#endif
+
+const double kAntiDenormalLevel = 1.0e-20;	///< peak of the injected noise: -400dBFS, far above the denormal range
+
+/**
+\struct AntiDenormal
+\ingroup FX-Objects
+\brief
+Inaudible noise for feedback loops that must not decay into the denormal range when the FPU cannot flush them.
+
+- apply( ) adds kAntiDenormalLevel white noise (a 32-bit LCG) to the value written back into the loop; noise rather than
+  DC so that it survives the high pass and low pass filters inside the loops
+- compiles to nothing when FX_DENORMAL_INJECTION is 0 (x86 and AArch64, where DenormalGuard sets flush-to-zero)
+- one per loop; copying it is fine
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+struct AntiDenormal
+{
+#if FX_DENORMAL_INJECTION
+	/** add the noise to a value about to be written into a feedback loop */
+	inline void apply(double& value)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		value += (int32_t)seed * (kAntiDenormalLevel / 2147483648.0);
+	}
+
+	uint32_t seed = 22222;	///< LCG state
+#else
+	/** flush-to-zero handles it: nothing to do */
+	inline void apply(double& value) {}
+#endif
+};
+
 /**
 @doLinearInterpolation
 \ingroup FX-Functions
@@ -148,6 +208,93 @@ inline double doLagrangeInterpolation(double* x, double* y, int n, double xbar)
 	return (fx);
 }
 
+/**
+@getLagrange4Coefficients
+\ingroup FX-Functions
+
+@brief calculates the four weights of a 3rd order Lagrange interpolator for taps at x = -1, 0, 1, 2; the same result
+as doLagrangeInterpolation( ) with n = 4 on those points, without the O(n^2) divisions
+
+\param fraction - the interpolation location between the taps at x = 0 and x = 1, on the range [0.0, 1.0)
+\param coefficients - array of four weights for the taps at x = -1, 0, 1, 2
+*/
+inline void getLagrange4Coefficients(double fraction, double* coefficients)
+{
+	// --- polynomial coefficients by power (rows) and tap (columns); each weight is a Horner evaluation,
+	//     and the four of them run side by side in SIMD registers
+	static const double p[4][4] = {
+		{ 0.0, 1.0, 0.0, 0.0 },
+		{ -1.0 / 3.0, -1.0 / 2.0, 1.0, -1.0 / 6.0 },
+		{ 1.0 / 2.0, -1.0, 1.0 / 2.0, 0.0 },
+		{ -1.0 / 6.0, 1.0 / 2.0, -1.0 / 2.0, 1.0 / 6.0 } };
+
+	for (int i = 0; i < 4; i++)
+		coefficients[i] = ((p[3][i] * fraction + p[2][i]) * fraction + p[1][i]) * fraction + p[0][i];
+}
+
+/**
+@getHermite4Coefficients
+\ingroup FX-Functions
+
+@brief calculates the four weights of a cubic Hermite (Catmull-Rom) interpolator for taps at x = -1, 0, 1, 2; it
+passes through the taps with a continuous slope, so it is smoother than Lagrange at a similar cost
+
+\param fraction - the interpolation location between the taps at x = 0 and x = 1, on the range [0.0, 1.0)
+\param coefficients - array of four weights for the taps at x = -1, 0, 1, 2
+*/
+inline void getHermite4Coefficients(double fraction, double* coefficients)
+{
+	// --- same layout as getLagrange4Coefficients( )
+	static const double p[4][4] = {
+		{ 0.0, 1.0, 0.0, 0.0 },
+		{ -1.0 / 2.0, 0.0, 1.0 / 2.0, 0.0 },
+		{ 1.0, -5.0 / 2.0, 2.0, -1.0 / 2.0 },
+		{ -1.0 / 2.0, 3.0 / 2.0, -3.0 / 2.0, 1.0 / 2.0 } };
+
+	for (int i = 0; i < 4; i++)
+		coefficients[i] = ((p[3][i] * fraction + p[2][i]) * fraction + p[1][i]) * fraction + p[0][i];
+}
+
+/**
+@getThiranCoefficient
+\ingroup FX-Functions
+
+@brief calculates the coefficient of a 1st order Thiran allpass H(z) = (a + z^-1)/(1 + a z^-1), whose low frequency
+delay is fractionalDelay samples; best behaved for delays on the range [0.5, 1.5)
+
+\param fractionalDelay - the allpass delay in samples
+\return the allpass coefficient a
+*/
+inline double getThiranCoefficient(double fractionalDelay)
+{
+	return (1.0 - fractionalDelay) / (1.0 + fractionalDelay);
+}
+
+/**
+@besselI0
+\ingroup FX-Functions
+
+@brief zeroth order modified Bessel function of the first kind, for Kaiser windows
+
+\param x - the argument
+\return I0(x)
+*/
+inline double besselI0(double x)
+{
+	// --- power series; the terms fall off quickly for the window shapes we use
+	double sum = 1.0;
+	double term = 1.0;
+	double halfX = x / 2.0;
+	for (int k = 1; k < 50; k++)
+	{
+		term *= (halfX / k) * (halfX / k);
+		sum += term;
+		if (term < sum * 1.0e-16)
+			break;
+	}
+	return sum;
+}
+
 
 /**
 @boundValue
@@ -1202,6 +1349,28 @@ public:
 	}
 };
 
+/**
+\class IBufferGrowthClient
+\ingroup Interfaces
+\brief
+Use this interface for objects whose buffers grow on demand: the audio thread posts a request and keeps running on the
+buffer it has, and FXBufferGrowthService calls serviceBufferGrowth( ) on its own thread to allocate the bigger buffer and
+to free the one it replaced. How the request and the new buffer are handed over (lock-free) is up to the object.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class IBufferGrowthClient
+{
+public:
+	virtual ~IBufferGrowthClient() {}
+
+	/** called on the FXBufferGrowthService thread: allocate what was requested, free what was retired */
+	virtual void serviceBufferGrowth() = 0;
+};
+
 /**
 \struct SignalGenData
 \ingroup Structures
@@ -1395,6 +1564,24 @@ public:
 	*/
 	virtual double processAudioSample(double xn);
 
+	/** process a block of input through the biquad; the direct form runs the CPU-dispatched kernel (see fxkernels.h) */
+	/**
+	\param in input buffer
+	\param out output buffer; may be the same buffer as in
+	\param numSamples number of samples to process
+	*/
+	void processAudioBlock(const double* in, double* out, uint32_t numSamples)
+	{
+		if (parameters.biquadCalcType == biquadAlgorithm::kDirect)
+		{
+			storageComponent = getFXKernels().biquadDirect(&coeffArray[0], &stateArray[0], in, out, numSamples);
+			return;
+		}
+
+		for (uint32_t i = 0; i < numSamples; i++)
+			out[i] = processAudioSample(in[i]);
+	}
+
 	/** get parameters: note use of custom structure for passing param data */
 	/**
 	\return BiquadParameters custom data structure
@@ -1799,6 +1986,7 @@ struct AudioDetectorParameters
 		detectMode = params.detectMode;
 		detect_dB = params.detect_dB;
 		clampToUnityMax = params.clampToUnityMax;
+		fastMode = params.fastMode;
 		return *this;
 	}
 
@@ -1808,6 +1996,7 @@ struct AudioDetectorParameters
 	unsigned int  detectMode = 0;///< detect mode, see TLD_ constants above
 	bool detect_dB = false;	///< detect in dB  DEFAULT  = false (linear NOT log)
 	bool clampToUnityMax = true;///< clamp output to 1.0 (set false for true log detectors)
+	bool fastMode = false;		///< keep the envelope linear (|x| or x^2); dB via fastLog2( ) only on output
 };
 
 /**
@@ -1823,6 +2012,12 @@ Audio I/O:
 Control I/F:
 - Use AudioDetectorParameters structure to get/set object params.
 
+Fast mode (AudioDetectorParameters::fastMode):
+- the envelope stays in the detection domain: |x| for PEAK, x^2 for MS and RMS; no per-sample sqrt( ) or log( )
+- consumers that can work on the envelope call detectEnvelope( ) or detectEnvelopeBlock( ) and convert with
+  envelopeTo_dB( ) or envelopeToLinear( ) only when they need to; processAudioSample( ) does that conversion for them
+- dB values come from fastLog2( ) and are within FAST_LOG2_MAX_ERROR*6.02dB of 20*log10( )
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
@@ -1853,6 +2048,12 @@ public:
 	*/
 	virtual double processAudioSample(double xn)
 	{
+		if (audioDetectorParameters.fastMode)
+		{
+			double envelope = detectEnvelope(xn);
+			return audioDetectorParameters.detect_dB ? envelopeTo_dB(envelope) : envelopeToLinear(envelope);
+		}
+
 		// --- all modes do Full Wave Rectification
 		double input = fabs(xn);
 
@@ -1901,6 +2102,100 @@ public:
 		return 20.0*log10(currEnvelope);
 	}
 
+	/** detect a block; the envelope runs on the CPU-dispatched kernel (see fxkernels.h) */
+	/**
+	\param in input buffer
+	\param out detector output, in dB or linear as set in the parameters; may be the same buffer as in
+	\param numSamples number of samples to process
+	*/
+	void processAudioBlock(const double* in, double* out, uint32_t numSamples)
+	{
+		if (audioDetectorParameters.fastMode)
+		{
+			detectEnvelopeBlock(in, out, numSamples);
+			if (audioDetectorParameters.detect_dB)
+			{
+				for (uint32_t i = 0; i < numSamples; i++)
+					out[i] = envelopeTo_dB(out[i]);
+			}
+			else if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
+			{
+				for (uint32_t i = 0; i < numSamples; i++)
+					out[i] = sqrt(out[i]);
+			}
+			return;
+		}
+
+		bool squareInput = audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_MS ||
+						   audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS;
+
+		lastEnvelope = getFXKernels().detectorEnvelope(in, out, numSamples, lastEnvelope, attackTime, releaseTime, squareInput,
+													   audioDetectorParameters.clampToUnityMax,
+													   audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS);
+		if (!audioDetectorParameters.detect_dB)
+			return;
+
+		for (uint32_t i = 0; i < numSamples; i++)
+			out[i] = out[i] <= 0 ? -96.0 : 20.0*log10(out[i]);
+	}
+
+	/** fast mode core: run the envelope on one sample and return it in the detection domain (|x|, or x^2 for
+	    MS and RMS); works in either mode, but shares its state with processAudioSample( ) */
+	/**
+	\param xn input
+	\return the envelope
+	*/
+	inline double detectEnvelope(double xn)
+	{
+		double input = fabs(xn);
+		if (audioDetectorParameters.detectMode != TLD_AUDIO_DETECT_MODE_PEAK)
+			input *= input;
+
+		// --- a convex mix of non-negative values: never (-), so only the underflow needs checking
+		double coeff = input > lastEnvelope ? attackTime : releaseTime;
+		double currEnvelope = coeff * (lastEnvelope - input) + input;
+		if (currEnvelope < FLT_MIN_PLUS)
+			currEnvelope = 0.0;
+
+		if (audioDetectorParameters.clampToUnityMax && currEnvelope > 1.0)
+			currEnvelope = 1.0;
+
+		lastEnvelope = currEnvelope;
+		return currEnvelope;
+	}
+
+	/** fast mode core over a block: the envelope in the detection domain; runs on the CPU-dispatched kernel */
+	/**
+	\param in input buffer
+	\param envelope envelope output; may be the same buffer as in
+	\param numSamples number of samples to process
+	*/
+	void detectEnvelopeBlock(const double* in, double* envelope, uint32_t numSamples)
+	{
+		bool squareInput = audioDetectorParameters.detectMode != TLD_AUDIO_DETECT_MODE_PEAK;
+		lastEnvelope = getFXKernels().detectorEnvelope(in, envelope, numSamples, lastEnvelope, attackTime, releaseTime, squareInput,
+													   audioDetectorParameters.clampToUnityMax, false);
+	}
+
+	/** the last envelope value, in the detection domain */
+	double getEnvelope() { return lastEnvelope; }
+
+	/** convert an envelope to dB with fastLog2( ); RMS needs no sqrt( ): 10*log10(x^2) */
+	inline double envelopeTo_dB(double envelope)
+	{
+		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
+			return fastPower2dB(envelope);
+		return fastRaw2dB(envelope);
+	}
+
+	/** convert an envelope to the linear detector output (the sqrt( ) for RMS) */
+	inline double envelopeToLinear(double envelope)
+	{
+		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
+			return sqrt(envelope);
+		return envelope;
+	}
+
 	/** get parameters: note use of custom structure for passing param data */
 	/**
 	\return AudioDetectorParameters custom data structure
@@ -2057,6 +2352,7 @@ public:
 		AudioDetectorParameters detectorParams = detector.getParameters();
 		detectorParams.clampToUnityMax = false;
 		detectorParams.detect_dB = true;
+		detectorParams.fastMode = true;	// --- linear envelope, fastLog2( ) for the gain computer
 		detector.setParameters(detectorParams);
 		return true;
 	}
@@ -2086,6 +2382,9 @@ public:
 	*/
 	void setParameters(const DynamicsProcessorParameters& _parameters)
 	{
+		if (_parameters.outputGain_dB != parameters.outputGain_dB)
+			makeupGain = pow(10.0, _parameters.outputGain_dB / 20.0);
+
 		parameters = _parameters;
 
 		AudioDetectorParameters detectorParams = detector.getParameters();
@@ -2118,9 +2417,6 @@ public:
 		// --- compute gain
 		double gr = computeGain(detect_dB);
 
-		// --- makeup gain
-		double makeupGain = pow(10.0, parameters.outputGain_dB / 20.0);
-
 		// --- do DCA + makeup gain
 		return xn * gr * makeupGain;
 	}
@@ -2128,6 +2424,7 @@ public:
 protected:
 	DynamicsProcessorParameters parameters; ///< object parameters
 	AudioDetector detector; ///< the sidechain audio detector
+	double makeupGain = 1.0; ///< outputGain_dB as a raw gain, cooked in setParameters( )
 
 	// --- storage for sidechain audio input (mono only)
 	double sidechainInputSample = 0.0; ///< storage for sidechain sample
@@ -2217,1148 +2514,1675 @@ protected:
 	}
 };
 
+// --- FX object memory: every buffer is cache-line aligned, and may come from a per-instance FXArena
+const size_t kFXCacheLineSize = 64;			///< alignment of every fxNewArray( ) allocation
+const size_t kFXArenaPageSize = 4096;		///< alignment of the arena itself
+const size_t kFXArenaHugePageSize = 2097152;	///< 2MB huge pages (x86-64 and AArch64 Linux)
+
 /**
-\class LinearBuffer
+\class FXArena
 \ingroup FX-Objects
 \brief
-The LinearBuffer object implements a linear buffer of type T. It allows easy wrapping of a smart pointer object.
-
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+The FXArena object is a per-instance bump allocator for the FX object buffers: one block, sized up front, that the
+buffers of every object in a plugin instance are carved from.
+
+Operation:
+- reserve( ) allocates the block once (page aligned; on Linux it is mapped, so pages that are never touched cost no
+  memory); with useHugePages it asks for 2MB pages (MAP_HUGETLB, else transparent huge pages via madvise)
+- open an FXArenaScope on it while the objects create their buffers; fxNewArray( ) then takes cache-line aligned
+  slices of the block, and falls back to the heap if the arena is full or no scope is open
+- slices are not freed one by one; only the most recent one is given back (so re-creating the last buffer at the
+  same size re-uses its memory); release( ) frees the whole block in one call
+- the arena must outlive every object that allocated from it: declare it before them
+- allocate( ) and deallocate( ) take a lock, so a buffer may be freed on another (non-audio) thread, e.g. by
+  FXBufferGrowthService after the buffer was replaced by a bigger one
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
 \version Revision : 1.0
-\date Date : 2018 / 09 / 7
+\date Date : 2019 / 01 / 31
 */
-template <typename T>
-class LinearBuffer
+class FXArena
 {
 public:
-	LinearBuffer() {}	/* C-TOR */
-	~LinearBuffer() {}	/* D-TOR */
+	FXArena() {}					/* C-TOR */
+	~FXArena() { release(); }		/* D-TOR */
 
-	/** flush buffer by resetting all values to 0.0 */
-	void flushBuffer() { memset(&buffer[0], 0, bufferLength * sizeof(T)); }
+	// --- owns the block; no copies
+	FXArena(const FXArena&) = delete;
+	FXArena& operator=(const FXArena&) = delete;
 
-	/** Create a buffer based on a target maximum in SAMPLES
-	//	   do NOT call from realtime audio thread; do this prior to any processing */
-	void createLinearBuffer(unsigned int _bufferLength)
+	/** allocate the block; do NOT call from realtime audio thread, nor while objects still use an older block */
+	/**
+	\param bytes total size; use getAllocationBytes( ) to add up the buffers
+	\param useHugePages back the block with 2MB pages where the OS allows it
+	\return true if the block was allocated
+	*/
+	bool reserve(size_t bytes, bool useHugePages = false)
 	{
-		// --- find nearest power of 2 for buffer, save it as bufferLength
-		bufferLength = _bufferLength;
+		release();
+		if (bytes == 0)
+			return false;
 
-		// --- create new buffer
-		buffer.reset(new T[bufferLength]);
+#if defined(__linux__)
+		size_t pageSize = useHugePages ? kFXArenaHugePageSize : kFXArenaPageSize;
+#else
+		size_t pageSize = kFXArenaPageSize;
+#endif
+		capacity = ((bytes + pageSize - 1) / pageSize) * pageSize;
 
-		// --- flush buffer
-		flushBuffer();
+#if defined(__linux__)
+		void* block = MAP_FAILED;
+#ifdef MAP_HUGETLB
+		// --- reserved huge pages first...
+		if (useHugePages)
+		{
+			block = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			hugePages = block != MAP_FAILED;
+		}
+#endif
+		if (block == MAP_FAILED)
+		{
+			block = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+			// --- ...then transparent huge pages, if the kernel has them
+			if (block != MAP_FAILED && useHugePages)
+				hugePages = madvise(block, capacity, MADV_HUGEPAGE) == 0;
+#endif
+		}
+		if (block == MAP_FAILED)
+		{
+			capacity = 0;
+			hugePages = false;
+			return false;
+		}
+		base = (char*)block;
+		mapped = true;
+#else
+		// --- heap, aligned by hand
+		heapBlock.reset(new char[capacity + kFXArenaPageSize]);
+		base = heapBlock.get() + (kFXArenaPageSize - ((uintptr_t)heapBlock.get() & (kFXArenaPageSize - 1))) % kFXArenaPageSize;
+#endif
+		used = 0;
+		return true;
 	}
 
-	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
-	void writeBuffer(unsigned int index, T input)
+	/** free the block in one call; every object that allocated from it must be gone */
+	void release()
 	{
-		if (index >= bufferLength) return;
-
-		// --- write and increment index counter
-		buffer[index] = input;
+#if defined(__linux__)
+		if (mapped)
+			munmap(base, capacity);
+#endif
+		heapBlock.reset();
+		base = nullptr;
+		capacity = 0;
+		used = 0;
+		lastSlice = 0;
+		mapped = false;
+		hugePages = false;
 	}
 
-	/**  read an arbitrary location that is delayInSamples old */
-	T readBuffer(unsigned int index)//, bool readBeforeWrite = true)
+	/** take a cache-line aligned slice; nullptr if there is no room (the caller falls back to the heap) */
+	void* allocate(size_t bytes)
 	{
-		if (index >= bufferLength) return 0.0;
+		std::lock_guard<std::mutex> lock(mutex);
+		size_t size = roundUp(bytes);
+		if (!base || size > capacity - used)
+			return nullptr;
 
-		// --- read it
-		return buffer[index];
+		void* slice = base + used;
+		lastSlice = used;
+		used += size;
+		return slice;
 	}
 
+	/** give back a slice: only the most recent one is actually returned to the arena */
+	void deallocate(void* slice)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (slice == base + lastSlice && used > lastSlice)
+			used = lastSlice;
+	}
+
+	/** true if p is inside the block */
+	bool owns(const void* p) const { return base && (const char*)p >= base && (const char*)p < base + capacity; }
+
+	/** the size of the block */
+	size_t getCapacity() const { return capacity; }
+
+	/** bytes handed out so far */
+	size_t getUsed() const { return used; }
+
+	/** true if the block is on huge pages (reserved or transparent) */
+	bool isHugePages() const { return hugePages; }
+
+	/** what an fxNewArray( ) of the given size takes from an arena, header and alignment included */
+	static size_t getAllocationBytes(size_t bytes) { return roundUp(bytes) + kFXCacheLineSize; }
+
 private:
-	std::unique_ptr<T[]> buffer = nullptr;	///< smart pointer will auto-delete
-	unsigned int bufferLength = 1024; ///< buffer length
+	static size_t roundUp(size_t bytes) { return ((bytes + kFXCacheLineSize - 1) / kFXCacheLineSize) * kFXCacheLineSize; }
+
+	char* base = nullptr;						///< start of the block
+	std::unique_ptr<char[]> heapBlock = nullptr;	///< the block when it is not mapped
+	size_t capacity = 0;						///< size of the block
+	size_t used = 0;							///< bump pointer
+	size_t lastSlice = 0;						///< offset of the most recent slice
+	bool mapped = false;						///< true if the block is an mmap( )
+	bool hugePages = false;						///< true if the block is on huge pages
+	std::mutex mutex;							///< for allocate( )/deallocate( ) from different threads
 };
 
+/** the arena fxNewArray( ) draws from on this thread; see FXArenaScope */
+inline FXArena*& getCurrentFXArena()
+{
+	static thread_local FXArena* currentArena = nullptr;
+	return currentArena;
+}
 
 /**
-\class CircularBuffer
+\class FXArenaScope
 \ingroup FX-Objects
 \brief
-The CircularBuffer object implements a simple circular buffer. It uses a wrap mask to wrap the read or write index quickly.
+Scoped arena selection: FX object buffers created on this thread while the scope is open come from the arena.
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
 \version Revision : 1.0
-\date Date : 2018 / 09 / 7
+\date Date : 2019 / 01 / 31
 */
-/** A simple cyclic buffer: NOTE - this is NOT an IAudioSignalProcessor or IAudioSignalGenerator
-	S must be a power of 2.
+class FXArenaScope
+{
+public:
+	FXArenaScope(FXArena& arena) : previousArena(getCurrentFXArena()) { getCurrentFXArena() = &arena; }
+	~FXArenaScope() { getCurrentFXArena() = previousArena; }
+
+private:
+	FXArenaScope(const FXArenaScope&) = delete;
+	FXArenaScope& operator=(const FXArenaScope&) = delete;
+
+	FXArena* previousArena = nullptr;	///< restored on exit
+};
+
+/**
+\struct FXAllocationHeader
+\ingroup FX-Objects
+\brief
+Bookkeeping in the cache line in front of every fxNewArray( ) allocation, so fxDeleteArray( ) knows where it came from.
 */
+struct FXAllocationHeader
+{
+	FXArena* arena = nullptr;		///< the arena it came from, or nullptr for the heap
+	void* heapBlock = nullptr;		///< the heap allocation, if any
+	size_t count = 0;				///< number of elements
+};
+
+/** allocate count default-constructed T, cache-line aligned, from the current arena (or the heap); not realtime safe */
 template <typename T>
-class CircularBuffer
+T* fxNewArray(size_t count)
 {
-public:
-	CircularBuffer() {}		/* C-TOR */
-	~CircularBuffer() {}	/* D-TOR */
+	static_assert(sizeof(FXAllocationHeader) <= kFXCacheLineSize, "FXAllocationHeader must fit in the cache line in front of the data");
+	size_t bytes = count * sizeof(T);
 
-							/** flush buffer by resetting all values to 0.0 */
-	void flushBuffer(){ memset(&buffer[0], 0, bufferLength * sizeof(T)); }
+	FXAllocationHeader header;
+	char* block = nullptr;
+	FXArena* arena = getCurrentFXArena();
+	if (arena)
+		block = (char*)arena->allocate(bytes + kFXCacheLineSize);
 
-	/** Create a buffer based on a target maximum in SAMPLES
-	//	   do NOT call from realtime audio thread; do this prior to any processing */
-	void createCircularBuffer(unsigned int _bufferLength)
+	if (block)
+		header.arena = arena;
+	else
 	{
-		// --- find nearest power of 2 for buffer, and create
-		createCircularBufferPowerOfTwo((unsigned int)(pow(2, ceil(log(_bufferLength) / log(2)))));
+		// --- heap: room to align by hand
+		char* heapBlock = new char[bytes + 2 * kFXCacheLineSize];
+		block = heapBlock + (kFXCacheLineSize - ((uintptr_t)heapBlock & (kFXCacheLineSize - 1))) % kFXCacheLineSize;
+		header.heapBlock = heapBlock;
 	}
+	header.count = count;
+	memcpy(block, &header, sizeof(header));
 
-	/** Create a buffer based on a target maximum in SAMPLESwhere the size is
-	    pre-calculated as a power of two */
-	void createCircularBufferPowerOfTwo(unsigned int _bufferLengthPowerOfTwo)
-	{
-		// --- reset to top
-		writeIndex = 0;
+	T* data = (T*)(block + kFXCacheLineSize);
+	for (size_t i = 0; i < count; i++)
+		new (&data[i]) T();
+	return data;
+}
 
-		// --- find nearest power of 2 for buffer, save it as bufferLength
-		bufferLength = _bufferLengthPowerOfTwo;
+/** destroy and free an fxNewArray( ) allocation; arena memory is only reclaimed when the arena is released */
+template <typename T>
+void fxDeleteArray(T* data)
+{
+	if (!data)
+		return;
 
-		// --- save (bufferLength - 1) for use as wrapping mask
-		wrapMask = bufferLength - 1;
+	char* block = (char*)data - kFXCacheLineSize;
+	FXAllocationHeader header;
+	memcpy(&header, block, sizeof(header));
+	for (size_t i = 0; i < header.count; i++)
+		data[i].~T();
 
-		// --- create new buffer
-		buffer.reset(new T[bufferLength]);
+	if (header.arena)
+		header.arena->deallocate(block);
+	else
+		delete[] (char*)header.heapBlock;
+}
 
-		// --- flush buffer
-		flushBuffer();
-	}
+/** unique_ptr deleter for fxNewArray( ) */
+template <typename T>
+struct FXArrayDeleter
+{
+	void operator()(T* data) const { fxDeleteArray(data); }
+};
 
-	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
-	void writeBuffer(T input)
-	{
-		// --- write and increment index counter
-		buffer[writeIndex++] = input;
+/** owning pointer to an fxNewArray( ) allocation; the drop-in for std::unique_ptr<T[]> in the FX object buffers */
+template <typename T>
+using FXArray = std::unique_ptr<T[], FXArrayDeleter<T>>;
 
-		// --- wrap if index > bufferlength - 1
-		writeIndex &= wrapMask;
-	}
+const double kFXBufferGrowthPoll_mSec = 5.0;	///< how often FXBufferGrowthService looks for requests
 
-	/** read an arbitrary location that is delayInSamples old */
-	T readBuffer(int delayInSamples)//, bool readBeforeWrite = true)
+/**
+\class FXBufferGrowthService
+\ingroup FX-Objects
+\brief
+The FXBufferGrowthService object is the one background thread, shared by every object in the process, that services
+IBufferGrowthClient requests; objects that grow their buffers on demand register here.
+
+Operation:
+- the thread starts with the first registered client and stops (and is joined) when the last one unregisters
+- it polls its clients every kFXBufferGrowthPoll_mSec: the audio thread never waits on it, nor wakes it
+- a client is serviced under the lock that unregisterClient( ) takes, so once that returns the thread will never
+  call the client again; unregister in the destructor of the most derived class, before its members go
+- registerClient( ) and unregisterClient( ) are not realtime safe
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class FXBufferGrowthService
+{
+public:
+	/** the process-wide service */
+	static FXBufferGrowthService& getInstance()
 	{
-		// --- subtract to make read index
-		//     note: -1 here is because we read-before-write,
-		//           so the *last* write location is what we use for the calculation
-		int readIndex = (writeIndex - 1) - delayInSamples;
+		static FXBufferGrowthService service;
+		return service;
+	}
 
-		// --- autowrap index
-		readIndex &= wrapMask;
+	/** add a client; starts the thread if this is the first one */
+	void registerClient(IBufferGrowthClient* client)
+	{
+		std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+		{
+			std::lock_guard<std::mutex> lock(clientMutex);
+			for (IBufferGrowthClient* c : clients)
+			{
+				if (c == client)
+					return;
+			}
+			clients.push_back(client);
+			running = true;
+		}
+		if (!worker.joinable())
+			worker = std::thread(&FXBufferGrowthService::run, this);
+	}
 
-		// --- read it
-		return buffer[readIndex];
+	/** remove a client; waits for a service call in progress, and stops the thread after the last client */
+	void unregisterClient(IBufferGrowthClient* client)
+	{
+		std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+		bool stop = false;
+		{
+			std::lock_guard<std::mutex> lock(clientMutex);
+			for (size_t i = 0; i < clients.size(); i++)
+			{
+				if (clients[i] == client)
+				{
+					clients.erase(clients.begin() + i);
+					break;
+				}
+			}
+			stop = clients.empty() && worker.joinable();
+			if (stop)
+				running = false;
+		}
+
+		if (stop)
+		{
+			wakeUp.notify_all();
+			worker.join();
+		}
 	}
 
-	/** read an arbitrary location that includes a fractional sample */
-	T readBuffer(double delayInFractionalSamples)
+	/** number of registered clients */
+	size_t getNumClients()
 	{
-		// --- truncate delayInFractionalSamples and read the int part
-		T y1 = readBuffer((int)delayInFractionalSamples);
+		std::lock_guard<std::mutex> lock(clientMutex);
+		return clients.size();
+	}
 
-		// --- if no interpolation, just return value
-		if (!interpolate) return y1;
+private:
+	FXBufferGrowthService() {}
+	~FXBufferGrowthService()
+	{
+		{
+			std::lock_guard<std::mutex> lock(clientMutex);
+			running = false;
+		}
+		wakeUp.notify_all();
+		if (worker.joinable())
+			worker.join();
+	}
 
-		// --- else do interpolation
-		//
-		// --- read the sample at n+1 (one sample OLDER)
-		T y2 = readBuffer((int)delayInFractionalSamples + 1);
+	FXBufferGrowthService(const FXBufferGrowthService&) = delete;
+	FXBufferGrowthService& operator=(const FXBufferGrowthService&) = delete;
 
-		// --- get fractional part
-		double fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
+	/** the thread: service every client, then sleep */
+	void run()
+	{
+		std::unique_lock<std::mutex> lock(clientMutex);
+		while (running)
+		{
+			for (IBufferGrowthClient* client : clients)
+				client->serviceBufferGrowth();
 
-		// --- do the interpolation (you could try different types here)
-		return doLinearInterpolation(y1, y2, fraction);
+			wakeUp.wait_for(lock, std::chrono::microseconds((long long)(kFXBufferGrowthPoll_mSec * 1000.0)));
+		}
 	}
 
-	/** enable or disable interpolation; usually used for diagnostics or in algorithms that require strict integer samples times */
-	void setInterpolate(bool b) { interpolate = b; }
-
-private:
-	std::unique_ptr<T[]> buffer = nullptr;	///< smart pointer will auto-delete
-	unsigned int writeIndex = 0;		///> write index
-	unsigned int bufferLength = 1024;	///< must be nearest power of 2
-	unsigned int wrapMask = 1023;		///< must be (bufferLength - 1)
-	bool interpolate = true;			///< interpolation (default is ON)
+	std::vector<IBufferGrowthClient*> clients;	///< registered objects
+	std::mutex clientMutex;						///< guards clients and running; held while servicing
+	std::mutex lifecycleMutex;					///< serializes register/unregister, so the thread is started and joined once
+	std::condition_variable wakeUp;				///< only used to stop the thread promptly
+	std::thread worker;							///< the service thread
+	bool running = false;						///< false tells the thread to exit
 };
 
-
 /**
-\class ImpulseConvolver
+\class LinearBuffer
 \ingroup FX-Objects
 \brief
-The ImpulseConvolver object implements a linear conovlver. NOTE: compile in Release mode or you may experice stuttering,
-glitching or other sample-drop activity.
-
-Audio I/O:
-- Processes mono input to mono output.
-
-Control I/F:
-- none.
+The LinearBuffer object implements a linear buffer of type T. It allows easy wrapping of a smart pointer object.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class ImpulseConvolver : public IAudioSignalProcessor
+template <typename T>
+class LinearBuffer
 {
 public:
-	ImpulseConvolver() {
-		init(512);
-	}		/* C-TOR */
-	~ImpulseConvolver() {}		/* D-TOR */
+	LinearBuffer() {}	/* C-TOR */
+	~LinearBuffer() {}	/* D-TOR */
 
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate)
-	{
-		// --- flush signal buffer; IR buffer is static
-		signalBuffer.flushBuffer();
-		return true;
-	}
+	/** flush buffer by resetting all values to 0.0 */
+	void flushBuffer() { memset(&buffer[0], 0, bufferLength * sizeof(T)); }
 
-	/** process one input - note this is CPU intensive as it performs simple linear convolution */
-	/**
-	\param xn input
-	\return the processed sample
-	*/
-	virtual double processAudioSample(double xn)
+	/** Create a buffer based on a target maximum in SAMPLES
+	//	   do NOT call from realtime audio thread; do this prior to any processing */
+	void createLinearBuffer(unsigned int _bufferLength)
 	{
-		double output = 0.0;
-
-		// --- write buffer; x(n) overwrites oldest value
-		//     this is the only time we do not read before write!
-		signalBuffer.writeBuffer(xn);
-
-		// --- do the convolution
-		for (unsigned int i = 0; i < length; i++)
-		{
-			// --- y(n) += x(n)h(n)
-			//     for signalBuffer.readBuffer(0) -> x(n)
-			//		   signalBuffer.readBuffer(n-D)-> x(n-D)
-			double signal = signalBuffer.readBuffer((int)i);
-			double irrrrr = irBuffer.readBuffer((int)i);
-			output += signal*irrrrr;
+		// --- find nearest power of 2 for buffer, save it as bufferLength
+		bufferLength = _bufferLength;
 
-			//output += signalBuffer.readBuffer((int)i) * irBuffer.readBuffer((int)i);
-		}
+		// --- create new buffer
+		buffer.reset(fxNewArray<T>(bufferLength));
 
-		return output;
+		// --- flush buffer
+		flushBuffer();
 	}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
-
-	/** create the buffer based on the exact power of 2 */
-	void init(unsigned int lengthPowerOfTwo)
+	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
+	void writeBuffer(unsigned int index, T input)
 	{
-		length = lengthPowerOfTwo;
-		// --- create (and clear out) the buffers
-		signalBuffer.createCircularBufferPowerOfTwo(lengthPowerOfTwo);
-		irBuffer.createLinearBuffer(lengthPowerOfTwo);
+		if (index >= bufferLength) return;
+
+		// --- write and increment index counter
+		buffer[index] = input;
 	}
 
-	/** set the impulse response */
-	void setImpulseResponse(double* irArray, unsigned int lengthPowerOfTwo)
+	/**  read an arbitrary location that is delayInSamples old */
+	T readBuffer(unsigned int index)//, bool readBeforeWrite = true)
 	{
-		if (lengthPowerOfTwo != length)
-		{
-			length = lengthPowerOfTwo;
-			// --- create (and clear out) the buffers
-			signalBuffer.createCircularBufferPowerOfTwo(lengthPowerOfTwo);
-			irBuffer.createLinearBuffer(lengthPowerOfTwo);
-		}
+		if (index >= bufferLength) return 0.0;
 
-		// --- load up the IR buffer
-		for (unsigned int i = 0; i < length; i++)
-		{
-			irBuffer.writeBuffer(i, irArray[i]);
-		}
+		// --- read it
+		return buffer[index];
 	}
 
-protected:
-	// --- delay buffer of doubles
-	CircularBuffer<double> signalBuffer; ///< circulat buffer for the signal
-	LinearBuffer<double> irBuffer;	///< linear buffer for the IR
+private:
+	FXArray<T> buffer = nullptr;	///< smart pointer will auto-delete; see fxNewArray( )
+	unsigned int bufferLength = 1024; ///< buffer length
+};
 
-	unsigned int length = 0;	///< length of convolution (buffer)
 
-};
+/**
+\enum bufferInterpolation
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to set the fractional delay interpolator of a circular buffer or tape head; listed in
+order of CPU cost per read (the allpass is the cheapest after linear, but see FractionalDelayInterpolator)
+
+- kNone: truncate to the integer delay
+- kLinear: two taps; dulls the highs most at half sample delays (-inf dB at Nyquist)
+- kLagrange4: four taps, 3rd order Lagrange polynomial
+- kHermite4: four taps, cubic Hermite (Catmull-Rom) spline
+- kThiranAllpass: two taps and one state, 1st order Thiran allpass; flat magnitude, one reader per interpolator
+- kWindowedSinc: eight taps, Kaiser windowed sinc from a table of kWindowedSincPhases phases
+
+- enum class bufferInterpolation { kNone, kLinear, kLagrange4, kHermite4, kThiranAllpass, kWindowedSinc };
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+enum class bufferInterpolation { kNone, kLinear, kLagrange4, kHermite4, kThiranAllpass, kWindowedSinc };
+
+// --- windowed sinc interpolator; see WindowedSincTable
+const unsigned int kWindowedSincTaps = 8;		///< taps at x = -3 ... 4 around the interpolation point
+const unsigned int kWindowedSincPhases = 256;	///< fractional positions in the table; the rest are interpolated
+const double kWindowedSincBeta = 8.0;			///< Kaiser window shape: about -80dB sidelobes
 
-const unsigned int IR_LEN = 512;
 /**
-\struct AnalogFIRFilterParameters
+\class WindowedSincTable
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the AnalogFIRFilter object. This is a somewhat silly object that implaments an analog
-magnitude response as a FIR filter. NOT DESIGNED to replace virtual analog; rather it is intended to show the
-frequency sampling method in an easy (and fun) way.
+The WindowedSincTable object holds the tap weights of an 8 tap Kaiser windowed sinc interpolator for kWindowedSincPhases + 1
+fractional positions across [0.0, 1.0], each normalized to unity gain at DC. getCoefficients( ) interpolates linearly
+between the two nearest phases, so a read costs two table rows instead of eight sin( ) and Bessel evaluations.
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+The table is read-only once built; use getWindowedSincTable( ) to share one copy.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
 \version Revision : 1.0
-\date Date : 2018 / 09 / 7
+\date Date : 2019 / 01 / 31
 */
-struct AnalogFIRFilterParameters
+class WindowedSincTable
 {
-	AnalogFIRFilterParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	AnalogFIRFilterParameters& operator=(const AnalogFIRFilterParameters& params)	// need this override for collections to work
+public:
+	WindowedSincTable()	/* C-TOR */
 	{
-		if (this == &params)
-			return *this;
+		const double halfLength = kWindowedSincTaps / 2.0;
+		const double windowGain = 1.0 / besselI0(kWindowedSincBeta);
 
-		filterType = params.filterType;
-		fc = params.fc;
-		Q = params.Q;
+		for (unsigned int phase = 0; phase <= kWindowedSincPhases; phase++)
+		{
+			double fraction = (double)phase / kWindowedSincPhases;
+			double* row = &table[phase * kWindowedSincTaps];
+			double sum = 0.0;
 
-		return *this;
+			for (unsigned int i = 0; i < kWindowedSincTaps; i++)
+			{
+				// --- distance from the interpolation point to the tap at x = i - 3
+				double t = ((double)i - (halfLength - 1.0)) - fraction;
+				double sinc = fabs(t) < 1.0e-12 ? 1.0 : sin(kPi * t) / (kPi * t);
+				double w = t / (halfLength + 0.5);
+				double window = besselI0(kWindowedSincBeta * sqrt(fmax(0.0, 1.0 - w * w))) * windowGain;
+
+				row[i] = sinc * window;
+				sum += row[i];
+			}
+
+			// --- unity gain at DC for every phase
+			for (unsigned int i = 0; i < kWindowedSincTaps; i++)
+				row[i] /= sum;
+		}
 	}
 
-	// --- individual parameters
-	analogFilter filterType = analogFilter::kLPF1; ///< filter type
-	double fc = 0.0;	///< filter fc
-	double Q = 0.0;		///< filter Q
+	/** calculate the tap weights for taps at x = -3 ... 4 */
+	/**
+	\param fraction the interpolation location between the taps at x = 0 and x = 1, on the range [0.0, 1.0)
+	\param coefficients array of kWindowedSincTaps weights
+	*/
+	void getCoefficients(double fraction, double* coefficients) const
+	{
+		double position = fraction * kWindowedSincPhases;
+		unsigned int phase = (unsigned int)position;
+		if (phase >= kWindowedSincPhases)
+			phase = kWindowedSincPhases - 1;
+
+		double blend = position - phase;
+		const double* row = &table[phase * kWindowedSincTaps];
+		const double* nextRow = row + kWindowedSincTaps;
+
+		// --- straight line loop over contiguous rows: vectorizes
+		for (unsigned int i = 0; i < kWindowedSincTaps; i++)
+			coefficients[i] = row[i] + blend * (nextRow[i] - row[i]);
+	}
+
+private:
+	double table[(kWindowedSincPhases + 1) * kWindowedSincTaps];	///< phase-major tap weights
 };
 
 /**
-\class AnalogFIRFilter
-\ingroup FX-Objects
-\brief
-The AnalogFIRFilter object implements a somewhat silly algorithm that implaments an analog
-magnitude response as a FIR filter. NOT DESIGNED to replace virtual analog; rather it is intended to show the
-frequency sampling method in an easy (and fun) way.
+@getWindowedSincTable
+\ingroup FX-Functions
 
-Audio I/O:
-- Processes mono input to mono output.
+@brief the shared WindowedSincTable; built on first use, which FractionalDelayInterpolator::setInterpolation( ) makes
+sure is not on the audio thread
 
-Control I/F:
-- Use AnalogFIRFilterParameters structure to get/set object params.
+\return the table
+*/
+inline const WindowedSincTable& getWindowedSincTable()
+{
+	static const WindowedSincTable table;
+	return table;
+}
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+/**
+\class FractionalDelayInterpolator
+\ingroup FX-Objects
+\brief
+The FractionalDelayInterpolator object reads a fractional delay from a delay line with one of the bufferInterpolation
+types. It does not own the delay line: interpolate( ) takes a tap reader, a callable that returns the sample
+delayInSamples old, so the same object serves the circular buffers and the FourTapDelay tape heads.
+
+NOTE:
+- the coefficient evaluation is a short fixed-length loop over constant tables (see getLagrange4Coefficients( ) and
+  WindowedSincTable) that compilers vectorize; the tap reads are the rest of the cost
+- taps past either end of the line are clamped to [0, maxDelay], so keep delays kWindowedSincTaps / 2 samples short
+  of the line length for the 8 tap interpolator (2 samples for the 4 tap ones) to avoid a small error at the end
+- kThiranAllpass is recursive: the object must be read exactly once per sample written, by one reader; a second
+  head needs its own interpolator. Its allpass delay is kept on [0.5, 1.5) by borrowing one sample from the
+  integer delay; delays below 0.5 samples fall back to linear. Call reset( ) when the line is flushed.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
 \version Revision : 1.0
-\date Date : 2018 / 09 / 7
+\date Date : 2019 / 01 / 31
 */
-class AnalogFIRFilter : public IAudioSignalProcessor
+template <typename T>
+class FractionalDelayInterpolator
 {
 public:
-	AnalogFIRFilter() {}	/* C-TOR */
-	~AnalogFIRFilter() {}	/* D-TOR */
+	FractionalDelayInterpolator() {}	/* C-TOR */
+	~FractionalDelayInterpolator() {}	/* D-TOR */
 
-public:
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate)
+	/** select the interpolator; builds the shared sinc table if needed, so do NOT call from the audio thread the
+	    first time kWindowedSinc is selected */
+	void setInterpolation(bufferInterpolation _interpolation)
 	{
-		sampleRate = _sampleRate;
-		convolver.reset(_sampleRate);
-		convolver.init(IR_LEN);
-		return true;
+		if (_interpolation == bufferInterpolation::kWindowedSinc)
+			getWindowedSincTable();
+
+		interpolation = _interpolation;
+		reset();
 	}
 
-	/** pefrorm the convolution */
+	/** the current interpolator */
+	bufferInterpolation getInterpolation() { return interpolation; }
+
+	/** clear the allpass state */
+	void reset() { allpassOutput = T(); }
+
+	/** read the line at a fractional delay */
 	/**
-	\param xn input
-	\return the processed sample
+	\param readTap callable with the signature T readTap(int delayInSamples)
+	\param delayInFractionalSamples the delay to read, >= 0
+	\param maxDelay the longest delay readTap( ) accepts
+	\return the interpolated sample
 	*/
-	virtual double processAudioSample(double xn)
+	template <class TapReader>
+	T interpolate(TapReader readTap, double delayInFractionalSamples, int maxDelay)
 	{
-		// --- do the linear convolution
-		return convolver.processAudioSample(xn);
-	}
+		int delay = (int)delayInFractionalSamples;
+		double fraction = delayInFractionalSamples - delay;
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
+		// --- neighbours past either end of the line are held at the end
+		auto tap = [&](int delayInSamples) { return readTap(delayInSamples < 0 ? 0 : (delayInSamples > maxDelay ? maxDelay : delayInSamples)); };
 
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return AnalogFIRFilterParameters custom data structure
-	*/
-	AnalogFIRFilterParameters getParameters() { return parameters; }
+		switch (interpolation)
+		{
+			case bufferInterpolation::kNone:
+				return readTap(delay);
 
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param AnalogFIRFilterParameters custom data structure
-	*/
-	void setParameters(AnalogFIRFilterParameters _parameters)
-	{
-		if (_parameters.fc != parameters.fc ||
-			_parameters.Q != parameters.Q ||
-			_parameters.filterType != parameters.filterType)
-		{
-			// --- set the filter IR for the convolver
-			AnalogMagData analogFilterData;
-			analogFilterData.sampleRate = sampleRate;
-			analogFilterData.magArray = &analogMagArray[0];
-			analogFilterData.dftArrayLen = IR_LEN;
-			analogFilterData.mirrorMag = false;
+			case bufferInterpolation::kLagrange4:
+			case bufferInterpolation::kHermite4:
+			{
+				double c[4];
+				if (interpolation == bufferInterpolation::kLagrange4)
+					getLagrange4Coefficients(fraction, c);
+				else
+					getHermite4Coefficients(fraction, c);
 
-			analogFilterData.filterType = _parameters.filterType;
-			analogFilterData.fc = _parameters.fc; // 1000.0;
-			analogFilterData.Q = _parameters.Q;
+				// --- x = -1 is one sample NEWER than the integer delay
+				return c[0] * tap(delay - 1) + c[1] * tap(delay) + c[2] * tap(delay + 1) + c[3] * tap(delay + 2);
+			}
 
-			// --- calculate the analog mag array
-			calculateAnalogMagArray(analogFilterData);
+			case bufferInterpolation::kThiranAllpass:
+			{
+				// --- keep the allpass delay on [0.5, 1.5) where the pole is well inside the unit circle
+				if (fraction < 0.5)
+				{
+					if (delay == 0)
+						break;
+					delay--;
+					fraction += 1.0;
+				}
 
-			// --- frequency sample the mag array
-			freqSample(IR_LEN, analogMagArray, irArray, POSITIVE);
+				// --- y(n) = a*x(n) + x(n-1) - a*y(n-1); x(n-1) is the next older tap
+				double a = getThiranCoefficient(fraction);
+				allpassOutput = a * tap(delay) + tap(delay + 1) - a * allpassOutput;
+				return allpassOutput;
+			}
 
-			// --- update new frequency response
-			convolver.setImpulseResponse(irArray, IR_LEN);
+			case bufferInterpolation::kWindowedSinc:
+			{
+				double c[kWindowedSincTaps];
+				getWindowedSincTable().getCoefficients(fraction, c);
+
+				T yn = c[0] * tap(delay - 3);
+				for (int i = 1; i < (int)kWindowedSincTaps; i++)
+					yn += c[i] * tap(delay - 3 + i);
+				return yn;
+			}
+
+			default:
+				break;
 		}
 
-		parameters = _parameters;
+		// --- linear
+		return doLinearInterpolation(tap(delay), tap(delay + 1), fraction);
 	}
 
 private:
-	AnalogFIRFilterParameters parameters; ///< object parameters
-	ImpulseConvolver convolver; ///< convolver object to perform FIR convolution
-	double analogMagArray[IR_LEN] = { 0.0 }; ///< array for analog magnitude response
-	double irArray[IR_LEN] = { 0.0 }; ///< array to hold calcualted IR
-	double sampleRate = 0.0; ///< storage for sample rate
+	bufferInterpolation interpolation = bufferInterpolation::kLinear;	///< the interpolator
+	T allpassOutput = T();	///< kThiranAllpass state: the last output
 };
 
-/**
-\enum delayAlgorithm
-\ingroup Constants-Enums
-\brief
-Use this strongly typed enum to easily set the delay algorithm
-
-- enum class delayAlgorithm { kNormal, kPingPong };
-
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-enum class delayAlgorithm { kNormal, kPingPong };
 
 /**
-\enum delayUpdateType
-\ingroup Constants-Enums
+\class CircularBuffer
+\ingroup FX-Objects
 \brief
-Use this strongly typed enum to easily set the delay update type; this varies depending on the designer's choice
-of GUI controls. See the book reference for more details.
-
-- enum class delayUpdateType { kLeftAndRight, kLeftPlusRatio };
+The CircularBuffer object implements a simple circular buffer. It uses a wrap mask to wrap the read or write index quickly.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-enum class delayUpdateType { kLeftAndRight, kLeftPlusRatio };
+/** A simple cyclic buffer: NOTE - this is NOT an IAudioSignalProcessor or IAudioSignalGenerator
+	S must be a power of 2. reserveCircularBuffer( ) preallocates for the longest buffer; any shorter power of two
+	is then a re-slice of that storage.
+*/
+template <typename T>
+class CircularBuffer
+{
+public:
+	CircularBuffer() {}		/* C-TOR */
+	~CircularBuffer() {}	/* D-TOR */
 
+							/** flush buffer by resetting all values to 0.0 */
+	void flushBuffer(){ memset(&buffer[0], 0, bufferLength * sizeof(T)); interpolator.reset(); }
 
-/**
-\struct AudioDelayParameters
-\ingroup FX-Objects
-\brief
-Custom parameter structure for the AudioDelay object.
+	/** Create a buffer based on a target maximum in SAMPLES
+	//	   do NOT call from realtime audio thread; do this prior to any processing */
+	void createCircularBuffer(unsigned int _bufferLength)
+	{
+		// --- find nearest power of 2 for buffer, and create
+		createCircularBufferPowerOfTwo((unsigned int)(pow(2, ceil(log(_bufferLength) / log(2)))));
+	}
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-struct AudioDelayParameters
-{
-	AudioDelayParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	AudioDelayParameters& operator=(const AudioDelayParameters& params)	// need this override for collections to work
+	/** Create a buffer based on a target maximum in SAMPLESwhere the size is
+	    pre-calculated as a power of two; re-slices the reserved storage if it is long enough */
+	void createCircularBufferPowerOfTwo(unsigned int _bufferLengthPowerOfTwo)
 	{
-		if (this == &params)
-			return *this;
+		// --- reset to top
+		writeIndex = 0;
 
-		algorithm = params.algorithm;
-		wetLevel_dB = params.wetLevel_dB;
-		dryLevel_dB = params.dryLevel_dB;
-		feedback_Pct = params.feedback_Pct;
+		// --- find nearest power of 2 for buffer, save it as bufferLength
+		bufferLength = _bufferLengthPowerOfTwo;
 
-		updateType = params.updateType;
-		leftDelay_mSec = params.leftDelay_mSec;
-		rightDelay_mSec = params.rightDelay_mSec;
-		delayRatio_Pct = params.delayRatio_Pct;
+		// --- save (bufferLength - 1) for use as wrapping mask
+		wrapMask = bufferLength - 1;
 
-		return *this;
+		// --- create new buffer unless the reserved one is long enough
+		if (bufferLength > capacity)
+		{
+			buffer.reset(fxNewArray<T>(bufferLength));
+			capacity = bufferLength;
+		}
+
+		// --- flush buffer
+		flushBuffer();
 	}
 
-	// --- individual parameters
-	delayAlgorithm algorithm = delayAlgorithm::kNormal; ///< delay algorithm
-	double wetLevel_dB = -3.0;	///< wet output level in dB
-	double dryLevel_dB = -3.0;	///< dry output level in dB
-	double feedback_Pct = 0.0;	///< feedback as a % value
+	/** bytes reserveCircularBuffer( ) takes from an FXArena for _maxBufferLength SAMPLES */
+	static size_t getReserveBytes(unsigned int _maxBufferLength)
+	{
+		return FXArena::getAllocationBytes((size_t)pow(2, ceil(log(_maxBufferLength) / log(2))) * sizeof(T));
+	}
 
-	delayUpdateType updateType = delayUpdateType::kLeftAndRight;///< update algorithm
-	double leftDelay_mSec = 0.0;	///< left delay time
-	double rightDelay_mSec = 0.0;	///< right delay time
-	double delayRatio_Pct = 100.0;	///< dela ratio: right length = (delayRatio)*(left length)
-};
+	/** allocate storage for buffers up to _maxBufferLength SAMPLES so that createCircularBuffer( ) does not
+	    have to; do NOT call from realtime audio thread */
+	void reserveCircularBuffer(unsigned int _maxBufferLength)
+	{
+		unsigned int maxLengthPowerOfTwo = (unsigned int)(pow(2, ceil(log(_maxBufferLength) / log(2))));
+		if (maxLengthPowerOfTwo <= capacity)
+			return;
 
-/**
-\class AudioDelay
-\ingroup FX-Objects
-\brief
-The AudioDelay object implements a stereo audio delay with multiple delay algorithms.
+		// --- free first, so an arena can hand the same slice back
+		buffer.reset();
+		buffer.reset(fxNewArray<T>(maxLengthPowerOfTwo));
+		capacity = maxLengthPowerOfTwo;
 
-Audio I/O:
-- Processes mono input to mono output OR stereo output.
+		// --- the old slice is gone; keep a valid (empty) one until createCircularBuffer( )
+		if (bufferLength > capacity)
+		{
+			bufferLength = capacity;
+			wrapMask = bufferLength - 1;
+		}
+		writeIndex = 0;
+		flushBuffer();
+	}
 
-Control I/F:
-- Use AudioDelayParameters structure to get/set object params.
+	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
+	void writeBuffer(T input)
+	{
+		// --- write and increment index counter
+		buffer[writeIndex++] = input;
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-class AudioDelay : public IAudioSignalProcessor
-{
-public:
-	AudioDelay() {}		/* C-TOR */
-	~AudioDelay() {}	/* D-TOR */
+		// --- wrap if index > bufferlength - 1
+		writeIndex &= wrapMask;
+	}
 
-public:
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate)
+	/** read an arbitrary location that is delayInSamples old */
+	T readBuffer(int delayInSamples)//, bool readBeforeWrite = true)
 	{
-		// --- if sample rate did not change
-		if (sampleRate == _sampleRate)
-		{
-			// --- just flush buffer and return
-			delayBuffer_L.flushBuffer();
-			delayBuffer_R.flushBuffer();
-			return true;
-		}
+		// --- subtract to make read index
+		//     note: -1 here is because we read-before-write,
+		//           so the *last* write location is what we use for the calculation
+		int readIndex = (writeIndex - 1) - delayInSamples;
 
-		// --- create new buffer, will store sample rate and length(mSec)
-		createDelayBuffers(_sampleRate, bufferLength_mSec);
+		// --- autowrap index
+		readIndex &= wrapMask;
 
-		return true;
+		// --- read it
+		return buffer[readIndex];
 	}
 
-	/** process MONO audio delay */
-	/**
-	\param xn input
-	\return the processed sample
-	*/
-	virtual double processAudioSample(double xn)
+	/** read an arbitrary location that includes a fractional sample */
+	T readBuffer(double delayInFractionalSamples)
 	{
-		// --- read delay
-		double yn = delayBuffer_L.readBuffer(delayInSamples_L);
+		// --- higher order interpolators; see setInterpolation( )
+		if (interpolator.getInterpolation() > bufferInterpolation::kLinear)
+			return interpolator.interpolate([this](int delayInSamples) { return readBuffer(delayInSamples); },
+											delayInFractionalSamples, (int)wrapMask);
 
-		// --- create input for delay buffer
-		double dn = xn + (parameters.feedback_Pct / 100.0) * yn;
+		// --- truncate delayInFractionalSamples and read the int part
+		T y1 = readBuffer((int)delayInFractionalSamples);
 
-		// --- write to delay buffer
-		delayBuffer_L.writeBuffer(dn);
+		// --- if no interpolation, just return value
+		if (!interpolate) return y1;
 
-		// --- form mixture out = dry*xn + wet*yn
-		double output = dryMix*xn + wetMix*yn;
+		// --- else do interpolation
+		//
+		// --- read the sample at n+1 (one sample OLDER)
+		T y2 = readBuffer((int)delayInFractionalSamples + 1);
 
-		return output;
-	}
+		// --- get fractional part
+		double fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
 
-	/** return true: this object can also process frames */
-	virtual bool canProcessAudioFrame() { return true; }
+		// --- do the interpolation (you could try different types here)
+		return doLinearInterpolation(y1, y2, fraction);
+	}
 
-	/** process STEREO audio delay in frames */
-	virtual bool processAudioFrame(const float* inputFrame,		/* ptr to one frame of data: pInputFrame[0] = left, pInputFrame[1] = right, etc...*/
-		float* outputFrame,
-		uint32_t inputChannels,
-		uint32_t outputChannels)
+	/** read several locations that include fractional samples (e.g. multi-tap); linear interpolation runs on the
+	    CPU-dispatched kernel (see fxkernels.h), the others tap by tap (and kThiranAllpass is for one reader only) */
+	void readBuffer(const double* delaysInFractionalSamples, double* output, unsigned int count)
 	{
-		// --- make sure we have input and outputs
-		if (inputChannels == 0 || outputChannels == 0)
-			return false;
-
-		// --- make sure we support this delay algorithm
-		if (parameters.algorithm != delayAlgorithm::kNormal &&
-			parameters.algorithm != delayAlgorithm::kPingPong)
-			return false;
+		if (interpolator.getInterpolation() > bufferInterpolation::kLinear)
+		{
+			for (unsigned int i = 0; i < count; i++)
+				output[i] = readBuffer(delaysInFractionalSamples[i]);
+			return;
+		}
 
-		// --- if only one output channel, revert to mono operation
-		if (outputChannels == 1)
+		double y1[kKernelChunkSize], y2[kKernelChunkSize], fraction[kKernelChunkSize];
+		for (unsigned int start = 0; start < count; start += kKernelChunkSize)
 		{
-			// --- process left channel only
-			outputFrame[0] = processAudioSample(inputFrame[0]);
-			return true;
+			unsigned int chunk = count - start < kKernelChunkSize ? count - start : kKernelChunkSize;
+			for (unsigned int i = 0; i < chunk; i++)
+			{
+				int delay = (int)delaysInFractionalSamples[start + i];
+				y1[i] = readBuffer(delay);
+				y2[i] = interpolate ? readBuffer(delay + 1) : y1[i];
+				fraction[i] = delaysInFractionalSamples[start + i] - delay;
+			}
+			getFXKernels().interpolate(y1, y2, fraction, &output[start], chunk);
 		}
+	}
 
-		// --- if we get here we know we have 2 output channels
-		//
-		// --- pick up inputs
-		//
-		// --- LEFT channel
-		double xnL = inputFrame[0];
+	/** enable or disable interpolation; usually used for diagnostics or in algorithms that require strict integer samples times */
+	void setInterpolate(bool b) { setInterpolation(b ? bufferInterpolation::kLinear : bufferInterpolation::kNone); }
 
-		// --- RIGHT channel (duplicate left input if mono-in)
-		double xnR = inputChannels > 1 ? inputFrame[1] : xnL;
+	/** select the fractional delay interpolator; see FractionalDelayInterpolator */
+	void setInterpolation(bufferInterpolation _interpolation)
+	{
+		interpolator.setInterpolation(_interpolation);
+		interpolate = _interpolation != bufferInterpolation::kNone;
+	}
 
-		// --- read delay LEFT
-		double ynL = delayBuffer_L.readBuffer(delayInSamples_L);
+	/** the fractional delay interpolator */
+	bufferInterpolation getInterpolation() { return interpolator.getInterpolation(); }
 
-		// --- read delay RIGHT
-		double ynR = delayBuffer_R.readBuffer(delayInSamples_R);
+	/** the active length in samples */
+	unsigned int getBufferLength() { return bufferLength; }
 
-		// --- create input for delay buffer with LEFT channel info
-		double dnL = xnL + (parameters.feedback_Pct / 100.0) * ynL;
+	/** exchange storage and state with another buffer; no allocation, so this is realtime safe */
+	void swapBuffer(CircularBuffer& other)
+	{
+		std::swap(buffer, other.buffer);
+		std::swap(writeIndex, other.writeIndex);
+		std::swap(bufferLength, other.bufferLength);
+		std::swap(wrapMask, other.wrapMask);
+		std::swap(capacity, other.capacity);
+		std::swap(interpolate, other.interpolate);
+		std::swap(interpolator, other.interpolator);
+	}
 
-		// --- create input for delay buffer with RIGHT channel info
-		double dnR = xnR + (parameters.feedback_Pct / 100.0) * ynR;
+private:
+	FXArray<T> buffer = nullptr;	///< smart pointer will auto-delete; see fxNewArray( )
+	unsigned int writeIndex = 0;		///> write index
+	unsigned int bufferLength = 1024;	///< must be nearest power of 2
+	unsigned int wrapMask = 1023;		///< must be (bufferLength - 1)
+	unsigned int capacity = 0;			///< allocated length
+	bool interpolate = true;			///< interpolation (default is ON)
+	FractionalDelayInterpolator<T> interpolator;	///< higher order interpolators; see setInterpolation( )
+};
 
-		// --- decode
-		if (parameters.algorithm == delayAlgorithm::kNormal)
-		{
-			// --- write to LEFT delay buffer with LEFT channel info
-			delayBuffer_L.writeBuffer(dnL);
 
-			// --- write to RIGHT delay buffer with RIGHT channel info
-			delayBuffer_R.writeBuffer(dnR);
-		}
-		else if (parameters.algorithm == delayAlgorithm::kPingPong)
-		{
-			// --- write to LEFT delay buffer with RIGHT channel info
-			delayBuffer_L.writeBuffer(dnR);
+/**
+\class ExactCircularBuffer
+\ingroup FX-Objects
+\brief
+The ExactCircularBuffer object is a drop-in alternative to CircularBuffer that is sized to the requested length
+instead of the next power of two, so memory scales with the maximum delay time (a 12 second line at 48kHz is 576,001
+samples instead of 1,048,576). Indexes wrap with a compare-and-subtract, which is branch predictable since the
+wrap is taken once per trip around the buffer.
+
+NOTE:
+- one extra sample is allocated so that the interpolation neighbour of the longest delay is always valid
+- read delays must be in the range [0, requested length]; unlike CircularBuffer, out of range delays are not masked
+
+Preallocation:
+- reserveCircularBuffer( ) allocates the storage for the longest buffer up front; createCircularBuffer( ) then re-slices
+  that storage for any length that fits, without allocating
+- flushBuffer( ) zeroes only the samples written since the last flush (up to the write index until the first wrap),
+  so a flush after a short run is cheap
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+template <typename T>
+class ExactCircularBuffer
+{
+public:
+	ExactCircularBuffer() {}	/* C-TOR */
+	~ExactCircularBuffer() {}	/* D-TOR */
 
-			// --- write to RIGHT delay buffer with LEFT channel info
-			delayBuffer_R.writeBuffer(dnL);
-		}
+	/** flush buffer by resetting all values to 0.0; only what has been written needs it */
+	void flushBuffer()
+	{
+		// --- before the first wrap, only [0, writeIndex) has been written
+		unsigned int dirty = wrapped ? bufferLength : writeIndex;
+		if (dirty > 0)
+			memset(&buffer[0], 0, dirty * sizeof(T));
 
-		// --- form mixture out = dry*xn + wet*yn
-		double outputL = dryMix*xnL + wetMix*ynL;
+		// --- everything is zero, so start again from the top
+		writeIndex = 0;
+		wrapped = false;
+		interpolator.reset();
+	}
 
-		// --- form mixture out = dry*xn + wet*yn
-		double outputR = dryMix*xnR + wetMix*ynR;
+	/** bytes reserveCircularBuffer( ) takes from an FXArena for _maxBufferLength SAMPLES */
+	static size_t getReserveBytes(unsigned int _maxBufferLength)
+	{
+		return FXArena::getAllocationBytes(((size_t)_maxBufferLength + 1) * sizeof(T));
+	}
 
-		// --- set left channel
-		outputFrame[0] = outputL;
+	/** allocate (and zero) storage for buffers up to _maxBufferLength SAMPLES so that createCircularBuffer( ) does not
+	    have to; do NOT call from realtime audio thread */
+	void reserveCircularBuffer(unsigned int _maxBufferLength)
+	{
+		// --- +1 for the interpolation neighbour of the longest delay
+		if (_maxBufferLength + 1 <= capacity)
+			return;
 
-		// --- set right channel
-		outputFrame[1] = outputR;
+		capacity = _maxBufferLength + 1;
+		buffer.reset();
+		buffer.reset(fxNewArray<T>(capacity));
+		memset(&buffer[0], 0, capacity * sizeof(T));
 
-		return true;
+		// --- no active slice until createCircularBuffer( )
+		bufferLength = 0;
+		writeIndex = 0;
+		wrapped = false;
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return AudioDelayParameters custom data structure
-	*/
-	AudioDelayParameters getParameters() { return parameters; }
-
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param AudioDelayParameters custom data structure
-	*/
-	void setParameters(AudioDelayParameters _parameters)
+	/** Create a buffer based on a target maximum in SAMPLES; re-slices the reserved storage if it is long enough,
+	//	   otherwise allocates: do NOT call from realtime audio thread; do this prior to any processing */
+	void createCircularBuffer(unsigned int _bufferLength)
 	{
-		// --- check mix in dB for calc
-		if (_parameters.dryLevel_dB != parameters.dryLevel_dB)
-			dryMix = pow(10.0, _parameters.dryLevel_dB / 20.0);
-		if (_parameters.wetLevel_dB != parameters.wetLevel_dB)
-			wetMix = pow(10.0, _parameters.wetLevel_dB / 20.0);
+		if (_bufferLength + 1 > capacity)
+			reserveCircularBuffer(_bufferLength);
+		else
+			flushBuffer();
 
-		// --- save; rest of updates are cheap on CPU
-		parameters = _parameters;
+		// --- +1 for the interpolation neighbour of the longest delay
+		bufferLength = _bufferLength + 1;
+	}
 
-		// --- check update type first:
-		if (parameters.updateType == delayUpdateType::kLeftAndRight)
-		{
-			// --- set left and right delay times
-			// --- calculate total delay time in samples + fraction
-			double newDelayInSamples_L = parameters.leftDelay_mSec*(samplesPerMSec);
-			double newDelayInSamples_R = parameters.rightDelay_mSec*(samplesPerMSec);
+	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
+	void writeBuffer(T input)
+	{
+		// --- write and increment index counter
+		buffer[writeIndex++] = input;
 
-			// --- new delay time with fraction
-			delayInSamples_L = newDelayInSamples_L;
-			delayInSamples_R = newDelayInSamples_R;
-		}
-		else if (parameters.updateType == delayUpdateType::kLeftPlusRatio)
+		// --- wrap if index > bufferlength - 1
+		if (writeIndex == bufferLength)
 		{
-			// --- get and validate ratio
-			double delayRatio = parameters.delayRatio_Pct / 100.0;
-			boundValue(delayRatio, 0.0, 1.0);
-
-			// --- calculate total delay time in samples + fraction
-			double newDelayInSamples = parameters.leftDelay_mSec*(samplesPerMSec);
-
-			// --- new delay time with fraction
-			delayInSamples_L = newDelayInSamples;
-			delayInSamples_R = delayInSamples_L*delayRatio;
+			writeIndex = 0;
+			wrapped = true;
 		}
 	}
 
-	/** creation function */
-	void createDelayBuffers(double _sampleRate, double _bufferLength_mSec)
+	/** read an arbitrary location that is delayInSamples old */
+	T readBuffer(int delayInSamples)
 	{
-		// --- store for math
-		bufferLength_mSec = _bufferLength_mSec;
-		sampleRate = _sampleRate;
-		samplesPerMSec = sampleRate / 1000.0;
+		// --- subtract to make read index; -1 because we read-before-write
+		int readIndex = (int)writeIndex - 1 - delayInSamples;
 
-		// --- total buffer length including fractional part
-		bufferLength = (unsigned int)(bufferLength_mSec*(samplesPerMSec)) + 1; // +1 for fractional part
+		// --- wrap
+		if (readIndex < 0)
+			readIndex += bufferLength;
 
-																			   // --- create new buffer
-		delayBuffer_L.createCircularBuffer(bufferLength);
-		delayBuffer_R.createCircularBuffer(bufferLength);
+		// --- read it
+		return buffer[readIndex];
 	}
 
-private:
-	AudioDelayParameters parameters; ///< object parameters
+	/** read an arbitrary location that includes a fractional sample */
+	T readBuffer(double delayInFractionalSamples)
+	{
+		// --- higher order interpolators; see setInterpolation( )
+		if (interpolator.getInterpolation() > bufferInterpolation::kLinear)
+			return interpolator.interpolate([this](int delayInSamples) { return readBuffer(delayInSamples); },
+											delayInFractionalSamples, (int)bufferLength - 1);
 
-	double sampleRate = 0.0;		///< current sample rate
-	double samplesPerMSec = 0.0;	///< samples per millisecond, for easy access calculation
-	double delayInSamples_L = 0.0;	///< double includes fractional part
-	double delayInSamples_R = 0.0;	///< double includes fractional part
-	double bufferLength_mSec = 0.0;	///< buffer length in mSec
-	unsigned int bufferLength = 0;	///< buffer length in samples
-	double wetMix = 0.707; ///< wet output default = -3dB
-	double dryMix = 0.707; ///< dry output default = -3dB
+		// --- truncate delayInFractionalSamples and read the int part
+		T y1 = readBuffer((int)delayInFractionalSamples);
 
-	// --- delay buffer of doubles
-	CircularBuffer<double> delayBuffer_L;	///< LEFT delay buffer of doubles
-	CircularBuffer<double> delayBuffer_R;	///< RIGHT delay buffer of doubles
-};
+		// --- if no interpolation, just return value
+		if (!interpolate) return y1;
 
+		// --- read the sample at n+1 (one sample OLDER) and interpolate
+		T y2 = readBuffer((int)delayInFractionalSamples + 1);
+		double fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
 
-/**
-\enum generatorWaveform
-\ingroup Constants-Enums
-\brief
-Use this strongly typed enum to easily set the oscillator waveform
+		return doLinearInterpolation(y1, y2, fraction);
+	}
 
-- enum  generatorWaveform { kTriangle, kSin, kSaw };
+	/** enable or disable interpolation; usually used for diagnostics or in algorithms that require strict integer samples times */
+	void setInterpolate(bool b) { setInterpolation(b ? bufferInterpolation::kLinear : bufferInterpolation::kNone); }
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-enum class generatorWaveform { kTriangle, kSin, kSaw };
+	/** select the fractional delay interpolator; see FractionalDelayInterpolator */
+	void setInterpolation(bufferInterpolation _interpolation)
+	{
+		interpolator.setInterpolation(_interpolation);
+		interpolate = _interpolation != bufferInterpolation::kNone;
+	}
 
-/**
-\struct OscillatorParameters
-\ingroup FX-Objects
-\brief
-Custom parameter structure for the LFO and DFOscillator objects.
+	/** the fractional delay interpolator */
+	bufferInterpolation getInterpolation() { return interpolator.getInterpolation(); }
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-struct OscillatorParameters
-{
-	OscillatorParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	OscillatorParameters& operator=(const OscillatorParameters& params)	// need this override for collections to work
-	{
-		if (this == &params)
-			return *this;
+	/** the active length in samples */
+	unsigned int getBufferLength() { return bufferLength; }
 
-		waveform = params.waveform;
-		frequency_Hz = params.frequency_Hz;
-		return *this;
+	/** the allocated (reserved) length in samples */
+	unsigned int getCapacity() { return capacity; }
+
+	/** exchange storage and state with another buffer; no allocation, so this is realtime safe */
+	void swapBuffer(ExactCircularBuffer& other)
+	{
+		std::swap(buffer, other.buffer);
+		std::swap(writeIndex, other.writeIndex);
+		std::swap(bufferLength, other.bufferLength);
+		std::swap(capacity, other.capacity);
+		std::swap(wrapped, other.wrapped);
+		std::swap(interpolate, other.interpolate);
+		std::swap(interpolator, other.interpolator);
 	}
 
-	// --- individual parameters
-	generatorWaveform waveform = generatorWaveform::kTriangle; ///< the current waveform
-	double frequency_Hz = 0.0;	///< oscillator frequency
+private:
+	FXArray<T> buffer = nullptr;	///< smart pointer will auto-delete; see fxNewArray( )
+	unsigned int writeIndex = 0;		///> write index
+	unsigned int bufferLength = 0;		///< requested length + 1
+	unsigned int capacity = 0;			///< allocated length
+	bool wrapped = false;				///< the write index has wrapped since the last flush
+	bool interpolate = true;			///< interpolation (default is ON)
+	FractionalDelayInterpolator<T> interpolator;	///< higher order interpolators; see setInterpolation( )
 };
 
+
 /**
-\class LFO
+\class MirroredCircularBuffer
 \ingroup FX-Objects
 \brief
-The LFO object implements a mathematically perfect LFO generator for modulation uses only. It should not be used for
-audio frequencies except for the sinusoidal output which, though an approximation, has very low TDH.
-
-Audio I/O:
-- Output only object: low frequency generator.
-
-Control I/F:
-- Use OscillatorParameters structure to get/set object params.
-
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+The MirroredCircularBuffer object is a drop-in alternative to CircularBuffer where the storage appears twice, back to back,
+in memory. Any window of up to bufferLength samples behind the write head is therefore contiguous: reads need no wrap
+mask, and getReadPointer( ) hands block or SIMD code a plain pointer it can walk without wrap checks.
+
+- on Linux the two halves are the same physical pages, mapped twice with memfd_create/mmap; the length is rounded up
+  to a whole number of pages
+- elsewhere (or if the mapping fails) the buffer is allocated at twice the length and each write goes to both halves
+- one extra sample is allocated so that the interpolation neighbour of the longest delay is always valid
+- read delays must be in the range [0, requested length]; out of range delays are not masked
+- the two halves must be exactly one length apart, so a new length always means a new mapping; re-creating at the
+  same length keeps the mapping and only flushes it (reserveCircularBuffer( ) is accepted and does nothing)
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
 \version Revision : 1.0
-\date Date : 2018 / 09 / 7
+\date Date : 2019 / 01 / 31
 */
-class LFO : public IAudioSignalGenerator
+template <typename T>
+class MirroredCircularBuffer
 {
 public:
-	LFO() {	srand(time(NULL)); }	/* C-TOR */
-	virtual ~LFO() {}				/* D-TOR */
+	MirroredCircularBuffer() {}							/* C-TOR */
+	~MirroredCircularBuffer() { destroyCircularBuffer(); }	/* D-TOR */
 
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate)
+	// --- owns a mapping; no copies
+	MirroredCircularBuffer(const MirroredCircularBuffer&) = delete;
+	MirroredCircularBuffer& operator=(const MirroredCircularBuffer&) = delete;
+
+	/** flush buffer by resetting all values to 0.0 */
+	void flushBuffer()
 	{
-		sampleRate = _sampleRate;
-		phaseInc = lfoParameters.frequency_Hz / sampleRate;
+		if (!buffer) return;
+		memset(&buffer[0], 0, (mirrored ? bufferLength : 2 * bufferLength) * sizeof(T));
+		interpolator.reset();
+	}
 
-		// --- timebase variables
-		modCounter = 0.0;			///< modulo counter [0.0, +1.0]
-		modCounterQP = 0.25;		///<Quad Phase modulo counter [0.0, +1.0]
+	/** Create a buffer based on a target maximum in SAMPLES
+	//	   do NOT call from realtime audio thread; do this prior to any processing */
+	void createCircularBuffer(unsigned int _bufferLength)
+	{
+		// --- same length: keep the mapping
+		writeIndex = 0;
+		if (buffer && _bufferLength == requestedLength)
+		{
+			flushBuffer();
+			return;
+		}
 
-		return true;
-	}
+		destroyCircularBuffer();
+		requestedLength = _bufferLength;
 
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return OscillatorParameters custom data structure
-	*/
-	OscillatorParameters getParameters(){ return lfoParameters; }
+		// --- reset to top; +1 for the interpolation neighbour of the longest delay
+		bufferLength = _bufferLength + 1;
 
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param OscillatorParameters custom data structure
-	*/
-	void setParameters(const OscillatorParameters& params)
-	{
-		if(params.frequency_Hz != lfoParameters.frequency_Hz)
-			// --- update phase inc based on osc freq and fs
-			phaseInc = params.frequency_Hz / sampleRate;
+#if defined(__linux__)
+		// --- round up to whole pages so the second mapping lines up with the first
+		size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+		size_t bytes = ((bufferLength * sizeof(T) + pageSize - 1) / pageSize) * pageSize;
+		if (bytes % sizeof(T) == 0 && mapMirror(bytes))
+			bufferLength = (unsigned int)(bytes / sizeof(T));
+		else
+#endif
+		{
+			// --- double-write fallback
+			heapBuffer.reset(fxNewArray<T>(2 * bufferLength));
+			buffer = heapBuffer.get();
+			mirrored = false;
+		}
 
-		lfoParameters = params;
+		// --- flush buffer
+		flushBuffer();
 	}
 
-	/** render a new audio output structure */
-	virtual const SignalGenData renderAudioOutput();
+	/** the mapping depends on the exact length, so there is nothing to reserve; see the class notes */
+	void reserveCircularBuffer(unsigned int /*_maxBufferLength*/) {}
 
-protected:
-	// --- parameters
-	OscillatorParameters lfoParameters; ///< obejcgt parameters
+	/** the mapping is not arena memory; this is what the double-write fallback would take */
+	static size_t getReserveBytes(unsigned int _maxBufferLength)
+	{
+		return FXArena::getAllocationBytes(2 * (size_t)_maxBufferLength * sizeof(T));
+	}
 
-	// --- sample rate
-	double sampleRate = 0.0;			///< sample rate
+	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
+	void writeBuffer(T input)
+	{
+		buffer[writeIndex] = input;
+		if (!mirrored)
+			buffer[writeIndex + bufferLength] = input;
 
-	// --- timebase variables
-	double modCounter = 0.0;			///< modulo counter [0.0, +1.0]
-	double phaseInc = 0.0;				///< phase inc = fo/fs
-	double modCounterQP = 0.25;			///<Quad Phase modulo counter [0.0, +1.0]
+		// --- wrap if index > bufferlength - 1
+		if (++writeIndex == bufferLength)
+			writeIndex = 0;
+	}
 
-	/** check the modulo counter and wrap if needed */
-	inline bool checkAndWrapModulo(double& moduloCounter, double phaseInc)
+	/** read an arbitrary location that is delayInSamples old */
+	T readBuffer(int delayInSamples)
 	{
-		// --- for positive frequencies
-		if (phaseInc > 0 && moduloCounter >= 1.0)
-		{
-			moduloCounter -= 1.0;
-			return true;
-		}
+		// --- the mirror makes [writeIndex - bufferLength, writeIndex) contiguous; -1 because we read-before-write
+		return buffer[writeIndex + bufferLength - 1 - delayInSamples];
+	}
 
-		// --- for negative frequencies
-		if (phaseInc < 0 && moduloCounter <= 0.0)
-		{
-			moduloCounter += 1.0;
-			return true;
-		}
+	/** read an arbitrary location that includes a fractional sample */
+	T readBuffer(double delayInFractionalSamples)
+	{
+		// --- higher order interpolators; see setInterpolation( )
+		if (interpolator.getInterpolation() > bufferInterpolation::kLinear)
+			return interpolator.interpolate([this](int delayInSamples) { return readBuffer(delayInSamples); },
+											delayInFractionalSamples, (int)bufferLength - 1);
 
-		return false;
+		// --- truncate delayInFractionalSamples and read the int part
+		T y1 = readBuffer((int)delayInFractionalSamples);
+
+		// --- if no interpolation, just return value
+		if (!interpolate) return y1;
+
+		// --- read the sample at n+1 (one sample OLDER) and interpolate
+		T y2 = readBuffer((int)delayInFractionalSamples + 1);
+		double fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
+
+		return doLinearInterpolation(y1, y2, fraction);
 	}
 
-	/** advanvce the modulo counter, then check the modulo counter and wrap if needed */
-	inline bool advanceAndCheckWrapModulo(double& moduloCounter, double phaseInc)
+	/** pointer to the sample that is delayInSamples old; older samples are at lower addresses, and the
+	    pointer is valid from [-(bufferLength - 1 - delayInSamples)] up to [delayInSamples] with no wrapping */
+	const T* getReadPointer(int delayInSamples)
 	{
-		// --- advance counter
-		moduloCounter += phaseInc;
+		return &buffer[writeIndex + bufferLength - 1 - delayInSamples];
+	}
 
-		// --- for positive frequencies
-		if (phaseInc > 0 && moduloCounter >= 1.0)
-		{
-			moduloCounter -= 1.0;
-			return true;
-		}
+	/** enable or disable interpolation; usually used for diagnostics or in algorithms that require strict integer samples times */
+	void setInterpolate(bool b) { setInterpolation(b ? bufferInterpolation::kLinear : bufferInterpolation::kNone); }
 
-		// --- for negative frequencies
-		if (phaseInc < 0 && moduloCounter <= 0.0)
+	/** select the fractional delay interpolator; see FractionalDelayInterpolator */
+	void setInterpolation(bufferInterpolation _interpolation)
+	{
+		interpolator.setInterpolation(_interpolation);
+		interpolate = _interpolation != bufferInterpolation::kNone;
+	}
+
+	/** the fractional delay interpolator */
+	bufferInterpolation getInterpolation() { return interpolator.getInterpolation(); }
+
+	/** the length of one half of the mirror in samples */
+	unsigned int getBufferLength() { return bufferLength; }
+
+	/** true if the halves share pages (no double-write) */
+	bool isMirrored() { return mirrored; }
+
+	/** exchange mappings and state with another buffer; no allocation, so this is realtime safe */
+	void swapBuffer(MirroredCircularBuffer& other)
+	{
+		std::swap(buffer, other.buffer);
+		std::swap(heapBuffer, other.heapBuffer);
+		std::swap(mappedBytes, other.mappedBytes);
+		std::swap(mirrored, other.mirrored);
+		std::swap(writeIndex, other.writeIndex);
+		std::swap(bufferLength, other.bufferLength);
+		std::swap(requestedLength, other.requestedLength);
+		std::swap(interpolate, other.interpolate);
+		std::swap(interpolator, other.interpolator);
+	}
+
+protected:
+#if defined(__linux__)
+	/** map the same memfd pages twice, back to back; returns false on any failure */
+	bool mapMirror(size_t bytes)
+	{
+		int fd = memfd_create("MirroredCircularBuffer", MFD_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		void* base = MAP_FAILED;
+		if (ftruncate(fd, (off_t)bytes) == 0)
+			base = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		bool ok = base != MAP_FAILED;
+		if (ok)
 		{
-			moduloCounter += 1.0;
-			return true;
+			char* lower = (char*)base;
+			ok = mmap(lower, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+				 mmap(lower + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+			if (!ok)
+				munmap(base, 2 * bytes);
 		}
+		close(fd); // --- the mappings keep the pages alive
 
-		return false;
-	}
+		if (!ok)
+			return false;
 
-	/** advanvce the modulo counter */
-	inline void advanceModulo(double& moduloCounter, double phaseInc) { moduloCounter += phaseInc; }
+		buffer = (T*)base;
+		mappedBytes = 2 * bytes;
+		mirrored = true;
+		return true;
+	}
+#endif
 
-	const double B = 4.0 / kPi;
-	const double C = -4.0 / (kPi* kPi);
-	const double P = 0.225;
-	/** parabolic sinusoidal calcualtion; NOTE: input is -pi to +pi http://devmaster.net/posts/9648/fast-and-accurate-sine-cosine */
-	inline double parabolicSine(double angle)
+	/** release the mapping or the heap buffer */
+	void destroyCircularBuffer()
 	{
-		double y = B * angle + C * angle * fabs(angle);
-		y = P * (y * fabs(y) - y) + y;
-		return y;
+#if defined(__linux__)
+		if (mappedBytes > 0)
+			munmap(buffer, mappedBytes);
+#endif
+		mappedBytes = 0;
+		heapBuffer.reset();
+		buffer = nullptr;
+		mirrored = false;
 	}
+
+private:
+	T* buffer = nullptr;					///< start of the lower half
+	FXArray<T> heapBuffer = nullptr;		///< storage for the double-write fallback
+	size_t mappedBytes = 0;					///< size of the mapping (both halves), 0 if not mapped
+	bool mirrored = false;					///< true if the halves share pages
+	unsigned int writeIndex = 0;			///> write index
+	unsigned int bufferLength = 0;			///< length of one half
+	unsigned int requestedLength = 0;		///< createCircularBuffer( ) argument for the current mapping
+	bool interpolate = true;				///< interpolation (default is ON)
+	FractionalDelayInterpolator<T> interpolator;	///< higher order interpolators; see setInterpolation( )
 };
 
+
 /**
-\enum DFOscillatorCoeffs
-\ingroup Constants-Enums
+\class ImpulseConvolver
+\ingroup FX-Objects
 \brief
-Use this non-typed enum to easily access the direct form oscillator coefficients
+The ImpulseConvolver object implements a linear conovlver. NOTE: compile in Release mode or you may experice stuttering,
+glitching or other sample-drop activity.
 
-- enum DFOscillatorCoeffs { df_b1, df_b2, numDFOCoeffs };
+Audio I/O:
+- Processes mono input to mono output.
+
+Control I/F:
+- none.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-enum DFOscillatorCoeffs { df_b1, df_b2, numDFOCoeffs };
+class ImpulseConvolver : public IAudioSignalProcessor
+{
+public:
+	ImpulseConvolver() {
+		init(512);
+	}		/* C-TOR */
+	~ImpulseConvolver() {}		/* D-TOR */
+
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		// --- flush signal buffer; IR buffer is static
+		signalBuffer.flushBuffer();
+		return true;
+	}
+
+	/** process one input - note this is CPU intensive as it performs simple linear convolution */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		double output = 0.0;
+
+		// --- write buffer; x(n) overwrites oldest value
+		//     this is the only time we do not read before write!
+		signalBuffer.writeBuffer(xn);
 
+		// --- do the convolution
+		for (unsigned int i = 0; i < length; i++)
+		{
+			// --- y(n) += x(n)h(n)
+			//     for signalBuffer.readBuffer(0) -> x(n)
+			//		   signalBuffer.readBuffer(n-D)-> x(n-D)
+			double signal = signalBuffer.readBuffer((int)i);
+			double irrrrr = irBuffer.readBuffer((int)i);
+			output += signal*irrrrr;
+
+			//output += signalBuffer.readBuffer((int)i) * irBuffer.readBuffer((int)i);
+		}
+
+		return output;
+	}
+
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** create the buffer based on the exact power of 2 */
+	void init(unsigned int lengthPowerOfTwo)
+	{
+		length = lengthPowerOfTwo;
+		// --- create (and clear out) the buffers
+		signalBuffer.createCircularBufferPowerOfTwo(lengthPowerOfTwo);
+		irBuffer.createLinearBuffer(lengthPowerOfTwo);
+	}
+
+	/** set the impulse response */
+	void setImpulseResponse(double* irArray, unsigned int lengthPowerOfTwo)
+	{
+		if (lengthPowerOfTwo != length)
+		{
+			length = lengthPowerOfTwo;
+			// --- create (and clear out) the buffers
+			signalBuffer.createCircularBufferPowerOfTwo(lengthPowerOfTwo);
+			irBuffer.createLinearBuffer(lengthPowerOfTwo);
+		}
+
+		// --- load up the IR buffer
+		for (unsigned int i = 0; i < length; i++)
+		{
+			irBuffer.writeBuffer(i, irArray[i]);
+		}
+	}
+
+protected:
+	// --- delay buffer of doubles
+	CircularBuffer<double> signalBuffer; ///< circulat buffer for the signal
+	LinearBuffer<double> irBuffer;	///< linear buffer for the IR
+
+	unsigned int length = 0;	///< length of convolution (buffer)
+
+};
+
+const unsigned int IR_LEN = 512;
 /**
-\enum DFOscillatorStates
-\ingroup Constants-Enums
+\struct AnalogFIRFilterParameters
+\ingroup FX-Objects
 \brief
-Use this non-typed enum to easily access the direct form oscillator state registers
-
-- DFOscillatorStates { df_yz1, df_yz2, numDFOStates };
+Custom parameter structure for the AnalogFIRFilter object. This is a somewhat silly object that implaments an analog
+magnitude response as a FIR filter. NOT DESIGNED to replace virtual analog; rather it is intended to show the
+frequency sampling method in an easy (and fun) way.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-enum DFOscillatorStates { df_yz1, df_yz2, numDFOStates };
+struct AnalogFIRFilterParameters
+{
+	AnalogFIRFilterParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	AnalogFIRFilterParameters& operator=(const AnalogFIRFilterParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
+
+		filterType = params.filterType;
+		fc = params.fc;
+		Q = params.Q;
+
+		return *this;
+	}
 
+	// --- individual parameters
+	analogFilter filterType = analogFilter::kLPF1; ///< filter type
+	double fc = 0.0;	///< filter fc
+	double Q = 0.0;		///< filter Q
+};
 
 /**
-\class DFOscillator
+\class AnalogFIRFilter
 \ingroup FX-Objects
 \brief
-The DFOscillator object implements generates a very pure sinusoidal oscillator by placing poles direclty on the unit circle.
-Accuracy is excellent even at low frequencies.
+The AnalogFIRFilter object implements a somewhat silly algorithm that implaments an analog
+magnitude response as a FIR filter. NOT DESIGNED to replace virtual analog; rather it is intended to show the
+frequency sampling method in an easy (and fun) way.
 
 Audio I/O:
-- Output only object: pitched audio sinusoidal generator.
+- Processes mono input to mono output.
 
 Control I/F:
-- Use OscillatorParameters structure to get/set object params.
+- Use AnalogFIRFilterParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class DFOscillator : public IAudioSignalGenerator
+class AnalogFIRFilter : public IAudioSignalProcessor
 {
 public:
-	DFOscillator() { }	/* C-TOR */
-	virtual ~DFOscillator() {}				/* D-TOR */
+	AnalogFIRFilter() {}	/* C-TOR */
+	~AnalogFIRFilter() {}	/* D-TOR */
 
+public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
 		sampleRate = _sampleRate;
-		memset(&stateArray[0], 0, sizeof(double)*numDFOStates);
-		updateDFO();
+		convolver.reset(_sampleRate);
+		convolver.init(IR_LEN);
 		return true;
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
+	/** pefrorm the convolution */
 	/**
-	\return OscillatorParameters custom data structure
+	\param xn input
+	\return the processed sample
 	*/
-	OscillatorParameters getParameters()
+	virtual double processAudioSample(double xn)
 	{
-		return parameters;
+		// --- do the linear convolution
+		return convolver.processAudioSample(xn);
 	}
 
-	/** set parameters: note use of custom structure for passing param data */
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\param OscillatorParameters custom data structure
+	\return AnalogFIRFilterParameters custom data structure
 	*/
-	void setParameters(const OscillatorParameters& params)
-	{
-		if (parameters.frequency_Hz != params.frequency_Hz)
-		{
-			parameters = params;
-			updateDFO();
-		}
-	}
-
-	/** render the audio signal (pure sinusoid) */
-	virtual const SignalGenData renderAudioOutput()
-	{
-		// --- calculates normal and inverted outputs; quadphase are not used
-		SignalGenData output;
-
-		// -- do difference equation y(n) = -b1y(n-2) - b2y(n-2)
-		output.normalOutput = (-coeffArray[df_b1]*stateArray[df_yz1] - coeffArray[df_b2]*stateArray[df_yz2]);
-		output.invertedOutput = -output.normalOutput;
-
-		// --- update states
-		stateArray[df_yz2] = stateArray[df_yz1];
-		stateArray[df_yz1] = output.normalOutput;
-
-		return output;
-	}
+	AnalogFIRFilterParameters getParameters() { return parameters; }
 
-	/** Update the object */
-	void updateDFO()
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param AnalogFIRFilterParameters custom data structure
+	*/
+	void setParameters(AnalogFIRFilterParameters _parameters)
 	{
-		// --- Oscillation Rate = theta = wT = w/fs
-		double wT = (kTwoPi*parameters.frequency_Hz) / sampleRate;
+		if (_parameters.fc != parameters.fc ||
+			_parameters.Q != parameters.Q ||
+			_parameters.filterType != parameters.filterType)
+		{
+			// --- set the filter IR for the convolver
+			AnalogMagData analogFilterData;
+			analogFilterData.sampleRate = sampleRate;
+			analogFilterData.magArray = &analogMagArray[0];
+			analogFilterData.dftArrayLen = IR_LEN;
+			analogFilterData.mirrorMag = false;
 
-		// --- coefficients to place poles right on unit circle
-		coeffArray[df_b1] = -2.0*cos(wT);	// <--- set angle a = -2Rcod(theta)
-		coeffArray[df_b2] = 1.0;			// <--- R^2 = 1, so R = 1
+			analogFilterData.filterType = _parameters.filterType;
+			analogFilterData.fc = _parameters.fc; // 1000.0;
+			analogFilterData.Q = _parameters.Q;
 
-		// --- now update states to reflect the new frequency
-		//	   re calculate the new initial conditions
-		//	   arcsine of y(n-1) gives us wnT
-		double wnT1 = asin(stateArray[df_yz1]);
+			// --- calculate the analog mag array
+			calculateAnalogMagArray(analogFilterData);
 
-		// find n by dividing wnT by wT
-		double n = wnT1 / wT;
+			// --- frequency sample the mag array
+			freqSample(IR_LEN, analogMagArray, irArray, POSITIVE);
 
-		// --- re calculate the new initial conditions
-		//	   asin returns values from -pi/2 to +pi/2 where the sinusoid
-		//     moves from -1 to +1 -- the leading (rising) edge of the
-		//     sinewave. If we are on that leading edge (increasing)
-		//     then we use the value 1T behind.
-		//
-		//     If we are on the falling edge, we use the value 1T ahead
-		//     because it mimics the value that would be 1T behind
-		if (stateArray[df_yz1] > stateArray[df_yz2])
-			n -= 1;
-		else
-			n += 1;
+			// --- update new frequency response
+			convolver.setImpulseResponse(irArray, IR_LEN);
+		}
 
-		// ---  calculate the new (old) sample
-		stateArray[df_yz2] = sin((n)*wT);
+		parameters = _parameters;
 	}
 
+private:
+	AnalogFIRFilterParameters parameters; ///< object parameters
+	ImpulseConvolver convolver; ///< convolver object to perform FIR convolution
+	double analogMagArray[IR_LEN] = { 0.0 }; ///< array for analog magnitude response
+	double irArray[IR_LEN] = { 0.0 }; ///< array to hold calcualted IR
+	double sampleRate = 0.0; ///< storage for sample rate
+};
 
-protected:
-	// --- parameters
-	OscillatorParameters parameters; ///< object parameters
-
-	// --- implementation of half a biquad - this object is extremely specific
-	double stateArray[numDFOStates] = { 0.0 };///< array of state registers
-	double coeffArray[numDFOCoeffs] = { 0.0 };///< array of coefficients
+/**
+\enum delayAlgorithm
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to easily set the delay algorithm
 
-	// --- sample rate
-	double sampleRate = 0.0;			///< sample rate
-};
+- enum class delayAlgorithm { kNormal, kPingPong };
 
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class delayAlgorithm { kNormal, kPingPong };
 
 /**
-\enum modDelaylgorithm
+\enum delayUpdateType
 \ingroup Constants-Enums
 \brief
-Use this strongly typed enum to easily set modulated delay algorithm.
+Use this strongly typed enum to easily set the delay update type; this varies depending on the designer's choice
+of GUI controls. See the book reference for more details.
 
-- enum class modDelaylgorithm { kFlanger, kChorus, kVibrato };
+- enum class delayUpdateType { kLeftAndRight, kLeftPlusRatio };
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-enum class modDelaylgorithm { kFlanger, kChorus, kVibrato };
+enum class delayUpdateType { kLeftAndRight, kLeftPlusRatio };
 
 
 /**
-\struct ModulatedDelayParameters
+\struct AudioDelayParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the ModulatedDelay object.
+Custom parameter structure for the AudioDelay object.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct ModulatedDelayParameters
+struct AudioDelayParameters
 {
-	ModulatedDelayParameters() {}
+	AudioDelayParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	ModulatedDelayParameters& operator=(const ModulatedDelayParameters& params)	// need this override for collections to work
+	AudioDelayParameters& operator=(const AudioDelayParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
 
 		algorithm = params.algorithm;
-		lfoRate_Hz = params.lfoRate_Hz;
-		lfoDepth_Pct = params.lfoDepth_Pct;
+		wetLevel_dB = params.wetLevel_dB;
+		dryLevel_dB = params.dryLevel_dB;
 		feedback_Pct = params.feedback_Pct;
+
+		updateType = params.updateType;
+		leftDelay_mSec = params.leftDelay_mSec;
+		rightDelay_mSec = params.rightDelay_mSec;
+		delayRatio_Pct = params.delayRatio_Pct;
+		interpolation = params.interpolation;
+
 		return *this;
 	}
 
 	// --- individual parameters
-	modDelaylgorithm algorithm = modDelaylgorithm::kFlanger; ///< mod delay algorithm
-	double lfoRate_Hz = 0.0;	///< mod delay LFO rate in Hz
-	double lfoDepth_Pct = 0.0;	///< mod delay LFO depth in %
-	double feedback_Pct = 0.0;	///< feedback in %
+	delayAlgorithm algorithm = delayAlgorithm::kNormal; ///< delay algorithm
+	double wetLevel_dB = -3.0;	///< wet output level in dB
+	double dryLevel_dB = -3.0;	///< dry output level in dB
+	double feedback_Pct = 0.0;	///< feedback as a % value
+
+	delayUpdateType updateType = delayUpdateType::kLeftAndRight;///< update algorithm
+	double leftDelay_mSec = 0.0;	///< left delay time
+	double rightDelay_mSec = 0.0;	///< right delay time
+	double delayRatio_Pct = 100.0;	///< dela ratio: right length = (delayRatio)*(left length)
+	bufferInterpolation interpolation = bufferInterpolation::kLinear;	///< fractional delay interpolator
 };
 
 /**
-\class ModulatedDelay
+\class AudioDelayT
 \ingroup FX-Objects
 \brief
-The ModulatedDelay object implements the three basic algorithms: flanger, chorus, vibrato.
+The AudioDelay object implements a stereo audio delay with multiple delay algorithms.
 
-Audio I / O :
-	-Processes mono input to mono OR stereo output.
+Audio I/O:
+- Processes mono input to mono output OR stereo output.
 
-Control I / F :
-	-Use ModulatedDelayParameters structure to get / set object params.
+Control I/F:
+- Use AudioDelayParameters structure to get/set object params.
 
-\author Will Pirkle http ://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed.by Will Pirkle
+Buffers:
+- DelayBuffer is the circular buffer type: CircularBuffer<double> (AudioDelay) or ExactCircularBuffer<double> (ExactAudioDelay)
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class ModulatedDelay : public IAudioSignalProcessor
+template <class DelayBuffer = CircularBuffer<double>>
+class AudioDelayT : public IAudioSignalProcessor
 {
 public:
-	ModulatedDelay() {
-	}		/* C-TOR */
-	~ModulatedDelay() {}	/* D-TOR */
+	AudioDelayT() {}	/* C-TOR */
+	~AudioDelayT() {}	/* D-TOR */
 
 public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		// --- create new buffer, 100mSec long
-		delay.reset(_sampleRate);
-		delay.createDelayBuffers(_sampleRate, 100.0);
+		// --- if sample rate did not change
+		if (sampleRate == _sampleRate)
+		{
+			// --- just flush buffer and return
+			delayBuffer_L.flushBuffer();
+			delayBuffer_R.flushBuffer();
+			return true;
+		}
 
-		// --- lfo
-		lfo.reset(_sampleRate);
-		OscillatorParameters params = lfo.getParameters();
-		params.waveform = generatorWaveform::kTriangle;
-		lfo.setParameters(params);
+		// --- create new buffer, will store sample rate and length(mSec)
+		createDelayBuffers(_sampleRate, bufferLength_mSec);
 
 		return true;
 	}
 
-	/** process input sample */
+	/** process MONO audio delay */
 	/**
 	\param xn input
 	\return the processed sample
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		float input = xn;
-		float output = 0.0;
-		processAudioFrame(&input, &output, 1, 1);
+		// --- read delay
+		double yn = delayBuffer_L.readBuffer(delayInSamples_L);
+
+		// --- create input for delay buffer
+		double dn = xn + (parameters.feedback_Pct / 100.0) * yn;
+		antiDenormal.apply(dn);
+
+		// --- write to delay buffer
+		delayBuffer_L.writeBuffer(dn);
+
+		// --- form mixture out = dry*xn + wet*yn
+		double output = dryMix*xn + wetMix*yn;
+
 		return output;
 	}
 
-	/** return true: this object can process frames */
+	/** return true: this object can also process frames */
 	virtual bool canProcessAudioFrame() { return true; }
 
-	/** process STEREO audio delay of frames */
+	/** process STEREO audio delay in frames */
 	virtual bool processAudioFrame(const float* inputFrame,		/* ptr to one frame of data: pInputFrame[0] = left, pInputFrame[1] = right, etc...*/
 		float* outputFrame,
 		uint32_t inputChannels,
@@ -3368,885 +4192,883 @@ public:
 		if (inputChannels == 0 || outputChannels == 0)
 			return false;
 
-		// --- render LFO
-		SignalGenData lfoOutput = lfo.renderAudioOutput();
-
-		// --- setup delay modulation
-		AudioDelayParameters params = delay.getParameters();
-		double minDelay_mSec = 0.0;
-		double maxDepth_mSec = 0.0;
+		// --- make sure we support this delay algorithm
+		if (parameters.algorithm != delayAlgorithm::kNormal &&
+			parameters.algorithm != delayAlgorithm::kPingPong)
+			return false;
 
-		// --- set delay times, wet/dry and feedback
-		if (parameters.algorithm == modDelaylgorithm::kFlanger)
-		{
-			minDelay_mSec = 0.1;
-			maxDepth_mSec = 7.0;
-			params.wetLevel_dB = -3.0;
-			params.dryLevel_dB = -3.0;
-		}
-		if (parameters.algorithm == modDelaylgorithm::kChorus)
-		{
-			minDelay_mSec = 10.0;
-			maxDepth_mSec = 30.0;
-			params.wetLevel_dB = -3.0;
-			params.dryLevel_dB = -0.0;
-			params.feedback_Pct = 0.0;
-		}
-		if (parameters.algorithm == modDelaylgorithm::kVibrato)
+		// --- if only one output channel, revert to mono operation
+		if (outputChannels == 1)
 		{
-			minDelay_mSec = 0.0;
-			maxDepth_mSec = 7.0;
-			params.wetLevel_dB = 0.0;
-			params.dryLevel_dB = -96.0;
-			params.feedback_Pct = 0.0;
+			// --- process left channel only
+			outputFrame[0] = processAudioSample(inputFrame[0]);
+			return true;
 		}
 
-		// --- calc modulated delay times
-		double depth = parameters.lfoDepth_Pct / 100.0;
-		double modulationMin = minDelay_mSec;
-		double modulationMax = minDelay_mSec + maxDepth_mSec;
+		// --- if we get here we know we have 2 output channels
+		//
+		// --- pick up inputs
+		//
+		// --- LEFT channel
+		double xnL = inputFrame[0];
 
-		// --- flanger - unipolar
-		if (parameters.algorithm == modDelaylgorithm::kFlanger)
-			params.leftDelay_mSec = doUnipolarModulationFromMin(bipolarToUnipolar(depth * lfoOutput.normalOutput),
-															     modulationMin, modulationMax);
-		else
-			params.leftDelay_mSec = doBipolarModulation(depth * lfoOutput.normalOutput, modulationMin, modulationMax);
+		// --- RIGHT channel (duplicate left input if mono-in)
+		double xnR = inputChannels > 1 ? inputFrame[1] : xnL;
 
+		// --- read delay LEFT
+		double ynL = delayBuffer_L.readBuffer(delayInSamples_L);
 
-		// --- set right delay to match (*Hint Homework!)
-		params.rightDelay_mSec = params.leftDelay_mSec;
+		// --- read delay RIGHT
+		double ynR = delayBuffer_R.readBuffer(delayInSamples_R);
 
-		// --- modulate the delay
-		delay.setParameters(params);
+		// --- create input for delay buffer with LEFT channel info
+		double dnL = xnL + (parameters.feedback_Pct / 100.0) * ynL;
 
-		// --- just call the function and pass our info in/out
-		return delay.processAudioFrame(inputFrame, outputFrame, inputChannels, outputChannels);
+		// --- create input for delay buffer with RIGHT channel info
+		double dnR = xnR + (parameters.feedback_Pct / 100.0) * ynR;
+
+		antiDenormal.apply(dnL);
+		antiDenormal.apply(dnR);
+
+		// --- decode
+		if (parameters.algorithm == delayAlgorithm::kNormal)
+		{
+			// --- write to LEFT delay buffer with LEFT channel info
+			delayBuffer_L.writeBuffer(dnL);
+
+			// --- write to RIGHT delay buffer with RIGHT channel info
+			delayBuffer_R.writeBuffer(dnR);
+		}
+		else if (parameters.algorithm == delayAlgorithm::kPingPong)
+		{
+			// --- write to LEFT delay buffer with RIGHT channel info
+			delayBuffer_L.writeBuffer(dnR);
+
+			// --- write to RIGHT delay buffer with LEFT channel info
+			delayBuffer_R.writeBuffer(dnL);
+		}
+
+		// --- form mixture out = dry*xn + wet*yn
+		double outputL = dryMix*xnL + wetMix*ynL;
+
+		// --- form mixture out = dry*xn + wet*yn
+		double outputR = dryMix*xnR + wetMix*ynR;
+
+		// --- set left channel
+		outputFrame[0] = outputL;
+
+		// --- set right channel
+		outputFrame[1] = outputR;
+
+		return true;
 	}
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\return ModulatedDelayParameters custom data structure
+	\return AudioDelayParameters custom data structure
 	*/
-	ModulatedDelayParameters getParameters() { return parameters; }
+	AudioDelayParameters getParameters() { return parameters; }
 
 	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param ModulatedDelayParameters custom data structure
+	\param AudioDelayParameters custom data structure
 	*/
-	void setParameters(ModulatedDelayParameters _parameters)
+	void setParameters(AudioDelayParameters _parameters)
 	{
-		// --- bulk copy
+		// --- check mix in dB for calc
+		if (_parameters.dryLevel_dB != parameters.dryLevel_dB)
+			dryMix = pow(10.0, _parameters.dryLevel_dB / 20.0);
+		if (_parameters.wetLevel_dB != parameters.wetLevel_dB)
+			wetMix = pow(10.0, _parameters.wetLevel_dB / 20.0);
+
+		// --- only on change: this clears the allpass interpolator state
+		if (_parameters.interpolation != parameters.interpolation)
+		{
+			delayBuffer_L.setInterpolation(_parameters.interpolation);
+			delayBuffer_R.setInterpolation(_parameters.interpolation);
+		}
+
+		// --- save; rest of updates are cheap on CPU
 		parameters = _parameters;
 
-		OscillatorParameters lfoParams = lfo.getParameters();
-		lfoParams.frequency_Hz = parameters.lfoRate_Hz;
-		if (parameters.algorithm == modDelaylgorithm::kVibrato)
-			lfoParams.waveform = generatorWaveform::kSin;
-		else
-			lfoParams.waveform = generatorWaveform::kTriangle;
+		// --- check update type first:
+		if (parameters.updateType == delayUpdateType::kLeftAndRight)
+		{
+			// --- set left and right delay times
+			// --- calculate total delay time in samples + fraction
+			double newDelayInSamples_L = parameters.leftDelay_mSec*(samplesPerMSec);
+			double newDelayInSamples_R = parameters.rightDelay_mSec*(samplesPerMSec);
 
-		lfo.setParameters(lfoParams);
+			// --- new delay time with fraction
+			delayInSamples_L = newDelayInSamples_L;
+			delayInSamples_R = newDelayInSamples_R;
+		}
+		else if (parameters.updateType == delayUpdateType::kLeftPlusRatio)
+		{
+			// --- get and validate ratio
+			double delayRatio = parameters.delayRatio_Pct / 100.0;
+			boundValue(delayRatio, 0.0, 1.0);
 
-		AudioDelayParameters adParams = delay.getParameters();
-		adParams.feedback_Pct = parameters.feedback_Pct;
-		delay.setParameters(adParams);
+			// --- calculate total delay time in samples + fraction
+			double newDelayInSamples = parameters.leftDelay_mSec*(samplesPerMSec);
+
+			// --- new delay time with fraction
+			delayInSamples_L = newDelayInSamples;
+			delayInSamples_R = delayInSamples_L*delayRatio;
+		}
+	}
+
+	/** creation function */
+	void createDelayBuffers(double _sampleRate, double _bufferLength_mSec)
+	{
+		// --- store for math
+		bufferLength_mSec = _bufferLength_mSec;
+		sampleRate = _sampleRate;
+		samplesPerMSec = sampleRate / 1000.0;
+
+		// --- total buffer length including fractional part
+		bufferLength = (unsigned int)(bufferLength_mSec*(samplesPerMSec)) + 1; // +1 for fractional part
+
+																			   // --- create new buffer
+		delayBuffer_L.createCircularBuffer(bufferLength);
+		delayBuffer_R.createCircularBuffer(bufferLength);
 	}
 
 private:
-	ModulatedDelayParameters parameters; ///< object parameters
-	AudioDelay delay;	///< the delay to modulate
-	LFO lfo;			///< the modulator
+	AudioDelayParameters parameters; ///< object parameters
+
+	double sampleRate = 0.0;		///< current sample rate
+	double samplesPerMSec = 0.0;	///< samples per millisecond, for easy access calculation
+	double delayInSamples_L = 0.0;	///< double includes fractional part
+	double delayInSamples_R = 0.0;	///< double includes fractional part
+	double bufferLength_mSec = 0.0;	///< buffer length in mSec
+	unsigned int bufferLength = 0;	///< buffer length in samples
+	double wetMix = 0.707; ///< wet output default = -3dB
+	double dryMix = 0.707; ///< dry output default = -3dB
+
+	// --- delay buffer of doubles
+	DelayBuffer delayBuffer_L;	///< LEFT delay buffer of doubles
+	DelayBuffer delayBuffer_R;	///< RIGHT delay buffer of doubles
+	AntiDenormal antiDenormal;	///< see FX_DENORMAL_INJECTION
 };
 
+typedef AudioDelayT<> AudioDelay;									///< power-of-two buffers
+typedef AudioDelayT<ExactCircularBuffer<double>> ExactAudioDelay;	///< exact length buffers
+
+
 /**
-\struct PhaseShifterParameters
+\enum generatorWaveform
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to easily set the oscillator waveform
+
+- enum  generatorWaveform { kTriangle, kSin, kSaw };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class generatorWaveform { kTriangle, kSin, kSaw };
+
+/**
+\struct OscillatorParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the PhaseShifter object.
+Custom parameter structure for the LFO and DFOscillator objects.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct PhaseShifterParameters
+struct OscillatorParameters
 {
-	PhaseShifterParameters() {}
+	OscillatorParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	PhaseShifterParameters& operator=(const PhaseShifterParameters& params)
+	OscillatorParameters& operator=(const OscillatorParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
 
-		lfoRate_Hz = params.lfoRate_Hz;
-		lfoDepth_Pct = params.lfoDepth_Pct;
-		intensity_Pct = params.intensity_Pct;
-		quadPhaseLFO = params.quadPhaseLFO;
+		waveform = params.waveform;
+		frequency_Hz = params.frequency_Hz;
 		return *this;
 	}
 
 	// --- individual parameters
-	double lfoRate_Hz = 0.0;	///< phaser LFO rate in Hz
-	double lfoDepth_Pct = 0.0;	///< phaser LFO depth in %
-	double intensity_Pct = 0.0;	///< phaser feedback in %
-	bool quadPhaseLFO = false;	///< quad phase LFO flag
+	generatorWaveform waveform = generatorWaveform::kTriangle; ///< the current waveform
+	double frequency_Hz = 0.0;	///< oscillator frequency
 };
 
-// --- constants for Phaser
-const unsigned int PHASER_STAGES = 6;
-const double apf0_minF = 16.0;
-const double apf0_maxF = 1600.0;
-
-const double apf1_minF = 33.0;
-const double apf1_maxF = 3300.0;
-
-const double apf2_minF = 48.0;
-const double apf2_maxF = 4800.0;
-
-const double apf3_minF = 98.0;
-const double apf3_maxF = 9800.0;
-
-const double apf4_minF = 160.0;
-const double apf4_maxF = 16000.0;
-
-const double apf5_minF = 260.0;
-const double apf5_maxF = 20480.0;
-
 /**
-\class PhaseShifter
+\class LFO
 \ingroup FX-Objects
 \brief
-The PhaseShifter object implements a six-stage phaser.
+The LFO object implements a mathematically perfect LFO generator for modulation uses only. It should not be used for
+audio frequencies except for the sinusoidal output which, though an approximation, has very low TDH.
 
 Audio I/O:
-- Processes mono input to mono output.
+- Output only object: low frequency generator.
 
 Control I/F:
-- Use BiquadParameters structure to get/set object params.
+- Use OscillatorParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class PhaseShifter : public IAudioSignalProcessor
+class LFO : public IAudioSignalGenerator
 {
 public:
-	PhaseShifter(void) {
-		OscillatorParameters lfoparams = lfo.getParameters();
-		lfoparams.waveform = generatorWaveform::kSin;// sine LFO for phaser
-		lfo.setParameters(lfoparams);
-
-		AudioFilterParameters params = apf[0].getParameters();
-		params.algorithm = filterAlgorithm::kAPF1;
-
-		for (int i = 0; i < PHASER_STAGES; i++)
-		{
-			apf[i].setParameters(params);
-		}
-	}	/* C-TOR */
-
-	~PhaseShifter(void) {}	/* D-TOR */
+	LFO() {	srand(time(NULL)); }	/* C-TOR */
+	virtual ~LFO() {}				/* D-TOR */
 
-public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		// --- reset LFO
-		lfo.reset(_sampleRate);
+		sampleRate = _sampleRate;
+		phaseInc = lfoParameters.frequency_Hz / sampleRate;
 
-		// --- reset APFs
-		for (int i = 0; i < PHASER_STAGES; i++){
-			apf[i].reset(_sampleRate);
-		}
+		// --- timebase variables
+		modCounter = 0.0;			///< modulo counter [0.0, +1.0]
+		modCounterQP = 0.25;		///<Quad Phase modulo counter [0.0, +1.0]
 
 		return true;
 	}
 
-	/** process autio through phaser */
+	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\param xn input
-	\return the processed sample
+	\return OscillatorParameters custom data structure
 	*/
-	virtual double processAudioSample(double xn)
+	OscillatorParameters getParameters(){ return lfoParameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param OscillatorParameters custom data structure
+	*/
+	void setParameters(const OscillatorParameters& params)
 	{
-		SignalGenData lfoData = lfo.renderAudioOutput();
+		if(params.frequency_Hz != lfoParameters.frequency_Hz)
+			// --- update phase inc based on osc freq and fs
+			phaseInc = params.frequency_Hz / sampleRate;
 
-		// --- create the bipolar modulator value
-		double lfoValue = lfoData.normalOutput;
-		if (parameters.quadPhaseLFO)
-			lfoValue = lfoData.quadPhaseOutput_pos;
-
-		double depth = parameters.lfoDepth_Pct / 100.0;
-		double modulatorValue = lfoValue*depth;
-
-		// --- calculate modulated values for each APF; note they have different ranges
-		AudioFilterParameters params = apf[0].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf0_minF, apf0_maxF);
-		apf[0].setParameters(params);
+		lfoParameters = params;
+	}
 
-		params = apf[1].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf1_minF, apf1_maxF);
-		apf[1].setParameters(params);
+	/** render a new audio output structure */
+	virtual const SignalGenData renderAudioOutput();
 
-		params = apf[2].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf2_minF, apf2_maxF);
-		apf[2].setParameters(params);
+protected:
+	// --- parameters
+	OscillatorParameters lfoParameters; ///< obejcgt parameters
 
-		params = apf[3].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf3_minF, apf3_maxF);
-		apf[3].setParameters(params);
+	// --- sample rate
+	double sampleRate = 0.0;			///< sample rate
 
-		params = apf[4].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf4_minF, apf4_maxF);
-		apf[4].setParameters(params);
+	// --- timebase variables
+	double modCounter = 0.0;			///< modulo counter [0.0, +1.0]
+	double phaseInc = 0.0;				///< phase inc = fo/fs
+	double modCounterQP = 0.25;			///<Quad Phase modulo counter [0.0, +1.0]
 
-		params = apf[5].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf5_minF, apf5_maxF);
-		apf[5].setParameters(params);
+	/** check the modulo counter and wrap if needed */
+	inline bool checkAndWrapModulo(double& moduloCounter, double phaseInc)
+	{
+		// --- for positive frequencies
+		if (phaseInc > 0 && moduloCounter >= 1.0)
+		{
+			moduloCounter -= 1.0;
+			return true;
+		}
 
-		// --- calculate gamma values
-		double gamma1 = apf[5].getG_value();
-		double gamma2 = apf[4].getG_value() * gamma1;
-		double gamma3 = apf[3].getG_value() * gamma2;
-		double gamma4 = apf[2].getG_value() * gamma3;
-		double gamma5 = apf[1].getG_value() * gamma4;
-		double gamma6 = apf[0].getG_value() * gamma5;
+		// --- for negative frequencies
+		if (phaseInc < 0 && moduloCounter <= 0.0)
+		{
+			moduloCounter += 1.0;
+			return true;
+		}
 
-		// --- set the alpha0 value
-		double K = parameters.intensity_Pct / 100.0;
-		double alpha0 = 1.0 / (1.0 + K*gamma6);
+		return false;
+	}
 
-		// --- create combined feedback
-		double Sn = gamma5*apf[0].getS_value() + gamma4*apf[1].getS_value() + gamma3*apf[2].getS_value() + gamma2*apf[3].getS_value() + gamma1*apf[4].getS_value() + apf[5].getS_value();
+	/** advanvce the modulo counter, then check the modulo counter and wrap if needed */
+	inline bool advanceAndCheckWrapModulo(double& moduloCounter, double phaseInc)
+	{
+		// --- advance counter
+		moduloCounter += phaseInc;
 
-		// --- form input to first APF
-		double u = alpha0*(xn - K*Sn);
+		// --- for positive frequencies
+		if (phaseInc > 0 && moduloCounter >= 1.0)
+		{
+			moduloCounter -= 1.0;
+			return true;
+		}
 
-		// --- cascade of APFs (could also nest these in one massive line of code)
-		double APF1 = apf[0].processAudioSample(u);
-		double APF2 = apf[1].processAudioSample(APF1);
-		double APF3 = apf[2].processAudioSample(APF2);
-		double APF4 = apf[3].processAudioSample(APF3);
-		double APF5 = apf[4].processAudioSample(APF4);
-		double APF6 = apf[5].processAudioSample(APF5);
+		// --- for negative frequencies
+		if (phaseInc < 0 && moduloCounter <= 0.0)
+		{
+			moduloCounter += 1.0;
+			return true;
+		}
 
-		// --- sum with -3dB coefficients
-		double output = 0.707*xn + 0.707*APF6;
-		return output;
+		return false;
 	}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
-
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return PhaseShifterParameters custom data structure
-	*/
-	PhaseShifterParameters getParameters() { return parameters; }
+	/** advanvce the modulo counter */
+	inline void advanceModulo(double& moduloCounter, double phaseInc) { moduloCounter += phaseInc; }
 
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param PhaseShifterParameters custom data structure
-	*/
-	void setParameters(const PhaseShifterParameters& params)
+	const double B = 4.0 / kPi;
+	const double C = -4.0 / (kPi* kPi);
+	const double P = 0.225;
+	/** parabolic sinusoidal calcualtion; NOTE: input is -pi to +pi http://devmaster.net/posts/9648/fast-and-accurate-sine-cosine */
+	inline double parabolicSine(double angle)
 	{
-		// --- update LFO rate
-		if (params.lfoRate_Hz != parameters.lfoRate_Hz)
-		{
-			OscillatorParameters lfoparams = lfo.getParameters();
-			lfoparams.frequency_Hz = params.lfoRate_Hz;
-			lfo.setParameters(lfoparams);
-		}
-
-		// --- save new
-		parameters = params;
+		double y = B * angle + C * angle * fabs(angle);
+		y = P * (y * fabs(y) - y) + y;
+		return y;
 	}
-protected:
-	PhaseShifterParameters parameters;  ///< the object parameters
-	AudioFilter apf[PHASER_STAGES];		///< six APF objects
-	LFO lfo;							///< the one and only LFO
 };
 
 /**
-\struct SimpleLPFParameters
-\ingroup FX-Objects
+\enum DFOscillatorCoeffs
+\ingroup Constants-Enums
 \brief
-Custom parameter structure for the SimpleLPFP object. Used for reverb algorithms in book.
+Use this non-typed enum to easily access the direct form oscillator coefficients
+
+- enum DFOscillatorCoeffs { df_b1, df_b2, numDFOCoeffs };
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct SimpleLPFParameters
-{
-	SimpleLPFParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	SimpleLPFParameters& operator=(const SimpleLPFParameters& params)	// need this override for collections to work
-	{
-		if (this == &params)
-			return *this;
+enum DFOscillatorCoeffs { df_b1, df_b2, numDFOCoeffs };
 
-		g = params.g;
-		return *this;
-	}
+/**
+\enum DFOscillatorStates
+\ingroup Constants-Enums
+\brief
+Use this non-typed enum to easily access the direct form oscillator state registers
+
+- DFOscillatorStates { df_yz1, df_yz2, numDFOStates };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum DFOscillatorStates { df_yz1, df_yz2, numDFOStates };
 
-	// --- individual parameters
-	double g = 0.0; ///< simple LPF g value
-};
 
 /**
-\class SimpleLPF
+\class DFOscillator
 \ingroup FX-Objects
 \brief
-The SimpleLPF object implements a first order one-pole LPF using one coefficient "g" value.
+The DFOscillator object implements generates a very pure sinusoidal oscillator by placing poles direclty on the unit circle.
+Accuracy is excellent even at low frequencies.
 
 Audio I/O:
-- Processes mono input to mono output.
+- Output only object: pitched audio sinusoidal generator.
 
 Control I/F:
-- Use SimpleLPFParameters structure to get/set object params.
+- Use OscillatorParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class SimpleLPF : public IAudioSignalProcessor
+class DFOscillator : public IAudioSignalGenerator
 {
 public:
-	SimpleLPF(void) {}	/* C-TOR */
-	~SimpleLPF(void) {}	/* D-TOR */
+	DFOscillator() { }	/* C-TOR */
+	virtual ~DFOscillator() {}				/* D-TOR */
 
-public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		state = 0.0;
+		sampleRate = _sampleRate;
+		memset(&stateArray[0], 0, sizeof(double)*numDFOStates);
+		updateDFO();
 		return true;
 	}
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\return SimpleLPFParameters custom data structure
+	\return OscillatorParameters custom data structure
 	*/
-	SimpleLPFParameters getParameters()
+	OscillatorParameters getParameters()
 	{
-		return simpleLPFParameters;
+		return parameters;
 	}
 
 	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param SimpleLPFParameters custom data structure
+	\param OscillatorParameters custom data structure
 	*/
-	void setParameters(const SimpleLPFParameters& params)
+	void setParameters(const OscillatorParameters& params)
 	{
-		simpleLPFParameters = params;
+		if (parameters.frequency_Hz != params.frequency_Hz)
+		{
+			parameters = params;
+			updateDFO();
+		}
 	}
 
-	/** process simple one pole FB back filter */
-	/**
-	\param xn input
-	\return the processed sample
-	*/
-	virtual double processAudioSample(double xn)
+	/** render the audio signal (pure sinusoid) */
+	virtual const SignalGenData renderAudioOutput()
 	{
-		double g = simpleLPFParameters.g;
-		double yn = (1.0 - g)*xn + g*state;
-		state = yn;
-		return yn;
-	}
+		// --- calculates normal and inverted outputs; quadphase are not used
+		SignalGenData output;
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
+		// -- do difference equation y(n) = -b1y(n-2) - b2y(n-2)
+		output.normalOutput = (-coeffArray[df_b1]*stateArray[df_yz1] - coeffArray[df_b2]*stateArray[df_yz2]);
+		output.invertedOutput = -output.normalOutput;
 
-private:
-	SimpleLPFParameters simpleLPFParameters;	///< object parameters
-	double state = 0.0;							///< single state (z^-1) register
-};
+		// --- update states
+		stateArray[df_yz2] = stateArray[df_yz1];
+		stateArray[df_yz1] = output.normalOutput;
 
-/**
-\struct SimpleDelayParameters
-\ingroup FX-Objects
-\brief
-Custom parameter structure for the SimpleDelay object. Used for reverb algorithms in book.
+		return output;
+	}
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-struct SimpleDelayParameters
-{
-	SimpleDelayParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	SimpleDelayParameters& operator=(const SimpleDelayParameters& params)	// need this override for collections to work
+	/** Update the object */
+	void updateDFO()
 	{
-		if (this == &params)
-			return *this;
+		// --- Oscillation Rate = theta = wT = w/fs
+		double wT = (kTwoPi*parameters.frequency_Hz) / sampleRate;
 
-		delayTime_mSec = params.delayTime_mSec;
-		interpolate = params.interpolate;
-		delay_Samples = params.delay_Samples;
-		return *this;
+		// --- coefficients to place poles right on unit circle
+		coeffArray[df_b1] = -2.0*cos(wT);	// <--- set angle a = -2Rcod(theta)
+		coeffArray[df_b2] = 1.0;			// <--- R^2 = 1, so R = 1
+
+		// --- now update states to reflect the new frequency
+		//	   re calculate the new initial conditions
+		//	   arcsine of y(n-1) gives us wnT
+		double wnT1 = asin(stateArray[df_yz1]);
+
+		// find n by dividing wnT by wT
+		double n = wnT1 / wT;
+
+		// --- re calculate the new initial conditions
+		//	   asin returns values from -pi/2 to +pi/2 where the sinusoid
+		//     moves from -1 to +1 -- the leading (rising) edge of the
+		//     sinewave. If we are on that leading edge (increasing)
+		//     then we use the value 1T behind.
+		//
+		//     If we are on the falling edge, we use the value 1T ahead
+		//     because it mimics the value that would be 1T behind
+		if (stateArray[df_yz1] > stateArray[df_yz2])
+			n -= 1;
+		else
+			n += 1;
+
+		// ---  calculate the new (old) sample
+		stateArray[df_yz2] = sin((n)*wT);
 	}
 
-	// --- individual parameters
-	double delayTime_mSec = 0.0;	///< delay tine in mSec
-	bool interpolate = false;		///< interpolation flag (diagnostics usually)
 
-	// --- outbound parameters
-	double delay_Samples = 0.0;		///< current delay in samples; other objects may need to access this information
+protected:
+	// --- parameters
+	OscillatorParameters parameters; ///< object parameters
+
+	// --- implementation of half a biquad - this object is extremely specific
+	double stateArray[numDFOStates] = { 0.0 };///< array of state registers
+	double coeffArray[numDFOCoeffs] = { 0.0 };///< array of coefficients
+
+	// --- sample rate
+	double sampleRate = 0.0;			///< sample rate
 };
 
+
 /**
-\class SimpleDelay
-\ingroup FX-Objects
+\enum modDelaylgorithm
+\ingroup Constants-Enums
 \brief
-The SimpleDelay object implements a basic delay line without feedback.
-
-Audio I/O:
-- Processes mono input to mono output.
+Use this strongly typed enum to easily set modulated delay algorithm.
 
-Control I/F:
-- Use SimpleDelayParameters structure to get/set object params.
+- enum class modDelaylgorithm { kFlanger, kChorus, kVibrato };
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class SimpleDelay : public IAudioSignalProcessor
-{
-public:
-	SimpleDelay(void) {}	/* C-TOR */
-	~SimpleDelay(void) {}	/* D-TOR */
-
-public:
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate)
-	{
-		// --- if sample rate did not change
-		if (sampleRate == _sampleRate)
-		{
-			// --- just flush buffer and return
-			delayBuffer.flushBuffer();
-			return true;
-		}
-
-		// --- create new buffer, will store sample rate and length(mSec)
-		createDelayBuffer(_sampleRate, bufferLength_mSec);
-
-		return true;
-	}
-
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return SimpleDelayParameters custom data structure
-	*/
-	SimpleDelayParameters getParameters()
-	{
-		return simpleDelayParameters;
-	}
-
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param SimpleDelayParameters custom data structure
-	*/
-	void setParameters(const SimpleDelayParameters& params)
-	{
-		simpleDelayParameters = params;
-		simpleDelayParameters.delay_Samples = simpleDelayParameters.delayTime_mSec*(samplesPerMSec);
-		delayBuffer.setInterpolate(simpleDelayParameters.interpolate);
-	}
-
-	/** process MONO audio delay */
-	/**
-	\param xn input
-	\return the processed sample
-	*/
-	virtual double processAudioSample(double xn)
-	{
-		// --- read delay
-		if (simpleDelayParameters.delay_Samples == 0)
-			return xn;
-
-		double yn = delayBuffer.readBuffer(simpleDelayParameters.delay_Samples);
-
-		// --- write to delay buffer
-		delayBuffer.writeBuffer(xn);
-
-		// --- done
-		return yn;
-	}
-
-	/** reset members to initialized state */
-	virtual bool canProcessAudioFrame() { return false; }
-
-	/** create a new delay buffer */
-	void createDelayBuffer(double _sampleRate, double _bufferLength_mSec)
-	{
-		// --- store for math
-		bufferLength_mSec = _bufferLength_mSec;
-		sampleRate = _sampleRate;
-		samplesPerMSec = sampleRate / 1000.0;
-
-		// --- total buffer length including fractional part
-		bufferLength = (unsigned int)(bufferLength_mSec*(samplesPerMSec)) + 1; // +1 for fractional part
-
-		// --- create new buffer
-		delayBuffer.createCircularBuffer(bufferLength);
-	}
-
-	/** read delay at current location */
-	double readDelay()
-	{
-		// --- simple read
-		return delayBuffer.readBuffer(simpleDelayParameters.delay_Samples);
-	}
-
-	/** read delay at current location */
-	double readDelayAtTime_mSec(double _delay_mSec)
-	{
-		// --- calculate total delay time in samples + fraction
-		double _delay_Samples = _delay_mSec*(samplesPerMSec);
-
-		// --- simple read
-		return delayBuffer.readBuffer(_delay_Samples);
-	}
-
-	/** read delay at a percentage of total length */
-	double readDelayAtPercentage(double delayPercent)
-	{
-		// --- simple read
-		return delayBuffer.readBuffer((delayPercent / 100.0)*simpleDelayParameters.delay_Samples);
-	}
-
-	/** write a new value into the delay */
-	void writeDelay(double xn)
-	{
-		// --- simple write
-		delayBuffer.writeBuffer(xn);
-	}
-
-private:
-	SimpleDelayParameters simpleDelayParameters; ///< object parameters
-
-	double sampleRate = 0.0;		///< sample rate
-	double samplesPerMSec = 0.0;	///< samples per millisecond (for arbitrary access)
-	double bufferLength_mSec = 0.0; ///< total buffer lenth in mSec
-	unsigned int bufferLength = 0;	///< buffer length in samples
-
-	// --- delay buffer of doubles
-	CircularBuffer<double> delayBuffer; ///< circular buffer for delay
-};
+enum class modDelaylgorithm { kFlanger, kChorus, kVibrato };
 
 
 /**
-\struct CombFilterParameters
+\struct ModulatedDelayParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the CombFilter object. Used for reverb algorithms in book.
+Custom parameter structure for the ModulatedDelay object.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct CombFilterParameters
+struct ModulatedDelayParameters
 {
-	CombFilterParameters() {}
+	ModulatedDelayParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	CombFilterParameters& operator=(const CombFilterParameters& params)	// need this override for collections to work
+	ModulatedDelayParameters& operator=(const ModulatedDelayParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
 
-		delayTime_mSec = params.delayTime_mSec;
-		RT60Time_mSec = params.RT60Time_mSec;
-		enableLPF = params.enableLPF;
-		lpf_g = params.lpf_g;
-		interpolate = params.interpolate;
+		algorithm = params.algorithm;
+		lfoRate_Hz = params.lfoRate_Hz;
+		lfoDepth_Pct = params.lfoDepth_Pct;
+		feedback_Pct = params.feedback_Pct;
+		interpolation = params.interpolation;
 		return *this;
 	}
 
 	// --- individual parameters
-	double delayTime_mSec = 0.0;	///< delay time in mSec
-	double RT60Time_mSec = 0.0;		///< RT 60 time ini mSec
-	bool enableLPF = false;			///< enable LPF flag
-	double lpf_g = 0.0;				///< gain value for LPF (if enabled)
-	bool interpolate = false;		///< interpolation flag (diagnostics)
+	modDelaylgorithm algorithm = modDelaylgorithm::kFlanger; ///< mod delay algorithm
+	double lfoRate_Hz = 0.0;	///< mod delay LFO rate in Hz
+	double lfoDepth_Pct = 0.0;	///< mod delay LFO depth in %
+	double feedback_Pct = 0.0;	///< feedback in %
+	bufferInterpolation interpolation = bufferInterpolation::kLinear;	///< swept delay interpolator; kHermite4 or better for clean vibrato
 };
 
-
 /**
-\class CombFilter
+\class ModulatedDelay
 \ingroup FX-Objects
 \brief
-The CombFilter object implements a comb filter with optional LPF in feedback loop. Used for reverb algorithms in book.
+The ModulatedDelay object implements the three basic algorithms: flanger, chorus, vibrato.
 
-Audio I/O:
-- Processes mono input to mono output.
+Audio I / O :
+	-Processes mono input to mono OR stereo output.
 
-Control I/F:
-- Use CombFilterParameters structure to get/set object params.
+Control I / F :
+	-Use ModulatedDelayParameters structure to get / set object params.
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\author Will Pirkle http ://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed.by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class CombFilter : public IAudioSignalProcessor
+class ModulatedDelay : public IAudioSignalProcessor
 {
 public:
-	CombFilter(void) {}		/* C-TOR */
-	~CombFilter(void) {}	/* D-TOR */
+	ModulatedDelay() {
+	}		/* C-TOR */
+	~ModulatedDelay() {}	/* D-TOR */
 
 public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		// --- flush
-		lpf_state = 0.0;
+		// --- create new buffer, 100mSec long
+		delay.reset(_sampleRate);
+		delay.createDelayBuffers(_sampleRate, 100.0);
 
-		// --- create new buffer, will store sample rate and length(mSec)
-		createDelayBuffer(sampleRate, bufferLength_mSec);
+		// --- lfo
+		lfo.reset(_sampleRate);
+		OscillatorParameters params = lfo.getParameters();
+		params.waveform = generatorWaveform::kTriangle;
+		lfo.setParameters(params);
 
 		return true;
 	}
 
-	/** process CombFilter */
+	/** process input sample */
 	/**
 	\param xn input
 	\return the processed sample
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		double yn = delay.readDelay();
-		double input = 0.0;
+		float input = xn;
+		float output = 0.0;
+		processAudioFrame(&input, &output, 1, 1);
+		return output;
+	}
 
-		// --- form input & write
-		if (combFilterParameters.enableLPF)
-		{
-			// --- apply simple 1st order pole LPF
-			double g2 = lpf_g*(1.0 - comb_g); // see book for equation 11.27 (old book)
-			double filteredSignal = yn + g2*lpf_state;
-			input = xn + comb_g*(filteredSignal);
-			lpf_state = filteredSignal;
+	/** return true: this object can process frames */
+	virtual bool canProcessAudioFrame() { return true; }
+
+	/** process STEREO audio delay of frames */
+	virtual bool processAudioFrame(const float* inputFrame,		/* ptr to one frame of data: pInputFrame[0] = left, pInputFrame[1] = right, etc...*/
+		float* outputFrame,
+		uint32_t inputChannels,
+		uint32_t outputChannels)
+	{
+		// --- make sure we have input and outputs
+		if (inputChannels == 0 || outputChannels == 0)
+			return false;
+
+		// --- render LFO
+		SignalGenData lfoOutput = lfo.renderAudioOutput();
+
+		// --- setup delay modulation
+		AudioDelayParameters params = delay.getParameters();
+		double minDelay_mSec = 0.0;
+		double maxDepth_mSec = 0.0;
+
+		// --- set delay times, wet/dry and feedback
+		if (parameters.algorithm == modDelaylgorithm::kFlanger)
+		{
+			minDelay_mSec = 0.1;
+			maxDepth_mSec = 7.0;
+			params.wetLevel_dB = -3.0;
+			params.dryLevel_dB = -3.0;
 		}
-		else
+		if (parameters.algorithm == modDelaylgorithm::kChorus)
 		{
-			input = xn + comb_g*yn;
+			minDelay_mSec = 10.0;
+			maxDepth_mSec = 30.0;
+			params.wetLevel_dB = -3.0;
+			params.dryLevel_dB = -0.0;
+			params.feedback_Pct = 0.0;
+		}
+		if (parameters.algorithm == modDelaylgorithm::kVibrato)
+		{
+			minDelay_mSec = 0.0;
+			maxDepth_mSec = 7.0;
+			params.wetLevel_dB = 0.0;
+			params.dryLevel_dB = -96.0;
+			params.feedback_Pct = 0.0;
 		}
 
-		delay.writeDelay(input);
+		// --- calc modulated delay times
+		double depth = parameters.lfoDepth_Pct / 100.0;
+		double modulationMin = minDelay_mSec;
+		double modulationMax = minDelay_mSec + maxDepth_mSec;
 
-		// --- done
-		return yn;
-	}
+		// --- flanger - unipolar
+		if (parameters.algorithm == modDelaylgorithm::kFlanger)
+			params.leftDelay_mSec = doUnipolarModulationFromMin(bipolarToUnipolar(depth * lfoOutput.normalOutput),
+															     modulationMin, modulationMax);
+		else
+			params.leftDelay_mSec = doBipolarModulation(depth * lfoOutput.normalOutput, modulationMin, modulationMax);
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
+
+		// --- set right delay to match (*Hint Homework!)
+		params.rightDelay_mSec = params.leftDelay_mSec;
+
+		// --- modulate the delay
+		delay.setParameters(params);
+
+		// --- just call the function and pass our info in/out
+		return delay.processAudioFrame(inputFrame, outputFrame, inputChannels, outputChannels);
+	}
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\return CombFilterParameters custom data structure
+	\return ModulatedDelayParameters custom data structure
 	*/
-	CombFilterParameters getParameters()
-	{
-		return combFilterParameters;
-	}
+	ModulatedDelayParameters getParameters() { return parameters; }
 
 	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param CombFilterParameters custom data structure
+	\param ModulatedDelayParameters custom data structure
 	*/
-	void setParameters(const CombFilterParameters& params)
+	void setParameters(ModulatedDelayParameters _parameters)
 	{
-		combFilterParameters = params;
-
-		// --- update the delay line parameters first
-		SimpleDelayParameters delayParams = delay.getParameters();
-		delayParams.delayTime_mSec = combFilterParameters.delayTime_mSec;
-		delayParams.interpolate = combFilterParameters.interpolate;
-		delay.setParameters(delayParams); // this will set the delay time in samples
-
-										  // --- calculate g with RT60 time (requires updated delay above^^)
-		double exponent = -3.0*delayParams.delay_Samples*(1.0 / sampleRate);
-		double rt60_mSec = combFilterParameters.RT60Time_mSec / 1000.0; // RT is in mSec!
-		comb_g = pow(10.0, exponent / rt60_mSec);
+		// --- bulk copy
+		parameters = _parameters;
 
-		// --- set LPF g
-		lpf_g = combFilterParameters.lpf_g;
-	}
+		OscillatorParameters lfoParams = lfo.getParameters();
+		lfoParams.frequency_Hz = parameters.lfoRate_Hz;
+		if (parameters.algorithm == modDelaylgorithm::kVibrato)
+			lfoParams.waveform = generatorWaveform::kSin;
+		else
+			lfoParams.waveform = generatorWaveform::kTriangle;
 
-	/** create new buffers */
-	void createDelayBuffer(double _sampleRate, double delay_mSec)
-	{
-		sampleRate = _sampleRate;
-		bufferLength_mSec = delay_mSec;
+		lfo.setParameters(lfoParams);
 
-		// --- create new buffer, will store sample rate and length(mSec)
-		delay.createDelayBuffer(_sampleRate, delay_mSec);
+		AudioDelayParameters adParams = delay.getParameters();
+		adParams.feedback_Pct = parameters.feedback_Pct;
+		adParams.interpolation = parameters.interpolation;
+		delay.setParameters(adParams);
 	}
 
 private:
-	CombFilterParameters combFilterParameters; ///< object parameters
-	double sampleRate = 0.0;	///< sample rate
-	double comb_g = 0.0;		///< g value for comb filter (feedback, not %)
-	double bufferLength_mSec = 0.0; ///< total buffer length
-
-	// --- LPF support
-	double lpf_g = 0.0;		///< LPF g value
-	double lpf_state = 0.0; ///< state register for LPF (z^-1)
-
-	// --- delay buffer of doubles
-	SimpleDelay delay;		///< delay for comb filter
+	ModulatedDelayParameters parameters; ///< object parameters
+	AudioDelay delay;	///< the delay to modulate
+	LFO lfo;			///< the modulator
 };
 
 /**
-\struct DelayAPFParameters
+\struct PhaseShifterParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the DelayAPF object. Used for reverb algorithms in book.
+Custom parameter structure for the PhaseShifter object.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct DelayAPFParameters
+struct PhaseShifterParameters
 {
-	DelayAPFParameters() {}
+	PhaseShifterParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	DelayAPFParameters& operator=(const DelayAPFParameters& params)	// need this override for collections to work
+	PhaseShifterParameters& operator=(const PhaseShifterParameters& params)
 	{
 		if (this == &params)
 			return *this;
 
-		delayTime_mSec = params.delayTime_mSec;
-		apf_g = params.apf_g;
-		enableLPF = params.enableLPF;
-		lpf_g = params.lpf_g;
-		interpolate = params.interpolate;
-		enableLFO = params.enableLFO;
 		lfoRate_Hz = params.lfoRate_Hz;
-		lfoDepth = params.lfoDepth;
-		lfoMaxModulation_mSec = params.lfoMaxModulation_mSec;
+		lfoDepth_Pct = params.lfoDepth_Pct;
+		intensity_Pct = params.intensity_Pct;
+		quadPhaseLFO = params.quadPhaseLFO;
 		return *this;
 	}
 
 	// --- individual parameters
-	double delayTime_mSec = 0.0;	///< APF delay time
-	double apf_g = 0.0;				///< APF g coefficient
-	bool enableLPF = false;			///< flag to enable LPF in structure
-	double lpf_g = 0.0;				///< LPF g coefficient (if enabled)
-	bool interpolate = false;		///< interpolate flag (diagnostics)
-	bool enableLFO = false;			///< flag to enable LFO
-	double lfoRate_Hz = 0.0;		///< LFO rate in Hz, if enabled
-	double lfoDepth = 0.0;			///< LFO deoth (not in %) if enabled
-	double lfoMaxModulation_mSec = 0.0;	///< LFO maximum modulation time in mSec
-
+	double lfoRate_Hz = 0.0;	///< phaser LFO rate in Hz
+	double lfoDepth_Pct = 0.0;	///< phaser LFO depth in %
+	double intensity_Pct = 0.0;	///< phaser feedback in %
+	bool quadPhaseLFO = false;	///< quad phase LFO flag
 };
 
+// --- constants for Phaser
+const unsigned int PHASER_STAGES = 6;
+const double apf0_minF = 16.0;
+const double apf0_maxF = 1600.0;
+
+const double apf1_minF = 33.0;
+const double apf1_maxF = 3300.0;
+
+const double apf2_minF = 48.0;
+const double apf2_maxF = 4800.0;
+
+const double apf3_minF = 98.0;
+const double apf3_maxF = 9800.0;
+
+const double apf4_minF = 160.0;
+const double apf4_maxF = 16000.0;
+
+const double apf5_minF = 260.0;
+const double apf5_maxF = 20480.0;
+
 /**
-\class DelayAPF
+\class PhaseShifter
 \ingroup FX-Objects
 \brief
-The DelayAPF object implements a delaying APF with optional LPF and optional modulated delay time with LFO.
+The PhaseShifter object implements a six-stage phaser.
 
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- Use DelayAPFParameters structure to get/set object params.
+- Use BiquadParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class DelayAPF : public IAudioSignalProcessor
+class PhaseShifter : public IAudioSignalProcessor
 {
 public:
-	DelayAPF(void) {}	/* C-TOR */
-	~DelayAPF(void) {}	/* D-TOR */
+	PhaseShifter(void) {
+		OscillatorParameters lfoparams = lfo.getParameters();
+		lfoparams.waveform = generatorWaveform::kSin;// sine LFO for phaser
+		lfo.setParameters(lfoparams);
+
+		AudioFilterParameters params = apf[0].getParameters();
+		params.algorithm = filterAlgorithm::kAPF1;
+
+		for (int i = 0; i < PHASER_STAGES; i++)
+		{
+			apf[i].setParameters(params);
+		}
+	}	/* C-TOR */
+
+	~PhaseShifter(void) {}	/* D-TOR */
 
 public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		// --- reset children
-		modLFO.reset(_sampleRate);
-
-		// --- flush
-		lpf_state = 0.0;
+		// --- reset LFO
+		lfo.reset(_sampleRate);
 
-		// --- create new buffer, will store sample rate and length(mSec)
-		createDelayBuffer(sampleRate, bufferLength_mSec);
+		// --- reset APFs
+		for (int i = 0; i < PHASER_STAGES; i++){
+			apf[i].reset(_sampleRate);
+		}
 
 		return true;
 	}
 
-	/** process one input sample through object */
+	/** process autio through phaser */
 	/**
 	\param xn input
 	\return the processed sample
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		SimpleDelayParameters delayParams = delay.getParameters();
-		if (delayParams.delay_Samples == 0)
-			return xn;
-
-		// --- delay line output
-		double wnD = 0.0;
-		double apf_g = delayAPFParameters.apf_g;
-		double lpf_g = delayAPFParameters.lpf_g;
-		double lfoDepth = delayAPFParameters.lfoDepth;
+		SignalGenData lfoData = lfo.renderAudioOutput();
 
-		// --- for modulated APFs
-		if (delayAPFParameters.enableLFO)
-		{
-			SignalGenData lfoOutput = modLFO.renderAudioOutput();
-			double maxDelay = delayParams.delayTime_mSec;
-			double minDelay = maxDelay - delayAPFParameters.lfoMaxModulation_mSec;
-			minDelay = fmax(0.0, minDelay); // bound minDelay to 0 as minimum
+		// --- create the bipolar modulator value
+		double lfoValue = lfoData.normalOutput;
+		if (parameters.quadPhaseLFO)
+			lfoValue = lfoData.quadPhaseOutput_pos;
 
-			// --- calc max-down modulated value with unipolar converted LFO output
-			//     NOTE: LFO output is scaled by lfoDepth
-			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(lfoDepth*lfoOutput.normalOutput),
-				minDelay, maxDelay);
+		double depth = parameters.lfoDepth_Pct / 100.0;
+		double modulatorValue = lfoValue*depth;
 
-			// --- read modulated value to get w(n-D);
-			wnD = delay.readDelayAtTime_mSec(modDelay_mSec);
-		}
-		else
-			// --- read the delay line to get w(n-D)
-			wnD = delay.readDelay();
+		// --- calculate modulated values for each APF; note they have different ranges
+		AudioFilterParameters params = apf[0].getParameters();
+		params.fc = doBipolarModulation(modulatorValue, apf0_minF, apf0_maxF);
+		apf[0].setParameters(params);
 
-		if (delayAPFParameters.enableLPF)
-		{
-			// --- apply simple 1st order pole LPF, overwrite wnD
-			wnD = wnD*(1.0 - lpf_g) + lpf_g*lpf_state;
-			lpf_state = wnD;
-		}
+		params = apf[1].getParameters();
+		params.fc = doBipolarModulation(modulatorValue, apf1_minF, apf1_maxF);
+		apf[1].setParameters(params);
 
-		// form w(n) = x(n) + gw(n-D)
-		double wn = xn + apf_g*wnD;
+		params = apf[2].getParameters();
+		params.fc = doBipolarModulation(modulatorValue, apf2_minF, apf2_maxF);
+		apf[2].setParameters(params);
 
-		// form y(n) = -gw(n) + w(n-D)
-		double yn = -apf_g*wn + wnD;
+		params = apf[3].getParameters();
+		params.fc = doBipolarModulation(modulatorValue, apf3_minF, apf3_maxF);
+		apf[3].setParameters(params);
 
-		// underflow check
-		checkFloatUnderflow(yn);
+		params = apf[4].getParameters();
+		params.fc = doBipolarModulation(modulatorValue, apf4_minF, apf4_maxF);
+		apf[4].setParameters(params);
 
-		// write delay line
-		delay.writeDelay(wn);
+		params = apf[5].getParameters();
+		params.fc = doBipolarModulation(modulatorValue, apf5_minF, apf5_maxF);
+		apf[5].setParameters(params);
 
-		return yn;
+		// --- calculate gamma values
+		double gamma1 = apf[5].getG_value();
+		double gamma2 = apf[4].getG_value() * gamma1;
+		double gamma3 = apf[3].getG_value() * gamma2;
+		double gamma4 = apf[2].getG_value() * gamma3;
+		double gamma5 = apf[1].getG_value() * gamma4;
+		double gamma6 = apf[0].getG_value() * gamma5;
+
+		// --- set the alpha0 value
+		double K = parameters.intensity_Pct / 100.0;
+		double alpha0 = 1.0 / (1.0 + K*gamma6);
+
+		// --- create combined feedback
+		double Sn = gamma5*apf[0].getS_value() + gamma4*apf[1].getS_value() + gamma3*apf[2].getS_value() + gamma2*apf[3].getS_value() + gamma1*apf[4].getS_value() + apf[5].getS_value();
+
+		// --- form input to first APF
+		double u = alpha0*(xn - K*Sn);
+
+		// --- cascade of APFs (could also nest these in one massive line of code)
+		double APF1 = apf[0].processAudioSample(u);
+		double APF2 = apf[1].processAudioSample(APF1);
+		double APF3 = apf[2].processAudioSample(APF2);
+		double APF4 = apf[3].processAudioSample(APF3);
+		double APF5 = apf[4].processAudioSample(APF4);
+		double APF6 = apf[5].processAudioSample(APF5);
+
+		// --- sum with -3dB coefficients
+		double output = 0.707*xn + 0.707*APF6;
+		return output;
 	}
 
 	/** return false: this object only processes samples */
@@ -4254,974 +5076,1601 @@ public:
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\return DelayAPFParameters custom data structure
+	\return PhaseShifterParameters custom data structure
 	*/
-	DelayAPFParameters getParameters()
-	{
-		return delayAPFParameters;
-	}
+	PhaseShifterParameters getParameters() { return parameters; }
 
 	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param DelayAPFParameters custom data structure
+	\param PhaseShifterParameters custom data structure
 	*/
-	void setParameters(const DelayAPFParameters& params)
-	{
-		delayAPFParameters = params;
-
-		// --- update delay line
-		SimpleDelayParameters delayParams = delay.getParameters();
-		delayParams.delayTime_mSec = delayAPFParameters.delayTime_mSec;
-		delay.setParameters(delayParams);
-	}
-
-	/** create the delay buffer in mSec */
-	void createDelayBuffer(double _sampleRate, double delay_mSec)
+	void setParameters(const PhaseShifterParameters& params)
 	{
-		sampleRate = _sampleRate;
-		bufferLength_mSec = delay_mSec;
+		// --- update LFO rate
+		if (params.lfoRate_Hz != parameters.lfoRate_Hz)
+		{
+			OscillatorParameters lfoparams = lfo.getParameters();
+			lfoparams.frequency_Hz = params.lfoRate_Hz;
+			lfo.setParameters(lfoparams);
+		}
 
-		// --- create new buffer, will store sample rate and length(mSec)
-		delay.createDelayBuffer(_sampleRate, delay_mSec);
+		// --- save new
+		parameters = params;
 	}
-
 protected:
-	// --- component parameters
-	DelayAPFParameters delayAPFParameters;	///< obeject parameters
-	double sampleRate = 0.0;				///< current sample rate
-	double bufferLength_mSec = 0.0;			///< total buffer length in mSec
-
-	// --- delay buffer of doubles
-	SimpleDelay delay;						///< delay
-
-	// --- optional LFO
-	LFO modLFO;								///< LFO
-
-	// --- LPF support
-	double lpf_state = 0.0;					///< LPF state register (z^-1)
+	PhaseShifterParameters parameters;  ///< the object parameters
+	AudioFilter apf[PHASER_STAGES];		///< six APF objects
+	LFO lfo;							///< the one and only LFO
 };
 
-
 /**
-\struct NestedDelayAPFParameters
+\struct SimpleLPFParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the NestedDelayAPF object. Used for reverb algorithms in book.
+Custom parameter structure for the SimpleLPFP object. Used for reverb algorithms in book.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct NestedDelayAPFParameters
+struct SimpleLPFParameters
 {
-	NestedDelayAPFParameters() {}
+	SimpleLPFParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	NestedDelayAPFParameters& operator=(const NestedDelayAPFParameters& params)	// need this override for collections to work
+	SimpleLPFParameters& operator=(const SimpleLPFParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
 
-		outerAPFdelayTime_mSec = params.outerAPFdelayTime_mSec;
-		innerAPFdelayTime_mSec = params.innerAPFdelayTime_mSec;
-		outerAPF_g = params.outerAPF_g;
-		innerAPF_g = params.innerAPF_g;
-
-		// --- outer LFO
-		enableLFO = params.enableLFO;
-		lfoRate_Hz = params.lfoRate_Hz;
-		lfoDepth = params.lfoDepth;
-		lfoMaxModulation_mSec = params.lfoMaxModulation_mSec;
-
+		g = params.g;
 		return *this;
 	}
 
 	// --- individual parameters
-	double outerAPFdelayTime_mSec = 0.0;	///< delay time for outer APF
-	double innerAPFdelayTime_mSec = 0.0;	///< delay time for inner APF
-	double outerAPF_g = 0.0;				///< g coefficient for outer APF
-	double innerAPF_g = 0.0;				///< g coefficient for inner APF
-
-	// --- this LFO belongs to the outer APF only
-	bool enableLFO = false;					///< flag to enable the modulated delay
-	double lfoRate_Hz = 0.0;				///< LFO rate in Hz (if enabled)
-	double lfoDepth = 1.0;					///< LFO depth (not in %) (if enabled)
-	double lfoMaxModulation_mSec = 0.0;		///< max modulation time if LFO is enabled
-
+	double g = 0.0; ///< simple LPF g value
 };
 
 /**
-\class NestedDelayAPF
+\class SimpleLPF
 \ingroup FX-Objects
 \brief
-The NestedDelayAPF object implements a pair of nested Delaying APF structures. These are labled the
-outer and inner APFs. The outer APF's LPF and LFO may be optionally enabled. You might want
-to extend this object to enable and use the inner LPF and LFO as well.
+The SimpleLPF object implements a first order one-pole LPF using one coefficient "g" value.
 
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- Use BiquadParameters structure to get/set object params.
+- Use SimpleLPFParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class NestedDelayAPF : public DelayAPF
+class SimpleLPF : public IAudioSignalProcessor
 {
 public:
-	NestedDelayAPF(void) { }	/* C-TOR */
-	~NestedDelayAPF(void) { }	/* D-TOR */
+	SimpleLPF(void) {}	/* C-TOR */
+	~SimpleLPF(void) {}	/* D-TOR */
 
 public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		// --- call base class reset first
-		DelayAPF::reset(_sampleRate);
+		state = 0.0;
+		return true;
+	}
 
-		// --- then do our stuff
-		nestedAPF.reset(_sampleRate);
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return SimpleLPFParameters custom data structure
+	*/
+	SimpleLPFParameters getParameters()
+	{
+		return simpleLPFParameters;
+	}
 
-		return true;
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param SimpleLPFParameters custom data structure
+	*/
+	void setParameters(const SimpleLPFParameters& params)
+	{
+		simpleLPFParameters = params;
 	}
 
-	/** process mono audio input */
+	/** process simple one pole FB back filter */
 	/**
 	\param xn input
 	\return the processed sample
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		// --- delay line output
-		double wnD = 0.0;
+		double g = simpleLPFParameters.g;
+		double yn = (1.0 - g)*xn + g*state;
+		state = yn;
+		return yn;
+	}
 
-		SimpleDelayParameters delayParams = delay.getParameters();
-		if (delayParams.delay_Samples == 0)
-			return xn;
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
 
-		double apf_g = delayAPFParameters.apf_g;
-		double lpf_g = delayAPFParameters.lpf_g;
+private:
+	SimpleLPFParameters simpleLPFParameters;	///< object parameters
+	double state = 0.0;							///< single state (z^-1) register
+};
 
-		// --- for modulated APFs
-		if (delayAPFParameters.enableLFO)
-		{
-			SignalGenData lfoOutput = modLFO.renderAudioOutput();
-			double maxDelay = delayParams.delayTime_mSec;
-			double minDelay = maxDelay - delayAPFParameters.lfoMaxModulation_mSec;
-			minDelay = fmax(0.0, minDelay); // bound minDelay to 0 as minimum
-			double lfoDepth = delayAPFParameters.lfoDepth;
+/**
+\struct SimpleDelayParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the SimpleDelay object. Used for reverb algorithms in book.
 
-			// --- calc max-down modulated value with unipolar converted LFO output
-			//     NOTE: LFO output is scaled by lfoDepth
-			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(lfoDepth*lfoOutput.normalOutput),
-				minDelay, maxDelay);
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct SimpleDelayParameters
+{
+	SimpleDelayParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	SimpleDelayParameters& operator=(const SimpleDelayParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
 
-			// --- read modulated value to get w(n-D);
-			wnD = delay.readDelayAtTime_mSec(modDelay_mSec);
-		}
-		else
-			// --- read the delay line to get w(n-D)
-			wnD = delay.readDelay();
+		delayTime_mSec = params.delayTime_mSec;
+		interpolate = params.interpolate;
+		delay_Samples = params.delay_Samples;
+		return *this;
+	}
 
-		if (delayAPFParameters.enableLPF)
-		{
-			// --- apply simple 1st order pole LPF, overwrite wnD
-			wnD = wnD*(1.0 - lpf_g) + lpf_g*lpf_state;
-			lpf_state = wnD;
-		}
+	// --- individual parameters
+	double delayTime_mSec = 0.0;	///< delay tine in mSec
+	bool interpolate = false;		///< interpolation flag (diagnostics usually)
 
-		// --- form w(n) = x(n) + gw(n-D)
-		double wn = xn + apf_g*wnD;
+	// --- outbound parameters
+	double delay_Samples = 0.0;		///< current delay in samples; other objects may need to access this information
+};
 
-		// --- process wn through inner APF
-		double ynInner = nestedAPF.processAudioSample(wn);
+/**
+\class SimpleDelayT
+\ingroup FX-Objects
+\brief
+The SimpleDelay object implements a basic delay line without feedback.
 
-		// --- form y(n) = -gw(n) + w(n-D)
-		double yn = -apf_g*wn + wnD;
+Audio I/O:
+- Processes mono input to mono output.
 
-		// --- underflow check
-		checkFloatUnderflow(yn);
+Control I/F:
+- Use SimpleDelayParameters structure to get/set object params.
 
-		// --- write delay line
-		delay.writeDelay(ynInner);
+Buffers:
+- DelayBuffer is the circular buffer type: CircularBuffer<double> (SimpleDelay) or ExactCircularBuffer<double> (ExactSimpleDelay)
 
-		return yn;
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+template <class DelayBuffer = CircularBuffer<double>>
+class SimpleDelayT : public IAudioSignalProcessor
+{
+public:
+	SimpleDelayT(void) {}	/* C-TOR */
+	~SimpleDelayT(void) {}	/* D-TOR */
+
+public:
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		// --- if sample rate did not change
+		if (sampleRate == _sampleRate)
+		{
+			// --- just flush buffer and return
+			delayBuffer.flushBuffer();
+			return true;
+		}
+
+		// --- create new buffer, will store sample rate and length(mSec)
+		createDelayBuffer(_sampleRate, bufferLength_mSec);
+
+		return true;
 	}
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\return BiquadParameters custom data structure
+	\return SimpleDelayParameters custom data structure
 	*/
-	NestedDelayAPFParameters getParameters() { return nestedAPFParameters; }
+	SimpleDelayParameters getParameters()
+	{
+		return simpleDelayParameters;
+	}
 
 	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param BiquadParameters custom data structure
+	\param SimpleDelayParameters custom data structure
 	*/
-	void setParameters(const NestedDelayAPFParameters& params)
+	void setParameters(const SimpleDelayParameters& params)
 	{
-		nestedAPFParameters = params;
+		simpleDelayParameters = params;
+		simpleDelayParameters.delay_Samples = simpleDelayParameters.delayTime_mSec*(samplesPerMSec);
+		delayBuffer.setInterpolate(simpleDelayParameters.interpolate);
+	}
 
-		DelayAPFParameters outerAPFParameters = DelayAPF::getParameters();
-		DelayAPFParameters innerAPFParameters = nestedAPF.getParameters();
+	/** process MONO audio delay */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		// --- read delay
+		if (simpleDelayParameters.delay_Samples == 0)
+			return xn;
 
-		// --- outer APF
-		outerAPFParameters.apf_g = nestedAPFParameters.outerAPF_g;
-		outerAPFParameters.delayTime_mSec = nestedAPFParameters.outerAPFdelayTime_mSec;
+		double yn = delayBuffer.readBuffer(simpleDelayParameters.delay_Samples);
 
-		// --- LFO support
-		outerAPFParameters.enableLFO = nestedAPFParameters.enableLFO;
-		outerAPFParameters.lfoDepth = nestedAPFParameters.lfoDepth;
-		outerAPFParameters.lfoRate_Hz = nestedAPFParameters.lfoRate_Hz;
-		outerAPFParameters.lfoMaxModulation_mSec = nestedAPFParameters.lfoMaxModulation_mSec;
+		// --- write to delay buffer
+		delayBuffer.writeBuffer(xn);
 
-		// --- inner APF
-		innerAPFParameters.apf_g = nestedAPFParameters.innerAPF_g;
-		innerAPFParameters.delayTime_mSec = nestedAPFParameters.innerAPFdelayTime_mSec;
+		// --- done
+		return yn;
+	}
 
-		DelayAPF::setParameters(outerAPFParameters);
-		nestedAPF.setParameters(innerAPFParameters);
+	/** reset members to initialized state */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** create a new delay buffer */
+	void createDelayBuffer(double _sampleRate, double _bufferLength_mSec)
+	{
+		// --- store for math
+		bufferLength_mSec = _bufferLength_mSec;
+		sampleRate = _sampleRate;
+		samplesPerMSec = sampleRate / 1000.0;
+
+		// --- total buffer length including fractional part
+		bufferLength = (unsigned int)(bufferLength_mSec*(samplesPerMSec)) + 1; // +1 for fractional part
+
+		// --- create new buffer
+		delayBuffer.createCircularBuffer(bufferLength);
 	}
 
-	/** createDelayBuffers -- note there are two delay times here for inner and outer APFs*/
-	void createDelayBuffers(double _sampleRate, double delay_mSec, double nestedAPFDelay_mSec)
+	/** read delay at current location */
+	double readDelay()
 	{
-		// --- base class
-		DelayAPF::createDelayBuffer(_sampleRate, delay_mSec);
+		// --- simple read
+		return delayBuffer.readBuffer(simpleDelayParameters.delay_Samples);
+	}
 
-		// --- then our stuff
-		nestedAPF.createDelayBuffer(_sampleRate, nestedAPFDelay_mSec);
+	/** read delay at current location */
+	double readDelayAtTime_mSec(double _delay_mSec)
+	{
+		// --- calculate total delay time in samples + fraction
+		double _delay_Samples = _delay_mSec*(samplesPerMSec);
+
+		// --- simple read
+		return delayBuffer.readBuffer(_delay_Samples);
+	}
+
+	/** read delay at a percentage of total length */
+	double readDelayAtPercentage(double delayPercent)
+	{
+		// --- simple read
+		return delayBuffer.readBuffer((delayPercent / 100.0)*simpleDelayParameters.delay_Samples);
+	}
+
+	/** write a new value into the delay */
+	void writeDelay(double xn)
+	{
+		// --- simple write
+		delayBuffer.writeBuffer(xn);
 	}
 
 private:
-	NestedDelayAPFParameters nestedAPFParameters; ///< object parameters
-	DelayAPF nestedAPF;	///< nested APF object
+	SimpleDelayParameters simpleDelayParameters; ///< object parameters
+
+	double sampleRate = 0.0;		///< sample rate
+	double samplesPerMSec = 0.0;	///< samples per millisecond (for arbitrary access)
+	double bufferLength_mSec = 0.0; ///< total buffer lenth in mSec
+	unsigned int bufferLength = 0;	///< buffer length in samples
+
+	// --- delay buffer of doubles
+	DelayBuffer delayBuffer; ///< circular buffer for delay
 };
 
+typedef SimpleDelayT<> SimpleDelay;									///< power-of-two buffer
+typedef SimpleDelayT<ExactCircularBuffer<double>> ExactSimpleDelay;	///< exact length buffer
+
+
 /**
-\struct TwoBandShelvingFilterParameters
+\struct CombFilterParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the TwoBandShelvingFilter object. Used for reverb algorithms in book.
+Custom parameter structure for the CombFilter object. Used for reverb algorithms in book.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct TwoBandShelvingFilterParameters
+struct CombFilterParameters
 {
-	TwoBandShelvingFilterParameters() {}
+	CombFilterParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	TwoBandShelvingFilterParameters& operator=(const TwoBandShelvingFilterParameters& params)	// need this override for collections to work
+	CombFilterParameters& operator=(const CombFilterParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
 
-		lowShelf_fc = params.lowShelf_fc;
-		lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
-		highShelf_fc = params.highShelf_fc;
-		highShelfBoostCut_dB = params.highShelfBoostCut_dB;
+		delayTime_mSec = params.delayTime_mSec;
+		RT60Time_mSec = params.RT60Time_mSec;
+		enableLPF = params.enableLPF;
+		lpf_g = params.lpf_g;
+		interpolate = params.interpolate;
 		return *this;
 	}
 
 	// --- individual parameters
-	double lowShelf_fc = 0.0;			///< fc for low shelf
-	double lowShelfBoostCut_dB = 0.0;	///< low shelf gain
-	double highShelf_fc = 0.0;			///< fc for high shelf
-	double highShelfBoostCut_dB = 0.0;	///< high shelf gain
+	double delayTime_mSec = 0.0;	///< delay time in mSec
+	double RT60Time_mSec = 0.0;		///< RT 60 time ini mSec
+	bool enableLPF = false;			///< enable LPF flag
+	double lpf_g = 0.0;				///< gain value for LPF (if enabled)
+	bool interpolate = false;		///< interpolation flag (diagnostics)
 };
 
+
 /**
-\class TwoBandShelvingFilter
+\class CombFilter
 \ingroup FX-Objects
 \brief
-The TwoBandShelvingFilter object implements two shelving filters in series in the standard "Bass and Treble" configuration.
+The CombFilter object implements a comb filter with optional LPF in feedback loop. Used for reverb algorithms in book.
 
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- Use TwoBandShelvingFilterParameters structure to get/set object params.
+- Use CombFilterParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class TwoBandShelvingFilter : public IAudioSignalProcessor
+class CombFilter : public IAudioSignalProcessor
 {
 public:
-	TwoBandShelvingFilter()
-	{
-		AudioFilterParameters params = lowShelfFilter.getParameters();
-		params.algorithm = filterAlgorithm::kLowShelf;
-		lowShelfFilter.setParameters(params);
-
-		params = highShelfFilter.getParameters();
-		params.algorithm = filterAlgorithm::kHiShelf;
-		highShelfFilter.setParameters(params);
-	}		/* C-TOR */
-
-	~TwoBandShelvingFilter() {}		/* D-TOR */
+	CombFilter(void) {}		/* C-TOR */
+	~CombFilter(void) {}	/* D-TOR */
 
+public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		lowShelfFilter.reset(_sampleRate);
-		highShelfFilter.reset(_sampleRate);
+		// --- flush
+		lpf_state = 0.0;
+
+		// --- create new buffer, will store sample rate and length(mSec)
+		createDelayBuffer(sampleRate, bufferLength_mSec);
+
 		return true;
 	}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
-
-	/** process a single input through the two filters in series */
+	/** process CombFilter */
 	/**
 	\param xn input
 	\return the processed sample
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		// --- all modes do Full Wave Rectification
-		double filteredSignal = lowShelfFilter.processAudioSample(xn);
-		filteredSignal = highShelfFilter.processAudioSample(filteredSignal);
+		double yn = delay.readDelay();
+		double input = 0.0;
 
-		return filteredSignal;
+		// --- form input & write
+		if (combFilterParameters.enableLPF)
+		{
+			// --- apply simple 1st order pole LPF
+			double g2 = lpf_g*(1.0 - comb_g); // see book for equation 11.27 (old book)
+			double filteredSignal = yn + g2*lpf_state;
+			input = xn + comb_g*(filteredSignal);
+			lpf_state = filteredSignal;
+		}
+		else
+		{
+			input = xn + comb_g*yn;
+		}
+
+		antiDenormal.apply(input);
+		delay.writeDelay(input);
+
+		// --- done
+		return yn;
 	}
 
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
 	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\return TwoBandShelvingFilterParameters custom data structure
+	\return CombFilterParameters custom data structure
 	*/
-	TwoBandShelvingFilterParameters getParameters()
+	CombFilterParameters getParameters()
 	{
-		return parameters;
+		return combFilterParameters;
 	}
 
 	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param TwoBandShelvingFilterParameters custom data structure
+	\param CombFilterParameters custom data structure
 	*/
-	void setParameters(const TwoBandShelvingFilterParameters& params)
+	void setParameters(const CombFilterParameters& params)
 	{
-		parameters = params;
-		AudioFilterParameters filterParams = lowShelfFilter.getParameters();
-		filterParams.fc = parameters.lowShelf_fc;
-		filterParams.boostCut_dB = parameters.lowShelfBoostCut_dB;
-		lowShelfFilter.setParameters(filterParams);
+		combFilterParameters = params;
 
-		filterParams = highShelfFilter.getParameters();
-		filterParams.fc = parameters.highShelf_fc;
-		filterParams.boostCut_dB = parameters.highShelfBoostCut_dB;
-		highShelfFilter.setParameters(filterParams);
+		// --- update the delay line parameters first
+		SimpleDelayParameters delayParams = delay.getParameters();
+		delayParams.delayTime_mSec = combFilterParameters.delayTime_mSec;
+		delayParams.interpolate = combFilterParameters.interpolate;
+		delay.setParameters(delayParams); // this will set the delay time in samples
+
+										  // --- calculate g with RT60 time (requires updated delay above^^)
+		double exponent = -3.0*delayParams.delay_Samples*(1.0 / sampleRate);
+		double rt60_mSec = combFilterParameters.RT60Time_mSec / 1000.0; // RT is in mSec!
+		comb_g = pow(10.0, exponent / rt60_mSec);
+
+		// --- set LPF g
+		lpf_g = combFilterParameters.lpf_g;
 	}
 
-private:
-	TwoBandShelvingFilterParameters parameters; ///< object parameters
-	AudioFilter lowShelfFilter;					///< filter for low shelf
-	AudioFilter highShelfFilter;				///< filter for high shelf
-};
+	/** create new buffers */
+	void createDelayBuffer(double _sampleRate, double delay_mSec)
+	{
+		sampleRate = _sampleRate;
+		bufferLength_mSec = delay_mSec;
 
-/**
-\enum reverbDensity
-\ingroup Constants-Enums
-\brief
-Use this strongly typed enum to easily set the density in the reverb object.
+		// --- create new buffer, will store sample rate and length(mSec)
+		delay.createDelayBuffer(_sampleRate, delay_mSec);
+	}
 
-- enum class reverbDensity { kThick, kSparse };
+private:
+	CombFilterParameters combFilterParameters; ///< object parameters
+	double sampleRate = 0.0;	///< sample rate
+	double comb_g = 0.0;		///< g value for comb filter (feedback, not %)
+	double bufferLength_mSec = 0.0; ///< total buffer length
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-enum class reverbDensity { kThick, kSparse };
+	// --- LPF support
+	double lpf_g = 0.0;		///< LPF g value
+	double lpf_state = 0.0; ///< state register for LPF (z^-1)
+
+	// --- delay buffer of doubles
+	SimpleDelay delay;		///< delay for comb filter
+	AntiDenormal antiDenormal;	///< see FX_DENORMAL_INJECTION
+};
 
 /**
-\struct ReverbTankParameters
+\struct DelayAPFParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the ReverbTank object.
+Custom parameter structure for the DelayAPF object. Used for reverb algorithms in book.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct ReverbTankParameters
+struct DelayAPFParameters
 {
-	ReverbTankParameters() {}
+	DelayAPFParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	ReverbTankParameters& operator=(const ReverbTankParameters& params)	// need this override for collections to work
+	DelayAPFParameters& operator=(const DelayAPFParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
 
-		density = params.density;
-
-		// --- tweaker variables
-		apfDelayMax_mSec = params.apfDelayMax_mSec;
-		apfDelayWeight_Pct = params.apfDelayWeight_Pct;
-		fixeDelayMax_mSec = params.fixeDelayMax_mSec;
-		fixeDelayWeight_Pct = params.fixeDelayWeight_Pct;
-		preDelayTime_mSec = params.preDelayTime_mSec;
-
+		delayTime_mSec = params.delayTime_mSec;
+		apf_g = params.apf_g;
+		enableLPF = params.enableLPF;
 		lpf_g = params.lpf_g;
-		kRT = params.kRT;
-
-		lowShelf_fc = params.lowShelf_fc;
-		lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
-		highShelf_fc = params.highShelf_fc;
-		highShelfBoostCut_dB = params.highShelfBoostCut_dB;
-
-		wetLevel_dB = params.wetLevel_dB;
-		dryLevel_dB = params.dryLevel_dB;
+		interpolate = params.interpolate;
+		enableLFO = params.enableLFO;
+		lfoRate_Hz = params.lfoRate_Hz;
+		lfoDepth = params.lfoDepth;
+		lfoMaxModulation_mSec = params.lfoMaxModulation_mSec;
 		return *this;
 	}
 
 	// --- individual parameters
-	reverbDensity density = reverbDensity::kThick;	///< density setting thick or thin
-
-	// --- tweaking parameters - you may not want to expose these
-	//     in the final plugin!
-	// --- See the book for all the details on how these tweakers work!!
-	double apfDelayMax_mSec = 5.0;					///< APF max delay time
-	double apfDelayWeight_Pct = 100.0;				///< APF max delay weighying
-	double fixeDelayMax_mSec = 50.0;				///< fixed delay max time
-	double fixeDelayWeight_Pct = 100.0;				///< fixed delay max weighying
-
-	// --- direct control parameters
-	double preDelayTime_mSec = 0.0;					///< pre-delay time in mSec
-	double lpf_g = 0.0;								///< LPF g coefficient
-	double kRT = 0.0;								///< reverb time, 0 to 1
-
-	double lowShelf_fc = 0.0;						///< low shelf fc
-	double lowShelfBoostCut_dB = 0.0;				///< low shelf gain
-	double highShelf_fc = 0.0;						///< high shelf fc
-	double highShelfBoostCut_dB = 0.0;				///< high shelf gain
+	double delayTime_mSec = 0.0;	///< APF delay time
+	double apf_g = 0.0;				///< APF g coefficient
+	bool enableLPF = false;			///< flag to enable LPF in structure
+	double lpf_g = 0.0;				///< LPF g coefficient (if enabled)
+	bool interpolate = false;		///< interpolate flag (diagnostics)
+	bool enableLFO = false;			///< flag to enable LFO
+	double lfoRate_Hz = 0.0;		///< LFO rate in Hz, if enabled
+	double lfoDepth = 0.0;			///< LFO deoth (not in %) if enabled
+	double lfoMaxModulation_mSec = 0.0;	///< LFO maximum modulation time in mSec
 
-	double wetLevel_dB = -3.0;						///< wet output level in dB
-	double dryLevel_dB = -3.0;						///< dry output level in dB
 };
 
-// --- constants for reverb tank
-const unsigned int NUM_BRANCHES = 4;
-const unsigned int NUM_CHANNELS = 2; // stereo
-
 /**
-\class ReverbTank
+\class DelayAPF
 \ingroup FX-Objects
 \brief
-The ReverbTank object implements the cyclic reverb tank in the FX book listed below.
+The DelayAPF object implements a delaying APF with optional LPF and optional modulated delay time with LFO.
 
 Audio I/O:
-- Processes mono input to mono OR stereo output.
+- Processes mono input to mono output.
 
 Control I/F:
-- Use ReverbTankParameters structure to get/set object params.
+- Use DelayAPFParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class ReverbTank : public IAudioSignalProcessor
+class DelayAPF : public IAudioSignalProcessor
 {
 public:
-	ReverbTank() {}		/* C-TOR */
-	~ReverbTank() {}	/* D-TOR */
+	DelayAPF(void) {}	/* C-TOR */
+	~DelayAPF(void) {}	/* D-TOR */
 
+public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		// ---store
-		sampleRate = _sampleRate;
-
-		// ---set up preDelay
-		preDelay.reset(_sampleRate);
-		preDelay.createDelayBuffer(_sampleRate, 100.0);
-
-		for (int i = 0; i < NUM_BRANCHES; i++)
-		{
-			branchDelays[i].reset(_sampleRate);
-			branchDelays[i].createDelayBuffer(_sampleRate, 100.0);
+		// --- reset children
+		modLFO.reset(_sampleRate);
 
-			branchNestedAPFs[i].reset(_sampleRate);
-			branchNestedAPFs[i].createDelayBuffers(_sampleRate, 100.0, 100.0);
+		// --- flush
+		lpf_state = 0.0;
 
-			branchLPFs[i].reset(_sampleRate);
-		}
-		for (int i = 0; i < NUM_CHANNELS; i++)
-		{
-			shelvingFilters[i].reset(_sampleRate);
-		}
+		// --- create new buffer, will store sample rate and length(mSec)
+		createDelayBuffer(sampleRate, bufferLength_mSec);
 
 		return true;
 	}
 
-	/** return true: this object can process frames */
-	virtual bool canProcessAudioFrame() { return true; }
-
-	/** process mono reverb tank */
+	/** process one input sample through object */
 	/**
 	\param xn input
 	\return the processed sample
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		float inputs[2] = { 0.0 };
-		float outputs[2] = { 0.0 };
-		processAudioFrame(inputs, outputs, 1, 1);
-		return outputs[0];
-	}
-
-	/** process stereo reverb tank */
-	virtual bool processAudioFrame(const float* inputFrame,
-		float* outputFrame,
-		uint32_t inputChannels,
-		uint32_t outputChannels)
-	{
-		double output = 0.0;
+		SimpleDelayParameters delayParams = delay.getParameters();
+		if (delayParams.delay_Samples == 0)
+			return xn;
 
-		// --- global feedback from delay in last branch
-		double globFB = branchDelays[NUM_BRANCHES-1].readDelay();
+		// --- delay line output
+		double wnD = 0.0;
+		double apf_g = delayAPFParameters.apf_g;
+		double lpf_g = delayAPFParameters.lpf_g;
+		double lfoDepth = delayAPFParameters.lfoDepth;
 
-		// --- feedback value
-		double fb = parameters.kRT*(globFB);
+		// --- for modulated APFs
+		if (delayAPFParameters.enableLFO)
+		{
+			SignalGenData lfoOutput = modLFO.renderAudioOutput();
+			double maxDelay = delayParams.delayTime_mSec;
+			double minDelay = maxDelay - delayAPFParameters.lfoMaxModulation_mSec;
+			minDelay = fmax(0.0, minDelay); // bound minDelay to 0 as minimum
 
-		// --- mono-ized input signal
-		double xnL = inputFrame[0];
-		double xnR = inputChannels > 1 ? inputFrame[1] : 0.0;
-		double monoXn = double(1.0 / inputChannels)*xnL + double(1.0 / inputChannels)*xnR;
+			// --- calc max-down modulated value with unipolar converted LFO output
+			//     NOTE: LFO output is scaled by lfoDepth
+			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(lfoDepth*lfoOutput.normalOutput),
+				minDelay, maxDelay);
 
-		// --- pre delay output
-		double preDelayOut = preDelay.processAudioSample(monoXn);
+			// --- read modulated value to get w(n-D);
+			wnD = delay.readDelayAtTime_mSec(modDelay_mSec);
+		}
+		else
+			// --- read the delay line to get w(n-D)
+			wnD = delay.readDelay();
 
-		// --- input to first branch = preDalay + globFB
-		double input = preDelayOut + fb;
-		for (int i = 0; i < NUM_BRANCHES; i++)
+		if (delayAPFParameters.enableLPF)
 		{
-			double apfOut = branchNestedAPFs[i].processAudioSample(input);
-			double lpfOut = branchLPFs[i].processAudioSample(apfOut);
-			double delayOut = parameters.kRT*branchDelays[i].processAudioSample(lpfOut);
-			input = delayOut + preDelayOut;
+			// --- apply simple 1st order pole LPF, overwrite wnD
+			wnD = wnD*(1.0 - lpf_g) + lpf_g*lpf_state;
+			lpf_state = wnD;
 		}
-		// --- gather outputs
-		/*
-		There are 25 prime numbers between 1 and 100.
-		They are 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41,
-		43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, and 97
 
-		we want 16 of them: 23, 29, 31, 37, 41,
-		43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, and 97
-		*/
+		// form w(n) = x(n) + gw(n-D)
+		double wn = xn + apf_g*wnD;
 
-		double weight = 0.707;
+		// form y(n) = -gw(n) + w(n-D)
+		double yn = -apf_g*wn + wnD;
 
-		double outL= 0.0;
-		outL += weight*branchDelays[0].readDelayAtPercentage(23.0);
-		outL -= weight*branchDelays[1].readDelayAtPercentage(41.0);
-		outL += weight*branchDelays[2].readDelayAtPercentage(59.0);
-		outL -= weight*branchDelays[3].readDelayAtPercentage(73.0);
-
-		double outR = 0.0;
-		outR -= weight*branchDelays[0].readDelayAtPercentage(29.0);
-		outR += weight*branchDelays[1].readDelayAtPercentage(43.0);
-		outR -= weight*branchDelays[2].readDelayAtPercentage(61.0);
-		outR += weight*branchDelays[3].readDelayAtPercentage(79.0);
-
-		if (parameters.density == reverbDensity::kThick)
-		{
-			outL += weight*branchDelays[0].readDelayAtPercentage(31.0);
-			outL -= weight*branchDelays[1].readDelayAtPercentage(47.0);
-			outL += weight*branchDelays[2].readDelayAtPercentage(67.0);
-			outL -= weight*branchDelays[3].readDelayAtPercentage(83.0);
-
-			outR -= weight*branchDelays[0].readDelayAtPercentage(37.0);
-			outR += weight*branchDelays[1].readDelayAtPercentage(53.0);
-			outR -= weight*branchDelays[2].readDelayAtPercentage(71.0);
-			outR += weight*branchDelays[3].readDelayAtPercentage(89.0);
-		}
-
-		// ---  filter
-		double tankOutL = shelvingFilters[0].processAudioSample(outL);
-		double tankOutR = shelvingFilters[1].processAudioSample(outR);
-
-		// --- sum with dry
-		double dry = pow(10.0, parameters.dryLevel_dB / 20.0);
-		double wet = pow(10.0, parameters.wetLevel_dB / 20.0);
+		// underflow check
+		checkFloatUnderflow(yn);
 
-		if (outputChannels == 1)
-			outputFrame[0] = dry*xnL + wet*(0.5*tankOutL + 0.5*tankOutR);
-		else
-		{
-			outputFrame[0] = dry*xnL + wet*tankOutL;
-			outputFrame[1] = dry*xnR + wet*tankOutR;
-		}
+		// write delay line
+		antiDenormal.apply(wn);
+		delay.writeDelay(wn);
 
-		return true;
+		return yn;
 	}
 
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
 	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\return ReverbTankParameters custom data structure
+	\return DelayAPFParameters custom data structure
 	*/
-	ReverbTankParameters getParameters() { return parameters; }
+	DelayAPFParameters getParameters()
+	{
+		return delayAPFParameters;
+	}
 
 	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param ReverbTankParameters custom data structure
+	\param DelayAPFParameters custom data structure
 	*/
-	void setParameters(const ReverbTankParameters& params)
+	void setParameters(const DelayAPFParameters& params)
 	{
-		// --- do the updates here, the sub-components will only update themselves if
-		//     their parameters changed, so we let those object handle that chore
-		TwoBandShelvingFilterParameters filterParams = shelvingFilters[0].getParameters();
-		filterParams.highShelf_fc = params.highShelf_fc;
-		filterParams.highShelfBoostCut_dB = params.highShelfBoostCut_dB;
-		filterParams.lowShelf_fc = params.lowShelf_fc;
-		filterParams.lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
+		delayAPFParameters = params;
 
-		// --- copy to both channels
-		shelvingFilters[0].setParameters(filterParams);
-		shelvingFilters[1].setParameters(filterParams);
+		// --- update delay line
+		SimpleDelayParameters delayParams = delay.getParameters();
+		delayParams.delayTime_mSec = delayAPFParameters.delayTime_mSec;
+		delay.setParameters(delayParams);
+	}
 
-		SimpleLPFParameters  lpfParams = branchLPFs[0].getParameters();
-		lpfParams.g = params.lpf_g;
+	/** create the delay buffer in mSec */
+	void createDelayBuffer(double _sampleRate, double delay_mSec)
+	{
+		sampleRate = _sampleRate;
+		bufferLength_mSec = delay_mSec;
 
-		for (int i = 0; i < NUM_BRANCHES; i++)
-		{
-			branchLPFs[i].setParameters(lpfParams);
-		}
+		// --- create new buffer, will store sample rate and length(mSec)
+		delay.createDelayBuffer(_sampleRate, delay_mSec);
+	}
 
-		// --- update pre delay
-		SimpleDelayParameters delayParams = preDelay.getParameters();
-		delayParams.delayTime_mSec = params.preDelayTime_mSec;
-		preDelay.setParameters(delayParams);
+protected:
+	// --- component parameters
+	DelayAPFParameters delayAPFParameters;	///< obeject parameters
+	double sampleRate = 0.0;				///< current sample rate
+	double bufferLength_mSec = 0.0;			///< total buffer length in mSec
 
-		// --- set apf and delay parameters
-		int m = 0;
-		NestedDelayAPFParameters apfParams = branchNestedAPFs[0].getParameters();
-		delayParams = branchDelays[0].getParameters();
+	// --- delay buffer of doubles
+	SimpleDelay delay;						///< delay
 
-		// --- global max Delay times
-		double globalAPFMaxDelay = (parameters.apfDelayWeight_Pct / 100.0)*parameters.apfDelayMax_mSec;
-		double globalFixedMaxDelay = (parameters.fixeDelayWeight_Pct / 100.0)*parameters.fixeDelayMax_mSec;
+	// --- optional LFO
+	LFO modLFO;								///< LFO
 
-		// --- lfo
-		apfParams.enableLFO = true;
-		apfParams.lfoMaxModulation_mSec = 0.3;
-		apfParams.lfoDepth = 1.0;
+	// --- LPF support
+	double lpf_state = 0.0;					///< LPF state register (z^-1)
 
-		for (int i = 0; i < NUM_BRANCHES; i++)
-		{
-			// --- setup APFs
-			apfParams.outerAPFdelayTime_mSec = globalAPFMaxDelay*apfDelayWeight[m++];
-			apfParams.innerAPFdelayTime_mSec = globalAPFMaxDelay*apfDelayWeight[m++];
-			apfParams.innerAPF_g = -0.5;
-			apfParams.outerAPF_g = 0.5;
-			if (i == 0)
-				apfParams.lfoRate_Hz = 0.15;
-			else if (i == 1)
-				apfParams.lfoRate_Hz = 0.33;
-			else if (i == 2)
-				apfParams.lfoRate_Hz = 0.57;
-			else if (i == 3)
-				apfParams.lfoRate_Hz = 0.73;
+	AntiDenormal antiDenormal;				///< see FX_DENORMAL_INJECTION
+};
 
-			branchNestedAPFs[i].setParameters(apfParams);
 
-			// --- fixedDelayWeight
-			delayParams.delayTime_mSec = globalFixedMaxDelay*fixedDelayWeight[i];
-			branchDelays[i].setParameters(delayParams);
-		}
+/**
+\struct NestedDelayAPFParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the NestedDelayAPF object. Used for reverb algorithms in book.
 
-		// --- save our copy
-		parameters = params;
-	}
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct NestedDelayAPFParameters
+{
+	NestedDelayAPFParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	NestedDelayAPFParameters& operator=(const NestedDelayAPFParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
 
+		outerAPFdelayTime_mSec = params.outerAPFdelayTime_mSec;
+		innerAPFdelayTime_mSec = params.innerAPFdelayTime_mSec;
+		outerAPF_g = params.outerAPF_g;
+		innerAPF_g = params.innerAPF_g;
 
-private:
-	ReverbTankParameters parameters;				///< object parameters
+		// --- outer LFO
+		enableLFO = params.enableLFO;
+		lfoRate_Hz = params.lfoRate_Hz;
+		lfoDepth = params.lfoDepth;
+		lfoMaxModulation_mSec = params.lfoMaxModulation_mSec;
 
-	SimpleDelay  preDelay;							///< pre delay object
-	SimpleDelay  branchDelays[NUM_BRANCHES];		///< branch delay objects
-	NestedDelayAPF branchNestedAPFs[NUM_BRANCHES];	///< nested APFs for each branch
-	SimpleLPF  branchLPFs[NUM_BRANCHES];			///< LPFs in each branch
+		return *this;
+	}
 
-	TwoBandShelvingFilter shelvingFilters[NUM_CHANNELS]; ///< shelving filters 0 = left; 1 = right
+	// --- individual parameters
+	double outerAPFdelayTime_mSec = 0.0;	///< delay time for outer APF
+	double innerAPFdelayTime_mSec = 0.0;	///< delay time for inner APF
+	double outerAPF_g = 0.0;				///< g coefficient for outer APF
+	double innerAPF_g = 0.0;				///< g coefficient for inner APF
 
-	// --- weighting values to make various and low-correlated APF delay values easily
-	double apfDelayWeight[NUM_BRANCHES * 2] = { 0.317, 0.873, 0.477, 0.291, 0.993, 0.757, 0.179, 0.575 };///< weighting values to make various and low-correlated APF delay values easily
-	double fixedDelayWeight[NUM_BRANCHES] = { 1.0, 0.873, 0.707, 0.667 };	///< weighting values to make various and fixed delay values easily
-	double sampleRate = 0.0;	///< current sample rate
-};
+	// --- this LFO belongs to the outer APF only
+	bool enableLFO = false;					///< flag to enable the modulated delay
+	double lfoRate_Hz = 0.0;				///< LFO rate in Hz (if enabled)
+	double lfoDepth = 1.0;					///< LFO depth (not in %) (if enabled)
+	double lfoMaxModulation_mSec = 0.0;		///< max modulation time if LFO is enabled
 
+};
 
 /**
-\class PeakLimiter
+\class NestedDelayAPF
 \ingroup FX-Objects
 \brief
-The PeakLimiter object implements a simple peak limiter; it is really a simplified and hard-wired
-versio of the DynamicsProcessor
+The NestedDelayAPF object implements a pair of nested Delaying APF structures. These are labled the
+outer and inner APFs. The outer APF's LPF and LFO may be optionally enabled. You might want
+to extend this object to enable and use the inner LPF and LFO as well.
 
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- setThreshold_dB(double _threshold_dB) to adjust the limiter threshold
-- setMakeUpGain_dB(double _makeUpGain_dB) to adjust the makeup gain
+- Use BiquadParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class PeakLimiter : public IAudioSignalProcessor
+class NestedDelayAPF : public DelayAPF
 {
 public:
-	PeakLimiter() { setThreshold_dB(-3.0); }
-	~PeakLimiter() {}
+	NestedDelayAPF(void) { }	/* C-TOR */
+	~NestedDelayAPF(void) { }	/* D-TOR */
 
+public:
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		// --- init; true = analog time-constant
-		detector.setSampleRate(_sampleRate);
+		// --- call base class reset first
+		DelayAPF::reset(_sampleRate);
 
-		AudioDetectorParameters detectorParams = detector.getParameters();
-		detectorParams.detect_dB = true;
-		detectorParams.attackTime_mSec = 5.0;
-		detectorParams.releaseTime_mSec = 25.0;
-		detectorParams.clampToUnityMax = false;
-		detectorParams.detectMode = ENVELOPE_DETECT_MODE_PEAK;
-		detector.setParameters(detectorParams);
+		// --- then do our stuff
+		nestedAPF.reset(_sampleRate);
 
 		return true;
 	}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
-
-	/** process audio: implement hard limiter */
+	/** process mono audio input */
 	/**
 	\param xn input
 	\return the processed sample
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		return dB2Raw(makeUpGain_dB)*xn*computeGain(detector.processAudioSample(xn));
-	}
+		// --- delay line output
+		double wnD = 0.0;
 
-	/** compute the gain reductino value based on detected value in dB */
-	double computeGain(double detect_dB)
-	{
-		double output_dB = 0.0;
+		SimpleDelayParameters delayParams = delay.getParameters();
+		if (delayParams.delay_Samples == 0)
+			return xn;
 
-		// --- defaults - you can change these here
-		bool softknee = true;
-		double kneeWidth_dB = 10.0;
+		double apf_g = delayAPFParameters.apf_g;
+		double lpf_g = delayAPFParameters.lpf_g;
 
-		// --- hard knee
-		if (!softknee)
-		{
-			// --- below threshold, unity
-			if (detect_dB <= threshold_dB)
-				output_dB = detect_dB;
-			// --- above threshold, compress
-			else
-				output_dB = threshold_dB;
-		}
-		else
+		// --- for modulated APFs
+		if (delayAPFParameters.enableLFO)
 		{
-			// --- calc gain with knee
-			// --- left side of knee, outside of width, unity gain zone
-			if (2.0*(detect_dB - threshold_dB) < -kneeWidth_dB)
-				output_dB = detect_dB;
-			// --- inside the knee,
-			else if (2.0*(fabs(detect_dB - threshold_dB)) <= kneeWidth_dB)
-				output_dB = detect_dB - pow((detect_dB - threshold_dB + (kneeWidth_dB / 2.0)), 2.0) / (2.0*kneeWidth_dB);
-			// --- right of knee, compression zone
-			else if (2.0*(detect_dB - threshold_dB) > kneeWidth_dB)
-				output_dB = threshold_dB;
+			SignalGenData lfoOutput = modLFO.renderAudioOutput();
+			double maxDelay = delayParams.delayTime_mSec;
+			double minDelay = maxDelay - delayAPFParameters.lfoMaxModulation_mSec;
+			minDelay = fmax(0.0, minDelay); // bound minDelay to 0 as minimum
+			double lfoDepth = delayAPFParameters.lfoDepth;
+
+			// --- calc max-down modulated value with unipolar converted LFO output
+			//     NOTE: LFO output is scaled by lfoDepth
+			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(lfoDepth*lfoOutput.normalOutput),
+				minDelay, maxDelay);
+
+			// --- read modulated value to get w(n-D);
+			wnD = delay.readDelayAtTime_mSec(modDelay_mSec);
 		}
+		else
+			// --- read the delay line to get w(n-D)
+			wnD = delay.readDelay();
 
-		// --- convert difference between threshold and detected to raw
-		return  pow(10.0, (output_dB - detect_dB) / 20.0);
+		if (delayAPFParameters.enableLPF)
+		{
+			// --- apply simple 1st order pole LPF, overwrite wnD
+			wnD = wnD*(1.0 - lpf_g) + lpf_g*lpf_state;
+			lpf_state = wnD;
+		}
+
+		// --- form w(n) = x(n) + gw(n-D)
+		double wn = xn + apf_g*wnD;
+
+		// --- process wn through inner APF
+		double ynInner = nestedAPF.processAudioSample(wn);
+
+		// --- form y(n) = -gw(n) + w(n-D)
+		double yn = -apf_g*wn + wnD;
+
+		// --- underflow check
+		checkFloatUnderflow(yn);
+
+		// --- write delay line
+		antiDenormal.apply(ynInner);
+		delay.writeDelay(ynInner);
+
+		return yn;
 	}
 
-	/** adjust threshold in dB */
-	void setThreshold_dB(double _threshold_dB) { threshold_dB = _threshold_dB; }
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return BiquadParameters custom data structure
+	*/
+	NestedDelayAPFParameters getParameters() { return nestedAPFParameters; }
 
-	/** adjust makeup gain in dB*/
-	void setMakeUpGain_dB(double _makeUpGain_dB) { makeUpGain_dB = _makeUpGain_dB; }
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param BiquadParameters custom data structure
+	*/
+	void setParameters(const NestedDelayAPFParameters& params)
+	{
+		nestedAPFParameters = params;
 
-protected:
-	AudioDetector detector;		///< the detector object
-	double threshold_dB = 0.0;	///< stored threshold (dB)
-	double makeUpGain_dB = 0.0;	///< stored makeup gain (dB)
-};
+		DelayAPFParameters outerAPFParameters = DelayAPF::getParameters();
+		DelayAPFParameters innerAPFParameters = nestedAPF.getParameters();
 
+		// --- outer APF
+		outerAPFParameters.apf_g = nestedAPFParameters.outerAPF_g;
+		outerAPFParameters.delayTime_mSec = nestedAPFParameters.outerAPFdelayTime_mSec;
 
-/**
-\enum vaFilterAlgorithm
-\ingroup Constants-Enums
-\brief
-Use this strongly typed enum to easily set the virtual analog filter algorithm
+		// --- LFO support
+		outerAPFParameters.enableLFO = nestedAPFParameters.enableLFO;
+		outerAPFParameters.lfoDepth = nestedAPFParameters.lfoDepth;
+		outerAPFParameters.lfoRate_Hz = nestedAPFParameters.lfoRate_Hz;
+		outerAPFParameters.lfoMaxModulation_mSec = nestedAPFParameters.lfoMaxModulation_mSec;
 
-- enum class vaFilterAlgorithm { kLPF1, kHPF1, kAPF1, kSVF_LP, kSVF_HP, kSVF_BP, kSVF_BS };
+		// --- inner APF
+		innerAPFParameters.apf_g = nestedAPFParameters.innerAPF_g;
+		innerAPFParameters.delayTime_mSec = nestedAPFParameters.innerAPFdelayTime_mSec;
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-enum class vaFilterAlgorithm {
-	kLPF1, kHPF1, kAPF1, kSVF_LP, kSVF_HP, kSVF_BP, kSVF_BS
-}; // --- you will add more here...
+		DelayAPF::setParameters(outerAPFParameters);
+		nestedAPF.setParameters(innerAPFParameters);
+	}
+
+	/** createDelayBuffers -- note there are two delay times here for inner and outer APFs*/
+	void createDelayBuffers(double _sampleRate, double delay_mSec, double nestedAPFDelay_mSec)
+	{
+		// --- base class
+		DelayAPF::createDelayBuffer(_sampleRate, delay_mSec);
 
+		// --- then our stuff
+		nestedAPF.createDelayBuffer(_sampleRate, nestedAPFDelay_mSec);
+	}
+
+private:
+	NestedDelayAPFParameters nestedAPFParameters; ///< object parameters
+	DelayAPF nestedAPF;	///< nested APF object
+};
 
 /**
-\struct ZVAFilterParameters
+\struct TwoBandShelvingFilterParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the ZVAFilter object.
+Custom parameter structure for the TwoBandShelvingFilter object. Used for reverb algorithms in book.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct ZVAFilterParameters
+struct TwoBandShelvingFilterParameters
 {
-	ZVAFilterParameters() {}
+	TwoBandShelvingFilterParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	ZVAFilterParameters& operator=(const ZVAFilterParameters& params)	// need this override for collections to work
+	TwoBandShelvingFilterParameters& operator=(const TwoBandShelvingFilterParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
 
-		filterAlgorithm = params.filterAlgorithm;
-		fc = params.fc;
-		Q = params.Q;
-		filterOutputGain_dB = params.filterOutputGain_dB;
-		enableGainComp = params.enableGainComp;
-		matchAnalogNyquistLPF = params.matchAnalogNyquistLPF;
-		selfOscillate = params.selfOscillate;
-		enableNLP = params.enableNLP;
+		lowShelf_fc = params.lowShelf_fc;
+		lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
+		highShelf_fc = params.highShelf_fc;
+		highShelfBoostCut_dB = params.highShelfBoostCut_dB;
 		return *this;
 	}
 
 	// --- individual parameters
-	vaFilterAlgorithm filterAlgorithm = vaFilterAlgorithm::kSVF_LP;	///< va filter algorithm
-	double fc = 1000.0;						///< va filter fc
-	double Q = 0.707;						///< va filter Q
-	double filterOutputGain_dB = 0.0;		///< va filter gain (normally unused)
-	bool enableGainComp = false;			///< enable gain compensation (see book)
-	bool matchAnalogNyquistLPF = false;		///< match analog gain at Nyquist
-	bool selfOscillate = false;				///< enable selfOscillation
-	bool enableNLP = false;					///< enable non linear processing (use oversampling for best results)
+	double lowShelf_fc = 0.0;			///< fc for low shelf
+	double lowShelfBoostCut_dB = 0.0;	///< low shelf gain
+	double highShelf_fc = 0.0;			///< fc for high shelf
+	double highShelfBoostCut_dB = 0.0;	///< high shelf gain
 };
 
-
 /**
-\class ZVAFilter
+\class TwoBandShelvingFilter
 \ingroup FX-Objects
 \brief
-The ZVAFilter object implements multpile Zavalishin VA Filters.
+The TwoBandShelvingFilter object implements two shelving filters in series in the standard "Bass and Treble" configuration.
+
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- Use BiquadParameters structure to get/set object params.
+- Use TwoBandShelvingFilterParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class ZVAFilter : public IAudioSignalProcessor
+class TwoBandShelvingFilter : public IAudioSignalProcessor
 {
 public:
-	ZVAFilter() {}		/* C-TOR */
-	~ZVAFilter() {}		/* D-TOR */
+	TwoBandShelvingFilter()
+	{
+		AudioFilterParameters params = lowShelfFilter.getParameters();
+		params.algorithm = filterAlgorithm::kLowShelf;
+		lowShelfFilter.setParameters(params);
+
+		params = highShelfFilter.getParameters();
+		params.algorithm = filterAlgorithm::kHiShelf;
+		highShelfFilter.setParameters(params);
+	}		/* C-TOR */
+
+	~TwoBandShelvingFilter() {}		/* D-TOR */
 
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		sampleRate = _sampleRate;
-		integrator_z[0] = 0.0;
-		integrator_z[1] = 0.0;
-
+		lowShelfFilter.reset(_sampleRate);
+		highShelfFilter.reset(_sampleRate);
 		return true;
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** process a single input through the two filters in series */
 	/**
-	\return ZVAFilterParameters custom data structure
+	\param xn input
+	\return the processed sample
 	*/
-	ZVAFilterParameters getParameters()
+	virtual double processAudioSample(double xn)
 	{
-		return zvaFilterParameters;
+		// --- all modes do Full Wave Rectification
+		double filteredSignal = lowShelfFilter.processAudioSample(xn);
+		filteredSignal = highShelfFilter.processAudioSample(filteredSignal);
+
+		return filteredSignal;
 	}
 
-	/** set parameters: note use of custom structure for passing param data */
+	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\param ZVAFilterParameters custom data structure
+	\return TwoBandShelvingFilterParameters custom data structure
 	*/
-	void setParameters(const ZVAFilterParameters& params)
+	TwoBandShelvingFilterParameters getParameters()
 	{
-		if (params.fc != zvaFilterParameters.fc ||
-			params.Q != zvaFilterParameters.Q ||
-			params.selfOscillate != zvaFilterParameters.selfOscillate ||
-			params.matchAnalogNyquistLPF != zvaFilterParameters.matchAnalogNyquistLPF)
-			calculateFilterCoeffs();
-
-		zvaFilterParameters = params;
+		return parameters;
 	}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
-
-	/** process input x(n) through the VA filter to produce return value y(n) */
+	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param xn input
-	\return the processed sample
+	\param TwoBandShelvingFilterParameters custom data structure
 	*/
-	virtual double processAudioSample(double xn)
+	void setParameters(const TwoBandShelvingFilterParameters& params)
 	{
-		// --- with gain comp enabled, we reduce the input by
-		//     half the gain in dB at resonant peak
-		//     NOTE: you can change that logic here!
-		vaFilterAlgorithm filterAlgorithm = zvaFilterParameters.filterAlgorithm;
-		bool matchAnalogNyquistLPF = zvaFilterParameters.matchAnalogNyquistLPF;
-
-		if (zvaFilterParameters.enableGainComp)
-		{
-			double peak_dB = dBPeakGainFor_Q(zvaFilterParameters.Q);
-			if (peak_dB > 0.0)
-			{
-				double halfPeak_dBGain = dB2Raw(-peak_dB / 2.0);
-				xn *= halfPeak_dBGain;
-			}
-		}
+		parameters = params;
+		AudioFilterParameters filterParams = lowShelfFilter.getParameters();
+		filterParams.fc = parameters.lowShelf_fc;
+		filterParams.boostCut_dB = parameters.lowShelfBoostCut_dB;
+		lowShelfFilter.setParameters(filterParams);
 
-		// --- for 1st order filters:
-		if (filterAlgorithm == vaFilterAlgorithm::kLPF1 ||
-			filterAlgorithm == vaFilterAlgorithm::kHPF1 ||
-			filterAlgorithm == vaFilterAlgorithm::kAPF1)
-		{
-			// --- create vn node
-			double vn = (xn - integrator_z[0])*alpha;
+		filterParams = highShelfFilter.getParameters();
+		filterParams.fc = parameters.highShelf_fc;
+		filterParams.boostCut_dB = parameters.highShelfBoostCut_dB;
+		highShelfFilter.setParameters(filterParams);
+	}
 
-			// --- form LP output
-			double lpf = ((xn - integrator_z[0])*alpha) + integrator_z[0];
+private:
+	TwoBandShelvingFilterParameters parameters; ///< object parameters
+	AudioFilter lowShelfFilter;					///< filter for low shelf
+	AudioFilter highShelfFilter;				///< filter for high shelf
+};
 
-			double sn = integrator_z[0];
+/**
+\enum reverbDensity
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to easily set the density in the reverb object.
+
+- enum class reverbDensity { kThick, kSparse };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class reverbDensity { kThick, kSparse };
+
+/**
+\struct ReverbTankParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the ReverbTank object.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct ReverbTankParameters
+{
+	ReverbTankParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	ReverbTankParameters& operator=(const ReverbTankParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
+
+		density = params.density;
+
+		// --- tweaker variables
+		apfDelayMax_mSec = params.apfDelayMax_mSec;
+		apfDelayWeight_Pct = params.apfDelayWeight_Pct;
+		fixeDelayMax_mSec = params.fixeDelayMax_mSec;
+		fixeDelayWeight_Pct = params.fixeDelayWeight_Pct;
+		preDelayTime_mSec = params.preDelayTime_mSec;
+
+		lpf_g = params.lpf_g;
+		kRT = params.kRT;
+
+		lowShelf_fc = params.lowShelf_fc;
+		lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
+		highShelf_fc = params.highShelf_fc;
+		highShelfBoostCut_dB = params.highShelfBoostCut_dB;
+
+		wetLevel_dB = params.wetLevel_dB;
+		dryLevel_dB = params.dryLevel_dB;
+		return *this;
+	}
+
+	// --- individual parameters
+	reverbDensity density = reverbDensity::kThick;	///< density setting thick or thin
+
+	// --- tweaking parameters - you may not want to expose these
+	//     in the final plugin!
+	// --- See the book for all the details on how these tweakers work!!
+	double apfDelayMax_mSec = 5.0;					///< APF max delay time
+	double apfDelayWeight_Pct = 100.0;				///< APF max delay weighying
+	double fixeDelayMax_mSec = 50.0;				///< fixed delay max time
+	double fixeDelayWeight_Pct = 100.0;				///< fixed delay max weighying
+
+	// --- direct control parameters
+	double preDelayTime_mSec = 0.0;					///< pre-delay time in mSec
+	double lpf_g = 0.0;								///< LPF g coefficient
+	double kRT = 0.0;								///< reverb time, 0 to 1
+
+	double lowShelf_fc = 0.0;						///< low shelf fc
+	double lowShelfBoostCut_dB = 0.0;				///< low shelf gain
+	double highShelf_fc = 0.0;						///< high shelf fc
+	double highShelfBoostCut_dB = 0.0;				///< high shelf gain
+
+	double wetLevel_dB = -3.0;						///< wet output level in dB
+	double dryLevel_dB = -3.0;						///< dry output level in dB
+};
+
+// --- constants for reverb tank
+const unsigned int NUM_BRANCHES = 4;
+const unsigned int NUM_CHANNELS = 2; // stereo
+
+/**
+\class ReverbTank
+\ingroup FX-Objects
+\brief
+The ReverbTank object implements the cyclic reverb tank in the FX book listed below.
+
+Audio I/O:
+- Processes mono input to mono OR stereo output.
+
+Control I/F:
+- Use ReverbTankParameters structure to get/set object params.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class ReverbTank : public IAudioSignalProcessor
+{
+public:
+	ReverbTank() {}		/* C-TOR */
+	~ReverbTank() {}	/* D-TOR */
+
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		// ---store
+		sampleRate = _sampleRate;
+
+		// ---set up preDelay
+		preDelay.reset(_sampleRate);
+		preDelay.createDelayBuffer(_sampleRate, 100.0);
+
+		for (int i = 0; i < NUM_BRANCHES; i++)
+		{
+			branchDelays[i].reset(_sampleRate);
+			branchDelays[i].createDelayBuffer(_sampleRate, 100.0);
+
+			branchNestedAPFs[i].reset(_sampleRate);
+			branchNestedAPFs[i].createDelayBuffers(_sampleRate, 100.0, 100.0);
+
+			branchLPFs[i].reset(_sampleRate);
+		}
+		for (int i = 0; i < NUM_CHANNELS; i++)
+		{
+			shelvingFilters[i].reset(_sampleRate);
+		}
+
+		return true;
+	}
+
+	/** return true: this object can process frames */
+	virtual bool canProcessAudioFrame() { return true; }
+
+	/** process mono reverb tank */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		float inputs[2] = { 0.0 };
+		float outputs[2] = { 0.0 };
+		processAudioFrame(inputs, outputs, 1, 1);
+		return outputs[0];
+	}
+
+	/** process stereo reverb tank */
+	virtual bool processAudioFrame(const float* inputFrame,
+		float* outputFrame,
+		uint32_t inputChannels,
+		uint32_t outputChannels)
+	{
+		double output = 0.0;
+
+		// --- global feedback from delay in last branch
+		double globFB = branchDelays[NUM_BRANCHES-1].readDelay();
+
+		// --- feedback value
+		double fb = parameters.kRT*(globFB);
+
+		// --- mono-ized input signal
+		double xnL = inputFrame[0];
+		double xnR = inputChannels > 1 ? inputFrame[1] : 0.0;
+		double monoXn = double(1.0 / inputChannels)*xnL + double(1.0 / inputChannels)*xnR;
+
+		// --- pre delay output
+		double preDelayOut = preDelay.processAudioSample(monoXn);
+
+		// --- input to first branch = preDalay + globFB
+		double input = preDelayOut + fb;
+		for (int i = 0; i < NUM_BRANCHES; i++)
+		{
+			antiDenormal.apply(input);
+			double apfOut = branchNestedAPFs[i].processAudioSample(input);
+			double lpfOut = branchLPFs[i].processAudioSample(apfOut);
+			double delayOut = parameters.kRT*branchDelays[i].processAudioSample(lpfOut);
+			input = delayOut + preDelayOut;
+		}
+		// --- gather outputs
+		/*
+		There are 25 prime numbers between 1 and 100.
+		They are 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41,
+		43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, and 97
+
+		we want 16 of them: 23, 29, 31, 37, 41,
+		43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, and 97
+		*/
+
+		double weight = 0.707;
+
+		double outL= 0.0;
+		outL += weight*branchDelays[0].readDelayAtPercentage(23.0);
+		outL -= weight*branchDelays[1].readDelayAtPercentage(41.0);
+		outL += weight*branchDelays[2].readDelayAtPercentage(59.0);
+		outL -= weight*branchDelays[3].readDelayAtPercentage(73.0);
+
+		double outR = 0.0;
+		outR -= weight*branchDelays[0].readDelayAtPercentage(29.0);
+		outR += weight*branchDelays[1].readDelayAtPercentage(43.0);
+		outR -= weight*branchDelays[2].readDelayAtPercentage(61.0);
+		outR += weight*branchDelays[3].readDelayAtPercentage(79.0);
+
+		if (parameters.density == reverbDensity::kThick)
+		{
+			outL += weight*branchDelays[0].readDelayAtPercentage(31.0);
+			outL -= weight*branchDelays[1].readDelayAtPercentage(47.0);
+			outL += weight*branchDelays[2].readDelayAtPercentage(67.0);
+			outL -= weight*branchDelays[3].readDelayAtPercentage(83.0);
+
+			outR -= weight*branchDelays[0].readDelayAtPercentage(37.0);
+			outR += weight*branchDelays[1].readDelayAtPercentage(53.0);
+			outR -= weight*branchDelays[2].readDelayAtPercentage(71.0);
+			outR += weight*branchDelays[3].readDelayAtPercentage(89.0);
+		}
+
+		// ---  filter
+		double tankOutL = shelvingFilters[0].processAudioSample(outL);
+		double tankOutR = shelvingFilters[1].processAudioSample(outR);
+
+		// --- sum with dry
+		double dry = pow(10.0, parameters.dryLevel_dB / 20.0);
+		double wet = pow(10.0, parameters.wetLevel_dB / 20.0);
+
+		if (outputChannels == 1)
+			outputFrame[0] = dry*xnL + wet*(0.5*tankOutL + 0.5*tankOutR);
+		else
+		{
+			outputFrame[0] = dry*xnL + wet*tankOutL;
+			outputFrame[1] = dry*xnR + wet*tankOutR;
+		}
+
+		return true;
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return ReverbTankParameters custom data structure
+	*/
+	ReverbTankParameters getParameters() { return parameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param ReverbTankParameters custom data structure
+	*/
+	void setParameters(const ReverbTankParameters& params)
+	{
+		// --- do the updates here, the sub-components will only update themselves if
+		//     their parameters changed, so we let those object handle that chore
+		TwoBandShelvingFilterParameters filterParams = shelvingFilters[0].getParameters();
+		filterParams.highShelf_fc = params.highShelf_fc;
+		filterParams.highShelfBoostCut_dB = params.highShelfBoostCut_dB;
+		filterParams.lowShelf_fc = params.lowShelf_fc;
+		filterParams.lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
+
+		// --- copy to both channels
+		shelvingFilters[0].setParameters(filterParams);
+		shelvingFilters[1].setParameters(filterParams);
+
+		SimpleLPFParameters  lpfParams = branchLPFs[0].getParameters();
+		lpfParams.g = params.lpf_g;
+
+		for (int i = 0; i < NUM_BRANCHES; i++)
+		{
+			branchLPFs[i].setParameters(lpfParams);
+		}
+
+		// --- update pre delay
+		SimpleDelayParameters delayParams = preDelay.getParameters();
+		delayParams.delayTime_mSec = params.preDelayTime_mSec;
+		preDelay.setParameters(delayParams);
+
+		// --- set apf and delay parameters
+		int m = 0;
+		NestedDelayAPFParameters apfParams = branchNestedAPFs[0].getParameters();
+		delayParams = branchDelays[0].getParameters();
+
+		// --- global max Delay times
+		double globalAPFMaxDelay = (parameters.apfDelayWeight_Pct / 100.0)*parameters.apfDelayMax_mSec;
+		double globalFixedMaxDelay = (parameters.fixeDelayWeight_Pct / 100.0)*parameters.fixeDelayMax_mSec;
+
+		// --- lfo
+		apfParams.enableLFO = true;
+		apfParams.lfoMaxModulation_mSec = 0.3;
+		apfParams.lfoDepth = 1.0;
+
+		for (int i = 0; i < NUM_BRANCHES; i++)
+		{
+			// --- setup APFs
+			apfParams.outerAPFdelayTime_mSec = globalAPFMaxDelay*apfDelayWeight[m++];
+			apfParams.innerAPFdelayTime_mSec = globalAPFMaxDelay*apfDelayWeight[m++];
+			apfParams.innerAPF_g = -0.5;
+			apfParams.outerAPF_g = 0.5;
+			if (i == 0)
+				apfParams.lfoRate_Hz = 0.15;
+			else if (i == 1)
+				apfParams.lfoRate_Hz = 0.33;
+			else if (i == 2)
+				apfParams.lfoRate_Hz = 0.57;
+			else if (i == 3)
+				apfParams.lfoRate_Hz = 0.73;
+
+			branchNestedAPFs[i].setParameters(apfParams);
+
+			// --- fixedDelayWeight
+			delayParams.delayTime_mSec = globalFixedMaxDelay*fixedDelayWeight[i];
+			branchDelays[i].setParameters(delayParams);
+		}
+
+		// --- save our copy
+		parameters = params;
+	}
+
+
+private:
+	ReverbTankParameters parameters;				///< object parameters
+
+	SimpleDelay  preDelay;							///< pre delay object
+	SimpleDelay  branchDelays[NUM_BRANCHES];		///< branch delay objects
+	NestedDelayAPF branchNestedAPFs[NUM_BRANCHES];	///< nested APFs for each branch
+	SimpleLPF  branchLPFs[NUM_BRANCHES];			///< LPFs in each branch
+
+	TwoBandShelvingFilter shelvingFilters[NUM_CHANNELS]; ///< shelving filters 0 = left; 1 = right
+
+	// --- weighting values to make various and low-correlated APF delay values easily
+	double apfDelayWeight[NUM_BRANCHES * 2] = { 0.317, 0.873, 0.477, 0.291, 0.993, 0.757, 0.179, 0.575 };///< weighting values to make various and low-correlated APF delay values easily
+	double fixedDelayWeight[NUM_BRANCHES] = { 1.0, 0.873, 0.707, 0.667 };	///< weighting values to make various and fixed delay values easily
+	double sampleRate = 0.0;	///< current sample rate
+	AntiDenormal antiDenormal;	///< see FX_DENORMAL_INJECTION
+};
+
+
+/**
+\class PeakLimiter
+\ingroup FX-Objects
+\brief
+The PeakLimiter object implements a simple peak limiter; it is really a simplified and hard-wired
+versio of the DynamicsProcessor
+
+Audio I/O:
+- Processes mono input to mono output.
+
+Control I/F:
+- setThreshold_dB(double _threshold_dB) to adjust the limiter threshold
+- setMakeUpGain_dB(double _makeUpGain_dB) to adjust the makeup gain
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class PeakLimiter : public IAudioSignalProcessor
+{
+public:
+	PeakLimiter() { setThreshold_dB(-3.0); }
+	~PeakLimiter() {}
+
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		// --- init; true = analog time-constant
+		detector.setSampleRate(_sampleRate);
+
+		AudioDetectorParameters detectorParams = detector.getParameters();
+		detectorParams.detect_dB = true;
+		detectorParams.attackTime_mSec = 5.0;
+		detectorParams.releaseTime_mSec = 25.0;
+		detectorParams.clampToUnityMax = false;
+		detectorParams.detectMode = ENVELOPE_DETECT_MODE_PEAK;
+		detector.setParameters(detectorParams);
+
+		return true;
+	}
+
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** process audio: implement hard limiter */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		return dB2Raw(makeUpGain_dB)*xn*computeGain(detector.processAudioSample(xn));
+	}
+
+	/** compute the gain reductino value based on detected value in dB */
+	double computeGain(double detect_dB)
+	{
+		double output_dB = 0.0;
+
+		// --- defaults - you can change these here
+		bool softknee = true;
+		double kneeWidth_dB = 10.0;
+
+		// --- hard knee
+		if (!softknee)
+		{
+			// --- below threshold, unity
+			if (detect_dB <= threshold_dB)
+				output_dB = detect_dB;
+			// --- above threshold, compress
+			else
+				output_dB = threshold_dB;
+		}
+		else
+		{
+			// --- calc gain with knee
+			// --- left side of knee, outside of width, unity gain zone
+			if (2.0*(detect_dB - threshold_dB) < -kneeWidth_dB)
+				output_dB = detect_dB;
+			// --- inside the knee,
+			else if (2.0*(fabs(detect_dB - threshold_dB)) <= kneeWidth_dB)
+				output_dB = detect_dB - pow((detect_dB - threshold_dB + (kneeWidth_dB / 2.0)), 2.0) / (2.0*kneeWidth_dB);
+			// --- right of knee, compression zone
+			else if (2.0*(detect_dB - threshold_dB) > kneeWidth_dB)
+				output_dB = threshold_dB;
+		}
+
+		// --- convert difference between threshold and detected to raw
+		return  pow(10.0, (output_dB - detect_dB) / 20.0);
+	}
+
+	/** adjust threshold in dB */
+	void setThreshold_dB(double _threshold_dB) { threshold_dB = _threshold_dB; }
+
+	/** adjust makeup gain in dB*/
+	void setMakeUpGain_dB(double _makeUpGain_dB) { makeUpGain_dB = _makeUpGain_dB; }
+
+protected:
+	AudioDetector detector;		///< the detector object
+	double threshold_dB = 0.0;	///< stored threshold (dB)
+	double makeUpGain_dB = 0.0;	///< stored makeup gain (dB)
+};
+
+
+/**
+\enum vaFilterAlgorithm
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to easily set the virtual analog filter algorithm
+
+- enum class vaFilterAlgorithm { kLPF1, kHPF1, kAPF1, kSVF_LP, kSVF_HP, kSVF_BP, kSVF_BS };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class vaFilterAlgorithm {
+	kLPF1, kHPF1, kAPF1, kSVF_LP, kSVF_HP, kSVF_BP, kSVF_BS
+}; // --- you will add more here...
+
+
+/**
+\struct ZVAFilterParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the ZVAFilter object.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct ZVAFilterParameters
+{
+	ZVAFilterParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	ZVAFilterParameters& operator=(const ZVAFilterParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
+
+		filterAlgorithm = params.filterAlgorithm;
+		fc = params.fc;
+		Q = params.Q;
+		filterOutputGain_dB = params.filterOutputGain_dB;
+		enableGainComp = params.enableGainComp;
+		matchAnalogNyquistLPF = params.matchAnalogNyquistLPF;
+		selfOscillate = params.selfOscillate;
+		enableNLP = params.enableNLP;
+		return *this;
+	}
+
+	// --- individual parameters
+	vaFilterAlgorithm filterAlgorithm = vaFilterAlgorithm::kSVF_LP;	///< va filter algorithm
+	double fc = 1000.0;						///< va filter fc
+	double Q = 0.707;						///< va filter Q
+	double filterOutputGain_dB = 0.0;		///< va filter gain (normally unused)
+	bool enableGainComp = false;			///< enable gain compensation (see book)
+	bool matchAnalogNyquistLPF = false;		///< match analog gain at Nyquist
+	bool selfOscillate = false;				///< enable selfOscillation
+	bool enableNLP = false;					///< enable non linear processing (use oversampling for best results)
+};
+
+
+/**
+\class ZVAFilter
+\ingroup FX-Objects
+\brief
+The ZVAFilter object implements multpile Zavalishin VA Filters.
+Audio I/O:
+- Processes mono input to mono output.
+
+Control I/F:
+- Use BiquadParameters structure to get/set object params.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class ZVAFilter : public IAudioSignalProcessor
+{
+public:
+	ZVAFilter() {}		/* C-TOR */
+	~ZVAFilter() {}		/* D-TOR */
+
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		sampleRate = _sampleRate;
+		integrator_z[0] = 0.0;
+		integrator_z[1] = 0.0;
+
+		return true;
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return ZVAFilterParameters custom data structure
+	*/
+	ZVAFilterParameters getParameters()
+	{
+		return zvaFilterParameters;
+	}
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param ZVAFilterParameters custom data structure
+	*/
+	void setParameters(const ZVAFilterParameters& params)
+	{
+		if (params.fc != zvaFilterParameters.fc ||
+			params.Q != zvaFilterParameters.Q ||
+			params.selfOscillate != zvaFilterParameters.selfOscillate ||
+			params.matchAnalogNyquistLPF != zvaFilterParameters.matchAnalogNyquistLPF)
+			calculateFilterCoeffs();
+
+		zvaFilterParameters = params;
+	}
+
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** process input x(n) through the VA filter to produce return value y(n) */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		// --- with gain comp enabled, we reduce the input by
+		//     half the gain in dB at resonant peak
+		//     NOTE: you can change that logic here!
+		vaFilterAlgorithm filterAlgorithm = zvaFilterParameters.filterAlgorithm;
+		bool matchAnalogNyquistLPF = zvaFilterParameters.matchAnalogNyquistLPF;
+
+		if (zvaFilterParameters.enableGainComp)
+		{
+			double peak_dB = dBPeakGainFor_Q(zvaFilterParameters.Q);
+			if (peak_dB > 0.0)
+			{
+				double halfPeak_dBGain = dB2Raw(-peak_dB / 2.0);
+				xn *= halfPeak_dBGain;
+			}
+		}
+
+		// --- for 1st order filters:
+		if (filterAlgorithm == vaFilterAlgorithm::kLPF1 ||
+			filterAlgorithm == vaFilterAlgorithm::kHPF1 ||
+			filterAlgorithm == vaFilterAlgorithm::kAPF1)
+		{
+			// --- create vn node
+			double vn = (xn - integrator_z[0])*alpha;
+
+			// --- form LP output
+			double lpf = ((xn - integrator_z[0])*alpha) + integrator_z[0];
+
+			double sn = integrator_z[0];
 
 			// --- update memory
 			integrator_z[0] = vn + lpf;
@@ -5427,8 +6876,9 @@ public:
 		adParams.attackTime_mSec = -1.0;
 		adParams.releaseTime_mSec = -1.0;
 		adParams.detectMode = TLD_AUDIO_DETECT_MODE_RMS;
-		adParams.detect_dB = true;
+		adParams.detect_dB = false;		// --- the threshold compare is linear; no dB round trip
 		adParams.clampToUnityMax = false;
+		adParams.fastMode = true;
 		detector.setParameters(adParams);
 
 	}		/* C-TOR */
@@ -5470,6 +6920,8 @@ public:
 			adParams.releaseTime_mSec = params.releaseTime_mSec;
 			detector.setParameters(adParams);
 		}
+		if (params.threshold_dB != parameters.threshold_dB)
+			threshValue = pow(10.0, params.threshold_dB / 20.0);
 
 		// --- save
 		parameters = params;
@@ -5485,12 +6937,8 @@ public:
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		// --- calc threshold
-		double threshValue = pow(10.0, parameters.threshold_dB / 20.0);
-
-		// --- detect the signal
-		double detect_dB = detector.processAudioSample(xn);
-		double detectValue = pow(10.0, detect_dB / 20.0);
+		// --- detect the signal: linear RMS from the fast detector
+		double detectValue = detector.processAudioSample(xn);
 		double deltaValue = detectValue - threshValue;
 
 		ZVAFilterParameters filterParams = filter.getParameters();
@@ -5522,6 +6970,7 @@ protected:
 	// --- 1 filter and 1 detector
 	ZVAFilter filter;		///< filter to modulate
 	AudioDetector detector; ///< detector to track input signal
+	double threshValue = 1.0;	///< threshold_dB as a raw value, cooked in setParameters( )
 };
 
 /**
@@ -7564,213 +9013,493 @@ public:
 			getPort2_CompAdaptor()->setInput1(out2);
 	}
 
-	/** push audio input sample into reflected wave input*/
-	virtual void setInput2(double _in2)
+	/** push audio input sample into reflected wave input*/
+	virtual void setInput2(double _in2)
+	{
+		// --- save
+		in2 = _in2;
+
+		// --- calc N1
+		N1 = in2 - A*(-in1 + N2);
+
+		// --- calc out1
+		out1 = -in1 + N2 + N1;
+
+		// --- deliver upstream
+		if (getPort1_CompAdaptor())
+			getPort1_CompAdaptor()->setInput2(out1);
+
+		// --- set component state
+		if (getPort3_CompAdaptor())
+			getPort3_CompAdaptor()->setInput(N1);
+	}
+
+	/** set input 3 always connects to component */
+	virtual void setInput3(double _in3) { }
+
+	/** get OUT1 = reflected output pin on Port 1 */
+	virtual double getOutput1() { return out1; }
+
+	/** get OUT2 = incident (normal) output pin on Port 2 */
+	virtual double getOutput2() { return out2; }
+
+	/** get OUT3 always connects to component */
+	virtual double getOutput3() { return out3; }
+
+private:
+	double N1 = 0.0;	///< node 1 value, internal use only
+	double N2 = 0.0;	///< node 2 value, internal use only
+	double A = 0.0;		///< A coefficient value
+};
+
+
+/**
+\class WdfParallelTerminatedAdaptor
+\ingroup WDF-Objects
+\brief
+The WdfParallelTerminatedAdaptor object implements the parallel  terminated (non-reflection-free) adaptor
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class WdfParallelTerminatedAdaptor : public WdfAdaptorBase
+{
+public:
+	WdfParallelTerminatedAdaptor() {}
+	virtual ~WdfParallelTerminatedAdaptor() {}
+
+	/** get the resistance at port 2;  R2 = 1.0/(sum of admittances) */
+	virtual double getR2()
+	{
+		double componentConductance = 0.0;
+		if (getPort3_CompAdaptor())
+			componentConductance = getPort3_CompAdaptor()->getComponentConductance();
+
+		// --- 1 / (sum of admittances)
+		R2 = 1.0 / ((1.0 / R1) + componentConductance);
+		return R2;
+	}
+
+	/** initialize adaptor with input resistance */
+	virtual void initialize(double _R1)
+	{
+		// --- save R1
+		R1 = _R1;
+
+		double G1 = 1.0 / R1;
+		if (terminalResistance <= 0.0)
+			terminalResistance = 1e-15;
+
+		double G2 = 1.0 / terminalResistance;
+		double componentConductance = 0.0;
+		if (getPort3_CompAdaptor())
+			componentConductance = getPort3_CompAdaptor()->getComponentConductance();
+
+		A1 = 2.0*G1 / (G1 + componentConductance + G2);
+		A3 = openTerminalResistance ? 0.0 : 2.0*G2 / (G1 + componentConductance + G2);
+
+		// --- init downstream
+		if (getPort2_CompAdaptor())
+			getPort2_CompAdaptor()->initialize(getR2());
+
+		// --- not used in this implementation but saving for extended use
+		R3 = 1.0 / componentConductance;
+	}
+
+	/** push audio input sample into incident wave input*/
+	virtual void setInput1(double _in1)
+	{
+		// --- save
+		in1 = _in1;
+
+		N2 = 0.0;
+		if (getPort3_CompAdaptor())
+			N2 = getPort3_CompAdaptor()->getOutput();
+
+		// --- form N1
+		N1 = -A1*(-in1 + N2) + N2 - A3*N2;
+
+		// --- form output1
+		out1 = -in1 + N2 + N1;
+
+		// --- deliver upstream to input2
+		if (getPort1_CompAdaptor())
+			getPort1_CompAdaptor()->setInput2(out1);
+
+		// --- calc out2 y(n)
+		out2 = N2 + N1;
+
+		// --- set component state
+		if (getPort3_CompAdaptor())
+			getPort3_CompAdaptor()->setInput(N1);
+	}
+
+	/** push audio input sample into reflected wave input; this is a dead end for terminated adaptorsthis is a dead end for terminated adaptors  */
+	virtual void setInput2(double _in2){ in2 = _in2;}
+
+	/** set input 3 always connects to component */
+	virtual void setInput3(double _in3) { }
+
+	/** get OUT1 = reflected output pin on Port 1 */
+	virtual double getOutput1() { return out1; }
+
+	/** get OUT2 = incident (normal) output pin on Port 2 */
+	virtual double getOutput2() { return out2; }
+
+	/** get OUT3 always connects to component */
+	virtual double getOutput3() { return out3; }
+
+private:
+	double N1 = 0.0;	///< node 1 value, internal use only
+	double N2 = 0.0;	///< node 2 value, internal use only
+	double A1 = 0.0;	///< A1 coefficient value
+	double A3 = 0.0;	///< A3 coefficient value
+};
+
+// ------------------------------------------------------------------------------ //
+// --- WDF Ladder Filter Design  Examples --------------------------------------- //
+// ------------------------------------------------------------------------------ //
+//
+// --- 3rd order Butterworth LPF designed with Elsie www.TonneSoftware.comm
+//
+/*
+	3rd Order Inductor-Leading LPF
+
+	Rs = Rload = 600 ohms
+
+	Series(L1) -> Parallel(C1) -> Series(L2)
+
+	--L1-- | --L2--
+		   C1
+		   |
+
+	fc = 1kHz
+		L1 = 95.49e-3;
+		C1 = 0.5305e-6;
+		L2 = 95.49e-3;
+
+	fc = 10kHz
+		L1 = 9.549e-3;
+		C1 = 0.05305e-6;
+		L2 = 9.549e-3;
+*/
+
+/**
+\class WDFButterLPF3
+\ingroup WDF-Objects
+\brief
+The WDFButterLPF3 object implements a 3rd order Butterworth ladder filter.
+NOTE: designed with Elsie www.TonneSoftware.comm
+
+Audio I/O:
+- Processes mono input to mono output.
+
+Control I/F:
+- none - this object is hard-wired.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class WDFButterLPF3 : public IAudioSignalProcessor
+{
+public:
+	WDFButterLPF3(void) { createWDF(); }	/* C-TOR */
+	~WDFButterLPF3(void) {}	/* D-TOR */
+
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		// --- rest WDF components (flush state registers)
+		seriesAdaptor_L1.reset(_sampleRate);
+		parallelAdaptor_C1.reset(_sampleRate);
+		seriesTerminatedAdaptor_L2.reset(_sampleRate);
+
+		// --- intialize the chain of adapters
+		seriesAdaptor_L1.initializeAdaptorChain();
+		return true;
+	}
+
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** process input x(n) through the WDF ladder filter to produce return value y(n) */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		// --- push audio sample into series L1
+		seriesAdaptor_L1.setInput1(xn);
+
+		// --- output is at terminated L2's output2
+		return seriesTerminatedAdaptor_L2.getOutput2();
+	}
+
+	/** create the WDF structure for this object - may be called more than once */
+	void createWDF()
 	{
-		// --- save
-		in2 = _in2;
+		// --- actual component values fc = 1kHz
+		double L1_value = 95.49e-3;		// 95.5 mH
+		double C1_value = 0.5305e-6;	// 0.53 uF
+		double L2_value = 95.49e-3;		// 95.5 mH
 
-		// --- calc N1
-		N1 = in2 - A*(-in1 + N2);
+										// --- set adapter components
+		seriesAdaptor_L1.setComponent(wdfComponent::L, L1_value);
+		parallelAdaptor_C1.setComponent(wdfComponent::C, C1_value);
+		seriesTerminatedAdaptor_L2.setComponent(wdfComponent::L, L2_value);
 
-		// --- calc out1
-		out1 = -in1 + N2 + N1;
+		// --- connect adapters
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L1, &parallelAdaptor_C1);
+		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_C1, &seriesTerminatedAdaptor_L2);
 
-		// --- deliver upstream
-		if (getPort1_CompAdaptor())
-			getPort1_CompAdaptor()->setInput2(out1);
+		// --- set source resistance
+		seriesAdaptor_L1.setSourceResistance(600.0); // --- Rs = 600
 
-		// --- set component state
-		if (getPort3_CompAdaptor())
-			getPort3_CompAdaptor()->setInput(N1);
+		// --- set terminal resistance
+		seriesTerminatedAdaptor_L2.setTerminalResistance(600.0); // --- Rload = 600
 	}
 
-	/** set input 3 always connects to component */
-	virtual void setInput3(double _in3) { }
-
-	/** get OUT1 = reflected output pin on Port 1 */
-	virtual double getOutput1() { return out1; }
-
-	/** get OUT2 = incident (normal) output pin on Port 2 */
-	virtual double getOutput2() { return out2; }
-
-	/** get OUT3 always connects to component */
-	virtual double getOutput3() { return out3; }
-
-private:
-	double N1 = 0.0;	///< node 1 value, internal use only
-	double N2 = 0.0;	///< node 2 value, internal use only
-	double A = 0.0;		///< A coefficient value
+protected:
+	// --- three adapters
+	WdfSeriesAdaptor seriesAdaptor_L1;			///< adaptor for L1
+	WdfParallelAdaptor parallelAdaptor_C1;		///< adaptor for C1
+	WdfSeriesTerminatedAdaptor seriesTerminatedAdaptor_L2;	///< adaptor for L2
 };
 
-
 /**
-\class WdfParallelTerminatedAdaptor
+\class WDFTunableButterLPF3
 \ingroup WDF-Objects
 \brief
-The WdfParallelTerminatedAdaptor object implements the parallel  terminated (non-reflection-free) adaptor
+The WDFTunableButterLPF3 object implements a tunable 3rd order Butterworth ladder filter.
+NOTE: designed with Elsie www.TonneSoftware.comm
+
+Audio I/O:
+- Processes mono input to mono output.
+
+Control I/F:
+- setUsePostWarping(bool b) to enable/disable warping (see book)
+- setFilterFc(double fc_Hz) to set the tunable fc value
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class WdfParallelTerminatedAdaptor : public WdfAdaptorBase
+class WDFTunableButterLPF3 : public IAudioSignalProcessor
 {
 public:
-	WdfParallelTerminatedAdaptor() {}
-	virtual ~WdfParallelTerminatedAdaptor() {}
+	WDFTunableButterLPF3(void) { createWDF(); }	/* C-TOR */
+	~WDFTunableButterLPF3(void) {}	/* D-TOR */
 
-	/** get the resistance at port 2;  R2 = 1.0/(sum of admittances) */
-	virtual double getR2()
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
 	{
-		double componentConductance = 0.0;
-		if (getPort3_CompAdaptor())
-			componentConductance = getPort3_CompAdaptor()->getComponentConductance();
+		sampleRate = _sampleRate;
+		// --- rest WDF components (flush state registers)
+		seriesAdaptor_L1.reset(_sampleRate);
+		parallelAdaptor_C1.reset(_sampleRate);
+		seriesTerminatedAdaptor_L2.reset(_sampleRate);
 
-		// --- 1 / (sum of admittances)
-		R2 = 1.0 / ((1.0 / R1) + componentConductance);
-		return R2;
+		// --- intialize the chain of adapters
+		seriesAdaptor_L1.initializeAdaptorChain();
+		return true;
 	}
 
-	/** initialize adaptor with input resistance */
-	virtual void initialize(double _R1)
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** process input x(n) through the WDF ladder filter to produce return value y(n) */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
 	{
-		// --- save R1
-		R1 = _R1;
+		// --- push audio sample into series L1
+		seriesAdaptor_L1.setInput1(xn);
 
-		double G1 = 1.0 / R1;
-		if (terminalResistance <= 0.0)
-			terminalResistance = 1e-15;
+		// --- output is at terminated L2's output2
+		return seriesTerminatedAdaptor_L2.getOutput2();
+	}
 
-		double G2 = 1.0 / terminalResistance;
-		double componentConductance = 0.0;
-		if (getPort3_CompAdaptor())
-			componentConductance = getPort3_CompAdaptor()->getComponentConductance();
+	/** create the filter structure; may be called more than once */
+	void createWDF()
+	{
+		// --- create components, init to noramlized values fc = 1Hz
+		seriesAdaptor_L1.setComponent(wdfComponent::L, L1_norm);
+		parallelAdaptor_C1.setComponent(wdfComponent::C, C1_norm);
+		seriesTerminatedAdaptor_L2.setComponent(wdfComponent::L, L2_norm);
 
-		A1 = 2.0*G1 / (G1 + componentConductance + G2);
-		A3 = openTerminalResistance ? 0.0 : 2.0*G2 / (G1 + componentConductance + G2);
+		// --- connect adapters
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L1, &parallelAdaptor_C1);
+		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_C1, &seriesTerminatedAdaptor_L2);
 
-		// --- init downstream
-		if (getPort2_CompAdaptor())
-			getPort2_CompAdaptor()->initialize(getR2());
+		// --- set source resistance
+		seriesAdaptor_L1.setSourceResistance(600.0); // --- Rs = 600
 
-		// --- not used in this implementation but saving for extended use
-		R3 = 1.0 / componentConductance;
+		// --- set terminal resistance
+		seriesTerminatedAdaptor_L2.setTerminalResistance(600.0); // --- Rload = 600
 	}
 
-	/** push audio input sample into incident wave input*/
-	virtual void setInput1(double _in1)
+	/** parameter setter for warping */
+	void setUsePostWarping(bool b) { useFrequencyWarping = b; }
+
+	/** parameter setter for fc */
+	void setFilterFc(double fc_Hz)
 	{
-		// --- save
-		in1 = _in1;
+		if (useFrequencyWarping)
+		{
+			double arg = (kPi*fc_Hz) / sampleRate;
+			fc_Hz = fc_Hz*(tan(arg) / arg);
+		}
 
-		N2 = 0.0;
-		if (getPort3_CompAdaptor())
-			N2 = getPort3_CompAdaptor()->getOutput();
+		seriesAdaptor_L1.setComponentValue(L1_norm / fc_Hz);
+		parallelAdaptor_C1.setComponentValue(C1_norm / fc_Hz);
+		seriesTerminatedAdaptor_L2.setComponentValue(L2_norm / fc_Hz);
+	}
 
-		// --- form N1
-		N1 = -A1*(-in1 + N2) + N2 - A3*N2;
+protected:
+	// --- three adapters
+	WdfSeriesAdaptor seriesAdaptor_L1;		///< adaptor for L1
+	WdfParallelAdaptor parallelAdaptor_C1;	///< adaptor for C1
+	WdfSeriesTerminatedAdaptor seriesTerminatedAdaptor_L2;	///< adaptor for L2
 
-		// --- form output1
-		out1 = -in1 + N2 + N1;
+	double L1_norm = 95.493;		// 95.5 mH
+	double C1_norm = 530.516e-6;	// 0.53 uF
+	double L2_norm = 95.493;		// 95.5 mH
 
-		// --- deliver upstream to input2
-		if (getPort1_CompAdaptor())
-			getPort1_CompAdaptor()->setInput2(out1);
+	bool useFrequencyWarping = false;	///< flag for freq warping
+	double sampleRate = 1.0;			///< stored sample rate
+};
 
-		// --- calc out2 y(n)
-		out2 = N2 + N1;
+/**
+\class WDFBesselBSF3
+\ingroup WDF-Objects
+\brief
+The WDFBesselBSF3 object implements a 3rd order Bessel BSF
+NOTE: designed with Elsie www.TonneSoftware.comm
 
-		// --- set component state
-		if (getPort3_CompAdaptor())
-			getPort3_CompAdaptor()->setInput(N1);
-	}
+Audio I/O:
+- Processes mono input to mono output.
 
-	/** push audio input sample into reflected wave input; this is a dead end for terminated adaptorsthis is a dead end for terminated adaptors  */
-	virtual void setInput2(double _in2){ in2 = _in2;}
+Control I/F:
+- none - object is hardwired
 
-	/** set input 3 always connects to component */
-	virtual void setInput3(double _in3) { }
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class WDFBesselBSF3 : public IAudioSignalProcessor
+{
+public:
+	WDFBesselBSF3(void) { createWDF(); }	/* C-TOR */
+	~WDFBesselBSF3(void) {}	/* D-TOR */
 
-	/** get OUT1 = reflected output pin on Port 1 */
-	virtual double getOutput1() { return out1; }
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		// --- rest WDF components (flush state registers)
+		seriesAdaptor_L1C1.reset(_sampleRate);
+		parallelAdaptor_L2C2.reset(_sampleRate);
+		seriesTerminatedAdaptor_L3C3.reset(_sampleRate);
 
-	/** get OUT2 = incident (normal) output pin on Port 2 */
-	virtual double getOutput2() { return out2; }
+		// --- intialize the chain of adapters
+		seriesAdaptor_L1C1.initializeAdaptorChain();
 
-	/** get OUT3 always connects to component */
-	virtual double getOutput3() { return out3; }
+		return true;
+	}
 
-private:
-	double N1 = 0.0;	///< node 1 value, internal use only
-	double N2 = 0.0;	///< node 2 value, internal use only
-	double A1 = 0.0;	///< A1 coefficient value
-	double A3 = 0.0;	///< A3 coefficient value
-};
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
 
-// ------------------------------------------------------------------------------ //
-// --- WDF Ladder Filter Design  Examples --------------------------------------- //
-// ------------------------------------------------------------------------------ //
-//
-// --- 3rd order Butterworth LPF designed with Elsie www.TonneSoftware.comm
-//
-/*
-	3rd Order Inductor-Leading LPF
+	/** process input x(n) through the WDF ladder filter to produce return value y(n) */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		// --- push audio sample into series L1
+		seriesAdaptor_L1C1.setInput1(xn);
+
+		// --- output is at terminated L2's output2
+		return seriesTerminatedAdaptor_L3C3.getOutput2();
+	}
+
+	/** create the WDF structure; may be called more than once*/
+	void createWDF()
+	{
+		// --- set component values
+		// --- fo = 5kHz
+		//     BW = 2kHz or Q = 2.5
+		seriesAdaptor_L1C1.setComponent(wdfComponent::parallelLC, 16.8327e-3, 0.060193e-6);	/* L, C */
+		parallelAdaptor_L2C2.setComponent(wdfComponent::seriesLC, 49.1978e-3, 0.02059e-6);	/* L, C */
+		seriesTerminatedAdaptor_L3C3.setComponent(wdfComponent::parallelLC, 2.57755e-3, 0.393092e-6);	/* L, C */
 
-	Rs = Rload = 600 ohms
+		// --- connect adapters
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L1C1, &parallelAdaptor_L2C2);
+		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_L2C2, &seriesTerminatedAdaptor_L3C3);
 
-	Series(L1) -> Parallel(C1) -> Series(L2)
+		// --- set source resistance
+		seriesAdaptor_L1C1.setSourceResistance(600.0); // Ro = 600
 
-	--L1-- | --L2--
-		   C1
-		   |
+		// --- set terminal resistance
+		seriesTerminatedAdaptor_L3C3.setTerminalResistance(600.0);
+	}
 
-	fc = 1kHz
-		L1 = 95.49e-3;
-		C1 = 0.5305e-6;
-		L2 = 95.49e-3;
+protected:
+	// --- three adapters
+	WdfSeriesAdaptor seriesAdaptor_L1C1;		///< adaptor for L1 and C1
+	WdfParallelAdaptor parallelAdaptor_L2C2;	///< adaptor for L2 and C2
+	WdfSeriesTerminatedAdaptor seriesTerminatedAdaptor_L3C3;	///< adaptor for L3 and C3
+};
 
-	fc = 10kHz
-		L1 = 9.549e-3;
-		C1 = 0.05305e-6;
-		L2 = 9.549e-3;
-*/
 
 /**
-\class WDFButterLPF3
+\class WDFConstKBPF6
 \ingroup WDF-Objects
 \brief
-The WDFButterLPF3 object implements a 3rd order Butterworth ladder filter.
+The WDFConstKBPF6 object implements a 6th order constant K BPF
 NOTE: designed with Elsie www.TonneSoftware.comm
 
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- none - this object is hard-wired.
+- none - object is hardwired
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class WDFButterLPF3 : public IAudioSignalProcessor
+class WDFConstKBPF6 : public IAudioSignalProcessor
 {
 public:
-	WDFButterLPF3(void) { createWDF(); }	/* C-TOR */
-	~WDFButterLPF3(void) {}	/* D-TOR */
+	WDFConstKBPF6(void) { createWDF(); }	/* C-TOR */
+	~WDFConstKBPF6(void) {}	/* D-TOR */
 
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
 		// --- rest WDF components (flush state registers)
-		seriesAdaptor_L1.reset(_sampleRate);
-		parallelAdaptor_C1.reset(_sampleRate);
-		seriesTerminatedAdaptor_L2.reset(_sampleRate);
+		seriesAdaptor_L1C1.reset(_sampleRate);
+		parallelAdaptor_L2C2.reset(_sampleRate);
+
+		seriesAdaptor_L3C3.reset(_sampleRate);
+		parallelAdaptor_L4C4.reset(_sampleRate);
+
+		seriesAdaptor_L5C5.reset(_sampleRate);
+		parallelTerminatedAdaptor_L6C6.reset(_sampleRate);
 
 		// --- intialize the chain of adapters
-		seriesAdaptor_L1.initializeAdaptorChain();
+		seriesAdaptor_L1C1.initializeAdaptorChain();
 		return true;
 	}
 
@@ -7785,86 +9514,130 @@ public:
 	virtual double processAudioSample(double xn)
 	{
 		// --- push audio sample into series L1
-		seriesAdaptor_L1.setInput1(xn);
+		seriesAdaptor_L1C1.setInput1(xn);
 
-		// --- output is at terminated L2's output2
-		return seriesTerminatedAdaptor_L2.getOutput2();
+		// --- output is at terminated L6C6 output2
+		double output = parallelTerminatedAdaptor_L6C6.getOutput2();
+
+		return output;
 	}
 
-	/** create the WDF structure for this object - may be called more than once */
+	/** create the WDF structure */
 	void createWDF()
 	{
-		// --- actual component values fc = 1kHz
-		double L1_value = 95.49e-3;		// 95.5 mH
-		double C1_value = 0.5305e-6;	// 0.53 uF
-		double L2_value = 95.49e-3;		// 95.5 mH
+		// --- fo = 5kHz
+		//     BW = 2kHz or Q = 2.5
+		seriesAdaptor_L1C1.setComponent(wdfComponent::seriesLC, 47.7465e-3, 0.02122e-6);
+		parallelAdaptor_L2C2.setComponent(wdfComponent::parallelLC, 3.81972e-3, 0.265258e-6);
 
-										// --- set adapter components
-		seriesAdaptor_L1.setComponent(wdfComponent::L, L1_value);
-		parallelAdaptor_C1.setComponent(wdfComponent::C, C1_value);
-		seriesTerminatedAdaptor_L2.setComponent(wdfComponent::L, L2_value);
+		seriesAdaptor_L3C3.setComponent(wdfComponent::seriesLC, 95.493e-3, 0.01061e-6);
+		parallelAdaptor_L4C4.setComponent(wdfComponent::parallelLC, 3.81972e-3, 0.265258e-6);
+
+		seriesAdaptor_L5C5.setComponent(wdfComponent::seriesLC, 95.493e-3, 0.01061e-6);
+		parallelTerminatedAdaptor_L6C6.setComponent(wdfComponent::parallelLC, 7.63944e-3, 0.132629e-6);
 
 		// --- connect adapters
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L1, &parallelAdaptor_C1);
-		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_C1, &seriesTerminatedAdaptor_L2);
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L1C1, &parallelAdaptor_L2C2);
+		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_L2C2, &seriesAdaptor_L3C3);
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L3C3, &parallelAdaptor_L4C4);
+		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_L4C4, &seriesAdaptor_L5C5);
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L5C5, &parallelTerminatedAdaptor_L6C6);
 
 		// --- set source resistance
-		seriesAdaptor_L1.setSourceResistance(600.0); // --- Rs = 600
+		seriesAdaptor_L1C1.setSourceResistance(600.0); // Ro = 600
 
 		// --- set terminal resistance
-		seriesTerminatedAdaptor_L2.setTerminalResistance(600.0); // --- Rload = 600
+		parallelTerminatedAdaptor_L6C6.setTerminalResistance(600.0);
 	}
 
 protected:
-	// --- three adapters
-	WdfSeriesAdaptor seriesAdaptor_L1;			///< adaptor for L1
-	WdfParallelAdaptor parallelAdaptor_C1;		///< adaptor for C1
-	WdfSeriesTerminatedAdaptor seriesTerminatedAdaptor_L2;	///< adaptor for L2
+	// --- six adapters
+	WdfSeriesAdaptor seriesAdaptor_L1C1;		///< adaptor for L1 and C1
+	WdfParallelAdaptor parallelAdaptor_L2C2;	///< adaptor for L2 and C2
+
+	WdfSeriesAdaptor seriesAdaptor_L3C3;		///< adaptor for L3 and C3
+	WdfParallelAdaptor parallelAdaptor_L4C4;	///< adaptor for L4 and C4
+
+	WdfSeriesAdaptor seriesAdaptor_L5C5;		///< adaptor for L5 and C5
+	WdfParallelTerminatedAdaptor parallelTerminatedAdaptor_L6C6;///< adaptor for L6 and C6
 };
 
+
 /**
-\class WDFTunableButterLPF3
+\struct WDFParameters
 \ingroup WDF-Objects
 \brief
-The WDFTunableButterLPF3 object implements a tunable 3rd order Butterworth ladder filter.
-NOTE: designed with Elsie www.TonneSoftware.comm
+Custom parameter structure for the WDF filter examples.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct WDFParameters
+{
+	WDFParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	WDFParameters& operator=(const WDFParameters& params)
+	{
+		if (this == &params)
+			return *this;
+
+		fc = params.fc;
+		Q = params.Q;
+		boostCut_dB = params.boostCut_dB;
+		frequencyWarping = params.frequencyWarping;
+		return *this;
+	}
+
+	// --- individual parameters
+	double fc = 100.0;				///< filter fc
+	double Q = 0.707;				///< filter Q
+	double boostCut_dB = 0.0;		///< filter boost or cut in dB
+	bool frequencyWarping = true;	///< enable frequency warping
+};
+
+/**
+\class WDFIdealRLCLPF
+\ingroup WDF-Objects
+\brief
+The WDFIdealRLCLPF object implements an ideal RLC LPF using the WDF library.
 
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- setUsePostWarping(bool b) to enable/disable warping (see book)
-- setFilterFc(double fc_Hz) to set the tunable fc value
+- Use WDFParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class WDFTunableButterLPF3 : public IAudioSignalProcessor
+class WDFIdealRLCLPF : public IAudioSignalProcessor
 {
 public:
-	WDFTunableButterLPF3(void) { createWDF(); }	/* C-TOR */
-	~WDFTunableButterLPF3(void) {}	/* D-TOR */
+	WDFIdealRLCLPF(void) { createWDF(); }	/* C-TOR */
+	~WDFIdealRLCLPF(void) {}	/* D-TOR */
 
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
 		sampleRate = _sampleRate;
+
 		// --- rest WDF components (flush state registers)
-		seriesAdaptor_L1.reset(_sampleRate);
-		parallelAdaptor_C1.reset(_sampleRate);
-		seriesTerminatedAdaptor_L2.reset(_sampleRate);
+		seriesAdaptor_RL.reset(_sampleRate);
+		parallelTerminatedAdaptor_C.reset(_sampleRate);
 
 		// --- intialize the chain of adapters
-		seriesAdaptor_L1.initializeAdaptorChain();
+		seriesAdaptor_RL.initializeAdaptorChain();
 		return true;
 	}
 
 	/** return false: this object only processes samples */
 	virtual bool canProcessAudioFrame() { return false; }
 
-	/** process input x(n) through the WDF ladder filter to produce return value y(n) */
+	/** process input x(n) through the WDF Ideal RLC filter to produce return value y(n) */
 	/**
 	\param xn input
 	\return the processed sample
@@ -7872,104 +9645,119 @@ public:
 	virtual double processAudioSample(double xn)
 	{
 		// --- push audio sample into series L1
-		seriesAdaptor_L1.setInput1(xn);
+		seriesAdaptor_RL.setInput1(xn);
 
 		// --- output is at terminated L2's output2
-		return seriesTerminatedAdaptor_L2.getOutput2();
+		//     note compensation scaling by -6dB = 0.5
+		//     because of WDF assumption about Rs and Rload
+		return 0.5*parallelTerminatedAdaptor_C.getOutput2();
 	}
 
-	/** create the filter structure; may be called more than once */
+	/** create the WDF structure; may be called more than once */
 	void createWDF()
 	{
-		// --- create components, init to noramlized values fc = 1Hz
-		seriesAdaptor_L1.setComponent(wdfComponent::L, L1_norm);
-		parallelAdaptor_C1.setComponent(wdfComponent::C, C1_norm);
-		seriesTerminatedAdaptor_L2.setComponent(wdfComponent::L, L2_norm);
+		// --- create components, init to noramlized values fc =
+		//	   initial values for fc = 1kHz Q = 0.707
+		//     Holding C Constant at 1e-6
+		//			   L = 2.533e-2
+		//			   R = 2.251131 e2
+		seriesAdaptor_RL.setComponent(wdfComponent::seriesRL, 2.251131e2, 2.533e-2);
+		parallelTerminatedAdaptor_C.setComponent(wdfComponent::C, 1.0e-6);
 
 		// --- connect adapters
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L1, &parallelAdaptor_C1);
-		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_C1, &seriesTerminatedAdaptor_L2);
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_RL, &parallelTerminatedAdaptor_C);
 
 		// --- set source resistance
-		seriesAdaptor_L1.setSourceResistance(600.0); // --- Rs = 600
+		seriesAdaptor_RL.setSourceResistance(0.0); // --- Rs = 600
 
-		// --- set terminal resistance
-		seriesTerminatedAdaptor_L2.setTerminalResistance(600.0); // --- Rload = 600
+		// --- set open ckt termination
+		parallelTerminatedAdaptor_C.setOpenTerminalResistance(true);
 	}
 
-	/** parameter setter for warping */
-	void setUsePostWarping(bool b) { useFrequencyWarping = b; }
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return WDFParameters custom data structure
+	*/
+	WDFParameters getParameters() { return wdfParameters; }
 
-	/** parameter setter for fc */
-	void setFilterFc(double fc_Hz)
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param WDFParameters custom data structure
+	*/
+	void setParameters(const WDFParameters& _wdfParameters)
 	{
-		if (useFrequencyWarping)
+		if (_wdfParameters.fc != wdfParameters.fc ||
+			_wdfParameters.Q != wdfParameters.Q ||
+			_wdfParameters.boostCut_dB != wdfParameters.boostCut_dB ||
+			_wdfParameters.frequencyWarping != wdfParameters.frequencyWarping)
 		{
-			double arg = (kPi*fc_Hz) / sampleRate;
-			fc_Hz = fc_Hz*(tan(arg) / arg);
-		}
+			wdfParameters = _wdfParameters;
+			double fc_Hz = wdfParameters.fc;
 
-		seriesAdaptor_L1.setComponentValue(L1_norm / fc_Hz);
-		parallelAdaptor_C1.setComponentValue(C1_norm / fc_Hz);
-		seriesTerminatedAdaptor_L2.setComponentValue(L2_norm / fc_Hz);
+			if (wdfParameters.frequencyWarping)
+			{
+				double arg = (kPi*fc_Hz) / sampleRate;
+				fc_Hz = fc_Hz*(tan(arg) / arg);
+			}
+
+			double inductorValue = 1.0 / (1.0e-6 * pow((2.0*kPi*fc_Hz), 2.0));
+			double resistorValue = (1.0 / wdfParameters.Q)*(pow(inductorValue / 1.0e-6, 0.5));
+
+			seriesAdaptor_RL.setComponentValue_RL(resistorValue, inductorValue);
+		}
 	}
 
 protected:
-	// --- three adapters
-	WdfSeriesAdaptor seriesAdaptor_L1;		///< adaptor for L1
-	WdfParallelAdaptor parallelAdaptor_C1;	///< adaptor for C1
-	WdfSeriesTerminatedAdaptor seriesTerminatedAdaptor_L2;	///< adaptor for L2
+	WDFParameters wdfParameters;	///< object parameters
 
-	double L1_norm = 95.493;		// 95.5 mH
-	double C1_norm = 530.516e-6;	// 0.53 uF
-	double L2_norm = 95.493;		// 95.5 mH
+	// --- adapters
+	WdfSeriesAdaptor				seriesAdaptor_RL;				///< adaptor for series RL
+	WdfParallelTerminatedAdaptor	parallelTerminatedAdaptor_C;	///< adaptopr for parallel C
+
+	double sampleRate = 1.0;
 
-	bool useFrequencyWarping = false;	///< flag for freq warping
-	double sampleRate = 1.0;			///< stored sample rate
 };
 
 /**
-\class WDFBesselBSF3
+\class WDFIdealRLCHPF
 \ingroup WDF-Objects
 \brief
-The WDFBesselBSF3 object implements a 3rd order Bessel BSF
-NOTE: designed with Elsie www.TonneSoftware.comm
+The WDFIdealRLCHPF object implements an ideal RLC HPF using the WDF library.
 
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- none - object is hardwired
+- Use WDFParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class WDFBesselBSF3 : public IAudioSignalProcessor
+class WDFIdealRLCHPF : public IAudioSignalProcessor
 {
 public:
-	WDFBesselBSF3(void) { createWDF(); }	/* C-TOR */
-	~WDFBesselBSF3(void) {}	/* D-TOR */
+	WDFIdealRLCHPF(void) { createWDF(); }	/* C-TOR */
+	~WDFIdealRLCHPF(void) {}	/* D-TOR */
 
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
+		sampleRate = _sampleRate;
 		// --- rest WDF components (flush state registers)
-		seriesAdaptor_L1C1.reset(_sampleRate);
-		parallelAdaptor_L2C2.reset(_sampleRate);
-		seriesTerminatedAdaptor_L3C3.reset(_sampleRate);
+		seriesAdaptor_RC.reset(_sampleRate);
+		parallelTerminatedAdaptor_L.reset(_sampleRate);
 
 		// --- intialize the chain of adapters
-		seriesAdaptor_L1C1.initializeAdaptorChain();
-
+		seriesAdaptor_RC.initializeAdaptorChain();
 		return true;
 	}
 
 	/** return false: this object only processes samples */
 	virtual bool canProcessAudioFrame() { return false; }
 
-	/** process input x(n) through the WDF ladder filter to produce return value y(n) */
+	/** process input x(n) through the WDF Ideal RLC filter to produce return value y(n) */
 	/**
 	\param xn input
 	\return the processed sample
@@ -7977,87 +9765,120 @@ public:
 	virtual double processAudioSample(double xn)
 	{
 		// --- push audio sample into series L1
-		seriesAdaptor_L1C1.setInput1(xn);
+		seriesAdaptor_RC.setInput1(xn);
 
 		// --- output is at terminated L2's output2
-		return seriesTerminatedAdaptor_L3C3.getOutput2();
+		//     note compensation scaling by -6dB = 0.5
+		//     because of WDF assumption about Rs and Rload
+		return 0.5*parallelTerminatedAdaptor_L.getOutput2();
 	}
 
-	/** create the WDF structure; may be called more than once*/
+	/** create WDF structure; may be called more than once */
 	void createWDF()
 	{
-		// --- set component values
-		// --- fo = 5kHz
-		//     BW = 2kHz or Q = 2.5
-		seriesAdaptor_L1C1.setComponent(wdfComponent::parallelLC, 16.8327e-3, 0.060193e-6);	/* L, C */
-		parallelAdaptor_L2C2.setComponent(wdfComponent::seriesLC, 49.1978e-3, 0.02059e-6);	/* L, C */
-		seriesTerminatedAdaptor_L3C3.setComponent(wdfComponent::parallelLC, 2.57755e-3, 0.393092e-6);	/* L, C */
+		// --- create components, init to noramlized values fc =
+		//	   initial values for fc = 1kHz Q = 0.707
+		//     Holding C Constant at 1e-6
+		//			   L = 2.533e-2
+		//			   R = 2.251131 e2
+		seriesAdaptor_RC.setComponent(wdfComponent::seriesRC, 2.251131e2, 1.0e-6);
+		parallelTerminatedAdaptor_L.setComponent(wdfComponent::L, 2.533e-2);
 
 		// --- connect adapters
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L1C1, &parallelAdaptor_L2C2);
-		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_L2C2, &seriesTerminatedAdaptor_L3C3);
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_RC, &parallelTerminatedAdaptor_L);
 
 		// --- set source resistance
-		seriesAdaptor_L1C1.setSourceResistance(600.0); // Ro = 600
+		seriesAdaptor_RC.setSourceResistance(0.0); // --- Rs = 600
 
-		// --- set terminal resistance
-		seriesTerminatedAdaptor_L3C3.setTerminalResistance(600.0);
+		// --- set open ckt termination
+		parallelTerminatedAdaptor_L.setOpenTerminalResistance(true);
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return WDFParameters custom data structure
+	*/
+	WDFParameters getParameters() { return wdfParameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param WDFParameters custom data structure
+	*/
+	void setParameters(const WDFParameters& _wdfParameters)
+	{
+		if (_wdfParameters.fc != wdfParameters.fc ||
+			_wdfParameters.Q != wdfParameters.Q ||
+			_wdfParameters.boostCut_dB != wdfParameters.boostCut_dB ||
+			_wdfParameters.frequencyWarping != wdfParameters.frequencyWarping)
+		{
+			wdfParameters = _wdfParameters;
+			double fc_Hz = wdfParameters.fc;
+
+			if (wdfParameters.frequencyWarping)
+			{
+				double arg = (kPi*fc_Hz) / sampleRate;
+				fc_Hz = fc_Hz*(tan(arg) / arg);
+			}
+
+			double inductorValue = 1.0 / (1.0e-6 * pow((2.0*kPi*fc_Hz), 2.0));
+			double resistorValue = (1.0 / wdfParameters.Q)*(pow(inductorValue / 1.0e-6, 0.5));
+
+			seriesAdaptor_RC.setComponentValue_RC(resistorValue, 1.0e-6);
+			parallelTerminatedAdaptor_L.setComponentValue(inductorValue);
+		}
 	}
 
+
 protected:
-	// --- three adapters
-	WdfSeriesAdaptor seriesAdaptor_L1C1;		///< adaptor for L1 and C1
-	WdfParallelAdaptor parallelAdaptor_L2C2;	///< adaptor for L2 and C2
-	WdfSeriesTerminatedAdaptor seriesTerminatedAdaptor_L3C3;	///< adaptor for L3 and C3
-};
+	WDFParameters wdfParameters;	///< object parameters
+
+	// --- three
+	WdfSeriesAdaptor				seriesAdaptor_RC;				///< adaptor for RC
+	WdfParallelTerminatedAdaptor	parallelTerminatedAdaptor_L;	///< adaptor for L
 
+	double sampleRate = 1.0;	///< sample rate storage
+};
 
 /**
-\class WDFConstKBPF6
+\class WDFIdealRLCBPF
 \ingroup WDF-Objects
 \brief
-The WDFConstKBPF6 object implements a 6th order constant K BPF
-NOTE: designed with Elsie www.TonneSoftware.comm
+The WDFIdealRLCBPF object implements an ideal RLC BPF using the WDF library.
 
 Audio I/O:
 - Processes mono input to mono output.
 
 Control I/F:
-- none - object is hardwired
+- Use WDFParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class WDFConstKBPF6 : public IAudioSignalProcessor
+class WDFIdealRLCBPF : public IAudioSignalProcessor
 {
 public:
-	WDFConstKBPF6(void) { createWDF(); }	/* C-TOR */
-	~WDFConstKBPF6(void) {}	/* D-TOR */
+	WDFIdealRLCBPF(void) { createWDF(); }	/* C-TOR */
+	~WDFIdealRLCBPF(void) {}	/* D-TOR */
 
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
+		sampleRate = _sampleRate;
 		// --- rest WDF components (flush state registers)
-		seriesAdaptor_L1C1.reset(_sampleRate);
-		parallelAdaptor_L2C2.reset(_sampleRate);
-
-		seriesAdaptor_L3C3.reset(_sampleRate);
-		parallelAdaptor_L4C4.reset(_sampleRate);
-
-		seriesAdaptor_L5C5.reset(_sampleRate);
-		parallelTerminatedAdaptor_L6C6.reset(_sampleRate);
+		seriesAdaptor_LC.reset(_sampleRate);
+		parallelTerminatedAdaptor_R.reset(_sampleRate);
 
 		// --- intialize the chain of adapters
-		seriesAdaptor_L1C1.initializeAdaptorChain();
+		seriesAdaptor_LC.initializeAdaptorChain();
 		return true;
 	}
 
 	/** return false: this object only processes samples */
 	virtual bool canProcessAudioFrame() { return false; }
 
-	/** process input x(n) through the WDF ladder filter to produce return value y(n) */
+	/** process input x(n) through the WDF Ideal RLC filter to produce return value y(n) */
 	/**
 	\param xn input
 	\return the processed sample
@@ -8065,94 +9886,85 @@ public:
 	virtual double processAudioSample(double xn)
 	{
 		// --- push audio sample into series L1
-		seriesAdaptor_L1C1.setInput1(xn);
-
-		// --- output is at terminated L6C6 output2
-		double output = parallelTerminatedAdaptor_L6C6.getOutput2();
+		seriesAdaptor_LC.setInput1(xn);
 
-		return output;
+		// --- output is at terminated L2's output2
+		//     note compensation scaling by -6dB = 0.5
+		//     because of WDF assumption about Rs and Rload
+		return 0.5*parallelTerminatedAdaptor_R.getOutput2();
 	}
 
-	/** create the WDF structure */
+	/** create the WDF structure*/
 	void createWDF()
 	{
-		// --- fo = 5kHz
-		//     BW = 2kHz or Q = 2.5
-		seriesAdaptor_L1C1.setComponent(wdfComponent::seriesLC, 47.7465e-3, 0.02122e-6);
-		parallelAdaptor_L2C2.setComponent(wdfComponent::parallelLC, 3.81972e-3, 0.265258e-6);
-
-		seriesAdaptor_L3C3.setComponent(wdfComponent::seriesLC, 95.493e-3, 0.01061e-6);
-		parallelAdaptor_L4C4.setComponent(wdfComponent::parallelLC, 3.81972e-3, 0.265258e-6);
-
-		seriesAdaptor_L5C5.setComponent(wdfComponent::seriesLC, 95.493e-3, 0.01061e-6);
-		parallelTerminatedAdaptor_L6C6.setComponent(wdfComponent::parallelLC, 7.63944e-3, 0.132629e-6);
+		// --- create components, init to noramlized values fc =
+		//	   initial values for fc = 1kHz Q = 0.707
+		//     Holding C Constant at 1e-6
+		//			   L = 2.533e-2
+		//			   R = 2.251131 e2
+		seriesAdaptor_LC.setComponent(wdfComponent::seriesLC, 2.533e-2, 1.0e-6);
+		parallelTerminatedAdaptor_R.setComponent(wdfComponent::R, 2.251131e2);
 
 		// --- connect adapters
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L1C1, &parallelAdaptor_L2C2);
-		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_L2C2, &seriesAdaptor_L3C3);
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L3C3, &parallelAdaptor_L4C4);
-		WdfAdaptorBase::connectAdaptors(&parallelAdaptor_L4C4, &seriesAdaptor_L5C5);
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_L5C5, &parallelTerminatedAdaptor_L6C6);
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_LC, &parallelTerminatedAdaptor_R);
 
 		// --- set source resistance
-		seriesAdaptor_L1C1.setSourceResistance(600.0); // Ro = 600
+		seriesAdaptor_LC.setSourceResistance(0.0); // --- Rs = 600
 
-		// --- set terminal resistance
-		parallelTerminatedAdaptor_L6C6.setTerminalResistance(600.0);
+		// --- set open ckt termination
+		parallelTerminatedAdaptor_R.setOpenTerminalResistance(true);
 	}
 
-protected:
-	// --- six adapters
-	WdfSeriesAdaptor seriesAdaptor_L1C1;		///< adaptor for L1 and C1
-	WdfParallelAdaptor parallelAdaptor_L2C2;	///< adaptor for L2 and C2
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return WDFParameters custom data structure
+	*/
+	WDFParameters getParameters() { return wdfParameters; }
 
-	WdfSeriesAdaptor seriesAdaptor_L3C3;		///< adaptor for L3 and C3
-	WdfParallelAdaptor parallelAdaptor_L4C4;	///< adaptor for L4 and C4
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param WDFParameters custom data structure
+	*/
+	void setParameters(const WDFParameters& _wdfParameters)
+	{
+		if (_wdfParameters.fc != wdfParameters.fc ||
+			_wdfParameters.Q != wdfParameters.Q ||
+			_wdfParameters.boostCut_dB != wdfParameters.boostCut_dB ||
+			_wdfParameters.frequencyWarping != wdfParameters.frequencyWarping)
+		{
+			wdfParameters = _wdfParameters;
+			double fc_Hz = wdfParameters.fc;
 
-	WdfSeriesAdaptor seriesAdaptor_L5C5;		///< adaptor for L5 and C5
-	WdfParallelTerminatedAdaptor parallelTerminatedAdaptor_L6C6;///< adaptor for L6 and C6
-};
+			if (wdfParameters.frequencyWarping)
+			{
+				double arg = (kPi*fc_Hz) / sampleRate;
+				fc_Hz = fc_Hz*(tan(arg) / arg);
+			}
 
+			double inductorValue = 1.0 / (1.0e-6 * pow((2.0*kPi*fc_Hz), 2.0));
+			double resistorValue = (1.0 / wdfParameters.Q)*(pow(inductorValue / 1.0e-6, 0.5));
 
-/**
-\struct WDFParameters
-\ingroup WDF-Objects
-\brief
-Custom parameter structure for the WDF filter examples.
+			seriesAdaptor_LC.setComponentValue_LC(inductorValue, 1.0e-6);
+			parallelTerminatedAdaptor_R.setComponentValue(resistorValue);
+		}
+	}
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-struct WDFParameters
-{
-	WDFParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	WDFParameters& operator=(const WDFParameters& params)
-	{
-		if (this == &params)
-			return *this;
+protected:
+	WDFParameters wdfParameters;	///< object parameters
 
-		fc = params.fc;
-		Q = params.Q;
-		boostCut_dB = params.boostCut_dB;
-		frequencyWarping = params.frequencyWarping;
-		return *this;
-	}
+	// --- adapters
+	WdfSeriesAdaptor				seriesAdaptor_LC; ///< adaptor for LC
+	WdfParallelTerminatedAdaptor	parallelTerminatedAdaptor_R; ///< adaptor for R
 
-	// --- individual parameters
-	double fc = 100.0;				///< filter fc
-	double Q = 0.707;				///< filter Q
-	double boostCut_dB = 0.0;		///< filter boost or cut in dB
-	bool frequencyWarping = true;	///< enable frequency warping
+	double sampleRate = 1.0;
 };
 
+
 /**
-\class WDFIdealRLCLPF
+\class WDFIdealRLCBSF
 \ingroup WDF-Objects
 \brief
-The WDFIdealRLCLPF object implements an ideal RLC LPF using the WDF library.
+The WDFIdealRLCBSF object implements an ideal RLC BSF using the WDF library.
 
 Audio I/O:
 - Processes mono input to mono output.
@@ -8165,23 +9977,22 @@ Control I/F:
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class WDFIdealRLCLPF : public IAudioSignalProcessor
+class WDFIdealRLCBSF : public IAudioSignalProcessor
 {
 public:
-	WDFIdealRLCLPF(void) { createWDF(); }	/* C-TOR */
-	~WDFIdealRLCLPF(void) {}	/* D-TOR */
+	WDFIdealRLCBSF(void) { createWDF(); }	/* C-TOR */
+	~WDFIdealRLCBSF(void) {}	/* D-TOR */
 
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
 		sampleRate = _sampleRate;
-
 		// --- rest WDF components (flush state registers)
-		seriesAdaptor_RL.reset(_sampleRate);
-		parallelTerminatedAdaptor_C.reset(_sampleRate);
+		seriesAdaptor_R.reset(_sampleRate);
+		parallelTerminatedAdaptor_LC.reset(_sampleRate);
 
 		// --- intialize the chain of adapters
-		seriesAdaptor_RL.initializeAdaptorChain();
+		seriesAdaptor_R.initializeAdaptorChain();
 		return true;
 	}
 
@@ -8196,15 +10007,15 @@ public:
 	virtual double processAudioSample(double xn)
 	{
 		// --- push audio sample into series L1
-		seriesAdaptor_RL.setInput1(xn);
+		seriesAdaptor_R.setInput1(xn);
 
 		// --- output is at terminated L2's output2
 		//     note compensation scaling by -6dB = 0.5
 		//     because of WDF assumption about Rs and Rload
-		return 0.5*parallelTerminatedAdaptor_C.getOutput2();
+		return 0.5*parallelTerminatedAdaptor_LC.getOutput2();
 	}
 
-	/** create the WDF structure; may be called more than once */
+	/** create WDF structure */
 	void createWDF()
 	{
 		// --- create components, init to noramlized values fc =
@@ -8212,17 +10023,17 @@ public:
 		//     Holding C Constant at 1e-6
 		//			   L = 2.533e-2
 		//			   R = 2.251131 e2
-		seriesAdaptor_RL.setComponent(wdfComponent::seriesRL, 2.251131e2, 2.533e-2);
-		parallelTerminatedAdaptor_C.setComponent(wdfComponent::C, 1.0e-6);
+		seriesAdaptor_R.setComponent(wdfComponent::R, 2.533e-2);
+		parallelTerminatedAdaptor_LC.setComponent(wdfComponent::seriesLC, 2.533e-2, 1.0e-6);
 
 		// --- connect adapters
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_RL, &parallelTerminatedAdaptor_C);
+		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_R, &parallelTerminatedAdaptor_LC);
 
 		// --- set source resistance
-		seriesAdaptor_RL.setSourceResistance(0.0); // --- Rs = 600
+		seriesAdaptor_R.setSourceResistance(0.0); // --- Rs = 600
 
 		// --- set open ckt termination
-		parallelTerminatedAdaptor_C.setOpenTerminalResistance(true);
+		parallelTerminatedAdaptor_LC.setOpenTerminalResistance(true);
 	}
 
 	/** get parameters: note use of custom structure for passing param data */
@@ -8254,7 +10065,8 @@ public:
 			double inductorValue = 1.0 / (1.0e-6 * pow((2.0*kPi*fc_Hz), 2.0));
 			double resistorValue = (1.0 / wdfParameters.Q)*(pow(inductorValue / 1.0e-6, 0.5));
 
-			seriesAdaptor_RL.setComponentValue_RL(resistorValue, inductorValue);
+			seriesAdaptor_R.setComponentValue(resistorValue);
+			parallelTerminatedAdaptor_LC.setComponentValue_LC(inductorValue, 1.0e-6);
 		}
 	}
 
@@ -8262,450 +10074,832 @@ protected:
 	WDFParameters wdfParameters;	///< object parameters
 
 	// --- adapters
-	WdfSeriesAdaptor				seriesAdaptor_RL;				///< adaptor for series RL
-	WdfParallelTerminatedAdaptor	parallelTerminatedAdaptor_C;	///< adaptopr for parallel C
-
-	double sampleRate = 1.0;
+	WdfSeriesAdaptor				seriesAdaptor_R; ///< adaptor for series R
+	WdfParallelTerminatedAdaptor	parallelTerminatedAdaptor_LC; ///< adaptor for parallel LC
 
+	double sampleRate = 1.0; ///< sample rate storage
 };
 
+
+// ------------------------------------------------------------------ //
+// --- OBJECTS REQUIRING FFTW --------------------------------------- //
+// ------------------------------------------------------------------ //
+
 /**
-\class WDFIdealRLCHPF
-\ingroup WDF-Objects
+\enum windowType
+\ingroup Constants-Enums
 \brief
-The WDFIdealRLCHPF object implements an ideal RLC HPF using the WDF library.
-
-Audio I/O:
-- Processes mono input to mono output.
+Use this strongly typed enum to easily set the windowing type for FFT algorithms that use it.
 
-Control I/F:
-- Use WDFParameters structure to get/set object params.
+- enum class windowType {kNoWindow, kRectWindow, kHannWindow, kBlackmanHarrisWindow, kHammingWindow };
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class WDFIdealRLCHPF : public IAudioSignalProcessor
+enum class windowType {kNoWindow, kRectWindow, kHannWindow, kBlackmanHarrisWindow, kHammingWindow };
+
+/**
+@makeWindow
+\ingroup FX-Functions
+
+@brief  creates a new std::unique_ptr<double[]> array for a given window lenght and type.
+
+\param windowLength - length of window array (does NOT need to be power of 2)
+\param hopSize - hopSize for vococerf applications, may set to 0 for non vocoder use
+\param gainCorrectionValue - return variable that contains the window gain correction value
+*/
+inline std::unique_ptr<double[]> makeWindow(unsigned int windowLength, unsigned int hopSize, windowType window, double& gainCorrectionValue)
 {
-public:
-	WDFIdealRLCHPF(void) { createWDF(); }	/* C-TOR */
-	~WDFIdealRLCHPF(void) {}	/* D-TOR */
+	std::unique_ptr<double[]> windowBuffer;
+	windowBuffer.reset(new double[windowLength]);
 
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate)
+	if (!windowBuffer) return nullptr;
+
+	double overlap = hopSize > 0.0 ? 1.0 - (double)hopSize / (double)windowLength : 0.0;
+	gainCorrectionValue = 0.0;
+
+	for (int n = 0; n < windowLength; n++)
 	{
-		sampleRate = _sampleRate;
-		// --- rest WDF components (flush state registers)
-		seriesAdaptor_RC.reset(_sampleRate);
-		parallelTerminatedAdaptor_L.reset(_sampleRate);
+		if (window == windowType::kRectWindow)
+		{
+			if (n >= 1 && n <= windowLength - 1)
+				windowBuffer[n] = 1.0;
+		}
+		else if (window == windowType::kHammingWindow)
+		{
+			windowBuffer[n] = 0.54 - 0.46*cos((n*2.0*kPi) / (windowLength));
+		}
+		else if (window == windowType::kHannWindow)
+		{
+			windowBuffer[n] = 0.5 * (1 - cos((n*2.0*kPi) / (windowLength)));
+		}
+		else if (window == windowType::kBlackmanHarrisWindow)
+		{
+			windowBuffer[n] = (0.42323 - (0.49755*cos((n*2.0*kPi) / (windowLength))) + 0.07922*cos((2 * n*2.0*kPi) / (windowLength)));
+		}
+		else if (window == windowType::kNoWindow)
+		{
+			windowBuffer[n] = 1.0;
+		}
 
-		// --- intialize the chain of adapters
-		seriesAdaptor_RC.initializeAdaptorChain();
-		return true;
+		gainCorrectionValue += windowBuffer[n];
 	}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
+	// --- calculate gain correction factor
+	if (window != windowType::kNoWindow)
+		gainCorrectionValue = (1.0 - overlap) / gainCorrectionValue;
+	else
+		gainCorrectionValue = 1.0 / gainCorrectionValue;
 
-	/** process input x(n) through the WDF Ideal RLC filter to produce return value y(n) */
-	/**
-	\param xn input
-	\return the processed sample
-	*/
-	virtual double processAudioSample(double xn)
+	return windowBuffer;
+}
+
+// --- sample rate conversion
+//
+// --- supported conversion ratios - you can EASILY add more to this
+/**
+\enum rateConversionRatio
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to easily set up or down sampling ratios.
+
+- enum class rateConversionRatio { k2x, k4x };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class rateConversionRatio { k2x, k4x };
+const unsigned int maxSamplingRatio = 4;
+
+/**
+@countForRatio
+\ingroup FX-Functions
+
+@brief returns the up or downsample ratio as a numeric value
+
+\param ratio - enum class ratio value
+\return the up or downsample ratio as a numeric value
+*/
+inline unsigned int countForRatio(rateConversionRatio ratio)
+{
+	if (ratio == rateConversionRatio::k2x)
+		return 2;
+	else if (ratio == rateConversionRatio::k4x)
+		return 4;
+
+	return 0;
+}
+
+// --- get table pointer for built-in anti-aliasing LPFs
+/**
+@getFilterIRTable
+\ingroup FX-Functions
+
+@brief returns the up or downsample ratio as a numeric value
+
+\param FIRLength - lenght of FIR
+\param ratio - the conversinon ratio
+\param sampleRate - the sample rate
+\return a pointer to the appropriate FIR coefficient table in filters.h or nullptr if not found
+*/
+inline double* getFilterIRTable(unsigned int FIRLength, rateConversionRatio ratio, unsigned int sampleRate)
+{
+	// --- we only have built in filters for 44.1 and 48 kHz
+	if (sampleRate != 44100 && sampleRate != 48000) return nullptr;
+
+	// --- choose 2xtable
+	if (ratio == rateConversionRatio::k2x)
 	{
-		// --- push audio sample into series L1
-		seriesAdaptor_RC.setInput1(xn);
+		if (sampleRate == 44100)
+		{
+			if (FIRLength == 128)
+				return &LPF128_882[0];
+			else if (FIRLength == 256)
+				return &LPF256_882[0];
+			else if (FIRLength == 512)
+				return &LPF512_882[0];
+			else if (FIRLength == 1024)
+				return &LPF1024_882[0];
+		}
+		if (sampleRate == 48000)
+		{
+			if (FIRLength == 128)
+				return &LPF128_96[0];
+			else if (FIRLength == 256)
+				return &LPF256_96[0];
+			else if (FIRLength == 512)
+				return &LPF512_96[0];
+			else if (FIRLength == 1024)
+				return &LPF1024_96[0];
+		}
+	}
 
-		// --- output is at terminated L2's output2
-		//     note compensation scaling by -6dB = 0.5
-		//     because of WDF assumption about Rs and Rload
-		return 0.5*parallelTerminatedAdaptor_L.getOutput2();
+	// --- choose 4xtable
+	if (ratio == rateConversionRatio::k4x)
+	{
+		if (sampleRate == 44100)
+		{
+			if (FIRLength == 128)
+				return &LPF128_1764[0];
+			else if (FIRLength == 256)
+				return &LPF256_1764[0];
+			else if (FIRLength == 512)
+				return &LPF512_1764[0];
+			else if (FIRLength == 1024)
+				return &LPF1024_1764[0];
+		}
+		if (sampleRate == 48000)
+		{
+			if (FIRLength == 128)
+				return &LPF128_192[0];
+			else if (FIRLength == 256)
+				return &LPF256_192[0];
+			else if (FIRLength == 512)
+				return &LPF512_192[0];
+			else if (FIRLength == 1024)
+				return &LPF1024_192[0];
+		}
+	}
+	return nullptr;
+}
+
+// --- get table pointer for built-in anti-aliasing LPFs
+/**
+@decomposeFilter
+\ingroup FX-Functions
+
+@brief performs a polyphase decomposition on a big FIR into a set of sub-band FIRs
+
+\param filterIR - pointer to filter IR array
+\param FIRLength - lenght of IR array
+\param ratio - up or down sampling ratio
+\return a pointer an arry of buffer pointers to the decomposed mini-filters
+*/
+inline double** decomposeFilter(double* filterIR, unsigned int FIRLength, unsigned int ratio)
+{
+	unsigned int subBandLength = FIRLength / ratio;
+	double ** polyFilterSet = new double*[ratio];
+	for (unsigned int i = 0; i < ratio; i++)
+	{
+		double* polyFilter = new double[subBandLength];
+		polyFilterSet[i] = polyFilter;
 	}
 
-	/** create WDF structure; may be called more than once */
-	void createWDF()
+	int m = 0;
+	for (unsigned int i = 0; i < subBandLength; i++)
 	{
-		// --- create components, init to noramlized values fc =
-		//	   initial values for fc = 1kHz Q = 0.707
-		//     Holding C Constant at 1e-6
-		//			   L = 2.533e-2
-		//			   R = 2.251131 e2
-		seriesAdaptor_RC.setComponent(wdfComponent::seriesRC, 2.251131e2, 1.0e-6);
-		parallelTerminatedAdaptor_L.setComponent(wdfComponent::L, 2.533e-2);
+		for (int j = ratio - 1; j >= 0; j--)
+		{
+			double* polyFilter = polyFilterSet[j];
+			polyFilter[i] = filterIR[m++];
+		}
+	}
 
-		// --- connect adapters
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_RC, &parallelTerminatedAdaptor_L);
+	return polyFilterSet;
+}
 
-		// --- set source resistance
-		seriesAdaptor_RC.setSourceResistance(0.0); // --- Rs = 600
+// --- arbitrary ratio resampling; see ResamplingKernel
+const unsigned int kResamplingKernelHalfSpan = 32;	///< kernel half width in samples at full bandwidth
+const unsigned int kResamplingKernelPhases = 64;	///< table entries per sample
+const double kMinResamplingCutoff = 1.0 / maxSamplingRatio;	///< narrowest band: the kernel stretches at most maxSamplingRatio times
+const unsigned int kResamplingKernelMaxTaps = 2 * kResamplingKernelHalfSpan * maxSamplingRatio + 2;	///< taps at kMinResamplingCutoff
 
-		// --- set open ckt termination
-		parallelTerminatedAdaptor_L.setOpenTerminalResistance(true);
-	}
+/**
+\class ResamplingKernel
+\ingroup FX-Objects
+\brief
+The ResamplingKernel object is the anti-aliasing lowpass for arbitrary and time varying resampling ratios, where the
+fixed 2x/4x polyphase sets of the Interpolator and Decimator do not apply. It is the 256 point, 4x oversampled FIR
+from filters.h (see getFilterIRTable( )): a 4 phase polyphase bank of 64 taps at the base rate, refined to
+kResamplingKernelPhases phases with the 4 point Lagrange interpolator when the table is built.
 
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return WDFParameters custom data structure
-	*/
-	WDFParameters getParameters() { return wdfParameters; }
+- getWeights( ) returns the tap weights for any fractional position, normalized to unity gain at DC
+- for a cutoff c < 1 (a fraction of the Nyquist frequency) the kernel is stretched to +/- kResamplingKernelHalfSpan / c
+  taps; c is limited to kMinResamplingCutoff so the cost of a call is bounded by kResamplingKernelMaxTaps
 
-	/** set parameters: note use of custom structure for passing param data */
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class ResamplingKernel
+{
+public:
+	ResamplingKernel() {}	/* C-TOR */
+	~ResamplingKernel() {}	/* D-TOR */
+
+	/** build the table from the built-in FIR for the sample rate: the 44.1kHz design at 44.1kHz, the 48kHz design
+	    (which scales with the rate) otherwise */
 	/**
-	\param WDFParameters custom data structure
+	\param _sampleRate the sample rate
 	*/
-	void setParameters(const WDFParameters& _wdfParameters)
+	void initialize(unsigned int _sampleRate)
 	{
-		if (_wdfParameters.fc != wdfParameters.fc ||
-			_wdfParameters.Q != wdfParameters.Q ||
-			_wdfParameters.boostCut_dB != wdfParameters.boostCut_dB ||
-			_wdfParameters.frequencyWarping != wdfParameters.frequencyWarping)
+		unsigned int designRate = _sampleRate == 44100 ? 44100 : 48000;
+		if (designRate == sampleRate)
+			return;
+
+		const unsigned int prototypeLength = 256;
+		double* prototype = getFilterIRTable(prototypeLength, rateConversionRatio::k4x, designRate);
+		double centre = (prototypeLength - 1) / 2.0;
+
+		for (unsigned int j = 0; j < kTableLength; j++)
 		{
-			wdfParameters = _wdfParameters;
-			double fc_Hz = wdfParameters.fc;
+			// --- table entry j is u = j/kResamplingKernelPhases - kResamplingKernelHalfSpan samples from the centre,
+			//     which is x = 4u + centre on the prototype
+			double u = (double)j / kResamplingKernelPhases - kResamplingKernelHalfSpan;
+			double x = u * countForRatio(rateConversionRatio::k4x) + centre;
+			int n = (int)floor(x);
 
-			if (wdfParameters.frequencyWarping)
+			double c[4];
+			getLagrange4Coefficients(x - n, c);
+
+			double sum = 0.0;
+			for (int i = 0; i < 4; i++)
 			{
-				double arg = (kPi*fc_Hz) / sampleRate;
-				fc_Hz = fc_Hz*(tan(arg) / arg);
+				int tap = n - 1 + i;
+				if (tap >= 0 && tap < (int)prototypeLength)
+					sum += c[i] * prototype[tap];
 			}
-
-			double inductorValue = 1.0 / (1.0e-6 * pow((2.0*kPi*fc_Hz), 2.0));
-			double resistorValue = (1.0 / wdfParameters.Q)*(pow(inductorValue / 1.0e-6, 0.5));
-
-			seriesAdaptor_RC.setComponentValue_RC(resistorValue, 1.0e-6);
-			parallelTerminatedAdaptor_L.setComponentValue(inductorValue);
+			table[j] = sum;
 		}
+		sampleRate = designRate;
 	}
 
+	/** calculate the weights of the taps around a fractional position */
+	/**
+	\param position the position to resample, in samples on the tap grid
+	\param cutoff the bandwidth as a fraction of the Nyquist frequency, on the range [kMinResamplingCutoff, 1.0]
+	\param firstTap returns the first tap: weights[i] is for tap firstTap + i
+	\param weights array of at least kResamplingKernelMaxTaps weights
+	\return the number of taps
+	*/
+	inline unsigned int getWeights(double position, double cutoff, int& firstTap, double* weights) const
+	{
+		double span = kResamplingKernelHalfSpan / cutoff;
+		firstTap = (int)ceil(position - span);
+		int lastTap = (int)floor(position + span);
 
-protected:
-	WDFParameters wdfParameters;	///< object parameters
+		// --- u = cutoff * (tap - position), stepped by cutoff, in table units
+		double index = (cutoff * (firstTap - position) + kResamplingKernelHalfSpan) * kResamplingKernelPhases;
+		double step = cutoff * kResamplingKernelPhases;
+		unsigned int count = (unsigned int)(lastTap - firstTap + 1);
+		double sum = 0.0;
 
-	// --- three
-	WdfSeriesAdaptor				seriesAdaptor_RC;				///< adaptor for RC
-	WdfParallelTerminatedAdaptor	parallelTerminatedAdaptor_L;	///< adaptor for L
+		for (unsigned int i = 0; i < count; i++)
+		{
+			// --- linear between table phases; index is inside [0, kTableLength - 1] by construction
+			int j = (int)index;
+			if (j >= (int)kTableLength - 1)
+				j = kTableLength - 2;
+			double fraction = index - j;
+			weights[i] = table[j] + fraction * (table[j + 1] - table[j]);
+			sum += weights[i];
+			index += step;
+		}
 
-	double sampleRate = 1.0;	///< sample rate storage
+		// --- unity gain at DC for every position and cutoff
+		double scale = sum != 0.0 ? 1.0 / sum : 0.0;
+		for (unsigned int i = 0; i < count; i++)
+			weights[i] *= scale;
+
+		return count;
+	}
+
+private:
+	static const unsigned int kTableLength = 2 * kResamplingKernelHalfSpan * kResamplingKernelPhases + 1;
+	double table[kTableLength] = { 0.0 };	///< the kernel from -kResamplingKernelHalfSpan to +kResamplingKernelHalfSpan samples
+	unsigned int sampleRate = 0;			///< design rate of the table, 0 until initialize( )
 };
 
+// --- direct form polyphase 2x/4x resampling; see PolyphaseInterpolator
+const unsigned int kMaxPolyphaseFIRLength = 512;	///< longest filters.h table the direct form filters take
+const unsigned int kMaxPolyphaseSubBandLength = kMaxPolyphaseFIRLength / 2;	///< longest sub-band (2x)
+
 /**
-\class WDFIdealRLCBPF
-\ingroup WDF-Objects
-\brief
-The WDFIdealRLCBPF object implements an ideal RLC BPF using the WDF library.
+@loadPolyphaseFilter
+\ingroup FX-Functions
 
-Audio I/O:
-- Processes mono input to mono output.
+@brief loads a built-in anti-aliasing FIR into a fixed polyphase array without allocating: phase j of a ratio R
+       set is taps j, j + R, j + 2R... of the FIR (the same split as decomposeFilter( ), in forward order); the
+       44.1kHz design is used at 44.1kHz, the 48kHz design (which scales with the rate) otherwise
 
-Control I/F:
-- Use WDFParameters structure to get/set object params.
+       each phase is normalized to a DC gain of gain / R: the short tables are truncated and their phases do not
+       sum to the same value, which would leave a DC gain error and a tone at the low rate on a constant input
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
+\param FIRLength - length of the FIR: 128, 256 or 512
+\param ratio - the conversion ratio
+\param sampleRate - the sample rate
+\param gain - scales every tap
+\param phases - maxSamplingRatio x kMaxPolyphaseSubBandLength array to fill
+\return true if a table was found
 */
-class WDFIdealRLCBPF : public IAudioSignalProcessor
+inline bool loadPolyphaseFilter(unsigned int FIRLength, rateConversionRatio ratio, unsigned int sampleRate, double gain,
+								double phases[maxSamplingRatio][kMaxPolyphaseSubBandLength])
 {
-public:
-	WDFIdealRLCBPF(void) { createWDF(); }	/* C-TOR */
-	~WDFIdealRLCBPF(void) {}	/* D-TOR */
+	if (FIRLength > kMaxPolyphaseFIRLength)
+		return false;
 
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate)
+	unsigned int designRate = sampleRate == 44100 ? 44100 : 48000;
+	double* filterIR = getFilterIRTable(FIRLength, ratio, designRate);
+	if (!filterIR)
+		return false;
+
+	unsigned int count = countForRatio(ratio);
+	unsigned int subBandLength = FIRLength / count;
+	for (unsigned int j = 0; j < count; j++)
 	{
-		sampleRate = _sampleRate;
-		// --- rest WDF components (flush state registers)
-		seriesAdaptor_LC.reset(_sampleRate);
-		parallelTerminatedAdaptor_R.reset(_sampleRate);
+		double sum = 0.0;
+		for (unsigned int k = 0; k < subBandLength; k++)
+			sum += filterIR[k * count + j];
 
-		// --- intialize the chain of adapters
-		seriesAdaptor_LC.initializeAdaptorChain();
-		return true;
+		double scale = sum != 0.0 ? gain / (count * sum) : 0.0;
+		for (unsigned int k = 0; k < subBandLength; k++)
+			phases[j][k] = scale * filterIR[k * count + j];
 	}
+	return true;
+}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
+/**
+\class PolyphaseInterpolator
+\ingroup FX-Objects
+\brief
+The PolyphaseInterpolator object is a direct form polyphase 2x/4x interpolator on the built-in filters.h tables:
+one input sample yields countForRatio( ) output samples, each one sub-band FIR of FIRLength / ratio taps.
 
-	/** process input x(n) through the WDF Ideal RLC filter to produce return value y(n) */
+- unlike the FFT based Interpolator it has no frame latency and the same cost on every sample; the group delay
+  is (FIRLength - 1) / 2 samples at the high rate
+- the coefficients and history are fixed arrays (kMaxPolyphaseFIRLength taps), so initialize( ) and
+  interpolateBlock( ) never allocate
+
+Audio I/O:
+- Processes blocks of mono input to blocks of interpolated output.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class PolyphaseInterpolator
+{
+public:
+	PolyphaseInterpolator() {}		/* C-TOR */
+	~PolyphaseInterpolator() {}		/* D-TOR */
+
+	/** load the filter and clear the history; realtime safe */
 	/**
-	\param xn input
-	\return the processed sample
+	\param _FIRLength the anti-aliasing filter length: 128, 256 or 512
+	\param _ratio the conversion ratio (see rateConversionRatio)
+	\param _sampleRate the actual sample rate
+	\return true if a table was found; otherwise the object passes the input through as a zero-stuffed stream
 	*/
-	virtual double processAudioSample(double xn)
+	bool initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate)
 	{
-		// --- push audio sample into series L1
-		seriesAdaptor_LC.setInput1(xn);
+		ratio = _ratio;
+		count = countForRatio(ratio);
 
-		// --- output is at terminated L2's output2
-		//     note compensation scaling by -6dB = 0.5
-		//     because of WDF assumption about Rs and Rload
-		return 0.5*parallelTerminatedAdaptor_R.getOutput2();
+		// --- interpolators need the amp correction
+		valid = loadPolyphaseFilter(_FIRLength, ratio, _sampleRate, (double)count, phases);
+		subBandLength = valid ? _FIRLength / count : 1;
+		if (!valid)
+		{
+			for (unsigned int j = 0; j < count; j++)
+				phases[j][0] = j == 0 ? 1.0 : 0.0;
+		}
+
+		reset();
+		return valid;
 	}
 
-	/** create the WDF structure*/
-	void createWDF()
+	/** clear the history */
+	void reset()
 	{
-		// --- create components, init to noramlized values fc =
-		//	   initial values for fc = 1kHz Q = 0.707
-		//     Holding C Constant at 1e-6
-		//			   L = 2.533e-2
-		//			   R = 2.251131 e2
-		seriesAdaptor_LC.setComponent(wdfComponent::seriesLC, 2.533e-2, 1.0e-6);
-		parallelTerminatedAdaptor_R.setComponent(wdfComponent::R, 2.251131e2);
-
-		// --- connect adapters
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_LC, &parallelTerminatedAdaptor_R);
-
-		// --- set source resistance
-		seriesAdaptor_LC.setSourceResistance(0.0); // --- Rs = 600
-
-		// --- set open ckt termination
-		parallelTerminatedAdaptor_R.setOpenTerminalResistance(true);
+		memset(history, 0, sizeof(history));
+		historyIndex = 0;
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return WDFParameters custom data structure
-	*/
-	WDFParameters getParameters() { return wdfParameters; }
+	/** the up sampling ratio as a number */
+	unsigned int getCount() const { return count; }
 
-	/** set parameters: note use of custom structure for passing param data */
+	/** group delay in input samples */
+	double getLatency() const { return valid ? (subBandLength * count - 1) / (2.0 * count) : 0.0; }
+
+	/** interpolate a block */
 	/**
-	\param WDFParameters custom data structure
+	\param input numSamples input samples
+	\param output numSamples * getCount( ) output samples
+	\param numSamples number of input samples
 	*/
-	void setParameters(const WDFParameters& _wdfParameters)
+	void interpolateBlock(const double* input, double* output, unsigned int numSamples)
 	{
-		if (_wdfParameters.fc != wdfParameters.fc ||
-			_wdfParameters.Q != wdfParameters.Q ||
-			_wdfParameters.boostCut_dB != wdfParameters.boostCut_dB ||
-			_wdfParameters.frequencyWarping != wdfParameters.frequencyWarping)
+		// --- every phase runs over the same window, on the CPU-dispatched kernel (see fxkernels.h)
+		const FXKernels& kernels = getFXKernels();
+		for (unsigned int n = 0; n < numSamples; n++)
 		{
-			wdfParameters = _wdfParameters;
-			double fc_Hz = wdfParameters.fc;
-
-			if (wdfParameters.frequencyWarping)
-			{
-				double arg = (kPi*fc_Hz) / sampleRate;
-				fc_Hz = fc_Hz*(tan(arg) / arg);
-			}
-
-			double inductorValue = 1.0 / (1.0e-6 * pow((2.0*kPi*fc_Hz), 2.0));
-			double resistorValue = (1.0 / wdfParameters.Q)*(pow(inductorValue / 1.0e-6, 0.5));
-
-			seriesAdaptor_LC.setComponentValue_LC(inductorValue, 1.0e-6);
-			parallelTerminatedAdaptor_R.setComponentValue(resistorValue);
+			// --- the history is stored twice so that the newest subBandLength samples are always contiguous,
+			//     newest first, at history[historyIndex]
+			historyIndex = historyIndex > 0 ? historyIndex - 1 : subBandLength - 1;
+			history[historyIndex] = input[n];
+			history[historyIndex + subBandLength] = input[n];
+
+			kernels.polyphaseFIR(&phases[0][0], kMaxPolyphaseSubBandLength, &history[historyIndex], 0, output, count, subBandLength);
+			output += count;
 		}
 	}
 
 protected:
-	WDFParameters wdfParameters;	///< object parameters
-
-	// --- adapters
-	WdfSeriesAdaptor				seriesAdaptor_LC; ///< adaptor for LC
-	WdfParallelTerminatedAdaptor	parallelTerminatedAdaptor_R; ///< adaptor for R
-
-	double sampleRate = 1.0;
+	rateConversionRatio ratio = rateConversionRatio::k2x;	///< conversion ratio
+	unsigned int count = 2;				///< countForRatio(ratio)
+	unsigned int subBandLength = 1;		///< taps per phase
+	bool valid = false;					///< true when a table was loaded
+	double phases[maxSamplingRatio][kMaxPolyphaseSubBandLength] = { { 0.0 } };	///< phase j: taps j, j + count...
+	double history[2 * kMaxPolyphaseSubBandLength] = { 0.0 };	///< input history, stored twice
+	unsigned int historyIndex = 0;		///< newest input
 };
 
-
 /**
-\class WDFIdealRLCBSF
-\ingroup WDF-Objects
+\class PolyphaseDecimator
+\ingroup FX-Objects
 \brief
-The WDFIdealRLCBSF object implements an ideal RLC BSF using the WDF library.
+The PolyphaseDecimator object is the direct form polyphase 2x/4x decimator that pairs with PolyphaseInterpolator:
+countForRatio( ) input samples yield one output sample; input sample i of each group runs through phase
+count - 1 - i, so the block is the same filter as the full FIR followed by dropping samples.
 
-Audio I/O:
-- Processes mono input to mono output.
+- the group delay is (FIRLength - 1) / 2 samples at the high rate, from the newest sample of each group; no
+  allocation after construction
 
-Control I/F:
-- Use WDFParameters structure to get/set object params.
+Audio I/O:
+- Processes blocks of oversampled mono input to blocks of decimated output.
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
 \version Revision : 1.0
-\date Date : 2018 / 09 / 7
+\date Date : 2019 / 01 / 31
 */
-class WDFIdealRLCBSF : public IAudioSignalProcessor
+class PolyphaseDecimator
 {
 public:
-	WDFIdealRLCBSF(void) { createWDF(); }	/* C-TOR */
-	~WDFIdealRLCBSF(void) {}	/* D-TOR */
-
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate)
-	{
-		sampleRate = _sampleRate;
-		// --- rest WDF components (flush state registers)
-		seriesAdaptor_R.reset(_sampleRate);
-		parallelTerminatedAdaptor_LC.reset(_sampleRate);
-
-		// --- intialize the chain of adapters
-		seriesAdaptor_R.initializeAdaptorChain();
-		return true;
-	}
+	PolyphaseDecimator() {}		/* C-TOR */
+	~PolyphaseDecimator() {}	/* D-TOR */
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
-
-	/** process input x(n) through the WDF Ideal RLC filter to produce return value y(n) */
+	/** load the filter and clear the history; realtime safe */
 	/**
-	\param xn input
-	\return the processed sample
+	\param _FIRLength the anti-aliasing filter length: 128, 256 or 512
+	\param _ratio the conversion ratio (see rateConversionRatio)
+	\param _sampleRate the actual (decimated) sample rate
+	\return true if a table was found; otherwise the object keeps the newest sample of each group
 	*/
-	virtual double processAudioSample(double xn)
+	bool initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate)
 	{
-		// --- push audio sample into series L1
-		seriesAdaptor_R.setInput1(xn);
+		ratio = _ratio;
+		count = countForRatio(ratio);
 
-		// --- output is at terminated L2's output2
-		//     note compensation scaling by -6dB = 0.5
-		//     because of WDF assumption about Rs and Rload
-		return 0.5*parallelTerminatedAdaptor_LC.getOutput2();
+		valid = loadPolyphaseFilter(_FIRLength, ratio, _sampleRate, 1.0, phases);
+		subBandLength = valid ? _FIRLength / count : 1;
+		if (!valid)
+		{
+			for (unsigned int j = 0; j < count; j++)
+				phases[j][0] = j == 0 ? 1.0 : 0.0;
+		}
+
+		reset();
+		return valid;
 	}
 
-	/** create WDF structure */
-	void createWDF()
+	/** clear the history */
+	void reset()
 	{
-		// --- create components, init to noramlized values fc =
-		//	   initial values for fc = 1kHz Q = 0.707
-		//     Holding C Constant at 1e-6
-		//			   L = 2.533e-2
-		//			   R = 2.251131 e2
-		seriesAdaptor_R.setComponent(wdfComponent::R, 2.533e-2);
-		parallelTerminatedAdaptor_LC.setComponent(wdfComponent::seriesLC, 2.533e-2, 1.0e-6);
-
-		// --- connect adapters
-		WdfAdaptorBase::connectAdaptors(&seriesAdaptor_R, &parallelTerminatedAdaptor_LC);
-
-		// --- set source resistance
-		seriesAdaptor_R.setSourceResistance(0.0); // --- Rs = 600
-
-		// --- set open ckt termination
-		parallelTerminatedAdaptor_LC.setOpenTerminalResistance(true);
+		memset(history, 0, sizeof(history));
+		historyIndex = 0;
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return WDFParameters custom data structure
-	*/
-	WDFParameters getParameters() { return wdfParameters; }
+	/** the down sampling ratio as a number */
+	unsigned int getCount() const { return count; }
 
-	/** set parameters: note use of custom structure for passing param data */
+	/** group delay in output samples, from the oldest sample of each input group: an interpolated block comes
+	    back after PolyphaseInterpolator::getLatency( ) + getLatency( ) = FIRLength / ratio - 1 samples */
+	double getLatency() const { return valid ? (subBandLength * count + 1 - 2.0 * count) / (2.0 * count) : 0.0; }
+
+	/** decimate a block */
 	/**
-	\param WDFParameters custom data structure
+	\param input numSamples * getCount( ) input samples, oldest first
+	\param output numSamples output samples
+	\param numSamples number of output samples
 	*/
-	void setParameters(const WDFParameters& _wdfParameters)
+	void decimateBlock(const double* input, double* output, unsigned int numSamples)
 	{
-		if (_wdfParameters.fc != wdfParameters.fc ||
-			_wdfParameters.Q != wdfParameters.Q ||
-			_wdfParameters.boostCut_dB != wdfParameters.boostCut_dB ||
-			_wdfParameters.frequencyWarping != wdfParameters.frequencyWarping)
+		const FXKernels& kernels = getFXKernels();
+		for (unsigned int n = 0; n < numSamples; n++)
 		{
-			wdfParameters = _wdfParameters;
-			double fc_Hz = wdfParameters.fc;
+			historyIndex = historyIndex > 0 ? historyIndex - 1 : subBandLength - 1;
 
-			if (wdfParameters.frequencyWarping)
+			// --- the newest sample of the group goes through phase 0
+			for (unsigned int j = 0; j < count; j++)
 			{
-				double arg = (kPi*fc_Hz) / sampleRate;
-				fc_Hz = fc_Hz*(tan(arg) / arg);
+				history[j][historyIndex] = input[count - 1 - j];
+				history[j][historyIndex + subBandLength] = input[count - 1 - j];
 			}
 
-			double inductorValue = 1.0 / (1.0e-6 * pow((2.0*kPi*fc_Hz), 2.0));
-			double resistorValue = (1.0 / wdfParameters.Q)*(pow(inductorValue / 1.0e-6, 0.5));
+			// --- each phase over its own history, on the CPU-dispatched kernel (see fxkernels.h)
+			double phaseOutput[maxSamplingRatio];
+			kernels.polyphaseFIR(&phases[0][0], kMaxPolyphaseSubBandLength, &history[0][historyIndex], 2 * kMaxPolyphaseSubBandLength,
+								 phaseOutput, count, subBandLength);
 
-			seriesAdaptor_R.setComponentValue(resistorValue);
-			parallelTerminatedAdaptor_LC.setComponentValue_LC(inductorValue, 1.0e-6);
+			double sum = 0.0;
+			for (unsigned int j = 0; j < count; j++)
+				sum += phaseOutput[j];
+			output[n] = sum;
+			input += count;
 		}
 	}
 
 protected:
-	WDFParameters wdfParameters;	///< object parameters
-
-	// --- adapters
-	WdfSeriesAdaptor				seriesAdaptor_R; ///< adaptor for series R
-	WdfParallelTerminatedAdaptor	parallelTerminatedAdaptor_LC; ///< adaptor for parallel LC
-
-	double sampleRate = 1.0; ///< sample rate storage
+	rateConversionRatio ratio = rateConversionRatio::k2x;	///< conversion ratio
+	unsigned int count = 2;				///< countForRatio(ratio)
+	unsigned int subBandLength = 1;		///< taps per phase
+	bool valid = false;					///< true when a table was loaded
+	double phases[maxSamplingRatio][kMaxPolyphaseSubBandLength] = { { 0.0 } };	///< phase j: taps j, j + count...
+	double history[maxSamplingRatio][2 * kMaxPolyphaseSubBandLength] = { { 0.0 } };	///< per phase input history, stored twice
+	unsigned int historyIndex = 0;		///< newest group
 };
 
-
-// ------------------------------------------------------------------ //
-// --- OBJECTS REQUIRING FFTW --------------------------------------- //
-// ------------------------------------------------------------------ //
-
 /**
-\enum windowType
+\enum saturationModel
 \ingroup Constants-Enums
 \brief
-Use this strongly typed enum to easily set the windowing type for FFT algorithms that use it.
+Use this strongly typed enum to easily set the waveshaper for the TapeSaturator object.
 
-- enum class windowType {kNoWindow, kRectWindow, kHannWindow, kBlackmanHarrisWindow, kHammingWindow };
+- enum class saturationModel { kTanh, kSoftClip, kTriode };
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
 \version Revision : 1.0
-\date Date : 2018 / 09 / 7
+\date Date : 2019 / 01 / 31
 */
-enum class windowType {kNoWindow, kRectWindow, kHannWindow, kBlackmanHarrisWindow, kHammingWindow };
+enum class saturationModel { kTanh, kSoftClip, kTriode };
 
 /**
-@makeWindow
-\ingroup FX-Functions
+\struct TapeSaturatorParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the TapeSaturator object.
 
-@brief  creates a new std::unique_ptr<double[]> array for a given window lenght and type.
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+struct TapeSaturatorParameters
+{
+	TapeSaturatorParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	TapeSaturatorParameters& operator=(const TapeSaturatorParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
 
-\param windowLength - length of window array (does NOT need to be power of 2)
-\param hopSize - hopSize for vococerf applications, may set to 0 for non vocoder use
-\param gainCorrectionValue - return variable that contains the window gain correction value
+		model = params.model;
+		saturation = params.saturation;
+		asymmetry = params.asymmetry;
+		oversampling = params.oversampling;
+		FIRLength = params.FIRLength;
+
+		return *this;
+	}
+
+	// --- individual parameters
+	saturationModel model = saturationModel::kTanh;	///< waveshaper
+	double saturation = 1.0;		///< drive; the output levels off near 1 / saturation
+	double asymmetry = 0.0;			///< kTriode only: even harmonics
+	unsigned int oversampling = 4;	///< 1 (off), 2 or 4
+	unsigned int FIRLength = 128;	///< anti-aliasing filter length: 128, 256 or 512
+};
+
+/**
+\class TapeSaturator
+\ingroup FX-Objects
+\brief
+The TapeSaturator object is an oversampled soft saturator built on the FX waveshapers: tanhWaveShaper( ),
+softClipWaveShaper( ) or a TriodeClassA running at the high rate.
+
+- the shaper is scaled to unity gain for small signals, so it only compresses: a loop through it with a gain
+  above one levels off instead of running away
+- at 2x or 4x the input runs up through a PolyphaseInterpolator, through the shaper and back down through a
+  PolyphaseDecimator in blocks of kTapeSaturatorBlock samples; all buffers are members, so nothing allocates
+  after construction, and setParameters( ) is realtime safe
+- the filters delay the signal by getLatency( ) = FIRLength / oversampling - 1 samples, 31 samples (0.65 mSec)
+  at 4x with the 128 point tables
+
+Audio I/O:
+- Processes mono input to mono output.
+
+Control I/F:
+- Use TapeSaturatorParameters structure to get/set object params.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
 */
-inline std::unique_ptr<double[]> makeWindow(unsigned int windowLength, unsigned int hopSize, windowType window, double& gainCorrectionValue)
+class TapeSaturator : public IAudioSignalProcessor
 {
-	std::unique_ptr<double[]> windowBuffer;
-	windowBuffer.reset(new double[windowLength]);
+public:
+	TapeSaturator() {}		/* C-TOR */
+	~TapeSaturator() {}		/* D-TOR */
 
-	if (!windowBuffer) return nullptr;
+	static const unsigned int kTapeSaturatorBlock = 64;	///< input samples per pass through the filters
 
-	double overlap = hopSize > 0.0 ? 1.0 - (double)hopSize / (double)windowLength : 0.0;
-	gainCorrectionValue = 0.0;
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		sampleRate = _sampleRate;
+		loadFilters();
+		return true;
+	}
 
-	for (int n = 0; n < windowLength; n++)
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return TapeSaturatorParameters custom data structure
+	*/
+	TapeSaturatorParameters getParameters() { return parameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param TapeSaturatorParameters custom data structure
+	*/
+	void setParameters(const TapeSaturatorParameters& params)
 	{
-		if (window == windowType::kRectWindow)
+		bool reload = params.oversampling != parameters.oversampling || params.FIRLength != parameters.FIRLength;
+		parameters = params;
+
+		if (reload && sampleRate > 0.0)
+			loadFilters();
+		else
+			cookShaper();
+	}
+
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** delay through the filters, in samples */
+	double getLatency() const { return oversampling > 1 ? interpolator.getLatency() + decimator.getLatency() : 0.0; }
+
+	/** saturate one sample */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		double yn = 0.0;
+		processAudioBlock(&xn, &yn, 1);
+		return yn;
+	}
+
+	/** saturate a block; input and output may be the same buffer */
+	/**
+	\param input input samples
+	\param output output samples
+	\param numSamples number of samples
+	*/
+	void processAudioBlock(const double* input, double* output, unsigned int numSamples)
+	{
+		if (oversampling == 1)
 		{
-			if (n >= 1 && n <= windowLength - 1)
-				windowBuffer[n] = 1.0;
+			shapeBlock(input, output, numSamples);
+			return;
 		}
-		else if (window == windowType::kHammingWindow)
+
+		for (unsigned int start = 0; start < numSamples; start += kTapeSaturatorBlock)
 		{
-			windowBuffer[n] = 0.54 - 0.46*cos((n*2.0*kPi) / (windowLength));
+			unsigned int length = numSamples - start < kTapeSaturatorBlock ? numSamples - start : kTapeSaturatorBlock;
+			interpolator.interpolateBlock(input + start, oversampled, length);
+			shapeBlock(oversampled, oversampled, length * oversampling);
+			decimator.decimateBlock(oversampled, output + start, length);
 		}
-		else if (window == windowType::kHannWindow)
+	}
+
+protected:
+	/** set the oversampling filters for the parameters and clear every state */
+	void loadFilters()
+	{
+		rateConversionRatio ratio = parameters.oversampling == 2 ? rateConversionRatio::k2x : rateConversionRatio::k4x;
+		oversampling = 1;
+		if (parameters.oversampling == 2 || parameters.oversampling == 4)
 		{
-			windowBuffer[n] = 0.5 * (1 - cos((n*2.0*kPi) / (windowLength)));
+			// --- the 44.1/48kHz designs scale to other rates; see loadPolyphaseFilter( )
+			bool loaded = interpolator.initialize(parameters.FIRLength, ratio, (unsigned int)sampleRate);
+			loaded = decimator.initialize(parameters.FIRLength, ratio, (unsigned int)sampleRate) && loaded;
+			if (loaded)
+				oversampling = parameters.oversampling;
 		}
-		else if (window == windowType::kBlackmanHarrisWindow)
+
+		triode.reset(sampleRate * oversampling);
+		cookShaper();
+	}
+
+	/** the waveshaper, without the makeup gain */
+	inline double shape(double xn)
+	{
+		if (parameters.model == saturationModel::kSoftClip)
+			return softClipWaveShaper(xn, parameters.saturation);
+		if (parameters.model == saturationModel::kTriode)
+			return fuzzExp1WaveShaper(xn, parameters.saturation, parameters.asymmetry);
+		return tanhWaveShaper(xn, parameters.saturation);
+	}
+
+	/** set up the triode and the makeup gain that brings the shaper's small signal slope to one */
+	void cookShaper()
+	{
+		const double delta = 1.0e-6;
+		double slope = (shape(delta) - shape(-delta)) / (2.0 * delta);
+		makeupGain = slope > 0.0 ? 1.0 / slope : 1.0;
+
+		// --- the triode adds its DC blocking cap; no plate inversion inside a loop
+		TriodeClassAParameters triodeParams = triode.getParameters();
+		triodeParams.waveshaper = distortionModel::kFuzzAsym;
+		triodeParams.saturation = parameters.saturation;
+		triodeParams.asymmetry = parameters.asymmetry;
+		triodeParams.outputGain = makeupGain;
+		triodeParams.invertOutput = false;
+		triodeParams.enableHPF = true;
+		triodeParams.enableLSF = false;
+		triode.setParameters(triodeParams);
+	}
+
+	/** run the shaper over a block */
+	void shapeBlock(const double* input, double* output, unsigned int numSamples)
+	{
+		if (parameters.model == saturationModel::kTriode)
 		{
-			windowBuffer[n] = (0.42323 - (0.49755*cos((n*2.0*kPi) / (windowLength))) + 0.07922*cos((2 * n*2.0*kPi) / (windowLength)));
+			for (unsigned int i = 0; i < numSamples; i++)
+				output[i] = triode.processAudioSample(input[i]);
 		}
-		else if (window == windowType::kNoWindow)
+		else if (parameters.model == saturationModel::kSoftClip)
 		{
-			windowBuffer[n] = 1.0;
+			for (unsigned int i = 0; i < numSamples; i++)
+				output[i] = makeupGain * softClipWaveShaper(input[i], parameters.saturation);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < numSamples; i++)
+				output[i] = makeupGain * tanhWaveShaper(input[i], parameters.saturation);
 		}
-
-		gainCorrectionValue += windowBuffer[n];
 	}
 
-	// --- calculate gain correction factor
-	if (window != windowType::kNoWindow)
-		gainCorrectionValue = (1.0 - overlap) / gainCorrectionValue;
-	else
-		gainCorrectionValue = 1.0 / gainCorrectionValue;
-
-	return windowBuffer;
-}
+	TapeSaturatorParameters parameters;	///< object parameters
+	double sampleRate = 0.0;			///< base sample rate
+	unsigned int oversampling = 1;		///< running ratio; 1 until reset( ) or without a table
+	double makeupGain = 1.0;			///< 1 / small signal slope of the shaper
+	TriodeClassA triode;				///< kTriode shaper, at the high rate
+	PolyphaseInterpolator interpolator;	///< up to the high rate
+	PolyphaseDecimator decimator;		///< and back down
+	double oversampled[kTapeSaturatorBlock * maxSamplingRatio] = { 0.0 };	///< one block at the high rate
+};
 
 // --- FFTW ---
 #ifdef HAVE_FFTW
@@ -8733,7 +10927,7 @@ class FastFFT
 public:
 	FastFFT() {}		/* C-TOR */
 	~FastFFT() {
-		if (windowBuffer) delete[] windowBuffer;
+		fxDeleteArray(windowBuffer);
 		destroyFFTW();
 	}	/* D-TOR */
 
@@ -8792,9 +10986,9 @@ class PhaseVocoder
 public:
 	PhaseVocoder() {}		/* C-TOR */
 	~PhaseVocoder() {
-		if (inputBuffer) delete[] inputBuffer;
-		if (outputBuffer) delete[] outputBuffer;
-		if (windowBuffer) delete[] windowBuffer;
+		fxDeleteArray(inputBuffer);
+		fxDeleteArray(outputBuffer);
+		fxDeleteArray(windowBuffer);
 		destroyFFTW();
 	}	/* D-TOR */
 
@@ -8881,10 +11075,359 @@ protected:
 	unsigned int hopSize = 0;					///< hop: ha = hs
 	double overlap = 1.0;						///< overlap as raw value (75% = 0.75)
 
-	// --- flag for overlap-add algorithms that do not involve hop-size, other
-	//     than setting the overlap
-	bool overlapAddOnly = false;				///< flag for overlap-add-only algorithms
+	// --- flag for overlap-add algorithms that do not involve hop-size, other
+	//     than setting the overlap
+	bool overlapAddOnly = false;				///< flag for overlap-add-only algorithms
+
+};
+
+/** most stages a PartitionedConvolver splits its IR into (partition sizes B, 2B, 4B ... ) */
+const unsigned int kMaxConvolverStages = 8;
+
+/** partitions each stage of a non-uniform layout covers before the next stage doubles the partition size */
+const unsigned int kConvolverStagePartitions = 4;
+
+/**
+\struct ConvolverStage
+\ingroup FFTW-Objects
+\brief
+One uniformly partitioned overlap-save stage of a PartitionedConvolver: the FFTs, the frequency domain delay line
+(FDL) of input spectra and the partition spectra of its part of the IR.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+struct ConvolverStage
+{
+	unsigned int partitionSize = 0;		///< B: samples per partition; the FFT length is 2B
+	unsigned int spectrumLength = 0;	///< B + 1 bins out of the r2c FFT
+	unsigned int spectrumStride = 0;	///< doubles from one spectrum to the next, a whole number of cache lines
+	unsigned int irOffset = 0;			///< first IR sample this stage covers
+	unsigned int irLength = 0;			///< IR samples this stage covers at most
+	unsigned int leadZeros = 0;			///< zeros in front of the stage IR that line its output up with the first stage
+	unsigned int skipPartitions = 0;	///< whole partitions of lead zeros: FDL slots that are never multiplied
+	unsigned int numPartitions = 0;		///< partition spectra allocated, after the skipped ones
+	unsigned int activePartitions = 0;	///< partition spectra that hold the current IR
+	unsigned int fdlLength = 0;			///< FDL slots = skipPartitions + numPartitions
+	unsigned int fdlIndex = 0;			///< FDL slot holding the newest input spectrum
+	unsigned int count = 0;				///< input samples collected towards the next partition
+
+	double* timeInput = nullptr;		///< last 2B input samples: the previous partition, then the one being collected
+	double* timeOutput = nullptr;		///< 2B samples out of the c2r FFT; the second half is the valid output
+	double* outputBlock = nullptr;		///< B output samples being played out while the next partition is collected
+	double* fdl = nullptr;				///< fdlLength input spectra (FDL)
+	double* filterSpectra = nullptr;	///< numPartitions IR partition spectra, scaled by 1/2B
+	double* accumulator = nullptr;		///< the MAC sum over the FDL, one spectrum
+	fftw_plan planForward = nullptr;	///< r2c, 2B
+	fftw_plan planBackward = nullptr;	///< c2r, 2B
+};
+
+/**
+\class PartitionedConvolver
+\ingroup FFTW-Objects
+\brief
+The PartitionedConvolver provides low latency fast convolution with long IRs: uniformly partitioned overlap-save
+with real-to-complex FFTs, a frequency domain delay line and the CPU-dispatched complex multiply-accumulate.
+
+Audio I/O:
+- processes mono input into mono output; the output is the IR convolution delayed by getLatency( ) samples.
+
+Control I/F:
+- initialize( ) with the partition size, the longest IR and (optionally) the largest partition size;
+  setFilterIR( ) with the IR.
+
+Partitioning:
+- the IR is cut into partitions of B samples; every B input samples the newest 2B samples are FFT'd (r2c) into the
+  FDL, multiplied with each partition spectrum against the matching older FDL slot, summed, and one c2r IFFT gives
+  the next B outputs
+- the latency is B, and the work happens once per B samples: set B to the host block size and every buffer
+  costs the same, one forward FFT, one inverse FFT and one MAC per partition, at any IR length
+- with a maximum partition size above B the layout is non-uniform: kConvolverStagePartitions partitions of B,
+  then of 2B, 4B and so on up to the maximum, and the rest of the IR in partitions of the maximum size. The tail
+  of a long IR costs far less per sample, but the larger stages run their FFTs every 2B, 4B ... samples, so the
+  CPU load of a host block is no longer uniform; each stage's output is lined up with the first by lead zeros in
+  its IR, so the latency is still B
+- initialize( ) allocates everything and plans the FFTs (not realtime safe); setFilterIR( ) only FFTs the IR
+  partitions and may be called again to swap IRs of up to the initialized length
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class PartitionedConvolver
+{
+public:
+	PartitionedConvolver() {}		/* C-TOR */
+	~PartitionedConvolver() {
+		destroyStages();
+	}	/* D-TOR */
+
+	/** setup the partitions */
+	/**
+	\param _partitionSize B, the first (and for a uniform layout the only) partition size and the latency
+	\param _maxIRLength the longest IR setFilterIR( ) will be given
+	\param _maxPartitionSize the largest partition size for a non-uniform layout; 0 (or B) for uniform
+	\return true if the layout was built
+	*/
+	bool initialize(unsigned int _partitionSize, unsigned int _maxIRLength, unsigned int _maxPartitionSize = 0)
+	{
+		if (_partitionSize == 0 || _maxIRLength == 0)
+			return false;
+
+		if (_maxPartitionSize < _partitionSize)
+			_maxPartitionSize = _partitionSize;
+
+		// --- same layout: keep the plans and the IR, just clear the history
+		if (_partitionSize == partitionSize && _maxIRLength == maxIRLength && _maxPartitionSize == maxPartitionSize)
+		{
+			reset();
+			return true;
+		}
+
+		destroyStages();
+		partitionSize = _partitionSize;
+		maxIRLength = _maxIRLength;
+		maxPartitionSize = _maxPartitionSize;
+		irLength = 0;
+
+		unsigned int irOffset = 0;
+		unsigned int stagePartitionSize = partitionSize;
+		while (irOffset < maxIRLength && numStages < kMaxConvolverStages)
+		{
+			ConvolverStage& stage = stages[numStages++];
+			bool lastStage = numStages == kMaxConvolverStages || stagePartitionSize * 2 > maxPartitionSize;
+
+			stage.partitionSize = stagePartitionSize;
+			stage.irOffset = irOffset;
+			stage.irLength = lastStage ? maxIRLength - irOffset : kConvolverStagePartitions * stagePartitionSize;
+			if (stage.irLength > maxIRLength - irOffset)
+				stage.irLength = maxIRLength - irOffset;
+
+			// --- this stage's output comes out stagePartitionSize samples late, the first stage's partitionSize
+			//     samples late: the difference is made up with zeros in front of its IR, whole partitions of
+			//     which are just FDL slots that are never multiplied
+			unsigned int delay = irOffset + partitionSize - stagePartitionSize;
+			stage.skipPartitions = delay / stagePartitionSize;
+			stage.leadZeros = delay % stagePartitionSize;
+			stage.numPartitions = (stage.leadZeros + stage.irLength + stagePartitionSize - 1) / stagePartitionSize;
+			stage.fdlLength = stage.skipPartitions + stage.numPartitions;
+
+			// --- r2c gives B + 1 bins; keep every spectrum on a cache line boundary for the FFTW SIMD paths
+			unsigned int doublesPerLine = (unsigned int)(kFXCacheLineSize / sizeof(double));
+			stage.spectrumLength = stagePartitionSize + 1;
+			stage.spectrumStride = ((2 * stage.spectrumLength + doublesPerLine - 1) / doublesPerLine) * doublesPerLine;
+
+			unsigned int fftLength = 2 * stagePartitionSize;
+			stage.timeInput = fxNewArray<double>(fftLength);
+			stage.timeOutput = fxNewArray<double>(fftLength);
+			stage.outputBlock = fxNewArray<double>(stagePartitionSize);
+			stage.fdl = fxNewArray<double>(stage.fdlLength * stage.spectrumStride);
+			stage.filterSpectra = fxNewArray<double>(stage.numPartitions * stage.spectrumStride);
+			stage.accumulator = fxNewArray<double>(stage.spectrumStride);
+
+			// --- the forward plan is run on every FDL slot with fftw_execute_dft_r2c( ); all slots share its alignment
+			stage.planForward = fftw_plan_dft_r2c_1d(fftLength, stage.timeInput, (fftw_complex*)stage.fdl, FFTW_ESTIMATE);
+			stage.planBackward = fftw_plan_dft_c2r_1d(fftLength, (fftw_complex*)stage.accumulator, stage.timeOutput, FFTW_ESTIMATE);
+
+			irOffset += stage.irLength;
+			if (!lastStage)
+				stagePartitionSize *= 2;
+		}
+
+		reset();
+		return true;
+	}
+
+	/** clear the input history and the FDL; the IR is kept */
+	void reset()
+	{
+		for (unsigned int s = 0; s < numStages; s++)
+		{
+			ConvolverStage& stage = stages[s];
+			memset(stage.timeInput, 0, 2 * stage.partitionSize * sizeof(double));
+			memset(stage.timeOutput, 0, 2 * stage.partitionSize * sizeof(double));
+			memset(stage.outputBlock, 0, stage.partitionSize * sizeof(double));
+			memset(stage.fdl, 0, stage.fdlLength * stage.spectrumStride * sizeof(double));
+			memset(stage.accumulator, 0, stage.spectrumStride * sizeof(double));
+			stage.fdlIndex = 0;
+			stage.count = 0;
+		}
+	}
+
+	/** set the IR; irBuffer holds length samples, and anything past the initialized maximum is ignored */
+	/**
+	\param irBuffer the IR
+	\param length the IR length
+	*/
+	void setFilterIR(const double* irBuffer, unsigned int length)
+	{
+		if (!irBuffer || numStages == 0)
+			return;
+
+		irLength = length < maxIRLength ? length : maxIRLength;
+		for (unsigned int s = 0; s < numStages; s++)
+		{
+			ConvolverStage& stage = stages[s];
+			unsigned int fftLength = 2 * stage.partitionSize;
+			double scale = 1.0 / fftLength; // --- FFTW does not normalize the IFFT
+			memset(stage.filterSpectra, 0, stage.numPartitions * stage.spectrumStride * sizeof(double));
+
+			// --- IR samples this stage holds with its lead zeros in front
+			unsigned int available = irLength > stage.irOffset ? irLength - stage.irOffset : 0;
+			unsigned int stageLength = available < stage.irLength ? available : stage.irLength;
+			stage.activePartitions = stageLength > 0 ? (stage.leadZeros + stageLength + stage.partitionSize - 1) / stage.partitionSize : 0;
+
+			// --- each partition is zero padded to 2B; timeOutput is free scratch between blocks
+			for (unsigned int p = 0; p < stage.activePartitions; p++)
+			{
+				memset(stage.timeOutput, 0, fftLength * sizeof(double));
+				for (unsigned int i = 0; i < stage.partitionSize; i++)
+				{
+					unsigned int k = p * stage.partitionSize + i;
+					if (k >= stage.leadZeros && k - stage.leadZeros < stageLength)
+						stage.timeOutput[i] = irBuffer[stage.irOffset + k - stage.leadZeros] * scale;
+				}
+
+				fftw_execute_dft_r2c(stage.planForward, stage.timeOutput, (fftw_complex*)&stage.filterSpectra[p * stage.spectrumStride]);
+			}
+			memset(stage.timeOutput, 0, fftLength * sizeof(double));
+		}
+	}
+
+	/** process an input sample through the convolver */
+	double processAudioSample(double input)
+	{
+		double output = 0.0;
+		processAudioBlock(&input, &output, 1);
+		return output;
+	}
+
+	/** process a block; input and output may be the same buffer */
+	/**
+	\param input count input samples
+	\param output count output samples
+	\param count the block length; any length, partitions are collected across calls
+	*/
+	void processAudioBlock(const double* input, double* output, uint32_t count)
+	{
+		if (numStages == 0)
+		{
+			memset(output, 0, count * sizeof(double));
+			return;
+		}
+
+		uint32_t done = 0;
+		while (done < count)
+		{
+			// --- never cross a B boundary, so no stage (all multiples of B) crosses one of its own
+			uint32_t chunk = partitionSize - stages[0].count;
+			if (chunk > count - done)
+				chunk = count - done;
+
+			// --- store the input in every stage before the output overwrites it
+			for (unsigned int s = 0; s < numStages; s++)
+				memcpy(&stages[s].timeInput[stages[s].partitionSize + stages[s].count], &input[done], chunk * sizeof(double));
+
+			memcpy(&output[done], &stages[0].outputBlock[stages[0].count], chunk * sizeof(double));
+			for (unsigned int s = 1; s < numStages; s++)
+			{
+				const double* stageOutput = &stages[s].outputBlock[stages[s].count];
+				for (uint32_t i = 0; i < chunk; i++)
+					output[done + i] += stageOutput[i];
+			}
+
+			for (unsigned int s = 0; s < numStages; s++)
+			{
+				ConvolverStage& stage = stages[s];
+				stage.count += chunk;
+				if (stage.count == stage.partitionSize)
+				{
+					processPartition(stage);
+					stage.count = 0;
+				}
+			}
+			done += chunk;
+		}
+	}
+
+	/** get the latency in samples: the first partition size */
+	unsigned int getLatency() { return partitionSize; }
+
+	/** get the first partition size */
+	unsigned int getPartitionSize() { return partitionSize; }
+
+	/** get the number of stages, 1 for a uniform layout */
+	unsigned int getNumStages() { return numStages; }
+
+	/** get the current IR length */
+	unsigned int getFilterIRLength() { return irLength; }
+
+protected:
+	ConvolverStage stages[kMaxConvolverStages];	///< B, 2B, 4B ... stages
+	unsigned int numStages = 0;			///< stages in use
+	unsigned int partitionSize = 0;		///< first partition size = latency
+	unsigned int maxPartitionSize = 0;	///< largest partition size
+	unsigned int maxIRLength = 0;		///< longest IR
+	unsigned int irLength = 0;			///< current IR length
+
+	/** one partition in: FFT into the FDL, MAC against the IR partitions, IFFT to the next output block */
+	void processPartition(ConvolverStage& stage)
+	{
+		// --- newest spectrum into the next FDL slot
+		stage.fdlIndex = stage.fdlIndex == 0 ? stage.fdlLength - 1 : stage.fdlIndex - 1;
+		fftw_execute_dft_r2c(stage.planForward, stage.timeInput, (fftw_complex*)&stage.fdl[stage.fdlIndex * stage.spectrumStride]);
+
+		// --- slide the window: this partition becomes the previous one
+		memcpy(stage.timeInput, &stage.timeInput[stage.partitionSize], stage.partitionSize * sizeof(double));
+
+		if (stage.activePartitions == 0)
+		{
+			memset(stage.outputBlock, 0, stage.partitionSize * sizeof(double));
+			return;
+		}
+
+		// --- IR partition p meets the input spectrum from p partitions ago; the FDL runs forward from fdlIndex
+		const FXKernels& kernels = getFXKernels();
+		memset(stage.accumulator, 0, 2 * stage.spectrumLength * sizeof(double));
+		for (unsigned int p = 0; p < stage.activePartitions; p++)
+		{
+			unsigned int slot = stage.fdlIndex + stage.skipPartitions + p;
+			if (slot >= stage.fdlLength)
+				slot -= stage.fdlLength;
+			kernels.complexMultiplyAccumulate(stage.accumulator, &stage.fdl[slot * stage.spectrumStride],
+											  &stage.filterSpectra[p * stage.spectrumStride], stage.spectrumLength);
+		}
+
+		// --- overlap-save: the second half is the linear convolution, the first half the circular wrap
+		fftw_execute(stage.planBackward);
+		memcpy(stage.outputBlock, &stage.timeOutput[stage.partitionSize], stage.partitionSize * sizeof(double));
+	}
 
+	/** free the buffers and plans */
+	void destroyStages()
+	{
+		for (unsigned int s = 0; s < numStages; s++)
+		{
+			ConvolverStage& stage = stages[s];
+			if (stage.planForward)
+				fftw_destroy_plan(stage.planForward);
+			if (stage.planBackward)
+				fftw_destroy_plan(stage.planBackward);
+
+			fxDeleteArray(stage.timeInput);
+			fxDeleteArray(stage.timeOutput);
+			fxDeleteArray(stage.outputBlock);
+			fxDeleteArray(stage.fdl);
+			fxDeleteArray(stage.filterSpectra);
+			fxDeleteArray(stage.accumulator);
+			stage = ConvolverStage();
+		}
+		numStages = 0;
+		partitionSize = maxPartitionSize = maxIRLength = irLength = 0;
+	}
 };
 
 /**
@@ -8901,6 +11444,11 @@ Audio I/O:
 Control I/F:
 - none.
 
+Partitions:
+- runs on a uniformly partitioned PartitionedConvolver; by default the IR is one partition, so the latency is
+  the IR length and the FFTs run once per IR length, as the original single block convolver did
+- pass a smaller partition size to initialize( ) to trade a little more CPU for a latency of just that many samples
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
@@ -8909,137 +11457,50 @@ Control I/F:
 class FastConvolver
 {
 public:
-	FastConvolver() {
-		vocoder.setOverlapAddOnly(true);
-	}		/* C-TOR */
-	~FastConvolver() {
-		if (filterIR)
-			delete[] filterIR;
-
-		if (filterFFT)
-			fftw_free(filterFFT);
-	}	/* D-TOR */
+	FastConvolver() {}		/* C-TOR */
+	~FastConvolver() {}		/* D-TOR */
 
 	/** setup the FFT for a given IR length */
 	/**
 	\param _filterImpulseLength the filter IR length, which is 1/2 FFT length due to need for zero-padding (see FX book)
+	\param _partitionSize the partition size and latency; 0 for a single partition of _filterImpulseLength
 	*/
-	void initialize(unsigned int _filterImpulseLength)
+	void initialize(unsigned int _filterImpulseLength, unsigned int _partitionSize = 0)
 	{
-		if (filterImpulseLength == _filterImpulseLength)
+		if (_partitionSize == 0 || _partitionSize > _filterImpulseLength)
+			_partitionSize = _filterImpulseLength;
+
+		if (filterImpulseLength == _filterImpulseLength && convolver.getPartitionSize() == _partitionSize)
 			return;
 
-		// --- setup a specialized vocoder with 50% hop size
 		filterImpulseLength = _filterImpulseLength;
-		vocoder.initialize(filterImpulseLength * 2, filterImpulseLength, windowType::kNoWindow);
-
-		// --- initialize the FFT object for capturing the filter FFT
-		filterFastFFT.initialize(filterImpulseLength * 2, windowType::kNoWindow);
-
-		// --- array to hold the filter IR; this could be localized to the particular function that uses it
-		if (filterIR)
-			delete [] filterIR;
-		filterIR = new double[filterImpulseLength * 2];
-		memset(&filterIR[0], 0, filterImpulseLength * 2 * sizeof(double));
-
-		// --- allocate the filter FFT arrays
-		if(filterFFT)
-			fftw_free(filterFFT);
-
-		 filterFFT = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * filterImpulseLength * 2);
-
-		 // --- reset
-		 inputCount = 0;
+		convolver.initialize(_partitionSize, filterImpulseLength);
 	}
 
 	/** setup the filter IRirBuffer MUST be exactly filterImpulseLength in size, or this will crash! */
 	void setFilterIR(double* irBuffer)
 	{
 		if (!irBuffer) return;
-
-		memset(&filterIR[0], 0, filterImpulseLength * 2 * sizeof(double));
-
-		// --- copy over first half; filterIR len = filterImpulseLength * 2
-		int m = 0;
-		for (unsigned int i = 0; i < filterImpulseLength; i++)
-		{
-			filterIR[i] = irBuffer[i];
-		}
-
-		// --- take FFT of the h(n)
-		fftw_complex* fftOfFilter = filterFastFFT.doFFT(&filterIR[0]);
-
-		// --- copy the FFT into our local buffer for storage; also
-		//     we never want to hold a pointer to a FFT output
-		//     for more than one local function's worth
-		//     could replace with memcpy( )
-		for (int i = 0; i < 2; i++)
-		{
-			for (unsigned int j = 0; j < filterImpulseLength * 2; j++)
-			{
-				filterFFT[j][i] = fftOfFilter[j][i];
-			}
-		}
+		convolver.setFilterIR(irBuffer, filterImpulseLength);
 	}
 
 	/** process an input sample through convolver */
 	double processAudioSample(double input)
 	{
-		bool fftReady = false;
-		double output = 0.0;
-
-		if (inputCount == filterImpulseLength)
-		{
-			fftReady = vocoder.addZeroPad(filterImpulseLength);
-
-			if (fftReady) // should happen on time
-			{
-				// --- multiply our filter IR with the vocoder FFT
-				fftw_complex* signalFFT = vocoder.getFFTData();
-				if (signalFFT)
-				{
-					unsigned int fff = vocoder.getFrameLength();
-
-					// --- complex multiply with FFT of IR
-					for (unsigned int i = 0; i < filterImpulseLength * 2; i++)
-					{
-						// --- get real/imag parts of each FFT
-						ComplexNumber signal(signalFFT[i][0], signalFFT[i][1]);
-						ComplexNumber filter(filterFFT[i][0], filterFFT[i][1]);
-
-						// --- use complex multiply function; this convolves in the time domain
-						ComplexNumber product = complexMultiply(signal, filter);
-
-						// --- overwrite the FFT bins
-						signalFFT[i][0] = product.real;
-						signalFFT[i][1] = product.imag;
-					}
-				}
-			}
-
-			// --- reset counter
-			inputCount = 0;
-		}
-
-		// --- process next sample
-		output = vocoder.processAudioSample(input, fftReady);
-		inputCount++;
-
-		return output;
+		return convolver.processAudioSample(input);
 	}
 
 	/** get current frame length */
-	unsigned int getFrameLength() { return vocoder.getFrameLength(); }
+	unsigned int getFrameLength() { return 2 * convolver.getPartitionSize(); }
 
 	/** get current IR length*/
 	unsigned int getFilterIRLength() { return filterImpulseLength; }
 
+	/** get the latency in samples, the partition size */
+	unsigned int getLatency() { return convolver.getLatency(); }
+
 protected:
-	PhaseVocoder vocoder;				///< vocoder object
-	FastFFT filterFastFFT;				///< FastFFT object
-	fftw_complex* filterFFT = nullptr;	///< filterFFT output arrays
-	double* filterIR = nullptr;			///< filter IR
-	unsigned int inputCount = 0;		///< input sample counter
+	PartitionedConvolver convolver;		///< the partitioned convolver
 	unsigned int filterImpulseLength = 0;///< IR length
 };
 
@@ -9160,9 +11621,8 @@ public:
 		vocoder.initialize(PSM_FFT_LEN, PSM_FFT_LEN/4, windowType::kHannWindow);  // 75% overlap
 	}		/* C-TOR */
 	~PSMVocoder() {
-		if (windowBuff) delete[] windowBuff;
-		if (outputBuff) delete[] outputBuff;
-
+		fxDeleteArray(windowBuff);
+		fxDeleteArray(outputBuff);
 	}	/* D-TOR */
 
 	/** reset members to initialized state */
@@ -9207,8 +11667,8 @@ public:
 		outputBufferLength = newOutputBufferLength;
 
 		// --- create Hann window
-		if (windowBuff) delete[] windowBuff;
-		windowBuff = new double[outputBufferLength];
+		fxDeleteArray(windowBuff);
+		windowBuff = fxNewArray<double>(outputBufferLength);
 		windowCorrection = 0.0;
 		for (unsigned int i = 0; i < outputBufferLength; i++)
 		{
@@ -9218,8 +11678,8 @@ public:
 		windowCorrection = 1.0 / windowCorrection;
 
 		// --- create output buffer
-		if (outputBuff) delete[] outputBuff;
-		outputBuff = new double[outputBufferLength];
+		fxDeleteArray(outputBuff);
+		outputBuff = fxNewArray<double>(outputBufferLength);
 		memset(outputBuff, 0, sizeof(double)*outputBufferLength);
 	}
 
@@ -9566,155 +12026,11 @@ protected:
 	unsigned int outputBufferLength = 0;	///< lenght of resampled output array
 };
 
-// --- sample rate conversion
-//
-// --- supported conversion ratios - you can EASILY add more to this
-/**
-\enum rateConversionRatio
-\ingroup Constants-Enums
-\brief
-Use this strongly typed enum to easily set up or down sampling ratios.
-
-- enum class rateConversionRatio { k2x, k4x };
-
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-enum class rateConversionRatio { k2x, k4x };
-const unsigned int maxSamplingRatio = 4;
-
-/**
-@countForRatio
-\ingroup FX-Functions
-
-@brief returns the up or downsample ratio as a numeric value
-
-\param ratio - enum class ratio value
-\return the up or downsample ratio as a numeric value
-*/
-inline unsigned int countForRatio(rateConversionRatio ratio)
-{
-	if (ratio == rateConversionRatio::k2x)
-		return 2;
-	else if (ratio == rateConversionRatio::k4x || ratio == rateConversionRatio::k4x)
-		return 4;
-
-	return 0;
-}
-
-// --- get table pointer for built-in anti-aliasing LPFs
-/**
-@getFilterIRTable
-\ingroup FX-Functions
-
-@brief returns the up or downsample ratio as a numeric value
-
-\param FIRLength - lenght of FIR
-\param ratio - the conversinon ratio
-\param sampleRate - the sample rate
-\return a pointer to the appropriate FIR coefficient table in filters.h or nullptr if not found
-*/
-inline double* getFilterIRTable(unsigned int FIRLength, rateConversionRatio ratio, unsigned int sampleRate)
-{
-	// --- we only have built in filters for 44.1 and 48 kHz
-	if (sampleRate != 44100 && sampleRate != 48000) return nullptr;
-
-	// --- choose 2xtable
-	if (ratio == rateConversionRatio::k2x)
-	{
-		if (sampleRate == 44100)
-		{
-			if (FIRLength == 128)
-				return &LPF128_882[0];
-			else if (FIRLength == 256)
-				return &LPF256_882[0];
-			else if (FIRLength == 512)
-				return &LPF512_882[0];
-			else if (FIRLength == 1024)
-				return &LPF1024_882[0];
-		}
-		if (sampleRate == 48000)
-		{
-			if (FIRLength == 128)
-				return &LPF128_96[0];
-			else if (FIRLength == 256)
-				return &LPF256_96[0];
-			else if (FIRLength == 512)
-				return &LPF512_96[0];
-			else if (FIRLength == 1024)
-				return &LPF1024_96[0];
-		}
-	}
-
-	// --- choose 4xtable
-	if (ratio == rateConversionRatio::k4x)
-	{
-		if (sampleRate == 44100)
-		{
-			if (FIRLength == 128)
-				return &LPF128_1764[0];
-			else if (FIRLength == 256)
-				return &LPF256_1764[0];
-			else if (FIRLength == 512)
-				return &LPF512_1764[0];
-			else if (FIRLength == 1024)
-				return &LPF1024_1764[0];
-		}
-		if (sampleRate == 48000)
-		{
-			if (FIRLength == 128)
-				return &LPF128_192[0];
-			else if (FIRLength == 256)
-				return &LPF256_192[0];
-			else if (FIRLength == 512)
-				return &LPF512_192[0];
-			else if (FIRLength == 1024)
-				return &LPF1024_192[0];
-		}
-	}
-	return nullptr;
-}
-
-// --- get table pointer for built-in anti-aliasing LPFs
-/**
-@decomposeFilter
-\ingroup FX-Functions
-
-@brief performs a polyphase decomposition on a big FIR into a set of sub-band FIRs
-
-\param filterIR - pointer to filter IR array
-\param FIRLength - lenght of IR array
-\param ratio - up or down sampling ratio
-\return a pointer an arry of buffer pointers to the decomposed mini-filters
-*/
-inline double** decomposeFilter(double* filterIR, unsigned int FIRLength, unsigned int ratio)
-{
-	unsigned int subBandLength = FIRLength / ratio;
-	double ** polyFilterSet = new double*[ratio];
-	for (unsigned int i = 0; i < ratio; i++)
-	{
-		double* polyFilter = new double[subBandLength];
-		polyFilterSet[i] = polyFilter;
-	}
-
-	int m = 0;
-	for (int i = 0; i < subBandLength; i++)
-	{
-		for (int j = ratio - 1; j >= 0; j--)
-		{
-			double* polyFilter = polyFilterSet[j];
-			polyFilter[i] = filterIR[m++];
-		}
-	}
-
-	return polyFilterSet;
-}
+#endif
 
 /**
 \struct InterpolatorOutput
-\ingroup FFTW-Objects
+\ingroup FX-Objects
 \brief
 Custom output structure for interpolator; it holds an arry of interpolated output samples.
 
@@ -9733,10 +12049,18 @@ struct InterpolatorOutput
 
 /**
 \class Interpolator
-\ingroup FFTW-Objects
+\ingroup FX-Objects
 \brief
 The Interpolator object implements a sample rate interpolator. One input sample yields N output samples.
 
+Filter paths:
+- polyphase FIRs up to the maxDirectFIRLength argument of initialize( ) (kMaxPolyphaseFIRLength, i.e. the 128, 256
+  and 512 point tables, by default) run direct form on a PolyphaseInterpolator: the same cost every sample, on the
+  CPU-dispatched kernel, and no frame latency
+- longer FIRs, or any FIR with polyphase off, run on FastConvolver: cheap on average, but it collects a frame of
+  FIRLength samples and runs a full FFT/IFFT on one of them, so the cost comes in spikes; it needs FFTW
+- without FFTW only the direct form is available; an FIR it does not take passes the input through zero-stuffed
+
 Audio I/O:
 - Processes mono input to interpoalted (multi-sample) output.
 
@@ -9760,13 +12084,31 @@ public:
 	\param _ratio the conversion ratio (see rateConversionRatio)
 	\param _sampleRate the actual sample rate
 	\param _polyphase flag to enable polyphase decomposition
+	\param maxDirectFIRLength polyphase FIRs up to this length run direct form, longer ones on the FFT; 0 = always FFT
 	*/
-	inline void initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate, bool _polyphase = true)
+	inline void initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate, bool _polyphase = true,
+						   unsigned int maxDirectFIRLength = kMaxPolyphaseFIRLength)
 	{
 		polyphase = _polyphase;
 		sampleRate = _sampleRate;
 		FIRLength = _FIRLength;
 		ratio = _ratio;
+
+		// --- direct form for the shorter tables
+#ifdef HAVE_FFTW
+		directForm = polyphase && FIRLength <= maxDirectFIRLength;
+#else
+		// --- no FFT path to hand the longer tables to
+		(void)maxDirectFIRLength;
+		directForm = true;
+#endif
+		if (directForm)
+		{
+			directInterpolator.initialize(FIRLength, ratio, sampleRate);
+			return;
+		}
+
+#ifdef HAVE_FFTW
 		unsigned int count = countForRatio(ratio);
 		unsigned int subBandLength = FIRLength / count;
 
@@ -9797,8 +12139,12 @@ public:
 		}
 
 		delete[] polyPhaseFilters;
+#endif
 	}
 
+	/** true when the direct form path is running */
+	bool isDirectForm() const { return directForm; }
+
 	/** perform the interpolation; the multiple outputs are in an array in the return structure */
 	inline InterpolatorOutput interpolateAudio(double xn)
 	{
@@ -9808,6 +12154,13 @@ public:
 		InterpolatorOutput output;
 		output.count = count;
 
+		if (directForm)
+		{
+			directInterpolator.interpolateBlock(&xn, output.audioData, 1);
+			return output;
+		}
+
+#ifdef HAVE_FFTW
 		// --- interpolators need the amp correction
 		double ampCorrection = double(count);
 
@@ -9820,12 +12173,15 @@ public:
 			else
 				output.audioData[i] = ampCorrection*polyPhaseConvolvers[m--].processAudioSample(xn);
 		}
+#endif
 		return output;
 	}
 
 protected:
+#ifdef HAVE_FFTW
 	// --- for straight, non-polyphase
 	FastConvolver convolver; ///< the convolver
+#endif
 
 	// --- we save these for future expansion, currently only sparsely used
 	unsigned int sampleRate = 44100;	///< sample rate
@@ -9834,12 +12190,18 @@ protected:
 
 	// --- polyphase: 4x is max right now
 	bool polyphase = true;									///< enable polyphase decomposition
+#ifdef HAVE_FFTW
 	FastConvolver polyPhaseConvolvers[maxSamplingRatio];	///< a set of sub-band convolvers for polyphase operation
+#endif
+
+	// --- direct form polyphase
+	bool directForm = false;						///< true when directInterpolator runs
+	PolyphaseInterpolator directInterpolator;		///< direct form path
 };
 
 /**
 \struct DecimatorInput
-\ingroup FFTW-Objects
+\ingroup FX-Objects
 \brief
 Custom input structure for DecimatorInput; it holds an arry of input samples that will be decimated down to just one sample.
 
@@ -9857,11 +12219,15 @@ struct DecimatorInput
 
 /**
 \class Decimator
-\ingroup FFTW-Objects
+\ingroup FX-Objects
 \brief
 The Decimator object implements a sample rate decimator. Ana array of M input samples is decimated
 to one output sample.
 
+Filter paths:
+- as the Interpolator: polyphase FIRs up to maxDirectFIRLength run direct form on a PolyphaseDecimator, the others
+  on FastConvolver (FFTW only)
+
 Audio I/O:
 - Processes mono input to interpoalted (multi-sample) output.
 
@@ -9885,13 +12251,31 @@ public:
 	\param _ratio the conversion ratio (see rateConversionRatio)
 	\param _sampleRate the actual sample rate
 	\param _polyphase flag to enable polyphase decomposition
+	\param maxDirectFIRLength polyphase FIRs up to this length run direct form, longer ones on the FFT; 0 = always FFT
 	*/
-	inline void initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate, bool _polyphase = true)
+	inline void initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate, bool _polyphase = true,
+						   unsigned int maxDirectFIRLength = kMaxPolyphaseFIRLength)
 	{
 		polyphase = _polyphase;
 		sampleRate = _sampleRate;
 		FIRLength = _FIRLength;
 		ratio = _ratio;
+
+		// --- direct form for the shorter tables
+#ifdef HAVE_FFTW
+		directForm = polyphase && FIRLength <= maxDirectFIRLength;
+#else
+		// --- no FFT path to hand the longer tables to
+		(void)maxDirectFIRLength;
+		directForm = true;
+#endif
+		if (directForm)
+		{
+			directDecimator.initialize(FIRLength, ratio, sampleRate);
+			return;
+		}
+
+#ifdef HAVE_FFTW
 		unsigned int count = countForRatio(ratio);
 		unsigned int subBandLength = FIRLength / count;
 
@@ -9922,16 +12306,27 @@ public:
 		}
 
 		delete[] polyPhaseFilters;
+#endif
 	}
 
+	/** true when the direct form path is running */
+	bool isDirectForm() const { return directForm; }
+
 	/** decimate audio input samples into one outut sample (return value) */
 	inline double decimateAudio(DecimatorInput data)
 	{
-		unsigned int count = countForRatio(ratio);
-
 		// --- setup output
 		double output = 0.0;
 
+		if (directForm)
+		{
+			directDecimator.decimateBlock(data.audioData, &output, 1);
+			return output;
+		}
+
+#ifdef HAVE_FFTW
+		unsigned int count = countForRatio(ratio);
+
 		// --- polyphase uses "forwards" indexing for decimator; see book
 		for (unsigned int i = 0; i < count; i++)
 		{
@@ -9940,12 +12335,15 @@ public:
 			else
 				output += polyPhaseConvolvers[i].processAudioSample(data.audioData[i]);
 		}
+#endif
 		return output;
 	}
 
 protected:
+#ifdef HAVE_FFTW
 	// --- for straight, non-polyphase
 	FastConvolver convolver;		 ///< fast convolver
+#endif
 
 	// --- we save these for future expansion, currently only sparsely used
 	unsigned int sampleRate = 44100;	///< sample rate
@@ -9954,7 +12352,12 @@ protected:
 
 	// --- polyphase: 4x is max right now
 	bool polyphase = true;									///< enable polyphase decomposition
+#ifdef HAVE_FFTW
 	FastConvolver polyPhaseConvolvers[maxSamplingRatio];	///< a set of sub-band convolvers for polyphase operation
+#endif
+
+	// --- direct form polyphase
+	bool directForm = false;					///< true when directDecimator runs
+	PolyphaseDecimator directDecimator;			///< direct form path
 };
 
-#endif